@@ -433,8 +433,32 @@ typedef struct
     cJSON_bool noalloc;
     cJSON_bool format; /* is this print a formatted print */
     internal_hooks hooks;
+    /* streamed printing: filled halves of stream_base are handed to sink */
+    cJSON_StreamSink sink;
+    void *sink_userdata;
+    unsigned char *stream_base;
 } printbuffer;
 
+/* hand the filled part of a streamed printbuffer to the sink and switch to the other half */
+static cJSON_bool flush_printbuffer(printbuffer * const p)
+{
+    if (p->offset == 0)
+    {
+        return true;
+    }
+
+    if (!p->sink((const char*)p->buffer, p->offset, p->sink_userdata))
+    {
+        return false;
+    }
+
+    p->buffer = (p->buffer == p->stream_base) ? (p->stream_base + p->length) : p->stream_base;
+    p->offset = 0;
+    p->buffer[0] = '\0';
+
+    return true;
+}
+
 /* realloc printbuffer if necessary to have at least "needed" bytes more */
 static unsigned char* ensure(printbuffer * const p, size_t needed)
 {
@@ -464,6 +488,18 @@ static unsigned char* ensure(printbuffer * const p, size_t needed)
         return p->buffer + p->offset;
     }
 
+    if (p->sink != NULL)
+    {
+        /* streamed: send what we have and continue in the other half */
+        needed -= p->offset;
+        if ((needed > p->length) || !flush_printbuffer(p))
+        {
+            return NULL;
+        }
+
+        return p->buffer;
+    }
+
     if (p->noalloc) {
         return NULL;
     }
@@ -777,8 +813,8 @@ static cJSON_bool parse_string(cJSON * const item, parse_buffer * const input_bu
     unsigned char *output_pointer = NULL;
     unsigned char *output = NULL;
 
-    /* not a string */
-    if (buffer_at_offset(input_buffer)[0] != '\"')
+    /* not a string, or nothing left at all (an object key after a trailing comma) */
+    if (cannot_access_at_index(input_buffer, 0) || (buffer_at_offset(input_buffer)[0] != '\"'))
     {
         goto fail;
     }
@@ -1261,7 +1297,7 @@ CJSON_PUBLIC(char *) cJSON_PrintUnformatted(const cJSON *item)
 
 CJSON_PUBLIC(char *) cJSON_PrintBuffered(const cJSON *item, int prebuffer, cJSON_bool fmt)
 {
-    printbuffer p = { 0, 0, 0, 0, 0, 0, { 0, 0, 0 } };
+    printbuffer p = { 0, 0, 0, 0, 0, 0, { 0, 0, 0 }, 0, 0, 0 };
 
     if (prebuffer < 0)
     {
@@ -1291,7 +1327,7 @@ CJSON_PUBLIC(char *) cJSON_PrintBuffered(const cJSON *item, int prebuffer, cJSON
 
 CJSON_PUBLIC(cJSON_bool) cJSON_PrintPreallocated(cJSON *item, char *buffer, const int length, const cJSON_bool format)
 {
-    printbuffer p = { 0, 0, 0, 0, 0, 0, { 0, 0, 0 } };
+    printbuffer p = { 0, 0, 0, 0, 0, 0, { 0, 0, 0 }, 0, 0, 0 };
 
     if ((length < 0) || (buffer == NULL))
     {
@@ -1308,6 +1344,35 @@ CJSON_PUBLIC(cJSON_bool) cJSON_PrintPreallocated(cJSON *item, char *buffer, cons
     return print_value(item, &p);
 }
 
+CJSON_PUBLIC(cJSON_bool) cJSON_PrintStreamed(const cJSON *item, char *buffer, size_t length, const cJSON_bool format, cJSON_StreamSink sink, void *userdata)
+{
+    printbuffer p = { 0, 0, 0, 0, 0, 0, { 0, 0, 0 }, 0, 0, 0 };
+
+    if ((buffer == NULL) || (sink == NULL) || (length < 4))
+    {
+        return false;
+    }
+
+    p.stream_base = (unsigned char*)buffer;
+    p.buffer = p.stream_base;
+    p.length = length / 2;
+    p.offset = 0;
+    p.noalloc = true;
+    p.format = format;
+    p.hooks = global_hooks;
+    p.sink = sink;
+    p.sink_userdata = userdata;
+    p.buffer[0] = '\0';
+
+    if (!print_value(item, &p))
+    {
+        return false;
+    }
+    update_offset(&p);
+
+    return flush_printbuffer(&p);
+}
+
 /* Parser core - when encountering text, process appropriately. */
 static cJSON_bool parse_value(cJSON * const item, parse_buffer * const input_buffer)
 {
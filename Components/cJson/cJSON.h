@@ -131,6 +131,11 @@ typedef struct cJSON_Hooks
 
 typedef int cJSON_bool;
 
+/* Receives one chunk of streamed output, returns false to abort printing.
+ * The chunk stays untouched until the sink is called again, so it may be
+ * handed to DMA as long as the next call waits for that transfer to finish. */
+typedef cJSON_bool (*cJSON_StreamSink)(const char *chunk, size_t length, void *userdata);
+
 /* Limits how deeply nested arrays/objects can be before cJSON rejects to parse them.
  * This is to prevent stack overflows. */
 #ifndef CJSON_NESTING_LIMIT
@@ -161,6 +166,11 @@ CJSON_PUBLIC(char *) cJSON_PrintBuffered(const cJSON *item, int prebuffer, cJSON
 /* Render a cJSON entity to text using a buffer already allocated in memory with given length. Returns 1 on success and 0 on failure. */
 /* NOTE: cJSON is not always 100% accurate in estimating how much memory it will use, so to be safe allocate 5 bytes more than you actually need */
 CJSON_PUBLIC(cJSON_bool) cJSON_PrintPreallocated(cJSON *item, char *buffer, const int length, const cJSON_bool format);
+/* Render a cJSON entity to text in chunks, without allocating.
+ * buffer is split into two halves: one is filled while the sink sends the other.
+ * Every single token (string, number, raw) must fit into length / 2 - 1 bytes.
+ * Chunks are not NUL terminated. Returns false on failure or when the sink aborts. */
+CJSON_PUBLIC(cJSON_bool) cJSON_PrintStreamed(const cJSON *item, char *buffer, size_t length, const cJSON_bool format, cJSON_StreamSink sink, void *userdata);
 /* Delete a cJSON entity and all subentities. */
 CJSON_PUBLIC(void) cJSON_Delete(cJSON *item);
 
@@ -0,0 +1,836 @@
+/*
+  Copyright (c) 2009-2017 Dave Gamble and cJSON contributors
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in
+  all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+  THE SOFTWARE.
+*/
+
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <float.h>
+
+#include "cJSON_Bind.h"
+
+/* define our own boolean type */
+#ifdef true
+#undef true
+#endif
+#define true ((cJSON_bool)1)
+
+#ifdef false
+#undef false
+#endif
+#define false ((cJSON_bool)0)
+
+/* keys longer than this can never match a field name and are skipped */
+#define BIND_KEY_MAX 64
+
+typedef struct
+{
+    const unsigned char *content;
+    size_t length;
+    size_t offset;
+    size_t depth;
+} bind_parser;
+
+typedef struct
+{
+    char *buffer;
+    size_t length;
+    size_t offset;
+    size_t depth;
+    cJSON_bool format;
+} bind_printer;
+
+#define can_read(parser, size) (((parser)->offset + (size)) <= (parser)->length)
+#define can_access_at_index(parser, index) (((parser)->offset + (index)) < (parser)->length)
+#define buffer_at_offset(parser) ((parser)->content + (parser)->offset)
+
+static void skip_whitespace(bind_parser * const parser)
+{
+    while (can_access_at_index(parser, 0) && (buffer_at_offset(parser)[0] <= 32))
+    {
+        parser->offset++;
+    }
+}
+
+static cJSON_bool consume(bind_parser * const parser, const char *literal)
+{
+    size_t length = strlen(literal);
+
+    if (!can_read(parser, length) || (strncmp((const char*)buffer_at_offset(parser), literal, length) != 0))
+    {
+        return false;
+    }
+    parser->offset += length;
+
+    return true;
+}
+
+static unsigned int parse_hex4(const unsigned char * const input)
+{
+    unsigned int h = 0;
+    size_t i = 0;
+
+    for (i = 0; i < 4; i++)
+    {
+        h <<= 4;
+        if ((input[i] >= '0') && (input[i] <= '9'))
+        {
+            h += (unsigned int) input[i] - '0';
+        }
+        else if ((input[i] >= 'A') && (input[i] <= 'F'))
+        {
+            h += (unsigned int) 10 + input[i] - 'A';
+        }
+        else if ((input[i] >= 'a') && (input[i] <= 'f'))
+        {
+            h += (unsigned int) 10 + input[i] - 'a';
+        }
+        else
+        {
+            return 0xFFFFFFFF;
+        }
+    }
+
+    return h;
+}
+
+/* append one byte to a bounded string, remembering if it overflowed */
+static void put_char(char *output, size_t capacity, size_t *used, cJSON_bool *fits, unsigned char c)
+{
+    if ((output != NULL) && ((*used + 1) < capacity))
+    {
+        output[*used] = (char)c;
+    }
+    else
+    {
+        *fits = false;
+    }
+    (*used)++;
+}
+
+/* Parse a JSON string at the parser position into output (capacity bytes including
+ * the terminator). output may be NULL to just skip the string. */
+static cJSON_bool parse_string(bind_parser * const parser, char *output, size_t capacity, cJSON_bool *fits)
+{
+    size_t used = 0;
+
+    *fits = true;
+    if (!can_access_at_index(parser, 0) || (buffer_at_offset(parser)[0] != '\"'))
+    {
+        return false;
+    }
+    parser->offset++;
+
+    while (can_access_at_index(parser, 0))
+    {
+        unsigned char c = buffer_at_offset(parser)[0];
+
+        if (c == '\"')
+        {
+            parser->offset++;
+            if ((output != NULL) && (capacity > 0))
+            {
+                output[(used < capacity) ? used : (capacity - 1)] = '\0';
+            }
+            return true;
+        }
+        if (c < 32)
+        {
+            return false;
+        }
+        if (c != '\\')
+        {
+            put_char(output, capacity, &used, fits, c);
+            parser->offset++;
+            continue;
+        }
+
+        if (!can_access_at_index(parser, 1))
+        {
+            return false;
+        }
+        c = buffer_at_offset(parser)[1];
+        parser->offset += 2;
+        switch (c)
+        {
+            case 'b': put_char(output, capacity, &used, fits, '\b'); break;
+            case 'f': put_char(output, capacity, &used, fits, '\f'); break;
+            case 'n': put_char(output, capacity, &used, fits, '\n'); break;
+            case 'r': put_char(output, capacity, &used, fits, '\r'); break;
+            case 't': put_char(output, capacity, &used, fits, '\t'); break;
+            case '\"':
+            case '\\':
+            case '/':
+                put_char(output, capacity, &used, fits, c);
+                break;
+            case 'u':
+            {
+                unsigned long codepoint = 0;
+                unsigned int first = 0;
+
+                if (!can_read(parser, 4) || ((first = parse_hex4(buffer_at_offset(parser))) == 0xFFFFFFFF))
+                {
+                    return false;
+                }
+                parser->offset += 4;
+                if ((first >= 0xDC00) && (first <= 0xDFFF))
+                {
+                    return false;
+                }
+                if ((first >= 0xD800) && (first <= 0xDBFF))
+                {
+                    unsigned int second = 0;
+
+                    if (!can_read(parser, 6) || (buffer_at_offset(parser)[0] != '\\') || (buffer_at_offset(parser)[1] != 'u'))
+                    {
+                        return false;
+                    }
+                    second = parse_hex4(buffer_at_offset(parser) + 2);
+                    if ((second < 0xDC00) || (second > 0xDFFF))
+                    {
+                        return false;
+                    }
+                    parser->offset += 6;
+                    codepoint = 0x10000 + (((first & 0x3FF) << 10) | (second & 0x3FF));
+                }
+                else
+                {
+                    codepoint = first;
+                }
+
+                /* encode as UTF-8 */
+                if (codepoint < 0x80)
+                {
+                    put_char(output, capacity, &used, fits, (unsigned char)codepoint);
+                }
+                else if (codepoint < 0x800)
+                {
+                    put_char(output, capacity, &used, fits, (unsigned char)(0xC0 | (codepoint >> 6)));
+                    put_char(output, capacity, &used, fits, (unsigned char)(0x80 | (codepoint & 0x3F)));
+                }
+                else if (codepoint < 0x10000)
+                {
+                    put_char(output, capacity, &used, fits, (unsigned char)(0xE0 | (codepoint >> 12)));
+                    put_char(output, capacity, &used, fits, (unsigned char)(0x80 | ((codepoint >> 6) & 0x3F)));
+                    put_char(output, capacity, &used, fits, (unsigned char)(0x80 | (codepoint & 0x3F)));
+                }
+                else
+                {
+                    put_char(output, capacity, &used, fits, (unsigned char)(0xF0 | (codepoint >> 18)));
+                    put_char(output, capacity, &used, fits, (unsigned char)(0x80 | ((codepoint >> 12) & 0x3F)));
+                    put_char(output, capacity, &used, fits, (unsigned char)(0x80 | ((codepoint >> 6) & 0x3F)));
+                    put_char(output, capacity, &used, fits, (unsigned char)(0x80 | (codepoint & 0x3F)));
+                }
+                break;
+            }
+            default:
+                return false;
+        }
+    }
+
+    return false;
+}
+
+static cJSON_bool parse_number(bind_parser * const parser, double *number)
+{
+    unsigned char number_c_string[64];
+    unsigned char *after_end = NULL;
+    size_t i = 0;
+
+    for (i = 0; (i < (sizeof(number_c_string) - 1)) && can_access_at_index(parser, i); i++)
+    {
+        unsigned char c = buffer_at_offset(parser)[i];
+        if (((c >= '0') && (c <= '9')) || (c == '+') || (c == '-') || (c == 'e') || (c == 'E') || (c == '.'))
+        {
+            number_c_string[i] = c;
+        }
+        else
+        {
+            break;
+        }
+    }
+    number_c_string[i] = '\0';
+
+    *number = strtod((const char*)number_c_string, (char**)&after_end);
+    if (number_c_string == after_end)
+    {
+        return false;
+    }
+    parser->offset += (size_t)(after_end - number_c_string);
+
+    return true;
+}
+
+static cJSON_bool skip_value(bind_parser * const parser)
+{
+    cJSON_bool fits = true;
+    double number = 0;
+
+    skip_whitespace(parser);
+    if (!can_access_at_index(parser, 0))
+    {
+        return false;
+    }
+
+    switch (buffer_at_offset(parser)[0])
+    {
+        case '\"':
+            return parse_string(parser, NULL, 0, &fits);
+        case 'n':
+            return consume(parser, "null");
+        case 't':
+            return consume(parser, "true");
+        case 'f':
+            return consume(parser, "false");
+        case '[':
+        case '{':
+        {
+            unsigned char close = (buffer_at_offset(parser)[0] == '[') ? ']' : '}';
+
+            if (++parser->depth > CJSON_NESTING_LIMIT)
+            {
+                return false;
+            }
+            parser->offset++;
+            skip_whitespace(parser);
+            if (can_access_at_index(parser, 0) && (buffer_at_offset(parser)[0] == close))
+            {
+                parser->offset++;
+                parser->depth--;
+                return true;
+            }
+            for (;;)
+            {
+                if (close == '}')
+                {
+                    skip_whitespace(parser);
+                    if (!parse_string(parser, NULL, 0, &fits))
+                    {
+                        return false;
+                    }
+                    skip_whitespace(parser);
+                    if (!consume(parser, ":"))
+                    {
+                        return false;
+                    }
+                }
+                if (!skip_value(parser))
+                {
+                    return false;
+                }
+                skip_whitespace(parser);
+                if (!can_access_at_index(parser, 0))
+                {
+                    return false;
+                }
+                if (buffer_at_offset(parser)[0] == close)
+                {
+                    parser->offset++;
+                    parser->depth--;
+                    return true;
+                }
+                if (buffer_at_offset(parser)[0] != ',')
+                {
+                    return false;
+                }
+                parser->offset++;
+            }
+        }
+        default:
+            return parse_number(parser, &number);
+    }
+}
+
+static const cJSON_BindField *find_field(const cJSON_BindSchema *schema, const char *key)
+{
+    size_t i = 0;
+
+    for (i = 0; i < schema->count; i++)
+    {
+        if (strcmp(schema->fields[i].name, key) == 0)
+        {
+            return &schema->fields[i];
+        }
+    }
+
+    return NULL;
+}
+
+static double clamp_number(const cJSON_BindField *field, double number)
+{
+    double min = field->min;
+    double max = field->max;
+
+    if (field->type == cJSON_BindUint)
+    {
+        if (min == max)
+        {
+            min = 0;
+            max = (field->size == 1) ? 255.0 : ((field->size == 2) ? 65535.0 : 4294967295.0);
+        }
+    }
+    else if (field->type == cJSON_BindInt)
+    {
+        if (min == max)
+        {
+            min = (field->size == 1) ? -128.0 : ((field->size == 2) ? -32768.0 : -2147483648.0);
+            max = (field->size == 1) ? 127.0 : ((field->size == 2) ? 32767.0 : 2147483647.0);
+        }
+    }
+    else if (min == max)
+    {
+        return number;
+    }
+
+    if (number < min)
+    {
+        return min;
+    }
+    if (number > max)
+    {
+        return max;
+    }
+
+    return number;
+}
+
+static cJSON_bool store_number(const cJSON_BindField *field, unsigned char *member, double number)
+{
+    number = clamp_number(field, number);
+
+    switch (field->type)
+    {
+        case cJSON_BindInt:
+        {
+            long value = (long)number;
+            if (field->size == 1) { *(signed char*)member = (signed char)value; }
+            else if (field->size == 2) { *(short*)member = (short)value; }
+            else if (field->size == 4) { *(int*)member = (int)value; }
+            else { return false; }
+            return true;
+        }
+        case cJSON_BindUint:
+        {
+            unsigned long value = (unsigned long)number;
+            if (field->size == 1) { *(unsigned char*)member = (unsigned char)value; }
+            else if (field->size == 2) { *(unsigned short*)member = (unsigned short)value; }
+            else if (field->size == 4) { *(unsigned int*)member = (unsigned int)value; }
+            else { return false; }
+            return true;
+        }
+        case cJSON_BindFloat:
+            *(float*)member = (float)number;
+            return true;
+        case cJSON_BindDouble:
+            *(double*)member = number;
+            return true;
+        default:
+            return false;
+    }
+}
+
+static cJSON_bool store_bool(const cJSON_BindField *field, unsigned char *member, cJSON_bool value)
+{
+    /* write the whole member so cJSON_bool (int) and uint8_t flags both work */
+    memset(member, 0, field->size);
+    if (value)
+    {
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
+        member[field->size - 1] = 1;
+#else
+        member[0] = 1;
+#endif
+    }
+
+    return true;
+}
+
+static cJSON_bool decode_object(bind_parser * const parser, const cJSON_BindSchema *schema, unsigned char *object);
+
+static cJSON_bool decode_field(bind_parser * const parser, const cJSON_BindField *field, unsigned char *object)
+{
+    unsigned char *member = object + field->offset;
+    cJSON_bool fits = true;
+    double number = 0;
+
+    skip_whitespace(parser);
+    if (!can_access_at_index(parser, 0))
+    {
+        return false;
+    }
+
+    /* null leaves the member at its default */
+    if (buffer_at_offset(parser)[0] == 'n')
+    {
+        return consume(parser, "null");
+    }
+
+    switch (field->type)
+    {
+        case cJSON_BindBool:
+            if (consume(parser, "true"))
+            {
+                return store_bool(field, member, true);
+            }
+            if (consume(parser, "false"))
+            {
+                return store_bool(field, member, false);
+            }
+            return false;
+        case cJSON_BindInt:
+        case cJSON_BindUint:
+        case cJSON_BindFloat:
+        case cJSON_BindDouble:
+            if (!parse_number(parser, &number))
+            {
+                return false;
+            }
+            return store_number(field, member, number);
+        case cJSON_BindString:
+            return parse_string(parser, (char*)member, field->size, &fits) && fits;
+        case cJSON_BindObject:
+            return (field->schema != NULL) && decode_object(parser, field->schema, member);
+        default:
+            return false;
+    }
+}
+
+static cJSON_bool decode_object(bind_parser * const parser, const cJSON_BindSchema *schema, unsigned char *object)
+{
+    char key[BIND_KEY_MAX];
+    cJSON_bool fits = true;
+
+    skip_whitespace(parser);
+    if (!consume(parser, "{") || (++parser->depth > CJSON_NESTING_LIMIT))
+    {
+        return false;
+    }
+    skip_whitespace(parser);
+    if (consume(parser, "}"))
+    {
+        parser->depth--;
+        return true;
+    }
+
+    for (;;)
+    {
+        const cJSON_BindField *field = NULL;
+
+        skip_whitespace(parser);
+        if (!parse_string(parser, key, sizeof(key), &fits))
+        {
+            return false;
+        }
+        skip_whitespace(parser);
+        if (!consume(parser, ":"))
+        {
+            return false;
+        }
+
+        field = fits ? find_field(schema, key) : NULL;
+        if (field != NULL)
+        {
+            if (!decode_field(parser, field, object))
+            {
+                return false;
+            }
+        }
+        else if (!skip_value(parser))
+        {
+            return false;
+        }
+
+        skip_whitespace(parser);
+        if (consume(parser, "}"))
+        {
+            parser->depth--;
+            return true;
+        }
+        if (!consume(parser, ","))
+        {
+            return false;
+        }
+    }
+}
+
+CJSON_PUBLIC(cJSON_bool) cJSON_BindDecode(const cJSON_BindSchema *schema, void *object, const char *json, size_t length)
+{
+    bind_parser parser;
+
+    if ((schema == NULL) || (object == NULL) || (json == NULL))
+    {
+        return false;
+    }
+
+    parser.content = (const unsigned char*)json;
+    parser.length = length;
+    parser.offset = 0;
+    parser.depth = 0;
+
+    /* skip UTF-8 BOM */
+    if (can_read(&parser, 3) && (strncmp(json, "\xEF\xBB\xBF", 3) == 0))
+    {
+        parser.offset += 3;
+    }
+
+    if (!decode_object(&parser, schema, (unsigned char*)object))
+    {
+        return false;
+    }
+
+    /* only whitespace may follow the object, up to the end or a terminating NUL */
+    while (can_access_at_index(&parser, 0) && (buffer_at_offset(&parser)[0] != '\0') && (buffer_at_offset(&parser)[0] <= 32))
+    {
+        parser.offset++;
+    }
+    return !can_access_at_index(&parser, 0) || (buffer_at_offset(&parser)[0] == '\0');
+}
+
+static cJSON_bool emit(bind_printer * const printer, const char *data, size_t length)
+{
+    if ((printer->offset + length + 1) > printer->length)
+    {
+        return false;
+    }
+    memcpy(printer->buffer + printer->offset, data, length);
+    printer->offset += length;
+    printer->buffer[printer->offset] = '\0';
+
+    return true;
+}
+
+static cJSON_bool emit_indent(bind_printer * const printer)
+{
+    size_t i = 0;
+
+    for (i = 0; i < printer->depth; i++)
+    {
+        if (!emit(printer, "\t", 1))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static cJSON_bool emit_string(bind_printer * const printer, const char *string, size_t capacity)
+{
+    size_t i = 0;
+
+    if (!emit(printer, "\"", 1))
+    {
+        return false;
+    }
+    for (i = 0; (i < capacity) && (string[i] != '\0'); i++)
+    {
+        unsigned char c = (unsigned char)string[i];
+        char escaped[7];
+        size_t escaped_length = 2;
+
+        escaped[0] = '\\';
+        switch (c)
+        {
+            case '\"': escaped[1] = '\"'; break;
+            case '\\': escaped[1] = '\\'; break;
+            case '\b': escaped[1] = 'b'; break;
+            case '\f': escaped[1] = 'f'; break;
+            case '\n': escaped[1] = 'n'; break;
+            case '\r': escaped[1] = 'r'; break;
+            case '\t': escaped[1] = 't'; break;
+            default:
+                if (c < 32)
+                {
+                    sprintf(escaped, "\\u%04x", c);
+                    escaped_length = 6;
+                }
+                else
+                {
+                    escaped[0] = (char)c;
+                    escaped_length = 1;
+                }
+                break;
+        }
+        if (!emit(printer, escaped, escaped_length))
+        {
+            return false;
+        }
+    }
+
+    return emit(printer, "\"", 1);
+}
+
+static cJSON_bool emit_number(bind_printer * const printer, const cJSON_BindField *field, const unsigned char *member)
+{
+    char number_buffer[26];
+    int length = 0;
+
+    switch (field->type)
+    {
+        case cJSON_BindInt:
+        {
+            long value = (field->size == 1) ? *(const signed char*)member : ((field->size == 2) ? *(const short*)member : *(const int*)member);
+            length = sprintf(number_buffer, "%ld", value);
+            break;
+        }
+        case cJSON_BindUint:
+        {
+            unsigned long value = (field->size == 1) ? *(const unsigned char*)member : ((field->size == 2) ? *(const unsigned short*)member : *(const unsigned int*)member);
+            length = sprintf(number_buffer, "%lu", value);
+            break;
+        }
+        case cJSON_BindFloat:
+        {
+            float value = *(const float*)member;
+            if ((value != value) || (value - value != 0))
+            {
+                length = sprintf(number_buffer, "null");
+            }
+            else
+            {
+                /* shortest of 7 or 9 digits that survives a round trip */
+                length = sprintf(number_buffer, "%1.7g", (double)value);
+                if ((float)strtod(number_buffer, NULL) != value)
+                {
+                    length = sprintf(number_buffer, "%1.9g", (double)value);
+                }
+            }
+            break;
+        }
+        case cJSON_BindDouble:
+        {
+            double value = *(const double*)member;
+            if ((value != value) || (value - value != 0))
+            {
+                length = sprintf(number_buffer, "null");
+            }
+            else
+            {
+                length = sprintf(number_buffer, "%1.15g", value);
+                if (strtod(number_buffer, NULL) != value)
+                {
+                    length = sprintf(number_buffer, "%1.17g", value);
+                }
+            }
+            break;
+        }
+        default:
+            return false;
+    }
+
+    return (length > 0) && emit(printer, number_buffer, (size_t)length);
+}
+
+static cJSON_bool encode_object(bind_printer * const printer, const cJSON_BindSchema *schema, const unsigned char *object)
+{
+    size_t i = 0;
+
+    if (!emit(printer, "{", 1))
+    {
+        return false;
+    }
+    printer->depth++;
+    if (printer->format && (schema->count > 0) && !emit(printer, "\n", 1))
+    {
+        return false;
+    }
+
+    for (i = 0; i < schema->count; i++)
+    {
+        const cJSON_BindField *field = &schema->fields[i];
+        const unsigned char *member = object + field->offset;
+        cJSON_bool ok = false;
+
+        if (printer->format && !emit_indent(printer))
+        {
+            return false;
+        }
+        if (!emit_string(printer, field->name, (size_t)-1) || !emit(printer, printer->format ? ":\t" : ":", printer->format ? 2 : 1))
+        {
+            return false;
+        }
+
+        switch (field->type)
+        {
+            case cJSON_BindBool:
+            {
+                size_t byte = 0;
+                cJSON_bool value = false;
+                for (byte = 0; byte < field->size; byte++)
+                {
+                    value |= (member[byte] != 0);
+                }
+                ok = value ? emit(printer, "true", 4) : emit(printer, "false", 5);
+                break;
+            }
+            case cJSON_BindString:
+                ok = emit_string(printer, (const char*)member, field->size);
+                break;
+            case cJSON_BindObject:
+                ok = (field->schema != NULL) && encode_object(printer, field->schema, member);
+                break;
+            default:
+                ok = emit_number(printer, field, member);
+                break;
+        }
+        if (!ok)
+        {
+            return false;
+        }
+
+        if (((i + 1) < schema->count) && !emit(printer, ",", 1))
+        {
+            return false;
+        }
+        if (printer->format && !emit(printer, "\n", 1))
+        {
+            return false;
+        }
+    }
+
+    printer->depth--;
+    if (printer->format && (schema->count > 0) && !emit_indent(printer))
+    {
+        return false;
+    }
+
+    return emit(printer, "}", 1);
+}
+
+CJSON_PUBLIC(cJSON_bool) cJSON_BindEncode(const cJSON_BindSchema *schema, const void *object, char *buffer, size_t length, cJSON_bool format)
+{
+    bind_printer printer;
+
+    if ((schema == NULL) || (object == NULL) || (buffer == NULL) || (length == 0))
+    {
+        return false;
+    }
+
+    printer.buffer = buffer;
+    printer.length = length;
+    printer.offset = 0;
+    printer.depth = 0;
+    printer.format = format;
+    buffer[0] = '\0';
+
+    return encode_object(&printer, schema, (const unsigned char*)object);
+}
@@ -0,0 +1,109 @@
+/*
+  Copyright (c) 2009-2017 Dave Gamble and cJSON contributors
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in
+  all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+  THE SOFTWARE.
+*/
+
+#ifndef cJSON_Bind__h
+#define cJSON_Bind__h
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include "cJSON.h"
+
+/* Schema binding: decode JSON text straight into a C struct and encode the
+ * struct back, driven by a static field table. No cJSON nodes are created and
+ * nothing is allocated, the only memory used is the caller's struct and
+ * output buffer. */
+
+/* Field types understood by the binder */
+typedef enum
+{
+    cJSON_BindBool = 0,  /* cJSON_bool / unsigned char / any integer, written as 0 or 1 */
+    cJSON_BindInt,       /* signed integer of 1, 2 or 4 bytes */
+    cJSON_BindUint,      /* unsigned integer of 1, 2 or 4 bytes */
+    cJSON_BindFloat,     /* float */
+    cJSON_BindDouble,    /* double */
+    cJSON_BindString,    /* char array, always NUL terminated */
+    cJSON_BindObject     /* nested struct described by its own schema */
+} cJSON_BindType;
+
+struct cJSON_BindSchema;
+
+/* Describes one member of the bound struct */
+typedef struct cJSON_BindField
+{
+    /* JSON key, compared case sensitively */
+    const char *name;
+    /* offsetof() of the member inside the struct */
+    size_t offset;
+    /* sizeof() of the member, the capacity for strings */
+    size_t size;
+    cJSON_BindType type;
+    /* Numbers outside [min, max] are clamped. min == max disables the check. */
+    double min;
+    double max;
+    /* Schema of the nested struct for cJSON_BindObject, NULL otherwise */
+    const struct cJSON_BindSchema *schema;
+} cJSON_BindField;
+
+typedef struct cJSON_BindSchema
+{
+    const cJSON_BindField *fields;
+    size_t count;
+} cJSON_BindSchema;
+
+/* Helpers for building field tables, e.g.
+ *
+ *   static const cJSON_BindField display_fields[] = {
+ *       CJSON_BIND_NUMBER(display_t, brightness, cJSON_BindUint, 0, 100),
+ *       CJSON_BIND_BOOL(display_t, auto_off),
+ *   };
+ *   static const cJSON_BindSchema display_schema = CJSON_BIND_SCHEMA(display_fields);
+ */
+#define CJSON_BIND_MEMBER_SIZE(type, member) sizeof(((type *)0)->member)
+#define CJSON_BIND_NUMBER(type, member, bind_type, min, max) \
+    { #member, offsetof(type, member), CJSON_BIND_MEMBER_SIZE(type, member), bind_type, (min), (max), NULL }
+#define CJSON_BIND_BOOL(type, member) \
+    { #member, offsetof(type, member), CJSON_BIND_MEMBER_SIZE(type, member), cJSON_BindBool, 0, 0, NULL }
+#define CJSON_BIND_STRING(type, member) \
+    { #member, offsetof(type, member), CJSON_BIND_MEMBER_SIZE(type, member), cJSON_BindString, 0, 0, NULL }
+#define CJSON_BIND_OBJECT(type, member, member_schema) \
+    { #member, offsetof(type, member), CJSON_BIND_MEMBER_SIZE(type, member), cJSON_BindObject, 0, 0, &(member_schema) }
+#define CJSON_BIND_SCHEMA(field_table) { (field_table), sizeof(field_table) / sizeof((field_table)[0]) }
+
+/* Decode the JSON object in json[0..length) into object.
+ * Keys that are not in the schema are skipped, members whose key is missing keep
+ * their current value, so pre-fill the struct with defaults before decoding.
+ * Only whitespace may follow the object, up to length or a NUL terminator.
+ * Returns false on malformed JSON, a type mismatch, a string longer than its member or
+ * trailing content; object may then be partially written. */
+CJSON_PUBLIC(cJSON_bool) cJSON_BindDecode(const cJSON_BindSchema *schema, void *object, const char *json, size_t length);
+/* Encode object as a JSON object into buffer (NUL terminated).
+ * Returns false if the buffer is too small. */
+CJSON_PUBLIC(cJSON_bool) cJSON_BindEncode(const cJSON_BindSchema *schema, const void *object, char *buffer, size_t length, cJSON_bool format);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,753 @@
+/*
+  Copyright (c) 2009-2017 Dave Gamble and cJSON contributors
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in
+  all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+  THE SOFTWARE.
+*/
+
+#include <string.h>
+#include <math.h>
+#include <limits.h>
+
+#include "cJSON_CBOR.h"
+
+/* define our own boolean type */
+#ifdef true
+#undef true
+#endif
+#define true ((cJSON_bool)1)
+
+#ifdef false
+#undef false
+#endif
+#define false ((cJSON_bool)0)
+
+/* CBOR major types */
+#define CBOR_UINT   0x00
+#define CBOR_NEGINT 0x20
+#define CBOR_BYTES  0x40
+#define CBOR_TEXT   0x60
+#define CBOR_ARRAY  0x80
+#define CBOR_MAP    0xA0
+#define CBOR_TAG    0xC0
+#define CBOR_SIMPLE 0xE0
+
+#define CBOR_FALSE     0xF4
+#define CBOR_TRUE      0xF5
+#define CBOR_NULL      0xF6
+#define CBOR_UNDEFINED 0xF7
+#define CBOR_FLOAT16   0xF9
+#define CBOR_FLOAT32   0xFA
+#define CBOR_FLOAT64   0xFB
+#define CBOR_BREAK     0xFF
+
+/* additional information value for indefinite length */
+#define CBOR_INDEFINITE 31
+
+/* integers up to 2^53 survive the trip through a double */
+#define CBOR_MAX_EXACT_INTEGER 9007199254740992.0
+
+CJSON_PUBLIC(void) cJSON_ArenaInit(cJSON_Arena *arena, void *memory, size_t size)
+{
+    if (arena == NULL)
+    {
+        return;
+    }
+
+    arena->memory = (unsigned char*)memory;
+    arena->size = (memory != NULL) ? size : 0;
+    arena->used = 0;
+}
+
+CJSON_PUBLIC(void) cJSON_ArenaReset(cJSON_Arena *arena)
+{
+    if (arena != NULL)
+    {
+        arena->used = 0;
+    }
+}
+
+typedef struct
+{
+    unsigned char *buffer;
+    unsigned char *base;
+    size_t length;
+    size_t offset;
+    size_t depth;
+    cJSON_StreamSink sink;
+    void *sink_userdata;
+} cbor_writer;
+
+static cJSON_bool writer_flush(cbor_writer * const writer)
+{
+    if (writer->offset == 0)
+    {
+        return true;
+    }
+    if (!writer->sink((const char*)writer->buffer, writer->offset, writer->sink_userdata))
+    {
+        return false;
+    }
+    writer->buffer = (writer->buffer == writer->base) ? (writer->base + writer->length) : writer->base;
+    writer->offset = 0;
+
+    return true;
+}
+
+static cJSON_bool write_bytes(cbor_writer * const writer, const unsigned char *data, size_t length)
+{
+    while (length > 0)
+    {
+        size_t room = writer->length - writer->offset;
+        size_t count = (length < room) ? length : room;
+
+        memcpy(writer->buffer + writer->offset, data, count);
+        writer->offset += count;
+        data += count;
+        length -= count;
+
+        if (length > 0)
+        {
+            if ((writer->sink == NULL) || !writer_flush(writer))
+            {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+/* write a major type with a 64 bit argument split into two 32 bit halves */
+static cJSON_bool write_head(cbor_writer * const writer, unsigned char major, unsigned long high, unsigned long low)
+{
+    unsigned char head[9];
+    size_t length = 0;
+
+    if (high != 0)
+    {
+        head[0] = (unsigned char)(major | 27);
+        head[1] = (unsigned char)(high >> 24);
+        head[2] = (unsigned char)(high >> 16);
+        head[3] = (unsigned char)(high >> 8);
+        head[4] = (unsigned char)high;
+        head[5] = (unsigned char)(low >> 24);
+        head[6] = (unsigned char)(low >> 16);
+        head[7] = (unsigned char)(low >> 8);
+        head[8] = (unsigned char)low;
+        length = 9;
+    }
+    else if (low > 0xFFFFUL)
+    {
+        head[0] = (unsigned char)(major | 26);
+        head[1] = (unsigned char)(low >> 24);
+        head[2] = (unsigned char)(low >> 16);
+        head[3] = (unsigned char)(low >> 8);
+        head[4] = (unsigned char)low;
+        length = 5;
+    }
+    else if (low > 0xFFUL)
+    {
+        head[0] = (unsigned char)(major | 25);
+        head[1] = (unsigned char)(low >> 8);
+        head[2] = (unsigned char)low;
+        length = 3;
+    }
+    else if (low > 23)
+    {
+        head[0] = (unsigned char)(major | 24);
+        head[1] = (unsigned char)low;
+        length = 2;
+    }
+    else
+    {
+        head[0] = (unsigned char)(major | low);
+        length = 1;
+    }
+
+    return write_bytes(writer, head, length);
+}
+
+static cJSON_bool write_text(cbor_writer * const writer, const char *string)
+{
+    size_t length = (string != NULL) ? strlen(string) : 0;
+
+    if (!write_head(writer, CBOR_TEXT, 0, (unsigned long)length))
+    {
+        return false;
+    }
+
+    return write_bytes(writer, (const unsigned char*)string, length);
+}
+
+static cJSON_bool write_number(cbor_writer * const writer, double number)
+{
+    unsigned char encoded[9];
+    float single = (float)number;
+
+    if ((number == floor(number)) && (fabs(number) <= CBOR_MAX_EXACT_INTEGER))
+    {
+        unsigned char major = CBOR_UINT;
+        double magnitude = number;
+        double high = 0;
+
+        if (number < 0)
+        {
+            major = CBOR_NEGINT;
+            magnitude = -1.0 - number;
+        }
+        high = floor(magnitude / 4294967296.0);
+
+        return write_head(writer, major, (unsigned long)high, (unsigned long)(magnitude - (high * 4294967296.0)));
+    }
+
+    if (((double)single == number) || (number != number))
+    {
+        unsigned char bits[4];
+        size_t i = 0;
+
+        memcpy(bits, &single, sizeof(bits));
+        encoded[0] = CBOR_FLOAT32;
+        for (i = 0; i < 4; i++)
+        {
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
+            encoded[1 + i] = bits[i];
+#else
+            encoded[1 + i] = bits[3 - i];
+#endif
+        }
+
+        return write_bytes(writer, encoded, 5);
+    }
+    else
+    {
+        unsigned char bits[8];
+        size_t i = 0;
+
+        memcpy(bits, &number, sizeof(bits));
+        encoded[0] = CBOR_FLOAT64;
+        for (i = 0; i < 8; i++)
+        {
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
+            encoded[1 + i] = bits[i];
+#else
+            encoded[1 + i] = bits[7 - i];
+#endif
+        }
+
+        return write_bytes(writer, encoded, 9);
+    }
+}
+
+static cJSON_bool write_item(cbor_writer * const writer, const cJSON * const item)
+{
+    unsigned char simple = 0;
+
+    switch ((item->type) & 0xFF)
+    {
+        case cJSON_False:
+            simple = CBOR_FALSE;
+            return write_bytes(writer, &simple, 1);
+        case cJSON_True:
+            simple = CBOR_TRUE;
+            return write_bytes(writer, &simple, 1);
+        case cJSON_NULL:
+            simple = CBOR_NULL;
+            return write_bytes(writer, &simple, 1);
+        case cJSON_Number:
+            return write_number(writer, item->valuedouble);
+        case cJSON_String:
+            return write_text(writer, item->valuestring);
+        case cJSON_Array:
+        case cJSON_Object:
+        {
+            const cJSON *child = NULL;
+            unsigned long count = 0;
+            cJSON_bool is_object = ((item->type & 0xFF) == cJSON_Object);
+
+            if (++writer->depth > CJSON_NESTING_LIMIT)
+            {
+                return false;
+            }
+            for (child = item->child; child != NULL; child = child->next)
+            {
+                count++;
+            }
+            if (!write_head(writer, is_object ? CBOR_MAP : CBOR_ARRAY, 0, count))
+            {
+                return false;
+            }
+            for (child = item->child; child != NULL; child = child->next)
+            {
+                if (is_object && !write_text(writer, child->string))
+                {
+                    return false;
+                }
+                if (!write_item(writer, child))
+                {
+                    return false;
+                }
+            }
+            writer->depth--;
+            return true;
+        }
+        default:
+            /* cJSON_Raw and invalid items have no CBOR representation */
+            return false;
+    }
+}
+
+CJSON_PUBLIC(size_t) cJSON_EncodeCBOR(const cJSON *item, unsigned char *buffer, size_t length)
+{
+    cbor_writer writer;
+
+    if ((item == NULL) || (buffer == NULL))
+    {
+        return 0;
+    }
+
+    memset(&writer, 0, sizeof(writer));
+    writer.buffer = buffer;
+    writer.base = buffer;
+    writer.length = length;
+
+    if (!write_item(&writer, item))
+    {
+        return 0;
+    }
+
+    return writer.offset;
+}
+
+CJSON_PUBLIC(cJSON_bool) cJSON_EncodeCBORStreamed(const cJSON *item, unsigned char *buffer, size_t length, cJSON_StreamSink sink, void *userdata)
+{
+    cbor_writer writer;
+
+    if ((item == NULL) || (buffer == NULL) || (sink == NULL) || (length < 2))
+    {
+        return false;
+    }
+
+    memset(&writer, 0, sizeof(writer));
+    writer.buffer = buffer;
+    writer.base = buffer;
+    writer.length = length / 2;
+    writer.sink = sink;
+    writer.sink_userdata = userdata;
+
+    if (!write_item(&writer, item))
+    {
+        return false;
+    }
+
+    return writer_flush(&writer);
+}
+
+typedef struct
+{
+    const unsigned char *content;
+    size_t length;
+    size_t offset;
+    size_t depth;
+    cJSON_Arena *arena;
+} cbor_reader;
+
+static void *reader_allocate(cbor_reader * const reader, size_t size)
+{
+    cJSON_Arena *arena = reader->arena;
+    size_t start = 0;
+
+    if (arena == NULL)
+    {
+        return cJSON_malloc(size);
+    }
+
+    /* keep every allocation aligned for the double inside cJSON */
+    start = (arena->used + (sizeof(double) - 1)) & ~(sizeof(double) - 1);
+    if ((start > arena->size) || (size > (arena->size - start)))
+    {
+        return NULL;
+    }
+    arena->used = start + size;
+
+    return arena->memory + start;
+}
+
+static cJSON *new_item(cbor_reader * const reader, int type)
+{
+    cJSON *item = (cJSON*)reader_allocate(reader, sizeof(cJSON));
+
+    if (item != NULL)
+    {
+        memset(item, 0, sizeof(cJSON));
+        item->type = type;
+    }
+
+    return item;
+}
+
+/* link child as the last element, keeping cJSON's child->prev == last convention */
+static void append_child(cJSON * const parent, cJSON * const child)
+{
+    if (parent->child == NULL)
+    {
+        parent->child = child;
+        child->prev = child;
+    }
+    else
+    {
+        cJSON *last = parent->child->prev;
+        last->next = child;
+        child->prev = last;
+        parent->child->prev = child;
+    }
+}
+
+/* read an initial byte and its argument. *indefinite is set for additional info 31 */
+static cJSON_bool read_head(cbor_reader * const reader, unsigned char *major, double *argument, cJSON_bool *indefinite)
+{
+    unsigned char initial = 0;
+    unsigned char info = 0;
+    size_t count = 0;
+    size_t i = 0;
+
+    if (reader->offset >= reader->length)
+    {
+        return false;
+    }
+    initial = reader->content[reader->offset++];
+    *major = (unsigned char)(initial & 0xE0);
+    info = (unsigned char)(initial & 0x1F);
+    *indefinite = false;
+    *argument = 0;
+
+    if (info < 24)
+    {
+        *argument = info;
+        return true;
+    }
+    if (info == CBOR_INDEFINITE)
+    {
+        *indefinite = true;
+        return true;
+    }
+    if (info > 27)
+    {
+        return false;
+    }
+
+    count = (size_t)1 << (info - 24);
+    if ((reader->length - reader->offset) < count)
+    {
+        return false;
+    }
+    for (i = 0; i < count; i++)
+    {
+        *argument = (*argument * 256.0) + reader->content[reader->offset + i];
+    }
+    reader->offset += count;
+
+    return true;
+}
+
+static double half_to_double(unsigned int half)
+{
+    int exponent = (int)((half >> 10) & 0x1F);
+    double mantissa = (double)(half & 0x3FF);
+    double value = 0;
+
+    if (exponent == 0)
+    {
+        value = ldexp(mantissa, -24);
+    }
+    else if (exponent != 31)
+    {
+        value = ldexp(mantissa + 1024.0, exponent - 25);
+    }
+    else
+    {
+        value = (mantissa == 0) ? HUGE_VAL : (HUGE_VAL - HUGE_VAL);
+    }
+
+    return (half & 0x8000) ? -value : value;
+}
+
+static cJSON_bool read_simple(cbor_reader * const reader, unsigned char initial, cJSON * const item)
+{
+    const unsigned char *bytes = reader->content + reader->offset;
+    size_t i = 0;
+
+    switch (initial)
+    {
+        case CBOR_FALSE:
+            item->type = cJSON_False;
+            return true;
+        case CBOR_TRUE:
+            item->type = cJSON_True;
+            return true;
+        case CBOR_NULL:
+        case CBOR_UNDEFINED:
+            item->type = cJSON_NULL;
+            return true;
+        case CBOR_FLOAT16:
+            if ((reader->length - reader->offset) < 2)
+            {
+                return false;
+            }
+            item->valuedouble = half_to_double(((unsigned int)bytes[0] << 8) | bytes[1]);
+            reader->offset += 2;
+            break;
+        case CBOR_FLOAT32:
+        {
+            unsigned char bits[4];
+            float single = 0;
+
+            if ((reader->length - reader->offset) < 4)
+            {
+                return false;
+            }
+            for (i = 0; i < 4; i++)
+            {
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
+                bits[i] = bytes[i];
+#else
+                bits[i] = bytes[3 - i];
+#endif
+            }
+            memcpy(&single, bits, sizeof(single));
+            item->valuedouble = single;
+            reader->offset += 4;
+            break;
+        }
+        case CBOR_FLOAT64:
+        {
+            unsigned char bits[8];
+
+            if ((reader->length - reader->offset) < 8)
+            {
+                return false;
+            }
+            for (i = 0; i < 8; i++)
+            {
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
+                bits[i] = bytes[i];
+#else
+                bits[i] = bytes[7 - i];
+#endif
+            }
+            memcpy(&item->valuedouble, bits, sizeof(double));
+            reader->offset += 8;
+            break;
+        }
+        default:
+            return false;
+    }
+
+    item->type = cJSON_Number;
+    /* same saturation as cJSON_SetNumberHelper */
+    if (item->valuedouble >= INT_MAX)
+    {
+        item->valueint = INT_MAX;
+    }
+    else if (item->valuedouble <= (double)INT_MIN)
+    {
+        item->valueint = INT_MIN;
+    }
+    else
+    {
+        item->valueint = (int)item->valuedouble;
+    }
+
+    return true;
+}
+
+/* read a definite length text string into a freshly allocated C string */
+static char *read_text(cbor_reader * const reader)
+{
+    unsigned char major = 0;
+    double argument = 0;
+    cJSON_bool indefinite = false;
+    size_t length = 0;
+    char *string = NULL;
+
+    if (!read_head(reader, &major, &argument, &indefinite) || (major != CBOR_TEXT) || indefinite)
+    {
+        return NULL;
+    }
+    if (argument > (double)(reader->length - reader->offset))
+    {
+        return NULL;
+    }
+    length = (size_t)argument;
+
+    string = (char*)reader_allocate(reader, length + 1);
+    if (string == NULL)
+    {
+        return NULL;
+    }
+    memcpy(string, reader->content + reader->offset, length);
+    string[length] = '\0';
+    reader->offset += length;
+
+    return string;
+}
+
+static cJSON_bool at_break(cbor_reader * const reader)
+{
+    if ((reader->offset < reader->length) && (reader->content[reader->offset] == CBOR_BREAK))
+    {
+        reader->offset++;
+        return true;
+    }
+
+    return false;
+}
+
+static cJSON_bool read_item(cbor_reader * const reader, cJSON * const item)
+{
+    unsigned char major = 0;
+    double argument = 0;
+    cJSON_bool indefinite = false;
+    size_t start = 0;
+
+    /* tags carry semantics cJSON has no use for, skip them in place: a chain of
+     * one-byte tags must not cost a stack frame each */
+    do
+    {
+        start = reader->offset;
+        if (!read_head(reader, &major, &argument, &indefinite) || ((major == CBOR_TAG) && indefinite))
+        {
+            return false;
+        }
+    } while (major == CBOR_TAG);
+
+    switch (major)
+    {
+        case CBOR_UINT:
+        case CBOR_NEGINT:
+            if (indefinite)
+            {
+                return false;
+            }
+            item->type = cJSON_Number;
+            item->valuedouble = (major == CBOR_UINT) ? argument : (-1.0 - argument);
+            item->valueint = (item->valuedouble >= INT_MAX) ? INT_MAX : ((item->valuedouble <= (double)INT_MIN) ? INT_MIN : (int)item->valuedouble);
+            return true;
+
+        case CBOR_TEXT:
+            reader->offset = start;
+            item->type = cJSON_String;
+            item->valuestring = read_text(reader);
+            return item->valuestring != NULL;
+
+        case CBOR_SIMPLE:
+            /* floats are decoded from their raw bytes rather than the integer argument */
+            reader->offset = start + 1;
+            return read_simple(reader, reader->content[start], item);
+
+        case CBOR_ARRAY:
+        case CBOR_MAP:
+        {
+            double remaining = argument;
+
+            if (++reader->depth > CJSON_NESTING_LIMIT)
+            {
+                return false;
+            }
+            item->type = (major == CBOR_ARRAY) ? cJSON_Array : cJSON_Object;
+
+            while (indefinite ? !at_break(reader) : (remaining > 0))
+            {
+                char *key = NULL;
+                cJSON *child = NULL;
+
+                if (major == CBOR_MAP)
+                {
+                    key = read_text(reader);
+                    if (key == NULL)
+                    {
+                        return false;
+                    }
+                }
+                child = new_item(reader, cJSON_Invalid);
+                if (child == NULL)
+                {
+                    if ((key != NULL) && (reader->arena == NULL))
+                    {
+                        cJSON_free(key);
+                    }
+                    return false;
+                }
+                child->string = key;
+                /* link before reading so a failure leaves a tree cJSON_Delete can free */
+                append_child(item, child);
+                if (!read_item(reader, child))
+                {
+                    return false;
+                }
+                remaining -= 1;
+            }
+
+            reader->depth--;
+            return true;
+        }
+
+        default:
+            /* byte strings have no JSON counterpart */
+            return false;
+    }
+}
+
+CJSON_PUBLIC(cJSON *) cJSON_DecodeCBOR(const unsigned char *data, size_t length, cJSON_Arena *arena)
+{
+    cbor_reader reader;
+    cJSON *item = NULL;
+    size_t arena_used = (arena != NULL) ? arena->used : 0;
+
+    if ((data == NULL) || (length == 0))
+    {
+        return NULL;
+    }
+
+    reader.content = data;
+    reader.length = length;
+    reader.offset = 0;
+    reader.depth = 0;
+    reader.arena = arena;
+
+    item = new_item(&reader, cJSON_Invalid);
+    if (item == NULL)
+    {
+        return NULL;
+    }
+
+    if (!read_item(&reader, item))
+    {
+        if (arena == NULL)
+        {
+            cJSON_Delete(item);
+        }
+        else
+        {
+            arena->used = arena_used;
+        }
+        return NULL;
+    }
+
+    return item;
+}
@@ -0,0 +1,68 @@
+/*
+  Copyright (c) 2009-2017 Dave Gamble and cJSON contributors
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in
+  all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+  THE SOFTWARE.
+*/
+
+#ifndef cJSON_CBOR__h
+#define cJSON_CBOR__h
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include "cJSON.h"
+
+/* CBOR (RFC 8949) serialization of cJSON trees.
+ *
+ * Numbers are written as the smallest integer, float32 or float64 that holds
+ * the value exactly. Raw items cannot be represented and make encoding fail.
+ * The decoder accepts definite and indefinite length arrays and maps, definite
+ * length text strings, tags (ignored), half/single/double floats and the
+ * simple values false, true, null and undefined (decoded as null). */
+
+/* Bump allocator for decoded trees. A tree decoded into an arena must not be
+ * passed to cJSON_Delete, release it all at once with cJSON_ArenaReset. */
+typedef struct cJSON_Arena
+{
+    unsigned char *memory;
+    size_t size;
+    size_t used;
+} cJSON_Arena;
+
+CJSON_PUBLIC(void) cJSON_ArenaInit(cJSON_Arena *arena, void *memory, size_t size);
+CJSON_PUBLIC(void) cJSON_ArenaReset(cJSON_Arena *arena);
+
+/* Encode item into buffer. Returns the number of bytes written, 0 on failure. */
+CJSON_PUBLIC(size_t) cJSON_EncodeCBOR(const cJSON *item, unsigned char *buffer, size_t length);
+/* Encode item in chunks of exactly length / 2 bytes (the last one may be shorter).
+ * buffer is used as two halves the same way as cJSON_PrintStreamed. */
+CJSON_PUBLIC(cJSON_bool) cJSON_EncodeCBORStreamed(const cJSON *item, unsigned char *buffer, size_t length, cJSON_StreamSink sink, void *userdata);
+
+/* Decode one CBOR data item. With arena == NULL the tree is allocated with the
+ * cJSON hooks and released with cJSON_Delete. Returns NULL on malformed input
+ * or when memory runs out. */
+CJSON_PUBLIC(cJSON *) cJSON_DecodeCBOR(const unsigned char *data, size_t length, cJSON_Arena *arena);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
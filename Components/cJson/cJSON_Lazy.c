@@ -0,0 +1,439 @@
+/*
+  Copyright (c) 2009-2017 Dave Gamble and cJSON contributors
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in
+  all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+  THE SOFTWARE.
+*/
+
+#include <string.h>
+
+#include "cJSON_Lazy.h"
+
+/* define our own boolean type */
+#ifdef true
+#undef true
+#endif
+#define true ((cJSON_bool)1)
+
+#ifdef false
+#undef false
+#endif
+#define false ((cJSON_bool)0)
+
+/* returned by the scanners when the text ends early or is malformed */
+#define LAZY_FAIL ((size_t)-1)
+
+/* SWAR helpers: test all bytes of a machine word at once.
+ * has_zero_byte() is exact about whether any byte is zero. */
+typedef size_t lazy_word;
+#define LAZY_ONES ((lazy_word)-1 / 0xFF)
+#define LAZY_HIGHS (LAZY_ONES * 0x80)
+#define has_zero_byte(word) (((word) - LAZY_ONES) & ~(word) & LAZY_HIGHS)
+#define has_byte(word, byte) has_zero_byte((word) ^ (LAZY_ONES * (lazy_word)(byte)))
+
+static lazy_word load_word(const char *pointer)
+{
+    lazy_word word;
+
+    /* memcpy keeps unaligned loads legal, compilers turn it into a single load */
+    memcpy(&word, pointer, sizeof(word));
+
+    return word;
+}
+
+static size_t skip_whitespace(const cJSON_LazyDoc * const doc, size_t offset)
+{
+    while ((offset < doc->length) && ((unsigned char)doc->json[offset] <= 32))
+    {
+        offset++;
+    }
+
+    return offset;
+}
+
+/* offset is just past the opening quote, returns the offset of the closing quote */
+static size_t scan_string(const cJSON_LazyDoc * const doc, size_t offset)
+{
+    while (offset < doc->length)
+    {
+        char c = 0;
+
+        while ((offset + sizeof(lazy_word)) <= doc->length)
+        {
+            lazy_word word = load_word(doc->json + offset);
+            if (has_byte(word, '\"') | has_byte(word, '\\'))
+            {
+                break;
+            }
+            offset += sizeof(lazy_word);
+        }
+        if (offset >= doc->length)
+        {
+            break;
+        }
+
+        c = doc->json[offset];
+        if (c == '\"')
+        {
+            return offset;
+        }
+        offset += (c == '\\') ? 2 : 1;
+    }
+
+    return LAZY_FAIL;
+}
+
+/* offset is at '[' or '{', returns the offset just past the matching bracket */
+static size_t scan_container(const cJSON_LazyDoc * const doc, size_t offset)
+{
+    size_t depth = 0;
+
+    while (offset < doc->length)
+    {
+        char c = 0;
+
+        /* '[' | 0x20 == '{' and ']' | 0x20 == '}', so three tests cover all five structural bytes */
+        while ((offset + sizeof(lazy_word)) <= doc->length)
+        {
+            lazy_word word = load_word(doc->json + offset);
+            lazy_word folded = word | (LAZY_ONES * 0x20);
+            if (has_byte(word, '\"') | has_byte(folded, '{') | has_byte(folded, '}'))
+            {
+                break;
+            }
+            offset += sizeof(lazy_word);
+        }
+        if (offset >= doc->length)
+        {
+            break;
+        }
+
+        c = doc->json[offset];
+        switch (c)
+        {
+            case '\"':
+                offset = scan_string(doc, offset + 1);
+                if (offset == LAZY_FAIL)
+                {
+                    return LAZY_FAIL;
+                }
+                break;
+            case '[':
+            case '{':
+                if (++depth > CJSON_NESTING_LIMIT)
+                {
+                    return LAZY_FAIL;
+                }
+                break;
+            case ']':
+            case '}':
+                if (--depth == 0)
+                {
+                    return offset + 1;
+                }
+                break;
+            default:
+                break;
+        }
+        offset++;
+    }
+
+    return LAZY_FAIL;
+}
+
+/* returns the offset just past the value starting at offset */
+static size_t scan_value(const cJSON_LazyDoc * const doc, size_t offset)
+{
+    offset = skip_whitespace(doc, offset);
+    if (offset >= doc->length)
+    {
+        return LAZY_FAIL;
+    }
+
+    switch (doc->json[offset])
+    {
+        case '\"':
+            offset = scan_string(doc, offset + 1);
+            return (offset == LAZY_FAIL) ? LAZY_FAIL : (offset + 1);
+        case '[':
+        case '{':
+            return scan_container(doc, offset);
+        default:
+            /* number, true, false or null */
+            while ((offset < doc->length) && ((unsigned char)doc->json[offset] > 32) &&
+                   (doc->json[offset] != ',') && (doc->json[offset] != ']') && (doc->json[offset] != '}'))
+            {
+                offset++;
+            }
+            return offset;
+    }
+}
+
+/* step from the container at offset into its member named by segment */
+static size_t enter_member(const cJSON_LazyDoc * const doc, size_t offset, const char *segment, size_t segment_length)
+{
+    offset = skip_whitespace(doc, offset);
+    if (offset >= doc->length)
+    {
+        return LAZY_FAIL;
+    }
+
+    if (doc->json[offset] == '{')
+    {
+        offset++;
+        for (;;)
+        {
+            size_t key_start = 0;
+            size_t key_end = 0;
+
+            offset = skip_whitespace(doc, offset);
+            if ((offset >= doc->length) || (doc->json[offset] != '\"'))
+            {
+                return LAZY_FAIL;
+            }
+            key_start = offset + 1;
+            key_end = scan_string(doc, key_start);
+            if (key_end == LAZY_FAIL)
+            {
+                return LAZY_FAIL;
+            }
+            offset = skip_whitespace(doc, key_end + 1);
+            if ((offset >= doc->length) || (doc->json[offset] != ':'))
+            {
+                return LAZY_FAIL;
+            }
+            offset = skip_whitespace(doc, offset + 1);
+
+            if (((key_end - key_start) == segment_length) && (memcmp(doc->json + key_start, segment, segment_length) == 0))
+            {
+                return offset;
+            }
+
+            offset = skip_whitespace(doc, scan_value(doc, offset));
+            if ((offset >= doc->length) || (doc->json[offset] != ','))
+            {
+                /* '}' or garbage: the key is not there */
+                return LAZY_FAIL;
+            }
+            offset++;
+        }
+    }
+
+    if (doc->json[offset] == '[')
+    {
+        size_t index = 0;
+        size_t i = 0;
+
+        if (segment_length == 0)
+        {
+            return LAZY_FAIL;
+        }
+        for (i = 0; i < segment_length; i++)
+        {
+            if ((segment[i] < '0') || (segment[i] > '9'))
+            {
+                return LAZY_FAIL;
+            }
+            /* an index too large for size_t is past the end of any array */
+            if (index > ((((size_t)-1) - (size_t)(segment[i] - '0')) / 10))
+            {
+                return LAZY_FAIL;
+            }
+            index = (index * 10) + (size_t)(segment[i] - '0');
+        }
+
+        offset++;
+        for (i = 0; i < index; i++)
+        {
+            offset = skip_whitespace(doc, scan_value(doc, offset));
+            if ((offset >= doc->length) || (doc->json[offset] != ','))
+            {
+                return LAZY_FAIL;
+            }
+            offset++;
+        }
+        offset = skip_whitespace(doc, offset);
+        if ((offset >= doc->length) || (doc->json[offset] == ']'))
+        {
+            return LAZY_FAIL;
+        }
+
+        return offset;
+    }
+
+    return LAZY_FAIL;
+}
+
+/* longest remembered prefix of path, returns its length (0 if none) */
+static size_t cache_lookup(const cJSON_LazyDoc * const doc, const char *path, size_t *offset)
+{
+    size_t best = 0;
+    size_t i = 0;
+
+    for (i = 0; i < CJSON_LAZY_CACHE_SIZE; i++)
+    {
+        const cJSON_LazyEntry *entry = &doc->cache[i];
+        size_t length = strlen(entry->path);
+
+        if ((length > best) && (strncmp(entry->path, path, length) == 0) &&
+            ((path[length] == '\0') || (path[length] == '.')))
+        {
+            best = length;
+            *offset = entry->offset;
+        }
+    }
+
+    return best;
+}
+
+static void cache_store(cJSON_LazyDoc * const doc, const char *path, size_t length, size_t offset)
+{
+    cJSON_LazyEntry *entry = NULL;
+    size_t i = 0;
+
+    if ((length == 0) || (length >= CJSON_LAZY_PATH_MAX))
+    {
+        return;
+    }
+    for (i = 0; i < CJSON_LAZY_CACHE_SIZE; i++)
+    {
+        if ((strlen(doc->cache[i].path) == length) && (strncmp(doc->cache[i].path, path, length) == 0))
+        {
+            return;
+        }
+    }
+
+    entry = &doc->cache[doc->next_entry];
+    doc->next_entry = (doc->next_entry + 1) % CJSON_LAZY_CACHE_SIZE;
+    memcpy(entry->path, path, length);
+    entry->path[length] = '\0';
+    entry->offset = offset;
+}
+
+/* offset of the value at path, LAZY_FAIL if it does not exist */
+static size_t resolve(cJSON_LazyDoc * const doc, const char *path)
+{
+    size_t offset = skip_whitespace(doc, 0);
+    size_t consumed = 0;
+
+    /* skip UTF-8 BOM */
+    if ((offset == 0) && (doc->length >= 3) && (strncmp(doc->json, "\xEF\xBB\xBF", 3) == 0))
+    {
+        offset = skip_whitespace(doc, 3);
+    }
+
+    consumed = cache_lookup(doc, path, &offset);
+    if (path[consumed] == '.')
+    {
+        consumed++;
+    }
+
+    while (path[consumed] != '\0')
+    {
+        const char *segment = path + consumed;
+        size_t segment_length = 0;
+
+        while ((segment[segment_length] != '\0') && (segment[segment_length] != '.'))
+        {
+            segment_length++;
+        }
+
+        offset = enter_member(doc, offset, segment, segment_length);
+        if (offset == LAZY_FAIL)
+        {
+            return LAZY_FAIL;
+        }
+        consumed += segment_length;
+        /* after an empty segment the prefix ends in '.', the same path with a trailing '.' would hit it */
+        if (segment_length > 0)
+        {
+            cache_store(doc, path, consumed, offset);
+        }
+
+        if (path[consumed] == '.')
+        {
+            consumed++;
+        }
+    }
+
+    return offset;
+}
+
+CJSON_PUBLIC(void) cJSON_LazyInit(cJSON_LazyDoc *doc, const char *json, size_t length)
+{
+    if (doc == NULL)
+    {
+        return;
+    }
+
+    memset(doc, 0, sizeof(cJSON_LazyDoc));
+    doc->json = json;
+    doc->length = (json != NULL) ? length : 0;
+}
+
+CJSON_PUBLIC(cJSON_bool) cJSON_LazyFind(cJSON_LazyDoc *doc, const char *path, const char **value, size_t *value_length)
+{
+    size_t start = 0;
+    size_t end = 0;
+
+    if ((doc == NULL) || (doc->json == NULL) || (path == NULL))
+    {
+        return false;
+    }
+
+    start = resolve(doc, path);
+    if (start == LAZY_FAIL)
+    {
+        return false;
+    }
+    end = scan_value(doc, start);
+    if ((end == LAZY_FAIL) || (end == start))
+    {
+        return false;
+    }
+
+    if (value != NULL)
+    {
+        *value = doc->json + start;
+    }
+    if (value_length != NULL)
+    {
+        *value_length = end - start;
+    }
+
+    return true;
+}
+
+CJSON_PUBLIC(cJSON *) cJSON_LazyGet(cJSON_LazyDoc *doc, const char *path)
+{
+    size_t start = 0;
+
+    if ((doc == NULL) || (doc->json == NULL) || (path == NULL))
+    {
+        return NULL;
+    }
+
+    start = resolve(doc, path);
+    if (start == LAZY_FAIL)
+    {
+        return NULL;
+    }
+
+    /* the parser stops after one value, the rest of the document is never touched */
+    return cJSON_ParseWithLengthOpts(doc->json + start, doc->length - start, NULL, false);
+}
@@ -0,0 +1,81 @@
+/*
+  Copyright (c) 2009-2017 Dave Gamble and cJSON contributors
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in
+  all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+  THE SOFTWARE.
+*/
+
+#ifndef cJSON_Lazy__h
+#define cJSON_Lazy__h
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include "cJSON.h"
+
+/* On-demand access to a large JSON text without parsing all of it.
+ *
+ * A path such as "settings.display.brightness" is resolved by scanning the
+ * text: subtrees that are not on the path are skipped with a word-at-a-time
+ * bracket/string scanner and never materialized. Numeric segments index into
+ * arrays ("playlist.3.title"), an index that does not fit in size_t matches
+ * nothing. Keys are compared byte for byte, so keys that contain escape
+ * sequences never match.
+ *
+ * The document remembers where the containers it already walked start, so
+ * looking up siblings ("settings.display.contrast") resumes from there.
+ * Skipped regions are only checked for balanced brackets and strings; the
+ * returned subtree itself is fully validated by cJSON_LazyGet. */
+
+#ifndef CJSON_LAZY_CACHE_SIZE
+#define CJSON_LAZY_CACHE_SIZE 8
+#endif
+
+/* longest path prefix that is remembered, longer prefixes are just rescanned */
+#ifndef CJSON_LAZY_PATH_MAX
+#define CJSON_LAZY_PATH_MAX 48
+#endif
+
+typedef struct cJSON_LazyEntry
+{
+    char path[CJSON_LAZY_PATH_MAX];
+    size_t offset;
+} cJSON_LazyEntry;
+
+typedef struct cJSON_LazyDoc
+{
+    const char *json;
+    size_t length;
+    cJSON_LazyEntry cache[CJSON_LAZY_CACHE_SIZE];
+    size_t next_entry;
+} cJSON_LazyDoc;
+
+/* json must stay valid and unchanged while the document is in use. */
+CJSON_PUBLIC(void) cJSON_LazyInit(cJSON_LazyDoc *doc, const char *json, size_t length);
+/* Find the raw text of the value at path. An empty path is the root value. */
+CJSON_PUBLIC(cJSON_bool) cJSON_LazyFind(cJSON_LazyDoc *doc, const char *path, const char **value, size_t *value_length);
+/* Parse only the value at path. The result belongs to the caller (cJSON_Delete). */
+CJSON_PUBLIC(cJSON *) cJSON_LazyGet(cJSON_LazyDoc *doc, const char *path);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
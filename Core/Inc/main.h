@@ -71,6 +71,9 @@ void Error_Handler(void);
 #define LCD_RESET_GPIO_Port GPIOB
 #define LCD_DC_Pin GPIO_PIN_10
 #define LCD_DC_GPIO_Port GPIOB
+#define LCD_TE_Pin GPIO_PIN_11
+#define LCD_TE_GPIO_Port GPIOB
+#define LCD_TE_EXTI_IRQn EXTI15_10_IRQn
 #define LCD_BLK_Pin GPIO_PIN_14
 #define LCD_BLK_GPIO_Port GPIOB
 #define STDBY_Pin GPIO_PIN_9
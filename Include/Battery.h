@@ -0,0 +1,91 @@
+#ifndef BATTERY_H
+#define BATTERY_H
+
+/**
+ * @file Battery.h
+ * @brief Supply voltage monitor on the POWER pin (PA0, ADC1_IN1).
+ *
+ * @note
+ *   - Battery_Task() converts one sample per call (polled, about 0.2 ms) and keeps a
+ *     running average, so a single dip during an SD write or a backlight step is not taken for
+ *     an empty battery.
+ *   - After BATTERY_LOW_COUNT averaged samples below BATTERY_LOW_MV the MicroOS event
+ *     BATTERY_EVENT_LOW is triggered once; it is armed again above BATTERY_LOW_MV + BATTERY_HYSTERESIS_MV
+ *     (charger plugged in). BlockCache flushes on it.
+ */
+
+#include "stdint.h"
+#include "stdbool.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+// ADC reference (VDDA) in mV
+#ifndef BATTERY_VREF_MV
+#define BATTERY_VREF_MV (3300)
+#endif
+
+// Divider in front of PA0: battery voltage = pin voltage * NUM / DEN
+#ifndef BATTERY_DIVIDER_NUM
+#define BATTERY_DIVIDER_NUM (2)
+#endif
+#ifndef BATTERY_DIVIDER_DEN
+#define BATTERY_DIVIDER_DEN (1)
+#endif
+
+// Power-down threshold, above the regulator dropout so there is time left to flush (mV)
+#ifndef BATTERY_LOW_MV
+#define BATTERY_LOW_MV (3450)
+#endif
+
+#ifndef BATTERY_HYSTERESIS_MV
+#define BATTERY_HYSTERESIS_MV (100)
+#endif
+
+// Consecutive samples below BATTERY_LOW_MV before the event
+#ifndef BATTERY_LOW_COUNT
+#define BATTERY_LOW_COUNT (4)
+#endif
+
+// MicroOS event triggered when the battery runs low
+#ifndef BATTERY_EVENT_LOW
+#define BATTERY_EVENT_LOW (5)
+#endif
+
+/**
+ * @brief Battery status codes
+ */
+typedef enum
+{
+    BATTERY_OK = 0, /**< Operation successful */
+    BATTERY_ERROR,  /**< ADC error */
+} Battery_Status_t;
+
+/**
+ * @brief Calibrate the ADC and set a sampling time suited to the divider
+ * @note Call after MX_ADC1_Init()
+ */
+extern Battery_Status_t Battery_Init(void);
+
+/**
+ * @brief Averaged battery voltage in mV, 0 before the first sample
+ */
+extern uint16_t Battery_GetMillivolts(void);
+
+/**
+ * @brief true from BATTERY_EVENT_LOW until the voltage recovers
+ */
+extern bool Battery_IsLow(void);
+
+/**
+ * @brief Sample the battery; MicroOS task, 10..100 ms period
+ */
+extern void Battery_Task(void *data);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,72 @@
+#ifndef BLIT_H
+#define BLIT_H
+
+/**
+ * @file Blit.h
+ * @brief RGB565 fill, copy, color-key and alpha blend for UI overlays (volume bar, subtitles, icons).
+ *
+ * @note
+ *   - Buffers are addressed as pointer + stride in pixels, so a strip from Render or any
+ *     sub-rectangle of it can be the target.
+ *   - The fast versions move two pixels per 32-bit word. The color key uses the Cortex-M4
+ *     __USUB16/__SEL pair; blending multiplies all three channels at once in the
+ *     0x07E0F81F spread form, so one MUL blends a pixel.
+ *   - Every fast function has a plain per-channel C reference (*_Ref) that gives the same
+ *     result bit for bit. Define BLIT_NO_SIMD to build the fast versions without DSP intrinsics.
+ *   - Alpha is 0..255 and is used with 5-bit precision: a5 = (alpha + 4) >> 3, out = d + (s - d) * a5 / 32.
+ */
+
+#include "stdint.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/**
+ * @brief Fill a rectangle with one color
+ * @param dst Top left pixel
+ * @param dst_stride Pixels per destination row
+ * @param w Width in pixels
+ * @param h Height in pixels
+ * @param color RGB565 color
+ */
+extern void Blit_Fill(uint16_t *dst, uint16_t dst_stride, uint16_t w, uint16_t h, uint16_t color);
+
+/**
+ * @brief Copy a rectangle
+ */
+extern void Blit_Copy(uint16_t *dst, uint16_t dst_stride, const uint16_t *src, uint16_t src_stride, uint16_t w, uint16_t h);
+
+/**
+ * @brief Copy a rectangle, skipping source pixels equal to key
+ * @param key Transparent RGB565 color
+ */
+extern void Blit_CopyKey(uint16_t *dst, uint16_t dst_stride, const uint16_t *src, uint16_t src_stride, uint16_t w, uint16_t h, uint16_t key);
+
+/**
+ * @brief Blend a source rectangle over the destination with a constant alpha
+ * @param alpha 0 keeps dst, 255 copies src
+ */
+extern void Blit_Blend(uint16_t *dst, uint16_t dst_stride, const uint16_t *src, uint16_t src_stride, uint16_t w, uint16_t h, uint8_t alpha);
+
+/**
+ * @brief Paint a solid color through an 8-bit coverage mask (anti-aliased glyphs, rounded icons)
+ * @param mask Top left coverage byte, 0 keeps dst, 255 paints color
+ * @param mask_stride Bytes per mask row
+ * @param color RGB565 color
+ */
+extern void Blit_BlendMask(uint16_t *dst, uint16_t dst_stride, const uint8_t *mask, uint16_t mask_stride, uint16_t w, uint16_t h, uint16_t color);
+
+// Plain C references, one pixel and one channel at a time
+extern void Blit_Fill_Ref(uint16_t *dst, uint16_t dst_stride, uint16_t w, uint16_t h, uint16_t color);
+extern void Blit_Copy_Ref(uint16_t *dst, uint16_t dst_stride, const uint16_t *src, uint16_t src_stride, uint16_t w, uint16_t h);
+extern void Blit_CopyKey_Ref(uint16_t *dst, uint16_t dst_stride, const uint16_t *src, uint16_t src_stride, uint16_t w, uint16_t h, uint16_t key);
+extern void Blit_Blend_Ref(uint16_t *dst, uint16_t dst_stride, const uint16_t *src, uint16_t src_stride, uint16_t w, uint16_t h, uint8_t alpha);
+extern void Blit_BlendMask_Ref(uint16_t *dst, uint16_t dst_stride, const uint8_t *mask, uint16_t mask_stride, uint16_t w, uint16_t h, uint16_t color);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
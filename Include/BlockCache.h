@@ -0,0 +1,138 @@
+#ifndef BLOCKCACHE_H
+#define BLOCKCACHE_H
+
+/**
+ * @file BlockCache.h
+ * @brief Write-back sector cache between the file system and the block device.
+ *
+ * @note
+ *   - BLOCKCACHE_SLOTS sectors with LRU replacement. Sectors read with BLOCKCACHE_PIN (FAT and
+ *     directory sectors) are only replaced when no unpinned slot is left; at most
+ *     BLOCKCACHE_PIN_MAX slots are pinned, beyond that the least recently used pin is dropped.
+ *   - Writes stay in the cache. Dirty sectors go to the card when they are evicted, after
+ *     BLOCKCACHE_WRITE_DELAY ms, on BlockCache_Flush() or when the battery runs low; every
+ *     write-back takes all dirty sectors that are consecutive on the card and sends them as one
+ *     multi-block write, gathered straight from the slots.
+ *   - Multi-sector reads and writes (file data) bypass the slots but stay coherent with them.
+ *   - BlockCache_Init() registers the BATTERY_EVENT_LOW handler: it flushes and switches to
+ *     write-through until the battery recovers.
+ *   - All calls block; a background card transfer (Prefetch, Ntv) is waited for first. Its result
+ *     stays with the request it was started with, see BlockDev_ReadAsync().
+ */
+
+#include "stdint.h"
+#include "stdbool.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+// Cached sectors (512 bytes each)
+#ifndef BLOCKCACHE_SLOTS
+#define BLOCKCACHE_SLOTS (16)
+#endif
+
+// Most pinned slots, below BLOCKCACHE_SLOTS
+#ifndef BLOCKCACHE_PIN_MAX
+#define BLOCKCACHE_PIN_MAX (8)
+#endif
+
+// Longest time a written sector stays dirty (ms)
+#ifndef BLOCKCACHE_WRITE_DELAY
+#define BLOCKCACHE_WRITE_DELAY (2000)
+#endif
+
+// Longest wait for one card transfer (ms)
+#ifndef BLOCKCACHE_IO_TIMEOUT
+#define BLOCKCACHE_IO_TIMEOUT (1000)
+#endif
+
+// Keep the sector when the cache is under pressure
+#define BLOCKCACHE_PIN (0x01)
+
+/**
+ * @brief BlockCache status codes
+ */
+typedef enum
+{
+    BLOCKCACHE_OK = 0,        /**< Operation successful */
+    BLOCKCACHE_ERROR,         /**< Card transfer failed */
+    BLOCKCACHE_INVALID_PARAM, /**< Invalid parameter */
+} BlockCache_Status_t;
+
+/**
+ * @brief Cache statistics
+ */
+typedef struct
+{
+    uint32_t Hits;
+    uint32_t Misses;
+    uint32_t Evictions;   /**< Valid sectors replaced */
+    uint32_t WriteBacks;  /**< Card writes issued for dirty sectors */
+    uint32_t Written;     /**< Sectors written back, Written / WriteBacks is the coalescing */
+    uint32_t Bypassed;    /**< Sectors moved by multi-sector reads and writes */
+    uint8_t Dirty;        /**< Dirty slots now */
+    uint8_t Pinned;       /**< Pinned slots now */
+} BlockCache_Stats_t;
+
+/**
+ * @brief Register the power-down flush
+ * @note Call after MicroOS_Init()
+ */
+extern BlockCache_Status_t BlockCache_Init(void);
+
+/**
+ * @brief Get a sector through the cache
+ * @param flags BLOCKCACHE_PIN or 0
+ * @param data Set to the cached copy, valid until the next BlockCache call
+ * @return BlockCache_Status_t Status code
+ */
+extern BlockCache_Status_t BlockCache_Read(uint32_t sector, uint8_t flags, const uint8_t **data);
+
+/**
+ * @brief Read consecutive sectors straight into buf, cached copies take precedence
+ */
+extern BlockCache_Status_t BlockCache_ReadBlocks(uint32_t sector, uint8_t *buf, uint32_t count);
+
+/**
+ * @brief Write a whole sector into the cache
+ * @param flags BLOCKCACHE_PIN or 0
+ */
+extern BlockCache_Status_t BlockCache_Write(uint32_t sector, const uint8_t *data, uint8_t flags);
+
+/**
+ * @brief Write consecutive sectors straight to the card, cached copies are updated
+ */
+extern BlockCache_Status_t BlockCache_WriteBlocks(uint32_t sector, const uint8_t *buf, uint32_t count);
+
+/**
+ * @brief Write all dirty sectors back
+ */
+extern BlockCache_Status_t BlockCache_Flush(void);
+
+/**
+ * @brief Drop every slot without writing back (card removed)
+ */
+extern void BlockCache_Invalidate(void);
+
+/**
+ * @brief Copy the statistics
+ */
+extern void BlockCache_GetStats(BlockCache_Stats_t *stats);
+
+/**
+ * @brief Reset the statistics
+ */
+extern void BlockCache_ResetStats(void);
+
+/**
+ * @brief Write back sectors dirty for longer than BLOCKCACHE_WRITE_DELAY; MicroOS task, 100 ms period
+ */
+extern void BlockCache_Task(void *data);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
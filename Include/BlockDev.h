@@ -0,0 +1,105 @@
+#ifndef BLOCKDEV_H
+#define BLOCKDEV_H
+
+/**
+ * @file BlockDev.h
+ * @brief Block device under the storage stack (BlockCache, Prefetch).
+ *
+ * @note
+ *   - Same model as the SD driver: transfers only start, the result is fetched once the device
+ *     is idle, and the MicroOS event BLOCKDEV_EVENT_DONE is triggered when a transfer has ended.
+ *   - BlockDev_GetResult() only describes the last transfer that ended. A background user whose
+ *     transfer may be waited for by someone else starts it with BlockDev_ReadAsync(): its result is
+ *     stored in the request by the first BlockDev call that finds the transfer ended, before any
+ *     other transfer can start.
+ *   - The backend is chosen at link time. Source/BlockDev.c runs on the SPI3 SD card;
+ *     Tools/sdbench/BlockDev_Host.c reads a disk image file on Linux with a card latency model.
+ */
+
+#include "stdint.h"
+#include "stdbool.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#define BLOCKDEV_SECTOR_SIZE (512)
+
+// MicroOS event triggered when a transfer has ended (SD_EVENT_DONE on the card)
+#ifndef BLOCKDEV_EVENT_DONE
+#define BLOCKDEV_EVENT_DONE (4)
+#endif
+
+/**
+ * @brief BlockDev status codes
+ */
+typedef enum
+{
+    BLOCKDEV_OK = 0,        /**< Operation successful */
+    BLOCKDEV_ERROR,         /**< Device rejected the transfer, or data error */
+    BLOCKDEV_BUSY,          /**< A transfer is still in progress */
+    BLOCKDEV_TIMEOUT,       /**< Device did not answer in time */
+    BLOCKDEV_INVALID_PARAM, /**< Invalid parameter */
+    BLOCKDEV_NO_MEDIA,      /**< No card, or not initialized */
+} BlockDev_Status_t;
+
+/**
+ * @brief Result of one transfer started with BlockDev_ReadAsync()
+ */
+typedef struct
+{
+    volatile bool Done;                /**< Transfer has ended, Result and EndTick are valid */
+    volatile BlockDev_Status_t Result; /**< Its result */
+    volatile uint32_t EndTick;         /**< HAL tick when its end was seen */
+} BlockDev_Request_t;
+
+/**
+ * @brief Bring the device up (blocking)
+ */
+extern BlockDev_Status_t BlockDev_Init(void);
+
+/**
+ * @brief Size in sectors, 0 before BlockDev_Init()
+ */
+extern uint32_t BlockDev_GetSectorCount(void);
+
+/**
+ * @brief Start reading sectors into buf, valid once the transfer has ended
+ */
+extern BlockDev_Status_t BlockDev_Read(uint32_t sector, uint8_t *buf, uint32_t count);
+
+/**
+ * @brief Start reading sectors into buf, the result goes to req when the transfer ends
+ * @param req Cleared here, must stay valid until req->Done
+ */
+extern BlockDev_Status_t BlockDev_ReadAsync(uint32_t sector, uint8_t *buf, uint32_t count, BlockDev_Request_t *req);
+
+/**
+ * @brief Start writing sectors from buf, which must stay valid until the transfer has ended
+ */
+extern BlockDev_Status_t BlockDev_Write(uint32_t sector, const uint8_t *buf, uint32_t count);
+
+/**
+ * @brief Start writing consecutive sectors gathered from one buffer per sector
+ */
+extern BlockDev_Status_t BlockDev_WriteList(uint32_t sector, const uint8_t *const *list, uint32_t count);
+
+extern bool BlockDev_IsBusy(void);
+
+/**
+ * @brief Result of the last finished transfer
+ */
+extern BlockDev_Status_t BlockDev_GetResult(void);
+
+/**
+ * @brief Wait for the running transfer
+ * @return Transfer result, or BLOCKDEV_TIMEOUT
+ */
+extern BlockDev_Status_t BlockDev_WaitIdle(uint32_t timeout_ms);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,88 @@
+#ifndef COLORCONV_H
+#define COLORCONV_H
+
+/**
+ * @file ColorConv.h
+ * @brief RGB888 to RGB565 conversion with per-channel gamma/brightness tables and 4x4 ordered dither.
+ *
+ * @note
+ *   - Each channel goes through its own 256-entry table (gamma and gain folded in), then gets the
+ *     Bayer threshold of its screen position added before it is cut to 5 or 6 bits. Gradients
+ *     come out as a fine fixed pattern instead of bands, and the pattern does not crawl between
+ *     frames because it is tied to the screen position.
+ *   - The fast version packs the three table outputs into one word and adds the dither to all of
+ *     them with a single saturating Cortex-M4 __UQADD8; two pixels are stored per 32-bit word.
+ *     ColorConv_Convert_Ref() is the plain per-channel reference and gives the same result bit
+ *     for bit. Define COLORCONV_NO_SIMD to build the fast version without DSP intrinsics.
+ *   - Works on any pointer + stride rectangle, so a decoder can convert straight into a Render strip.
+ */
+
+#include "stdint.h"
+#include "stdbool.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/**
+ * @brief ColorConv status codes
+ */
+typedef enum
+{
+    COLORCONV_OK = 0,        /**< Operation successful */
+    COLORCONV_INVALID_PARAM, /**< Invalid parameter */
+} ColorConv_Status_t;
+
+/**
+ * @brief Channels for ColorConv_SetCurve()
+ */
+typedef enum
+{
+    COLORCONV_RED = 0,
+    COLORCONV_GREEN,
+    COLORCONV_BLUE,
+    COLORCONV_ALL,
+} ColorConv_Channel_t;
+
+/**
+ * @brief Reset to identity tables with dithering on
+ */
+extern void ColorConv_Init(void);
+
+/**
+ * @brief Build a channel table: out = 255 * gain/255 * (in/255)^gamma, rounded
+ * @param channel Channel, or COLORCONV_ALL
+ * @param gamma Exponent, 0.1 .. 10 (1.0 is linear)
+ * @param gain Brightness, 255 is full scale
+ * @return ColorConv_Status_t Status code
+ */
+extern ColorConv_Status_t ColorConv_SetCurve(ColorConv_Channel_t channel, float gamma, uint8_t gain);
+
+/**
+ * @brief Turn the ordered dither on or off (off truncates)
+ */
+extern void ColorConv_SetDither(bool enable);
+
+/**
+ * @brief Convert a rectangle
+ * @param dst Top left RGB565 pixel
+ * @param dst_stride Pixels per destination row
+ * @param src Top left RGB888 pixel, bytes in R, G, B order
+ * @param src_stride Bytes per source row
+ * @param w Width in pixels
+ * @param h Height in pixels
+ * @param x, y Screen position of the top left pixel, selects the dither phase
+ */
+extern void ColorConv_Convert(uint16_t *dst, uint16_t dst_stride, const uint8_t *src, uint32_t src_stride,
+                              uint16_t w, uint16_t h, uint16_t x, uint16_t y);
+
+// Plain C reference, one channel at a time
+extern void ColorConv_Convert_Ref(uint16_t *dst, uint16_t dst_stride, const uint8_t *src, uint32_t src_stride,
+                                  uint16_t w, uint16_t h, uint16_t x, uint16_t y);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
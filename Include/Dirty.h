@@ -0,0 +1,97 @@
+#ifndef DIRTY_H
+#define DIRTY_H
+
+/**
+ * @file Dirty.h
+ * @brief Dirty-rectangle tracking: only the parts of the screen that changed are redrawn and sent.
+ *
+ * @note
+ *   - Invalidated rectangles are clipped to the screen and merged. Two rectangles are
+ *     merged when their bounding box is mostly covered by them (DIRTY_MERGE_COVERAGE percent)
+ *     or when the pixels wasted by merging cost less than an extra address window (DIRTY_WINDOW_COST).
+ *   - When the list is full the new rectangle is merged with the one that wastes the fewest pixels.
+ *   - Dirty_Start() takes a snapshot of the list, so invalidations made while it is being
+ *     flushed go to the next frame.
+ *   - Each rectangle is drawn and sent through Render, i.e. strips over SPI1 DMA.
+ */
+
+#include "stdint.h"
+#include "stdbool.h"
+#include "LCD.h"
+#include "Render.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+// Maximum number of separate dirty rectangles
+#ifndef DIRTY_MAX_RECTS
+#define DIRTY_MAX_RECTS (8)
+#endif
+
+// Merge when the rectangles cover at least this percentage of their bounding box
+#ifndef DIRTY_MERGE_COVERAGE
+#define DIRTY_MERGE_COVERAGE (75)
+#endif
+
+// Cost of one more CASET/RASET/RAMWR window and DMA setup, in pixels
+#ifndef DIRTY_WINDOW_COST
+#define DIRTY_WINDOW_COST (256)
+#endif
+
+/**
+ * @brief Mark a screen area as changed
+ * @param rect Area to redraw, clipped to the screen
+ */
+extern void Dirty_Invalidate(const LCD_Rect_t *rect);
+
+/**
+ * @brief Mark the whole screen as changed
+ */
+extern void Dirty_InvalidateAll(void);
+
+/**
+ * @brief Forget all pending rectangles
+ */
+extern void Dirty_Clear(void);
+
+/**
+ * @brief Get the number of pending rectangles
+ * @return Number of rectangles that will be sent by the next flush
+ */
+extern uint8_t Dirty_Count(void);
+
+/**
+ * @brief Get the number of pixels the next flush will send
+ * @return Sum of the pending rectangle areas
+ */
+extern uint32_t Dirty_Pixels(void);
+
+/**
+ * @brief Start sending the pending rectangles
+ * @param Draw Strip draw callback, called with each rectangle as area
+ * @param Userdata Pointer passed to the callback
+ * @return Render_Status_t RENDER_OK if started (or nothing to do), RENDER_BUSY if a flush is running
+ */
+extern Render_Status_t Dirty_Start(Render_DrawFunction_t Draw, void *Userdata);
+
+/**
+ * @brief Advance the running flush, never blocks
+ * @return Render_Status_t RENDER_BUSY while rectangles remain, RENDER_OK when all have been sent
+ */
+extern Render_Status_t Dirty_Process(void);
+
+/**
+ * @brief Send the pending rectangles and wait until done
+ * @param Draw Strip draw callback
+ * @param Userdata Pointer passed to the callback
+ * @return Render_Status_t Status code
+ */
+extern Render_Status_t Dirty_Flush(Render_DrawFunction_t Draw, void *Userdata);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
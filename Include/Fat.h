@@ -0,0 +1,161 @@
+#ifndef FAT_H
+#define FAT_H
+
+/**
+ * @file Fat.h
+ * @brief Read-only FAT32/exFAT file system on the SD card.
+ *
+ * @note
+ *   - Fat_Mount() takes the first FAT32 or exFAT partition of an MBR or GPT disk, or a disk
+ *     without partition table.
+ *   - Opening a file walks its cluster chain once and keeps it as a list of extents (runs of
+ *     consecutive clusters), so reading never goes back to the FAT. exFAT files flagged
+ *     NoFatChain and FAT32 files that happen to be unfragmented become a single extent.
+ *   - Fat_Read() moves whole sectors with one multi-block read per extent straight into the
+ *     caller's buffer; only a partial first or last sector goes through the block cache.
+ *     Fat_GetRun() gives the card sectors behind a file position for readers that drive the
+ *     block device themselves.
+ *   - Files with more than FAT_FILE_EXTENTS fragments keep the last extent as a window that
+ *     slides along the chain, so they still work, at the cost of FAT reads when seeking.
+ *   - Sectors go through BlockCache; FAT and directory sectors are read pinned there.
+ *   - Names are UTF-8, paths use '/' and compare case-insensitively (ASCII).
+ *   - All calls block until the card is done; BlockDev_Init() must already have succeeded.
+ */
+
+#include "stdint.h"
+#include "stdbool.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+// Extents kept per open file, at least 2 (the window slides behind a fixed one)
+#ifndef FAT_FILE_EXTENTS
+#define FAT_FILE_EXTENTS (8)
+#endif
+
+// Longest name in bytes (UTF-8, terminator included); longer names are cut
+#ifndef FAT_NAME_MAX
+#define FAT_NAME_MAX (128)
+#endif
+
+#define FAT_ATTR_READ_ONLY (0x01)
+#define FAT_ATTR_HIDDEN (0x02)
+#define FAT_ATTR_SYSTEM (0x04)
+#define FAT_ATTR_DIRECTORY (0x10)
+#define FAT_ATTR_ARCHIVE (0x20)
+
+/**
+ * @brief Fat status codes
+ */
+typedef enum
+{
+    FAT_OK = 0,        /**< Operation successful */
+    FAT_ERROR,         /**< Card read failed */
+    FAT_NO_FS,         /**< No FAT32/exFAT volume, or not mounted */
+    FAT_CORRUPT,       /**< Broken cluster chain or directory */
+    FAT_NOT_FOUND,     /**< Path does not exist */
+    FAT_INVALID_PARAM, /**< Invalid parameter */
+} Fat_Status_t;
+
+/**
+ * @brief Run of consecutive clusters of a file
+ */
+typedef struct
+{
+    uint32_t FileCluster; /**< Index of the first cluster inside the file */
+    uint32_t Cluster;     /**< Its cluster number on the volume */
+    uint32_t Count;       /**< Clusters in the run */
+} Fat_Extent_t;
+
+/**
+ * @brief Open file or directory; owned by the caller
+ */
+typedef struct
+{
+    uint32_t Size;     /**< Bytes; 0xFFFFFFFF for FAT32 directories (until end of chain) */
+    uint32_t Pos;      /**< Read position */
+    uint32_t FirstCluster;
+    uint8_t Attr;
+    bool NoChain;      /**< exFAT: contiguous, not in the FAT */
+    bool Complete;     /**< Extent list covers the whole chain */
+    uint8_t Extents;   /**< Extent entries used */
+    Fat_Extent_t Extent[FAT_FILE_EXTENTS];
+} Fat_File_t;
+
+/**
+ * @brief Directory entry
+ */
+typedef struct
+{
+    char Name[FAT_NAME_MAX];
+    uint32_t Size;
+    uint8_t Attr;
+    uint32_t FirstCluster;
+    bool NoChain;
+} Fat_Info_t;
+
+/**
+ * @brief Find and mount the volume
+ * @return Fat_Status_t Status code
+ */
+extern Fat_Status_t Fat_Mount(void);
+
+/**
+ * @brief true for exFAT, false for FAT32
+ */
+extern bool Fat_IsExFat(void);
+
+/**
+ * @brief Bytes per cluster, 0 when not mounted
+ */
+extern uint32_t Fat_GetClusterSize(void);
+
+/**
+ * @brief Open a file or directory by path, "/" is the root directory
+ */
+extern Fat_Status_t Fat_Open(Fat_File_t *file, const char *path);
+
+/**
+ * @brief Open the entry returned by Fat_ReadDir()
+ */
+extern Fat_Status_t Fat_OpenInfo(Fat_File_t *file, const Fat_Info_t *info);
+
+/**
+ * @brief Read from the current position
+ * @param read Bytes read, less than len at the end of the file
+ * @return Fat_Status_t Status code
+ */
+extern Fat_Status_t Fat_Read(Fat_File_t *file, void *buf, uint32_t len, uint32_t *read);
+
+/**
+ * @brief Set the read position, clamped to the file size
+ */
+extern Fat_Status_t Fat_Seek(Fat_File_t *file, uint32_t pos);
+
+/**
+ * @brief Card sectors behind a file position
+ * @param pos File position, rounded down to its sector
+ * @param sector First card sector
+ * @param count Consecutive sectors from there, up to the end of the extent or of the file
+ * @return FAT_INVALID_PARAM at or past the end of the file
+ */
+extern Fat_Status_t Fat_GetRun(Fat_File_t *file, uint32_t pos, uint32_t *sector, uint32_t *count);
+
+/**
+ * @brief true if the whole file is one extent
+ */
+extern bool Fat_IsContiguous(const Fat_File_t *file);
+
+/**
+ * @brief Next directory entry of an open directory
+ * @return FAT_NOT_FOUND after the last entry
+ */
+extern Fat_Status_t Fat_ReadDir(Fat_File_t *dir, Fat_Info_t *info);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,129 @@
+#ifndef FONT_H
+#define FONT_H
+
+/**
+ * @file Font.h
+ * @brief Anti-aliased bitmap fonts drawn straight into Render strips.
+ *
+ * @note
+ *   - Fonts are generated from TTF files by Tools/fontgen/fontgen.py as 2 or 4 bits per pixel
+ *     glyphs cropped to their ink box, stored in flash.
+ *   - Font_DrawText() paints glyphs blended onto a solid background. Glyphs are kept in an LRU
+ *     cache already converted to RGB565 for the current fg/bg pair, so repeated text is a copy.
+ *   - Font_DrawTextBlend() blends over whatever the strip already holds (subtitles over video);
+ *     it is not cached.
+ *   - Text is UTF-8; code points outside the font are drawn with the font's fallback glyph.
+ */
+
+#include "stdint.h"
+#include "LCD.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+// Cached glyphs
+#ifndef FONT_CACHE_SLOTS
+#define FONT_CACHE_SLOTS (32)
+#endif
+
+// Pixels per cache slot; larger glyphs are drawn uncached
+#ifndef FONT_CACHE_SLOT_PIXELS
+#define FONT_CACHE_SLOT_PIXELS (192)
+#endif
+
+// Widest glyph Font_DrawTextBlend() handles, wider ones are clipped
+#ifndef FONT_MAX_GLYPH_WIDTH
+#define FONT_MAX_GLYPH_WIDTH (64)
+#endif
+
+/**
+ * @brief Glyph descriptor
+ */
+typedef struct
+{
+    uint16_t Codepoint; /**< Unicode code point */
+    uint8_t Width;      /**< Ink box width in pixels */
+    uint8_t Height;     /**< Ink box height in pixels */
+    int8_t OffsetX;     /**< Ink box left edge, relative to the pen position */
+    int8_t OffsetY;     /**< Ink box top edge, relative to the top of the line */
+    uint8_t Advance;    /**< Pen advance in pixels */
+    uint32_t Offset;    /**< First byte in Font_t.Bitmap */
+} Font_Glyph_t;
+
+/**
+ * @brief Font descriptor
+ */
+typedef struct
+{
+    const Font_Glyph_t *Glyphs; /**< Sorted by code point */
+    const uint8_t *Bitmap;      /**< Packed coverage levels, MSB first */
+    uint16_t GlyphNum;
+    uint8_t Bpp;        /**< 2 or 4 */
+    uint8_t LineHeight; /**< Ascent + descent */
+    uint8_t Baseline;   /**< Ascent */
+    uint16_t Fallback;  /**< Code point drawn for missing glyphs */
+} Font_t;
+
+/**
+ * @brief Look up a glyph
+ * @param font Font
+ * @param codepoint Unicode code point
+ * @return Glyph, or the fallback glyph if the font lacks the code point
+ */
+extern const Font_Glyph_t *Font_FindGlyph(const Font_t *font, uint32_t codepoint);
+
+/**
+ * @brief Measure a string
+ * @return Sum of the glyph advances in pixels
+ */
+extern uint16_t Font_TextWidth(const Font_t *font, const char *text);
+
+/**
+ * @brief Count how much of a string fits into a width
+ * @return Bytes of text, always ending on a whole UTF-8 sequence
+ */
+extern uint16_t Font_TextFit(const Font_t *font, const char *text, uint16_t width);
+
+/**
+ * @brief Draw text blended onto a solid background color
+ * @details Only glyph ink inside the strip is touched, the background must already be bg
+ *          (the caller fills the line first).
+ * @param strip Strip buffer from the Render draw callback
+ * @param area Area being rendered
+ * @param y First strip row, relative to area->y
+ * @param lines Rows in the strip
+ * @param x Pen position in screen pixels
+ * @param top Top of the text line in screen pixels
+ * @param font Font
+ * @param text UTF-8 string
+ * @param fg Text color
+ * @param bg Background color
+ * @return Pen position after the text
+ */
+extern int16_t Font_DrawText(uint16_t *strip, const LCD_Rect_t *area, uint16_t y, uint16_t lines,
+                             int16_t x, int16_t top, const Font_t *font, const char *text, uint16_t fg, uint16_t bg);
+
+/**
+ * @brief Draw text blended over the current strip content
+ * @return Pen position after the text
+ */
+extern int16_t Font_DrawTextBlend(uint16_t *strip, const LCD_Rect_t *area, uint16_t y, uint16_t lines,
+                                  int16_t x, int16_t top, const Font_t *font, const char *text, uint16_t fg);
+
+/**
+ * @brief Drop all cached glyphs
+ */
+extern void Font_CacheClear(void);
+
+/**
+ * @brief Get cache hit and miss counters
+ */
+extern void Font_CacheStats(uint32_t *hits, uint32_t *misses);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,19 @@
+#ifndef FONT_SANS14_H
+#define FONT_SANS14_H
+
+// Generated by Tools/fontgen/fontgen.py from DejaVuSans.ttf, 14 px, 4 bpp, 95 glyphs, 5066 bytes
+
+#include "Font.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+extern const Font_t Font_Sans14;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,180 @@
+#ifndef LCD_H
+#define LCD_H
+
+/**
+ * @file LCD.h
+ * @brief ST7789 panel driver on SPI1.
+ *
+ * @note
+ *   - Commands go out as 8-bit frames, pixel data as 16-bit frames with half-word DMA,
+ *     so RGB565 buffers are sent straight from memory without byte swapping.
+ *   - LCD_Flush() only starts the transfer. When the last pixel has left the SPI the
+ *     MicroOS event LCD_EVENT_FLUSH_DONE is triggered; register it with MicroOS_RegisterEvent().
+ *   - HAL_SPI_TxCpltCallback() must forward SPI1 completions to LCD_TxCpltCallback().
+ *   - SCK is set in LCD_Init() to the fastest rate not above LCD_SPI_MAX_HZ for the current PCLK2.
+ *   - LCD_SetScrollArea()/LCD_SetScroll() drive the panel's vertical scrolling, so a list can
+ *     move by rewriting only the rows it exposes. Assumes the default refresh order (MADCTL ML = 0).
+ */
+
+#include "stdint.h"
+#include "stdbool.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+// Panel geometry (after LCD_MADCTL is applied)
+#ifndef LCD_WIDTH
+#define LCD_WIDTH (240)
+#endif
+#ifndef LCD_HEIGHT
+#define LCD_HEIGHT (240)
+#endif
+
+// Offset of the visible area inside the controller RAM (240x240 glass on a 240x320 controller etc.)
+#ifndef LCD_X_OFFSET
+#define LCD_X_OFFSET (0)
+#endif
+#ifndef LCD_Y_OFFSET
+#define LCD_Y_OFFSET (0)
+#endif
+
+// Memory access control: MY MX MV ML RGB MH - -
+#ifndef LCD_MADCTL
+#define LCD_MADCTL (0x00)
+#endif
+
+// Highest SCK the panel is run at; ST7789 write cycle is 16 ns minimum
+#ifndef LCD_SPI_MAX_HZ
+#define LCD_SPI_MAX_HZ (40000000UL)
+#endif
+
+// MicroOS event triggered when a flush has completed
+#ifndef LCD_EVENT_FLUSH_DONE
+#define LCD_EVENT_FLUSH_DONE (0)
+#endif
+
+// Rows of panel frame memory (ST7789: 320, also on 240x240 panels)
+#ifndef LCD_MEMORY_HEIGHT
+#define LCD_MEMORY_HEIGHT (320)
+#endif
+
+// RGB888 -> RGB565
+#define LCD_RGB565(r, g, b) ((uint16_t)((((r) & 0xF8) << 8) | (((g) & 0xFC) << 3) | ((b) >> 3)))
+
+/**
+ * @brief LCD status codes
+ */
+typedef enum
+{
+    LCD_OK = 0,        /**< Operation successful */
+    LCD_ERROR,         /**< SPI or DMA error */
+    LCD_BUSY,          /**< A flush is still in progress */
+    LCD_TIMEOUT,       /**< Timeout occurred */
+    LCD_INVALID_PARAM, /**< Invalid parameter */
+} LCD_Status_t;
+
+/**
+ * @brief Screen rectangle in pixels
+ */
+typedef struct
+{
+    uint16_t x;
+    uint16_t y;
+    uint16_t w;
+    uint16_t h;
+} LCD_Rect_t;
+
+/**
+ * @brief Reset and initialize the panel, clear it to black and turn the backlight on
+ * @note Blocking, takes about 250 ms
+ * @return LCD_Status_t Status code
+ */
+extern LCD_Status_t LCD_Init(void);
+
+/**
+ * @brief Start sending an RGB565 buffer to a rectangle of the screen
+ * @details buf holds rect->w * rect->h pixels, row by row, and must stay untouched
+ *          until LCD_EVENT_FLUSH_DONE is triggered or LCD_IsBusy() returns false.
+ * @param rect Target rectangle, must lie inside the screen
+ * @param buf Pixel data, half-word aligned
+ * @return LCD_Status_t LCD_BUSY if the previous flush has not completed yet
+ */
+extern LCD_Status_t LCD_Flush(const LCD_Rect_t *rect, const uint16_t *buf);
+
+/**
+ * @brief Fill a rectangle with one color (blocking, uses DMA without memory increment)
+ * @param rect Target rectangle, NULL for the whole screen
+ * @param color RGB565 color
+ * @return LCD_Status_t Status code
+ */
+extern LCD_Status_t LCD_Fill(const LCD_Rect_t *rect, uint16_t color);
+
+/**
+ * @brief Check whether a flush is in progress
+ * @return true while DMA is still sending pixels
+ */
+extern bool LCD_IsBusy(void);
+
+/**
+ * @brief Result of the last flush
+ * @details Stays valid until the next LCD_Flush() or LCD_Fill() starts.
+ * @return LCD_Status_t LCD_BUSY while it runs, LCD_ERROR if SPI or DMA failed, LCD_OK otherwise
+ */
+extern LCD_Status_t LCD_GetResult(void);
+
+/**
+ * @brief Wait until the running flush has completed
+ * @param timeout_ms Timeout in milliseconds
+ * @return LCD_Status_t LCD_OK, LCD_TIMEOUT or LCD_ERROR
+ */
+extern LCD_Status_t LCD_WaitIdle(uint32_t timeout_ms);
+
+/**
+ * @brief Enable or disable the tearing effect output (LCD_TE pin, pulses once per V-blank)
+ * @param on true to enable
+ * @return LCD_Status_t LCD_BUSY if a flush is in progress
+ */
+extern LCD_Status_t LCD_SetTearing(bool on);
+
+/**
+ * @brief Define the hardware vertical scroll area (VSCRDEF) and reset its offset to 0
+ * @details Rows inside the area are shown as a ring starting at the scroll offset. Flushes keep
+ *          using screen coordinates; the driver maps them to frame memory and splits rectangles
+ *          that cross the ring end into two windows.
+ * @param top First screen row of the area
+ * @param height Rows in the area, 0 turns scrolling off
+ * @return LCD_Status_t LCD_BUSY if a flush is in progress
+ */
+extern LCD_Status_t LCD_SetScrollArea(uint16_t top, uint16_t height);
+
+/**
+ * @brief Set the scroll offset (VSCSAD)
+ * @details After moving the offset by n rows only the n newly exposed rows need to be sent.
+ * @param offset Area row to show at the top of the area, below the area height
+ * @return LCD_Status_t LCD_INVALID_PARAM if no scroll area is set
+ */
+extern LCD_Status_t LCD_SetScroll(uint16_t offset);
+
+/**
+ * @brief Switch the backlight
+ * @param on true to turn the backlight on
+ */
+extern void LCD_SetBacklight(bool on);
+
+/**
+ * @brief SPI1 transfer complete hook, call from HAL_SPI_TxCpltCallback()
+ */
+extern void LCD_TxCpltCallback(void);
+
+/**
+ * @brief SPI1 error hook, call from HAL_SPI_ErrorCallback()
+ */
+extern void LCD_ErrorCallback(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,57 @@
+#ifndef LZ4_H
+#define LZ4_H
+
+/**
+ * @file Lz4.h
+ * @brief LZ4 block decompressor for compressed chunks and assets.
+ *
+ * @note
+ *   - Decodes the plain LZ4 block format (no frame header, no checksum), as written by
+ *     LZ4_compress_default()/LZ4_compress_HC() of the reference library or by Tools/ntv.
+ *   - Safe against any input: every length and offset is checked against both buffers, a
+ *     corrupt block returns LZ4_FORMAT and never reads or writes outside them. No heap, no tables.
+ *   - Cortex-M4 tuning: literals and matches move as 32-bit words with unaligned LDR/STR (allowed
+ *     on the M4 for single words), short literal runs are one fixed 16-byte copy, offset 1 is a
+ *     memset and offset 2 (one repeated RGB565 pixel, flat picture areas) a word fill. The word
+ *     paths may write up to 15 bytes beyond the current position, but only while that is still
+ *     inside the output buffer; near its end the decoder falls back to bytes.
+ *   - Lz4_Decompress_Ref() is the plain byte-by-byte reference with the same checks and results.
+ */
+
+#include "stdint.h"
+#include "stdbool.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/**
+ * @brief Lz4 status codes
+ */
+typedef enum
+{
+    LZ4_OK = 0,        /**< Block decoded */
+    LZ4_FORMAT,        /**< Corrupt block */
+    LZ4_OVERFLOW,      /**< Output does not fit the buffer */
+    LZ4_INVALID_PARAM, /**< Invalid parameter */
+} Lz4_Status_t;
+
+/**
+ * @brief Decompress one LZ4 block
+ * @param src Compressed block
+ * @param size Its bytes
+ * @param dst Output buffer
+ * @param capacity Output buffer bytes
+ * @param written Bytes decoded, may be NULL
+ * @return Lz4_Status_t
+ */
+extern Lz4_Status_t Lz4_Decompress(const uint8_t *src, uint32_t size, uint8_t *dst, uint32_t capacity, uint32_t *written);
+
+extern Lz4_Status_t Lz4_Decompress_Ref(const uint8_t *src, uint32_t size, uint8_t *dst, uint32_t capacity, uint32_t *written);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
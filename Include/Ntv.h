@@ -0,0 +1,211 @@
+#ifndef NTV_H
+#define NTV_H
+
+/**
+ * @file Ntv.h
+ * @brief Demuxer for the NanoTV media container (.ntv).
+ *
+ * @note
+ *   - Layout, all fields little-endian:
+ *       sector 0          Ntv_Header_t
+ *       DataSector..      chunks, each a Ntv_Chunk_t followed by its payload, padded to whole sectors
+ *       IndexSector..     Ntv_IndexEntry_t[IndexEntries], one per IndexPeriodMs
+ *   - Video and audio chunks are interleaved in time order; the audio of a frame comes right before
+ *     its video. A video frame is split into slices of whole lines (Line, Lines) so that every chunk
+ *     fits the buffer; NTV_CHUNK_FRAME_END marks the last slice.
+ *   - Every chunk header carries the size of the next chunk, so each chunk is fetched with exactly
+ *     one sector-aligned multi-block read into the buffer (more only if the file is fragmented
+ *     there) and handed out in place: demuxing is a header look-up, nothing is copied or parsed.
+ *   - Seeking is O(1): entry ms / IndexPeriodMs of the index points at the first chunk of the last
+ *     key frame at or before that time. The entry is read through BlockCache.
+ *   - A chunk flagged NTV_CHUNK_LZ4 is unpacked by Ntv_GetChunk() into its own buffer (NTV_LZ4_BUFFER)
+ *     and handed out like any other, with the unpacked Size; the codecs never see the difference.
+ *     Unpacking runs in the caller, once per chunk, at what Lz4_Decompress() takes.
+ *   - Reads run in the background from Ntv_Task() (1 ms MicroOS task), which also polls for their
+ *     completion: BLOCKDEV_EVENT_DONE stays with Prefetch. Tools/ntv writes the files.
+ */
+
+#include "stdint.h"
+#include "stdbool.h"
+#include "Fat.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+// Chunk buffer in sectors (512 bytes each), bounds the largest chunk
+#ifndef NTV_BUFFER_SECTORS
+#define NTV_BUFFER_SECTORS (64)
+#endif
+
+// Most chunks buffered at once
+#ifndef NTV_QUEUE
+#define NTV_QUEUE (16)
+#endif
+
+// Unpack buffer in bytes for LZ4 chunks, 0 leaves LZ4 out; NTV_BUFFER_SECTORS * NTV_SECTOR_SIZE takes any chunk
+#ifndef NTV_LZ4_BUFFER
+#define NTV_LZ4_BUFFER (0)
+#endif
+
+#define NTV_MAGIC (0x3156544EUL) // "NTV1"
+#define NTV_VERSION (1)
+#define NTV_SECTOR_SIZE (512)
+
+// Video codecs (Ntv_Header_t.Codec)
+#define NTV_CODEC_RAW565 (0) // Slice payload: Lines * Width RGB565 pixels
+#define NTV_CODEC_TILE (1)   // Slice payload: changed 8x8 tiles, see TileDelta.h; Lines 0 for a frame without changes
+#define NTV_CODEC_PAL8 (2)   // Slice payload: palette, then one index byte per pixel, see Palette.h
+#define NTV_CODEC_PAL4 (3)   // Slice payload: palette, then two indices per byte, see Palette.h
+
+// Chunk types
+#define NTV_CHUNK_VIDEO (1)
+#define NTV_CHUNK_AUDIO (2) // Payload: interleaved signed PCM samples
+
+// Chunk flags
+#define NTV_CHUNK_KEY (0x01)       // Video: decodes without the previous frame
+#define NTV_CHUNK_FRAME_END (0x02) // Video: last slice of the frame
+#define NTV_CHUNK_LZ4 (0x04)       // Payload: uint32 unpacked size, then an LZ4 block of the payload
+
+/**
+ * @brief File header, sector 0
+ */
+typedef struct
+{
+    uint32_t Magic;         /**< NTV_MAGIC */
+    uint16_t Version;       /**< NTV_VERSION */
+    uint16_t HeaderSize;    /**< sizeof(Ntv_Header_t) when written */
+    uint16_t Width;
+    uint16_t Height;
+    uint8_t Codec;          /**< NTV_CODEC_xxx */
+    uint8_t CodecFlags;
+    uint16_t Reserved0;
+    uint32_t FrameUs;       /**< Frame period */
+    uint32_t Frames;
+    uint32_t AudioRate;     /**< Sample rate, 0 without audio */
+    uint8_t AudioChannels;
+    uint8_t AudioBits;
+    uint16_t Reserved1;
+    uint32_t AudioSamples;  /**< Sample frames in the file */
+    uint32_t DurationMs;
+    uint32_t DataSector;    /**< First chunk */
+    uint16_t FirstSectors;  /**< Its size */
+    uint16_t MaxSectors;    /**< Largest chunk */
+    uint32_t IndexSector;
+    uint32_t IndexEntries;
+    uint32_t IndexPeriodMs;
+} Ntv_Header_t;
+
+/**
+ * @brief Chunk header, at the start of every chunk
+ */
+typedef struct
+{
+    uint8_t Type;         /**< NTV_CHUNK_VIDEO or NTV_CHUNK_AUDIO */
+    uint8_t Flags;        /**< NTV_CHUNK_xxx */
+    uint16_t Sectors;     /**< This chunk, header and padding included */
+    uint16_t NextSectors; /**< The chunk after it, 0 for the last one */
+    uint16_t Reserved;
+    uint32_t Size;        /**< Payload bytes */
+    uint32_t Pts;         /**< Presentation time (ms) */
+    uint16_t Line;        /**< Video: first line of the slice */
+    uint16_t Lines;       /**< Video: lines in the slice */
+    uint32_t Index;       /**< Video: frame number; audio: first sample frame */
+} Ntv_Chunk_t;
+
+/**
+ * @brief Seek index entry
+ */
+typedef struct
+{
+    uint32_t Sector;  /**< First chunk to read, from the start of the file */
+    uint16_t Sectors; /**< Its size */
+    uint16_t Reserved;
+} Ntv_IndexEntry_t;
+
+/**
+ * @brief Ntv status codes
+ */
+typedef enum
+{
+    NTV_OK = 0,        /**< Operation successful */
+    NTV_ERROR,         /**< Card or file system error */
+    NTV_UNDERRUN,      /**< Next chunk not read yet */
+    NTV_END,           /**< No more chunks */
+    NTV_FORMAT,        /**< Not an .ntv file, or chunks too large for the buffer */
+    NTV_INVALID_PARAM, /**< Invalid parameter, or no file open */
+} Ntv_Status_t;
+
+/**
+ * @brief Demuxer statistics
+ */
+typedef struct
+{
+    uint32_t Chunks;    /**< Chunks read */
+    uint32_t Reads;     /**< Card reads for them */
+    uint32_t Sectors;
+    uint32_t Errors;    /**< Card reads failed (retried) */
+    uint32_t Underruns; /**< Ntv_GetChunk() calls that found nothing */
+    uint32_t Unpacked;  /**< LZ4 chunks unpacked */
+    uint32_t LatencyMaxMs;
+    uint8_t Queued;     /**< Chunks buffered now */
+} Ntv_Stats_t;
+
+/**
+ * @brief Check the header and start reading at the first chunk
+ * @param file Open file, must stay valid until Ntv_Close()
+ * @return NTV_FORMAT if this is no .ntv file or its chunks exceed NTV_BUFFER_SECTORS
+ */
+extern Ntv_Status_t Ntv_Open(Fat_File_t *file);
+
+/**
+ * @brief Stop reading and drop the buffered chunks
+ */
+extern void Ntv_Close(void);
+
+/**
+ * @brief Header of the open file, NULL if none
+ */
+extern const Ntv_Header_t *Ntv_GetHeader(void);
+
+/**
+ * @brief Continue at the key frame at or before ms
+ * @details Blocks for the index entry (one sector, cached), then reading continues in the background.
+ */
+extern Ntv_Status_t Ntv_Seek(uint32_t ms);
+
+/**
+ * @brief Oldest buffered chunk, in place
+ * @param chunk Set to the chunk header
+ * @param payload Set to the payload, 4-byte aligned
+ * @return NTV_UNDERRUN if it is not read yet, NTV_END after the last chunk, NTV_FORMAT for an LZ4 chunk
+ *         that cannot be unpacked (release it to skip it)
+ */
+extern Ntv_Status_t Ntv_GetChunk(const Ntv_Chunk_t **chunk, const uint8_t **payload);
+
+/**
+ * @brief Give the chunk from Ntv_GetChunk() back to the buffer
+ */
+extern Ntv_Status_t Ntv_Release(void);
+
+/**
+ * @brief Copy the statistics
+ */
+extern void Ntv_GetStats(Ntv_Stats_t *stats);
+
+/**
+ * @brief Reset the statistics
+ */
+extern void Ntv_ResetStats(void);
+
+/**
+ * @brief Finish and issue chunk reads; 1 ms MicroOS task
+ */
+extern void Ntv_Task(void *data);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,107 @@
+#ifndef PALETTE_H
+#define PALETTE_H
+
+/**
+ * @file Palette.h
+ * @brief Decoder for palette-indexed video (NTV_CODEC_PAL8, NTV_CODEC_PAL4): indices are expanded to RGB565 straight into the Render strips.
+ *
+ * @note
+ *   - A slice covers full panel lines. Its payload starts with uint16 Colors and uint16 Reserved;
+ *     Colors RGB565 entries follow when a new palette starts with this slice (0: keep the current
+ *     one), padded to 4 bytes, then Lines * LCD_WIDTH indices: one byte per pixel (PAL8) or two
+ *     pixels per byte with the first in the low nibble (PAL4).
+ *   - The palette lives here across slices and frames, so a palette per scene costs nothing per
+ *     frame. Key frames always bring one.
+ *   - Expansion is word at a time: PAL8 reads four indices per load and stores two pixels per
+ *     word; PAL4 looks each index byte up in a 256-entry table of ready pixel pairs built when
+ *     the palette is loaded, eight pixels per load. Palette_Expand8_Ref()/Palette_Expand4_Ref()
+ *     are the plain per-pixel references and give the same result bit for bit.
+ *   - An indexed line is a half (PAL8) or a quarter (PAL4) of a raw565 line, on the card and in
+ *     the Ntv buffer. Palette_Start()/Palette_Process() mirror Dirty_Start()/Dirty_Process().
+ */
+
+#include "stdint.h"
+#include "stdbool.h"
+#include "LCD.h"
+#include "Render.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#define PALETTE_COLORS_MAX (256)
+
+/**
+ * @brief Palette statistics
+ */
+typedef struct
+{
+    uint32_t Slices;
+    uint32_t Palettes; /**< Palettes loaded */
+    uint32_t Errors;   /**< Slices rejected as corrupt or without a palette */
+} Palette_Stats_t;
+
+/**
+ * @brief Check a slice, load its palette if it has one and start sending it
+ * @param data Slice payload, 4-byte aligned
+ * @param size Payload bytes
+ * @param line First screen line
+ * @param lines Lines in the slice
+ * @param bits Bits per index: 8 (NTV_CODEC_PAL8) or 4 (NTV_CODEC_PAL4)
+ * @return Render_Status_t RENDER_BUSY if a slice is still being sent, RENDER_ERROR if it is corrupt
+ */
+extern Render_Status_t Palette_Start(const uint8_t *data, uint32_t size, uint16_t line, uint16_t lines, uint8_t bits);
+
+/**
+ * @brief Advance the running slice, never blocks
+ * @return Render_Status_t RENDER_BUSY while the slice is being sent, RENDER_OK when done
+ */
+extern Render_Status_t Palette_Process(void);
+
+/**
+ * @brief Send a slice and wait until done
+ */
+extern Render_Status_t Palette_Draw(const uint8_t *data, uint32_t size, uint16_t line, uint16_t lines, uint8_t bits);
+
+/**
+ * @brief Expand 8-bit indices
+ * @param dst RGB565 pixels, 4-byte aligned
+ * @param src Indices, 4-byte aligned
+ * @param palette 256 RGB565 colours
+ * @param pixels Pixel count
+ */
+extern void Palette_Expand8(uint16_t *dst, const uint8_t *src, const uint16_t *palette, uint32_t pixels);
+
+/**
+ * @brief Expand 4-bit indices, two per byte, first pixel in the low nibble
+ * @param pairs 256 pixel pairs from Palette_MakePairs()
+ * @param pixels Pixel count; when odd, the last byte only gives its low nibble
+ */
+extern void Palette_Expand4(uint16_t *dst, const uint8_t *src, const uint32_t *pairs, uint32_t pixels);
+
+/**
+ * @brief Build the PAL4 pair table: pairs[b] holds the pixels of index byte b
+ * @param palette 16 RGB565 colours
+ */
+extern void Palette_MakePairs(uint32_t *pairs, const uint16_t *palette);
+
+// Plain C references, one pixel at a time (Tools/pixelcheck/palettecheck.c holds the fast ones to them)
+extern void Palette_Expand8_Ref(uint16_t *dst, const uint8_t *src, const uint16_t *palette, uint32_t pixels);
+extern void Palette_Expand4_Ref(uint16_t *dst, const uint8_t *src, const uint16_t *palette, uint32_t pixels);
+
+/**
+ * @brief Copy the statistics
+ */
+extern void Palette_GetStats(Palette_Stats_t *stats);
+
+/**
+ * @brief Reset the statistics
+ */
+extern void Palette_ResetStats(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,158 @@
+#ifndef PREFETCH_H
+#define PREFETCH_H
+
+/**
+ * @file Prefetch.h
+ * @brief Read-ahead of the active media stream into a ring of sector buffers.
+ *
+ * @note
+ *   - Prefetch_Start() binds an open file; from then on the card is read in the background with
+ *     multi-block DMA reads (one per extent, at most PREFETCH_MAX_BURST sectors each) straight into
+ *     the ring. The next read is issued from the BLOCKDEV_EVENT_DONE event of the previous one, so
+ *     the card is kept busy without polling.
+ *   - The decoder only reads from RAM: Prefetch_Read()/Prefetch_Peek() never touch the card and
+ *     report PREFETCH_UNDERRUN when the data is not there yet.
+ *   - The window depth (sectors kept ahead of the read position) follows the measured stream rate
+ *     and card latency: it always covers PREFETCH_SPIKE_MS of playback, or twice the worst recent
+ *     read if that is longer, plus one burst. The worst read decays slowly, so one long busy
+ *     period keeps the window deep for a few seconds. Until a rate is known the whole ring is used.
+ *   - Prefetch_Init() registers the BLOCKDEV_EVENT_DONE handler; Prefetch_Task() must run as a 1 ms
+ *     MicroOS task. Other card users (BlockCache) wait for a prefetch read still in flight.
+ */
+
+#include "stdint.h"
+#include "stdbool.h"
+#include "Fat.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+// Ring size in sectors (512 bytes each)
+#ifndef PREFETCH_SECTORS
+#define PREFETCH_SECTORS (64)
+#endif
+
+// Most sectors per card read, bounds how long other card users wait; reading starts again once a
+// whole burst fits below the window depth
+#ifndef PREFETCH_MAX_BURST
+#define PREFETCH_MAX_BURST (16)
+#endif
+
+// Card stall the window always covers at the measured stream rate (ms), by default the longest a
+// read may take before the SD driver gives up on it (SD_READ_TIMEOUT)
+#ifndef PREFETCH_SPIKE_MS
+#define PREFETCH_SPIKE_MS (200)
+#endif
+
+// Stream rate measuring period (ms)
+#ifndef PREFETCH_RATE_PERIOD
+#define PREFETCH_RATE_PERIOD (250)
+#endif
+
+/**
+ * @brief Prefetch status codes
+ */
+typedef enum
+{
+    PREFETCH_OK = 0,        /**< Operation successful */
+    PREFETCH_ERROR,         /**< Card or file system error */
+    PREFETCH_UNDERRUN,      /**< Data not buffered yet */
+    PREFETCH_END,           /**< End of the stream */
+    PREFETCH_INVALID_PARAM, /**< Invalid parameter, or no stream */
+} Prefetch_Status_t;
+
+/**
+ * @brief Prefetch statistics
+ */
+typedef struct
+{
+    uint32_t Reads;        /**< Card reads finished */
+    uint32_t Sectors;      /**< Sectors read */
+    uint32_t Errors;       /**< Card reads failed (retried) */
+    uint32_t Underruns;    /**< Reads from the ring that found too little data */
+    uint32_t LatencyMs;    /**< Issue to completion, last read */
+    uint32_t LatencyMaxMs; /**< Issue to completion, worst case */
+    uint32_t PeakMs;       /**< Decaying worst read, drives the depth */
+    uint32_t Rate;         /**< Stream rate, bytes per second */
+    uint16_t Depth;        /**< Current window depth in sectors */
+    uint16_t Ahead;        /**< Sectors buffered ahead of the read position */
+} Prefetch_Stats_t;
+
+/**
+ * @brief Register the BLOCKDEV_EVENT_DONE handler
+ * @note Call after MicroOS_Init()
+ * @return Prefetch_Status_t Status code
+ */
+extern Prefetch_Status_t Prefetch_Init(void);
+
+/**
+ * @brief Start reading ahead in a file
+ * @param file Open file, must stay valid until Prefetch_Stop()
+ * @param pos Start position
+ * @return Prefetch_Status_t Status code
+ */
+extern Prefetch_Status_t Prefetch_Start(Fat_File_t *file, uint32_t pos);
+
+/**
+ * @brief Stop reading ahead and drop the ring
+ */
+extern void Prefetch_Stop(void);
+
+/**
+ * @brief Move the read position
+ * @details Inside the buffered data this only skips; anywhere else the ring is refilled from pos.
+ */
+extern Prefetch_Status_t Prefetch_Seek(uint32_t pos);
+
+/**
+ * @brief Current read position in the file
+ */
+extern uint32_t Prefetch_Tell(void);
+
+/**
+ * @brief Bytes that can be read without waiting for the card
+ */
+extern uint32_t Prefetch_Available(void);
+
+/**
+ * @brief Copy buffered data
+ * @param read Bytes copied; on PREFETCH_UNDERRUN and PREFETCH_END what was there
+ * @return PREFETCH_UNDERRUN if fewer than len bytes are buffered, PREFETCH_END at the end of the file
+ */
+extern Prefetch_Status_t Prefetch_Read(void *buf, uint32_t len, uint32_t *read);
+
+/**
+ * @brief Buffered data at the read position without copying
+ * @param data Set to the data in the ring
+ * @param len Contiguous bytes there, up to the ring wrap
+ * @return PREFETCH_UNDERRUN when nothing is buffered, PREFETCH_END at the end of the file
+ */
+extern Prefetch_Status_t Prefetch_Peek(const uint8_t **data, uint32_t *len);
+
+/**
+ * @brief Advance the read position over data returned by Prefetch_Peek()
+ */
+extern Prefetch_Status_t Prefetch_Consume(uint32_t len);
+
+/**
+ * @brief Copy the statistics
+ */
+extern void Prefetch_GetStats(Prefetch_Stats_t *stats);
+
+/**
+ * @brief Reset the statistics
+ */
+extern void Prefetch_ResetStats(void);
+
+/**
+ * @brief Issue reads, measure the stream rate; 1 ms MicroOS task
+ */
+extern void Prefetch_Task(void *data);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,135 @@
+#ifndef PRESENT_H
+#define PRESENT_H
+
+/**
+ * @file Present.h
+ * @brief Frame presenter: starts each frame transfer right after the panel V-blank.
+ *
+ * @note
+ *   - The panel TE output on LCD_TE (PB11, EXTI15_10) marks the start of V-blank.
+ *     HAL_GPIO_EXTI_Callback() must forward it to Present_TeCallback().
+ *   - Without TE edges for PRESENT_TE_TIMEOUT ms the presenter falls back to a
+ *     PRESENT_PANEL_PERIOD ms timer and switches back as soon as TE shows up again.
+ *   - A submitted frame starts on the first V-blank no earlier than half a period before
+ *     its due time. The write then trails the scan line, which is tear-free as long as
+ *     the transfer finishes within one panel period (compare Present_Stats_t.TransferUs).
+ *   - Present_Task() must run as a 1 ms MicroOS task; it pumps the renderer and the fallback timer.
+ */
+
+#include "stdint.h"
+#include "stdbool.h"
+#include "LCD.h"
+#include "Render.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+// Panel refresh period in ms (ST7789 default 60 Hz)
+#ifndef PRESENT_PANEL_PERIOD
+#define PRESENT_PANEL_PERIOD (17)
+#endif
+
+// Switch to the timer when no TE edge is seen for this long (ms)
+#ifndef PRESENT_TE_TIMEOUT
+#define PRESENT_TE_TIMEOUT (100)
+#endif
+
+// MicroOS event triggered by every (real or timed) V-blank
+#ifndef PRESENT_EVENT_VSYNC
+#define PRESENT_EVENT_VSYNC (2)
+#endif
+
+/**
+ * @brief Present status codes
+ */
+typedef enum
+{
+    PRESENT_OK = 0,        /**< Operation successful */
+    PRESENT_ERROR,         /**< LCD or render error */
+    PRESENT_BUSY,          /**< Frame in progress */
+    PRESENT_INVALID_PARAM, /**< Invalid parameter */
+} Present_Status_t;
+
+/**
+ * @brief V-blank source
+ */
+typedef enum
+{
+    PRESENT_MODE_TE = 0, /**< Panel TE pin */
+    PRESENT_MODE_TIMER,  /**< Free-running timer, no TE edges */
+} Present_Mode_t;
+
+/**
+ * @brief Presentation statistics
+ */
+typedef struct
+{
+    uint32_t Vsyncs;       /**< V-blanks seen (TE or timer) */
+    uint32_t Presented;    /**< Frames started */
+    uint32_t Late;         /**< Frames started more than one period after their due time */
+    uint32_t Dropped;      /**< Frames replaced by a newer one before they were started */
+    uint32_t LatencyUs;    /**< V-blank to transfer start, last frame */
+    uint32_t LatencyMaxUs; /**< V-blank to transfer start, worst case */
+    uint32_t TransferUs;   /**< Transfer start to last strip sent, last frame */
+    uint32_t TransferMaxUs;
+} Present_Stats_t;
+
+/**
+ * @brief Enable the panel TE output and register the V-blank event
+ * @note Call after LCD_Init() and MicroOS_Init()
+ * @return Present_Status_t Status code
+ */
+extern Present_Status_t Present_Init(void);
+
+/**
+ * @brief Queue a frame for presentation
+ * @details Replaces a queued frame that has not started yet (counted as dropped).
+ * @param area Screen area, NULL for the whole screen
+ * @param Draw Strip draw callback, see Render
+ * @param Userdata Pointer passed to the callback
+ * @param due_ms Presentation time in HAL_GetTick() milliseconds (the video timestamp)
+ * @return Present_Status_t Status code
+ */
+extern Present_Status_t Present_Submit(const LCD_Rect_t *area, Render_DrawFunction_t Draw, void *Userdata, uint32_t due_ms);
+
+/**
+ * @brief Check whether a frame is queued or being sent
+ * @return true while the presenter is not idle
+ */
+extern bool Present_IsBusy(void);
+
+/**
+ * @brief Get the current V-blank source
+ * @return Present_Mode_t Mode
+ */
+extern Present_Mode_t Present_GetMode(void);
+
+/**
+ * @brief Copy the statistics
+ * @param stats Destination
+ */
+extern void Present_GetStats(Present_Stats_t *stats);
+
+/**
+ * @brief Reset the statistics
+ */
+extern void Present_ResetStats(void);
+
+/**
+ * @brief Presenter task, add with MicroOS_AddTask() at a 1 ms period
+ * @param data Unused
+ */
+extern void Present_Task(void *data);
+
+/**
+ * @brief TE edge hook, call from HAL_GPIO_EXTI_Callback() for LCD_TE_Pin
+ */
+extern void Present_TeCallback(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
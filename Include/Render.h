@@ -0,0 +1,106 @@
+#ifndef RENDER_H
+#define RENDER_H
+
+/**
+ * @file Render.h
+ * @brief Strip renderer: draws a screen area a few lines at a time into two small buffers.
+ *
+ * @note
+ *   - While SPI1 DMA sends one strip, the draw callback fills the other one, so drawing
+ *     or decoding overlaps the transfer and no full framebuffer is needed.
+ *   - RAM cost is 2 * RENDER_STRIP_LINES * LCD_WIDTH * 2 bytes (15 KB for 16 lines at 240 px).
+ *   - Strips always span the full width of the area; narrow areas get more lines per strip.
+ *   - Render_Process() never blocks; call it from a task or from the LCD_EVENT_FLUSH_DONE handler.
+ *     RENDER_EVENT_FRAME_DONE is triggered once the last strip has been sent.
+ */
+
+#include "stdint.h"
+#include "stdbool.h"
+#include "LCD.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+// Lines of a full-width strip
+#ifndef RENDER_STRIP_LINES
+#define RENDER_STRIP_LINES (16)
+#endif
+
+#define RENDER_STRIP_PIXELS (RENDER_STRIP_LINES * LCD_WIDTH)
+
+// Blocking Render_Frame() timeout in ms
+#ifndef RENDER_FRAME_TIMEOUT
+#define RENDER_FRAME_TIMEOUT (1000)
+#endif
+
+// MicroOS event triggered when a frame has been completely sent
+#ifndef RENDER_EVENT_FRAME_DONE
+#define RENDER_EVENT_FRAME_DONE (1)
+#endif
+
+/**
+ * @brief Render status codes
+ */
+typedef enum
+{
+    RENDER_OK = 0,        /**< Idle, the last frame is complete */
+    RENDER_ERROR,         /**< Draw callback or LCD transfer failed, frame aborted */
+    RENDER_BUSY,          /**< Frame in progress */
+    RENDER_TIMEOUT,       /**< Timeout occurred */
+    RENDER_INVALID_PARAM, /**< Invalid parameter */
+} Render_Status_t;
+
+/**
+ * @brief Strip draw callback
+ * @param strip Pixel buffer, lines * area width RGB565 pixels, row by row
+ * @param area Area being rendered
+ * @param y First row of the strip, relative to area->y
+ * @param lines Number of rows in the strip
+ * @param Userdata Pointer passed to Render_Start()
+ * @return false aborts the frame
+ */
+typedef bool (*Render_DrawFunction_t)(uint16_t *strip, const LCD_Rect_t *area, uint16_t y, uint16_t lines, void *Userdata);
+
+/**
+ * @brief Start rendering an area
+ * @param area Screen area, NULL for the whole screen
+ * @param Draw Strip draw callback
+ * @param Userdata Pointer passed to the callback
+ * @return Render_Status_t RENDER_BUSY if a frame or an LCD transfer is still running
+ */
+extern Render_Status_t Render_Start(const LCD_Rect_t *area, Render_DrawFunction_t Draw, void *Userdata);
+
+/**
+ * @brief Advance the running frame: retire sent strips, send drawn ones, draw free ones
+ * @return Render_Status_t RENDER_BUSY while the frame is in progress, RENDER_OK when done,
+ *         RENDER_ERROR if a draw callback or the transfer of a strip failed
+ */
+extern Render_Status_t Render_Process(void);
+
+/**
+ * @brief Render an area and wait until it has been sent
+ * @param area Screen area, NULL for the whole screen
+ * @param Draw Strip draw callback
+ * @param Userdata Pointer passed to the callback
+ * @return Render_Status_t Status code
+ */
+extern Render_Status_t Render_Frame(const LCD_Rect_t *area, Render_DrawFunction_t Draw, void *Userdata);
+
+/**
+ * @brief Stop the running frame; strips already handed to DMA are still sent
+ */
+extern void Render_Abort(void);
+
+/**
+ * @brief Check whether a frame is in progress
+ * @return true until the last strip of the frame has been sent
+ */
+extern bool Render_IsActive(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,150 @@
+#ifndef SD_H
+#define SD_H
+
+/**
+ * @file SD.h
+ * @brief SD/SDHC card driver in SPI mode on SPI3, 512-byte blocks with DMA.
+ *
+ * @note
+ *   - SD_Init() runs the card identification at SD_INIT_HZ and then raises SCK to the fastest
+ *     rate not above SD_SPI_MAX_HZ for the current PCLK1.
+ *   - SD_ReadBlocks()/SD_WriteBlocks() only start a transfer. Counts above one use CMD18/CMD25, so a
+ *     stream of blocks costs a single command. Each block is moved by DMA: for reads the TX channel
+ *     clocks 0xFF from a constant (memory increment off) while the RX channel fills the buffer.
+ *   - Between blocks the data token and the card busy state are polled for SD_TOKEN_POLL bytes in
+ *     the DMA interrupt; a longer wait is left to SD_Task(), so the CPU is never held up by the card.
+ *     When the transfer has ended the MicroOS event SD_EVENT_DONE is triggered.
+ *   - HAL_SPI_TxRxCpltCallback(), HAL_SPI_TxCpltCallback() and HAL_SPI_ErrorCallback() must forward
+ *     SPI3 to SD_TxRxCpltCallback(), SD_TxCpltCallback() and SD_ErrorCallback().
+ *   - Define SD_USE_CRC to have the card check command and data CRCs and to check the CRC16 of
+ *     every block read (costs about a table lookup per nibble).
+ */
+
+#include "stdint.h"
+#include "stdbool.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#define SD_BLOCK_SIZE (512)
+
+// SCK during card identification (spec: 100..400 kHz)
+#ifndef SD_INIT_HZ
+#define SD_INIT_HZ (400000UL)
+#endif
+
+// Highest SCK after identification
+#ifndef SD_SPI_MAX_HZ
+#define SD_SPI_MAX_HZ (25000000UL)
+#endif
+
+// Bytes polled for a data token or the end of busy before handing the wait to SD_Task()
+#ifndef SD_TOKEN_POLL
+#define SD_TOKEN_POLL (16)
+#endif
+
+// Longest wait for a read data token (ms), spec: 100 ms
+#ifndef SD_READ_TIMEOUT
+#define SD_READ_TIMEOUT (200)
+#endif
+
+// Longest busy time after a written block or a stop (ms), spec: 250 ms for SDHC
+#ifndef SD_WRITE_TIMEOUT
+#define SD_WRITE_TIMEOUT (500)
+#endif
+
+// Longest card initialization, ACMD41 loop (ms)
+#ifndef SD_INIT_TIMEOUT
+#define SD_INIT_TIMEOUT (1000)
+#endif
+
+// Level of SD_CD with a card in the slot
+#ifndef SD_CD_INSERTED
+#define SD_CD_INSERTED (GPIO_PIN_RESET)
+#endif
+
+// MicroOS event triggered when a transfer has ended
+#ifndef SD_EVENT_DONE
+#define SD_EVENT_DONE (4)
+#endif
+
+/**
+ * @brief SD status codes
+ */
+typedef enum
+{
+    SD_OK = 0,        /**< Operation successful */
+    SD_ERROR,         /**< Card rejected a command or data */
+    SD_BUSY,          /**< A transfer is still in progress */
+    SD_TIMEOUT,       /**< Card did not answer in time */
+    SD_INVALID_PARAM, /**< Invalid parameter */
+    SD_NO_CARD,       /**< No card in the slot, or not initialized */
+    SD_CRC_ERROR,     /**< Data CRC mismatch */
+} SD_Status_t;
+
+/**
+ * @brief Identify and initialize the card (blocking, up to SD_INIT_TIMEOUT)
+ * @return Status code
+ */
+extern SD_Status_t SD_Init(void);
+
+/**
+ * @brief Card detect switch
+ */
+extern bool SD_IsInserted(void);
+
+/**
+ * @brief Card size in blocks, 0 before SD_Init()
+ */
+extern uint32_t SD_GetSectorCount(void);
+
+/**
+ * @brief Start reading blocks
+ * @param sector First block
+ * @param buf Destination, count * SD_BLOCK_SIZE bytes, must stay valid until SD_EVENT_DONE
+ * @param count Number of blocks
+ * @return SD_OK if the card accepted the command; the transfer result comes from SD_GetResult()
+ */
+extern SD_Status_t SD_ReadBlocks(uint32_t sector, uint8_t *buf, uint32_t count);
+
+/**
+ * @brief Start writing blocks
+ * @param buf Source, count * SD_BLOCK_SIZE bytes, must stay valid until SD_EVENT_DONE
+ */
+extern SD_Status_t SD_WriteBlocks(uint32_t sector, const uint8_t *buf, uint32_t count);
+
+/**
+ * @brief Start writing consecutive blocks gathered from separate buffers (one CMD25)
+ * @param list One SD_BLOCK_SIZE buffer per block; list and buffers must stay valid until SD_EVENT_DONE
+ */
+extern SD_Status_t SD_WriteBlockList(uint32_t sector, const uint8_t *const *list, uint32_t count);
+
+extern bool SD_IsBusy(void);
+
+/**
+ * @brief Result of the last finished transfer
+ */
+extern SD_Status_t SD_GetResult(void);
+
+/**
+ * @brief Wait for the running transfer, polling the card from here
+ * @return Transfer result, or SD_TIMEOUT
+ */
+extern SD_Status_t SD_WaitIdle(uint32_t timeout_ms);
+
+/**
+ * @brief Token and busy polling, timeouts; 1 ms MicroOS task
+ */
+extern void SD_Task(void *data);
+
+extern void SD_TxRxCpltCallback(void);
+extern void SD_TxCpltCallback(void);
+extern void SD_ErrorCallback(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
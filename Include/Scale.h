@@ -0,0 +1,114 @@
+#ifndef SCALE_H
+#define SCALE_H
+
+/**
+ * @file Scale.h
+ * @brief RGB565 video scaler: fits any source size into a screen box, line by line into Render strips.
+ *
+ * @note
+ *   - Scale_Init() keeps the aspect ratio; the bars around the picture are filled with a border color.
+ *   - Source rows are pulled through a callback as they are needed, so the decoder only has to keep
+ *     the rows around the current strip instead of a whole frame.
+ *   - Positions are 16.16 fixed point; bilinear weights use 5 bits and the 0x07E0F81F spread form,
+ *     like Blit_Blend(). Each source row is scaled horizontally once and kept for the next output rows.
+ *   - Exact 1x, 2x and 1.5x horizontal ratios (e.g. 240, 120 or 160 pixel wide sources on the
+ *     240 pixel panel) take fast paths that produce the same pixels as the generic one; the 2x
+ *     bilinear path packs pixel pairs with the Cortex-M4 __PKHBT/__PKHTB instructions.
+ *     Define SCALE_NO_FAST_PATH to always use the generic path.
+ */
+
+#include "stdint.h"
+#include "stdbool.h"
+#include "LCD.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+// Widest source row
+#ifndef SCALE_MAX_SRC_WIDTH
+#define SCALE_MAX_SRC_WIDTH (480)
+#endif
+
+/**
+ * @brief Scale status codes
+ */
+typedef enum
+{
+    SCALE_OK = 0,        /**< Operation successful */
+    SCALE_ERROR,         /**< Source row not available */
+    SCALE_INVALID_PARAM, /**< Invalid parameter */
+} Scale_Status_t;
+
+/**
+ * @brief Interpolation
+ */
+typedef enum
+{
+    SCALE_NEAREST = 0,
+    SCALE_BILINEAR,
+} Scale_Filter_t;
+
+/**
+ * @brief Horizontal fast paths
+ */
+typedef enum
+{
+    SCALE_PATH_GENERIC = 0,
+    SCALE_PATH_1X,
+    SCALE_PATH_2X,
+    SCALE_PATH_1_5X,
+} Scale_Path_t;
+
+/**
+ * @brief Scaler setup, filled in by Scale_Init()
+ */
+typedef struct
+{
+    uint16_t SrcW;
+    uint16_t SrcH;
+    LCD_Rect_t Dst;        /**< Picture on screen, centered in the box */
+    LCD_Rect_t Box;        /**< Dst plus the border bars */
+    uint32_t StepX;        /**< Source pixels per screen pixel, 16.16 */
+    uint32_t StepY;        /**< Source rows per screen row, 16.16 */
+    Scale_Filter_t Filter;
+    Scale_Path_t Path;
+    uint16_t Border;       /**< RGB565 color of the bars */
+} Scale_t;
+
+/**
+ * @brief Source row callback
+ * @param row Source row, 0..SrcH-1, requested in increasing order within a frame
+ * @return SrcW pixels (word aligned for the fast paths), NULL aborts the strip
+ */
+typedef const uint16_t *(*Scale_RowFunction_t)(uint16_t row, void *Userdata);
+
+/**
+ * @brief Fit a source size into a screen box
+ * @param scale Setup to fill in
+ * @param src_w, src_h Source size, src_w up to SCALE_MAX_SRC_WIDTH
+ * @param box Screen box, NULL for the whole screen
+ * @param filter SCALE_NEAREST or SCALE_BILINEAR
+ * @param border Color of the bars
+ * @return Scale_Status_t Status code
+ */
+extern Scale_Status_t Scale_Init(Scale_t *scale, uint16_t src_w, uint16_t src_h, const LCD_Rect_t *box,
+                                 Scale_Filter_t filter, uint16_t border);
+
+/**
+ * @brief Draw the part of the box inside a Render strip
+ * @details Call from the Render draw callback. Strip rows outside the box are not touched.
+ *          A strip with y == 0 starts a new frame and drops the cached rows.
+ * @param strip, area, y, lines Arguments of the Render draw callback
+ * @param GetRow Source row callback
+ * @return Scale_Status_t SCALE_ERROR if GetRow returned NULL
+ */
+extern Scale_Status_t Scale_Draw(const Scale_t *scale, uint16_t *strip, const LCD_Rect_t *area, uint16_t y, uint16_t lines,
+                                 Scale_RowFunction_t GetRow, void *Userdata);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,90 @@
+#ifndef TILEDELTA_H
+#define TILEDELTA_H
+
+/**
+ * @file TileDelta.h
+ * @brief Decoder for tile-delta video (NTV_CODEC_TILE): only the 8x8 tiles that changed are sent to the panel.
+ *
+ * @note
+ *   - A slice covers whole tile rows (Line and Lines of the chunk are multiples of 8). Its payload
+ *     is a map with 2 bits per tile, row-major, four tiles per byte from the low bits up and padded
+ *     to an even length, followed by the data of every tile that is not skipped, in map order:
+ *       SKIP   nothing, the panel keeps the tile of the previous frame
+ *       SOLID  one RGB565 colour
+ *       RAW    64 RGB565 pixels, row by row
+ *       RLE    run count n, n run lengths - 1 (bytes), padding to even, n RGB565 colours
+ *   - The panel memory is the reference frame, so there is no framebuffer. Changed tiles are grouped
+ *     into exact rectangles: runs of neighbouring tiles in a tile row, joined with the same run in
+ *     the rows below. Each rectangle goes through Render, decoded straight into the strips while
+ *     the previous strip is on its way over SPI1, so no rectangle ever covers a skipped tile.
+ *   - TileDelta_Start()/TileDelta_Process() mirror Dirty_Start()/Dirty_Process(); the payload must
+ *     stay valid until the slice is done (it is, in place, in the Ntv buffer until Ntv_Release()).
+ */
+
+#include "stdint.h"
+#include "stdbool.h"
+#include "LCD.h"
+#include "Render.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#define TILEDELTA_SIZE (8)
+
+#define TILEDELTA_SKIP (0)
+#define TILEDELTA_SOLID (1)
+#define TILEDELTA_RAW (2)
+#define TILEDELTA_RLE (3)
+
+#define TILEDELTA_COLUMNS (LCD_WIDTH / TILEDELTA_SIZE)
+#define TILEDELTA_ROWS (LCD_HEIGHT / TILEDELTA_SIZE)
+
+/**
+ * @brief TileDelta statistics
+ */
+typedef struct
+{
+    uint32_t Slices;
+    uint32_t Tiles[4]; /**< Per tile type */
+    uint32_t Rects;    /**< Address windows sent */
+    uint32_t Errors;   /**< Slices rejected as corrupt */
+} TileDelta_Stats_t;
+
+/**
+ * @brief Check a slice and start sending its changed tiles
+ * @param data Slice payload
+ * @param size Payload bytes
+ * @param line First screen line, multiple of 8
+ * @param lines Lines in the slice, multiple of 8; 0 for a frame without changes
+ * @return Render_Status_t RENDER_BUSY if a slice is still being sent, RENDER_ERROR if it is corrupt
+ */
+extern Render_Status_t TileDelta_Start(const uint8_t *data, uint32_t size, uint16_t line, uint16_t lines);
+
+/**
+ * @brief Advance the running slice, never blocks
+ * @return Render_Status_t RENDER_BUSY while rectangles remain, RENDER_OK when all have been sent
+ */
+extern Render_Status_t TileDelta_Process(void);
+
+/**
+ * @brief Send a slice and wait until done
+ */
+extern Render_Status_t TileDelta_Draw(const uint8_t *data, uint32_t size, uint16_t line, uint16_t lines);
+
+/**
+ * @brief Copy the statistics
+ */
+extern void TileDelta_GetStats(TileDelta_Stats_t *stats);
+
+/**
+ * @brief Reset the statistics
+ */
+extern void TileDelta_ResetStats(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,205 @@
+#ifndef WIDGET_H
+#define WIDGET_H
+
+/**
+ * @file Widget.h
+ * @brief Retained-mode widgets for the menus: panels, labels, lists, progress bars, icons and scroll views.
+ *
+ * @note
+ *   - Widgets come from a static pool of WIDGET_POOL_SIZE entries and form a tree under Widget_Root().
+ *     Positions are relative to the parent; one layout pass turns them into screen rectangles and is
+ *     only repeated when the tree changes or a scroll view moves.
+ *   - Every change invalidates just the pixels it affects through Dirty; Widget_Task() sends the
+ *     collected rectangles through the Render strips at most every WIDGET_FRAME_PERIOD ms.
+ *   - A focused list spanning the full screen width with nothing else in its rows is scrolled by
+ *     the panel (LCD_SetScroll()); each frame then only sends the rows that scroll into view.
+ *   - Keys: HAL_GPIO_EXTI_Callback() forwards RETURN/UP/DOWN/ENTER_KEY to Widget_KeyCallback(),
+ *     which queues them for the WIDGET_EVENT_KEY MicroOS event. UP/DOWN move the list selection,
+ *     then the focus; ENTER/RETURN go to the key handler of the focused widget and bubble up to its
+ *     parents until one handles them.
+ *   - Widget_Task() must run as a 1 ms MicroOS task. It leaves the LCD alone while Render is busy
+ *     with someone else (Present during playback).
+ */
+
+#include "stdint.h"
+#include "stdbool.h"
+#include "LCD.h"
+#include "Font.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+// Widgets in the pool, the root included
+#ifndef WIDGET_POOL_SIZE
+#define WIDGET_POOL_SIZE (32)
+#endif
+
+// Minimum time between two redraws (ms)
+#ifndef WIDGET_FRAME_PERIOD
+#define WIDGET_FRAME_PERIOD (16)
+#endif
+
+// Scroll animation: each frame covers 1/WIDGET_SCROLL_EASE of the remaining distance
+#ifndef WIDGET_SCROLL_EASE
+#define WIDGET_SCROLL_EASE (4)
+#endif
+
+// Key presses closer together than this are contact bounce (ms)
+#ifndef WIDGET_KEY_DEBOUNCE
+#define WIDGET_KEY_DEBOUNCE (30)
+#endif
+
+// Longest label or list item drawn truncated, in bytes
+#ifndef WIDGET_TEXT_MAX
+#define WIDGET_TEXT_MAX (64)
+#endif
+
+// MicroOS event triggered by key presses
+#ifndef WIDGET_EVENT_KEY
+#define WIDGET_EVENT_KEY (3)
+#endif
+
+#define WIDGET_COLOR_FG LCD_RGB565(0xFF, 0xFF, 0xFF)
+#define WIDGET_COLOR_BG LCD_RGB565(0x00, 0x00, 0x00)
+#define WIDGET_COLOR_FOCUS LCD_RGB565(0x20, 0x60, 0xC0)
+// Selected list item while the list does not have the focus
+#define WIDGET_COLOR_SELECT LCD_RGB565(0x40, 0x40, 0x40)
+
+// Text inset from the widget edge in pixels
+#define WIDGET_PADDING (4)
+
+/**
+ * @brief Widget status codes
+ */
+typedef enum
+{
+    WIDGET_OK = 0,        /**< Operation successful */
+    WIDGET_ERROR,         /**< MicroOS or render error */
+    WIDGET_BUSY,          /**< Redraw in progress */
+    WIDGET_INVALID_PARAM, /**< Invalid parameter */
+} Widget_Status_t;
+
+/**
+ * @brief Keys
+ */
+typedef enum
+{
+    WIDGET_KEY_RETURN = 0,
+    WIDGET_KEY_UP,
+    WIDGET_KEY_DOWN,
+    WIDGET_KEY_ENTER,
+} Widget_Key_t;
+
+/**
+ * @brief Horizontal text alignment
+ */
+typedef enum
+{
+    WIDGET_ALIGN_LEFT = 0,
+    WIDGET_ALIGN_CENTER,
+    WIDGET_ALIGN_RIGHT,
+} Widget_Align_t;
+
+typedef struct Widget_t Widget_t;
+
+/**
+ * @brief Key handler
+ * @param widget Focused widget, or the ancestor the key bubbled up to
+ * @return true if the key was handled, false to pass it to the parent
+ */
+typedef bool (*Widget_KeyFunction_t)(Widget_t *widget, Widget_Key_t key, void *Userdata);
+
+/**
+ * @brief Reset the pool, create the full-screen root and register the key event
+ */
+extern Widget_Status_t Widget_Init(void);
+
+/**
+ * @brief Get the root panel
+ */
+extern Widget_t *Widget_Root(void);
+
+/**
+ * @brief Create widgets
+ * @param parent Parent widget, NULL for the root
+ * @param x, y Position relative to the parent
+ * @return Widget, NULL if the pool is exhausted or the parameters are invalid
+ */
+extern Widget_t *Widget_CreatePanel(Widget_t *parent, int16_t x, int16_t y, uint16_t w, uint16_t h);
+extern Widget_t *Widget_CreateLabel(Widget_t *parent, int16_t x, int16_t y, uint16_t w, uint16_t h, const char *text);
+extern Widget_t *Widget_CreateProgress(Widget_t *parent, int16_t x, int16_t y, uint16_t w, uint16_t h, uint16_t max);
+
+/**
+ * @param items Item strings, must stay valid while the list shows them
+ */
+extern Widget_t *Widget_CreateList(Widget_t *parent, int16_t x, int16_t y, uint16_t w, uint16_t h,
+                                   const char *const *items, uint16_t count);
+
+/**
+ * @param mask 8-bit coverage, w * h bytes, painted in the widget fg color
+ */
+extern Widget_t *Widget_CreateIcon(Widget_t *parent, int16_t x, int16_t y, uint16_t w, uint16_t h, const uint8_t *mask);
+
+/**
+ * @brief Create a scroll view; children are placed in a content area content_h pixels tall
+ */
+extern Widget_t *Widget_CreateScroll(Widget_t *parent, int16_t x, int16_t y, uint16_t w, uint16_t h, uint16_t content_h);
+
+/**
+ * @brief Return a widget and all its children to the pool
+ */
+extern void Widget_Delete(Widget_t *widget);
+
+extern void Widget_SetText(Widget_t *widget, const char *text);
+extern void Widget_SetColors(Widget_t *widget, uint16_t fg, uint16_t bg);
+extern void Widget_SetFont(Widget_t *widget, const Font_t *font);
+extern void Widget_SetAlign(Widget_t *widget, Widget_Align_t align);
+extern void Widget_SetVisible(Widget_t *widget, bool visible);
+
+/**
+ * @brief Install a key handler; the widget becomes focusable
+ */
+extern void Widget_SetOnKey(Widget_t *widget, Widget_KeyFunction_t OnKey, void *Userdata);
+
+/**
+ * @brief Set a progress bar value, clamped to its max; only the changed span is redrawn
+ */
+extern void Widget_SetProgress(Widget_t *widget, uint16_t value);
+
+extern void Widget_ListSetItems(Widget_t *widget, const char *const *items, uint16_t count);
+extern void Widget_ListSelect(Widget_t *widget, uint16_t index);
+extern uint16_t Widget_ListSelected(const Widget_t *widget);
+
+/**
+ * @brief Scroll a scroll view so content row y is at its top (animated)
+ */
+extern void Widget_ScrollTo(Widget_t *widget, int16_t y);
+
+/**
+ * @brief Move the keyboard focus, scrolling enclosing scroll views to show the widget
+ */
+extern void Widget_Focus(Widget_t *widget);
+extern Widget_t *Widget_GetFocus(void);
+
+/**
+ * @brief Redraw a widget on the next frame
+ */
+extern void Widget_Invalidate(Widget_t *widget);
+
+/**
+ * @brief Key interrupt hook, call from HAL_GPIO_EXTI_Callback()
+ */
+extern void Widget_KeyCallback(uint16_t GPIO_Pin);
+
+/**
+ * @brief Animate, lay out and redraw, 1 ms MicroOS task
+ */
+extern void Widget_Task(void *data);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -5,6 +5,26 @@
 #include "main.h"
 #include "stdio.h"
 #include "Logic.h"
+#include "LCD.h"
+#include "Render.h"
+#include "Dirty.h"
+#include "Present.h"
+#include "Blit.h"
+#include "Font.h"
+#include "Font_Sans14.h"
+#include "Widget.h"
+#include "Scale.h"
+#include "ColorConv.h"
+#include "SD.h"
+#include "BlockDev.h"
+#include "Battery.h"
+#include "BlockCache.h"
+#include "Fat.h"
+#include "Prefetch.h"
+#include "Ntv.h"
+#include "TileDelta.h"
+#include "Palette.h"
+#include "Lz4.h"
 
 #ifdef __cplusplus
 extern "C"
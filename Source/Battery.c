@@ -0,0 +1,86 @@
+#include "Battery.h"
+
+#include "main.h"
+#include "adc.h"
+#include "MicroOS.h"
+
+// Running average over 2^BATTERY_AVERAGE_SHIFT samples
+#define BATTERY_AVERAGE_SHIFT (3)
+#define BATTERY_ADC_FULL (4095)
+
+typedef struct
+{
+    uint32_t Sum; // Running sum of BATTERY_AVERAGE_SHIFT-weighted samples, in mV
+    uint16_t Millivolts;
+    uint8_t Below; // Consecutive averaged samples below BATTERY_LOW_MV
+    bool Low;
+} Battery_Handle_t;
+
+static Battery_Handle_t Battery = {0};
+
+Battery_Status_t Battery_Init(void)
+{
+    ADC_ChannelConfTypeDef config = {0};
+
+    // The divider is high impedance, the CubeMX default of 2.5 cycles does not settle
+    config.Channel = ADC_CHANNEL_1;
+    config.Rank = ADC_REGULAR_RANK_1;
+    config.SamplingTime = ADC_SAMPLETIME_640CYCLES_5;
+    config.SingleDiff = ADC_SINGLE_ENDED;
+    config.OffsetNumber = ADC_OFFSET_NONE;
+    config.Offset = 0;
+
+    if (HAL_ADC_ConfigChannel(&hadc1, &config) != HAL_OK)
+        return BATTERY_ERROR;
+    if (HAL_ADCEx_Calibration_Start(&hadc1, ADC_SINGLE_ENDED) != HAL_OK)
+        return BATTERY_ERROR;
+
+    return BATTERY_OK;
+}
+
+uint16_t Battery_GetMillivolts(void)
+{
+    return Battery.Millivolts;
+}
+
+bool Battery_IsLow(void)
+{
+    return Battery.Low;
+}
+
+void Battery_Task(void *data)
+{
+    uint32_t mv = 0;
+
+    if (HAL_ADC_Start(&hadc1) != HAL_OK)
+        return;
+    // 640.5 + 12.5 ADC cycles at HCLK / 4, about 0.2 ms
+    if (HAL_ADC_PollForConversion(&hadc1, 1) != HAL_OK)
+    {
+        HAL_ADC_Stop(&hadc1);
+        return;
+    }
+
+    mv = HAL_ADC_GetValue(&hadc1) * BATTERY_VREF_MV / BATTERY_ADC_FULL;
+    mv = mv * BATTERY_DIVIDER_NUM / BATTERY_DIVIDER_DEN;
+
+    if (Battery.Millivolts == 0)
+        Battery.Sum = mv << BATTERY_AVERAGE_SHIFT;
+    else
+        Battery.Sum += mv - (Battery.Sum >> BATTERY_AVERAGE_SHIFT);
+    Battery.Millivolts = (uint16_t)(Battery.Sum >> BATTERY_AVERAGE_SHIFT);
+
+    if (Battery.Millivolts >= BATTERY_LOW_MV + BATTERY_HYSTERESIS_MV)
+        Battery.Low = false;
+    if (Battery.Millivolts >= BATTERY_LOW_MV)
+    {
+        Battery.Below = 0;
+        return;
+    }
+
+    if (!Battery.Low && ++Battery.Below >= BATTERY_LOW_COUNT)
+    {
+        Battery.Low = true;
+        MicroOS_TriggerEvent(BATTERY_EVENT_LOW);
+    }
+}
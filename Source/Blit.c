@@ -0,0 +1,351 @@
+#include "Blit.h"
+
+#include "main.h"
+#include "string.h"
+
+#if defined(__ARM_FEATURE_DSP) && (__ARM_FEATURE_DSP == 1) && !defined(BLIT_NO_SIMD)
+#define BLIT_SIMD 1
+#else
+#define BLIT_SIMD 0
+#endif
+
+// RGB565 spread over 32 bits as ----- GGGGGG ----- RRRRR ------ BBBBB, room for a 5-bit multiply
+#define BLIT_SPREAD_MASK (0x07E0F81FUL)
+// Two pixels with the lowest bit of every channel cleared, for the 50% average
+#define BLIT_HALF_MASK (0xF7DEF7DEUL)
+
+#define BLIT_ALPHA5(alpha) (((uint32_t)(alpha) + 4) >> 3)
+
+static inline uint32_t Blit_Spread(uint32_t p)
+{
+    return (p | (p << 16)) & BLIT_SPREAD_MASK;
+}
+
+static inline uint16_t Blit_Pack(uint32_t e)
+{
+    return (uint16_t)(e | (e >> 16));
+}
+
+/**
+ * @brief d + (s - d) * a5 / 32 on all three channels with one multiply
+ * @note Borrows between fields are cut off by the mask, leaving each channel floor-divided
+ */
+static inline uint16_t Blit_Mix(uint32_t s, uint32_t d, uint32_t a5)
+{
+    uint32_t se = Blit_Spread(s);
+    uint32_t de = Blit_Spread(d);
+
+    return Blit_Pack(((((se - de) * a5) >> 5) + de) & BLIT_SPREAD_MASK);
+}
+
+/**
+ * @brief true when dst and src can be walked with the same 32-bit alignment
+ */
+static inline int Blit_SamePhase(const void *dst, const void *src)
+{
+    return (((uintptr_t)dst ^ (uintptr_t)src) & 2) == 0;
+}
+
+void Blit_Fill(uint16_t *dst, uint16_t dst_stride, uint16_t w, uint16_t h, uint16_t color)
+{
+    uint32_t color2 = color | ((uint32_t)color << 16);
+
+    while (h--)
+    {
+        uint16_t *d = dst;
+        uint16_t n = w;
+        uint32_t *dw = NULL;
+
+        if (((uintptr_t)d & 2) && n > 0)
+        {
+            *d++ = color;
+            n--;
+        }
+        dw = (uint32_t *)d;
+        while (n >= 8)
+        {
+            dw[0] = color2;
+            dw[1] = color2;
+            dw[2] = color2;
+            dw[3] = color2;
+            dw += 4;
+            n -= 8;
+        }
+        while (n >= 2)
+        {
+            *dw++ = color2;
+            n -= 2;
+        }
+        if (n)
+            *(uint16_t *)dw = color;
+
+        dst += dst_stride;
+    }
+}
+
+void Blit_Copy(uint16_t *dst, uint16_t dst_stride, const uint16_t *src, uint16_t src_stride, uint16_t w, uint16_t h)
+{
+    while (h--)
+    {
+        memcpy(dst, src, (size_t)w * 2);
+        dst += dst_stride;
+        src += src_stride;
+    }
+}
+
+void Blit_CopyKey(uint16_t *dst, uint16_t dst_stride, const uint16_t *src, uint16_t src_stride, uint16_t w, uint16_t h, uint16_t key)
+{
+#if BLIT_SIMD
+    uint32_t key2 = key | ((uint32_t)key << 16);
+#endif
+
+    while (h--)
+    {
+        uint16_t *d = dst;
+        const uint16_t *s = src;
+        uint16_t n = w;
+
+#if BLIT_SIMD
+        if (Blit_SamePhase(d, s))
+        {
+            uint32_t *dw = NULL;
+            const uint32_t *sw = NULL;
+
+            if (((uintptr_t)d & 2) && n > 0)
+            {
+                if (*s != key)
+                    *d = *s;
+                d++;
+                s++;
+                n--;
+            }
+            dw = (uint32_t *)d;
+            sw = (const uint32_t *)s;
+            while (n >= 2)
+            {
+                uint32_t sv = *sw++;
+                // GE bits are set for every half-word that differs from the key
+                __USUB16(sv ^ key2, 0x00010001);
+                *dw = __SEL(sv, *dw);
+                dw++;
+                n -= 2;
+            }
+            d = (uint16_t *)dw;
+            s = (const uint16_t *)sw;
+        }
+#endif
+        while (n--)
+        {
+            if (*s != key)
+                *d = *s;
+            d++;
+            s++;
+        }
+
+        dst += dst_stride;
+        src += src_stride;
+    }
+}
+
+void Blit_Blend(uint16_t *dst, uint16_t dst_stride, const uint16_t *src, uint16_t src_stride, uint16_t w, uint16_t h, uint8_t alpha)
+{
+    uint32_t a5 = BLIT_ALPHA5(alpha);
+
+    if (a5 == 0)
+        return;
+    if (a5 == 32)
+    {
+        Blit_Copy(dst, dst_stride, src, src_stride, w, h);
+        return;
+    }
+
+    while (h--)
+    {
+        uint16_t *d = dst;
+        const uint16_t *s = src;
+        uint16_t n = w;
+
+        if (Blit_SamePhase(d, s))
+        {
+            uint32_t *dw = NULL;
+            const uint32_t *sw = NULL;
+
+            if (((uintptr_t)d & 2) && n > 0)
+            {
+                *d = Blit_Mix(*s, *d, a5);
+                d++;
+                s++;
+                n--;
+            }
+            dw = (uint32_t *)d;
+            sw = (const uint32_t *)s;
+            if (a5 == 16)
+            {
+                // 50%: per-channel floor average of two pixels at once
+                while (n >= 2)
+                {
+                    uint32_t sv = *sw++;
+                    uint32_t dv = *dw;
+                    *dw++ = (sv & dv) + (((sv ^ dv) & BLIT_HALF_MASK) >> 1);
+                    n -= 2;
+                }
+            }
+            else
+            {
+                while (n >= 2)
+                {
+                    uint32_t sv = *sw++;
+                    uint32_t dv = *dw;
+                    *dw++ = Blit_Mix(sv & 0xFFFF, dv & 0xFFFF, a5) | ((uint32_t)Blit_Mix(sv >> 16, dv >> 16, a5) << 16);
+                    n -= 2;
+                }
+            }
+            d = (uint16_t *)dw;
+            s = (const uint16_t *)sw;
+        }
+        while (n--)
+        {
+            *d = Blit_Mix(*s, *d, a5);
+            d++;
+            s++;
+        }
+
+        dst += dst_stride;
+        src += src_stride;
+    }
+}
+
+void Blit_BlendMask(uint16_t *dst, uint16_t dst_stride, const uint8_t *mask, uint16_t mask_stride, uint16_t w, uint16_t h, uint16_t color)
+{
+    uint32_t ce = Blit_Spread(color);
+
+    while (h--)
+    {
+        uint16_t *d = dst;
+        const uint8_t *m = mask;
+        uint16_t n = w;
+
+        while (n > 0)
+        {
+            // Glyph masks are mostly empty or solid: decide four pixels at once
+            if (n >= 4 && ((uintptr_t)m & 3) == 0)
+            {
+                uint32_t mv = *(const uint32_t *)m;
+                if (mv == 0)
+                {
+                    d += 4;
+                    m += 4;
+                    n -= 4;
+                    continue;
+                }
+                if (mv == 0xFFFFFFFF)
+                {
+                    d[0] = color;
+                    d[1] = color;
+                    d[2] = color;
+                    d[3] = color;
+                    d += 4;
+                    m += 4;
+                    n -= 4;
+                    continue;
+                }
+            }
+
+            {
+                uint32_t a5 = BLIT_ALPHA5(*m);
+                if (a5 == 32)
+                {
+                    *d = color;
+                }
+                else if (a5 != 0)
+                {
+                    uint32_t de = Blit_Spread(*d);
+                    *d = Blit_Pack(((((ce - de) * a5) >> 5) + de) & BLIT_SPREAD_MASK);
+                }
+            }
+            d++;
+            m++;
+            n--;
+        }
+
+        dst += dst_stride;
+        mask += mask_stride;
+    }
+}
+
+/**
+ * @brief Reference blend of one pixel, channel by channel
+ */
+static uint16_t Blit_Mix_Ref(uint16_t s, uint16_t d, uint32_t a5)
+{
+    int32_t sr = s >> 11, sg = (s >> 5) & 0x3F, sb = s & 0x1F;
+    int32_t dr = d >> 11, dg = (d >> 5) & 0x3F, db = d & 0x1F;
+    int32_t a = (int32_t)a5;
+    // Floor division, also for negative differences
+    int32_t r = dr + (int32_t)((sr - dr) * a + 1024) / 32 - 32;
+    int32_t g = dg + (int32_t)((sg - dg) * a + 2048) / 32 - 64;
+    int32_t b = db + (int32_t)((sb - db) * a + 1024) / 32 - 32;
+
+    return (uint16_t)((r << 11) | (g << 5) | b);
+}
+
+void Blit_Fill_Ref(uint16_t *dst, uint16_t dst_stride, uint16_t w, uint16_t h, uint16_t color)
+{
+    for (uint16_t y = 0; y < h; y++)
+    {
+        for (uint16_t x = 0; x < w; x++)
+        {
+            dst[(uint32_t)y * dst_stride + x] = color;
+        }
+    }
+}
+
+void Blit_Copy_Ref(uint16_t *dst, uint16_t dst_stride, const uint16_t *src, uint16_t src_stride, uint16_t w, uint16_t h)
+{
+    for (uint16_t y = 0; y < h; y++)
+    {
+        for (uint16_t x = 0; x < w; x++)
+        {
+            dst[(uint32_t)y * dst_stride + x] = src[(uint32_t)y * src_stride + x];
+        }
+    }
+}
+
+void Blit_CopyKey_Ref(uint16_t *dst, uint16_t dst_stride, const uint16_t *src, uint16_t src_stride, uint16_t w, uint16_t h, uint16_t key)
+{
+    for (uint16_t y = 0; y < h; y++)
+    {
+        for (uint16_t x = 0; x < w; x++)
+        {
+            uint16_t s = src[(uint32_t)y * src_stride + x];
+            if (s != key)
+                dst[(uint32_t)y * dst_stride + x] = s;
+        }
+    }
+}
+
+void Blit_Blend_Ref(uint16_t *dst, uint16_t dst_stride, const uint16_t *src, uint16_t src_stride, uint16_t w, uint16_t h, uint8_t alpha)
+{
+    uint32_t a5 = BLIT_ALPHA5(alpha);
+
+    for (uint16_t y = 0; y < h; y++)
+    {
+        for (uint16_t x = 0; x < w; x++)
+        {
+            uint16_t *d = &dst[(uint32_t)y * dst_stride + x];
+            *d = Blit_Mix_Ref(src[(uint32_t)y * src_stride + x], *d, a5);
+        }
+    }
+}
+
+void Blit_BlendMask_Ref(uint16_t *dst, uint16_t dst_stride, const uint8_t *mask, uint16_t mask_stride, uint16_t w, uint16_t h, uint16_t color)
+{
+    for (uint16_t y = 0; y < h; y++)
+    {
+        for (uint16_t x = 0; x < w; x++)
+        {
+            uint16_t *d = &dst[(uint32_t)y * dst_stride + x];
+            *d = Blit_Mix_Ref(color, *d, BLIT_ALPHA5(mask[(uint32_t)y * mask_stride + x]));
+        }
+    }
+}
@@ -0,0 +1,394 @@
+#include "BlockCache.h"
+
+#include "main.h"
+#include "string.h"
+#include "MicroOS.h"
+#include "BlockDev.h"
+#include "Battery.h"
+
+#if BLOCKCACHE_PIN_MAX >= BLOCKCACHE_SLOTS
+#error "BLOCKCACHE_PIN_MAX must leave unpinned slots"
+#endif
+
+#define BLOCKCACHE_NONE (0xFF)
+
+typedef struct
+{
+    uint32_t Sector;
+    uint32_t Used;       // LRU stamp, larger is more recent
+    uint32_t DirtyTick;  // HAL tick of the first write since the last write-back
+    bool Valid;
+    bool Dirty;
+    bool Pinned;
+} BlockCache_Slot_t;
+
+typedef struct
+{
+    BlockCache_Slot_t Slot[BLOCKCACHE_SLOTS];
+    uint32_t Stamp;       // Last LRU stamp handed out
+    uint8_t Pinned;
+    bool WriteThrough;    // Battery low: nothing may stay dirty
+    BlockCache_Stats_t Stats;
+} BlockCache_Handle_t;
+
+static BlockCache_Handle_t BlockCache = {0};
+
+static __ALIGNED(4) uint8_t BlockCache_Data[BLOCKCACHE_SLOTS][BLOCKDEV_SECTOR_SIZE];
+
+/**
+ * @brief Wait until a background transfer (Prefetch, Ntv) has left the card
+ * @note Its result is not ours: BlockDev stores it in the request the transfer was started with
+ *       (BlockDev_ReadAsync()) before our own transfer can start, so its owner still sees it
+ */
+static BlockCache_Status_t BlockCache_Idle(void)
+{
+    if (BlockDev_IsBusy() && BlockDev_WaitIdle(BLOCKCACHE_IO_TIMEOUT) == BLOCKDEV_TIMEOUT)
+        return BLOCKCACHE_ERROR;
+    return BLOCKCACHE_OK;
+}
+
+/**
+ * @brief Wait for the transfer just started
+ */
+static BlockCache_Status_t BlockCache_Finish(BlockDev_Status_t started)
+{
+    if (started != BLOCKDEV_OK)
+        return BLOCKCACHE_ERROR;
+    return (BlockDev_WaitIdle(BLOCKCACHE_IO_TIMEOUT) == BLOCKDEV_OK) ? BLOCKCACHE_OK : BLOCKCACHE_ERROR;
+}
+
+static BlockCache_Status_t BlockCache_CardRead(uint32_t sector, uint8_t *buf, uint32_t count)
+{
+    if (BlockCache_Idle() != BLOCKCACHE_OK)
+        return BLOCKCACHE_ERROR;
+    return BlockCache_Finish(BlockDev_Read(sector, buf, count));
+}
+
+static uint8_t BlockCache_Find(uint32_t sector)
+{
+    for (uint8_t i = 0; i < BLOCKCACHE_SLOTS; i++)
+    {
+        if (BlockCache.Slot[i].Valid && BlockCache.Slot[i].Sector == sector)
+            return i;
+    }
+    return BLOCKCACHE_NONE;
+}
+
+/**
+ * @brief Empty a slot without writing it back
+ */
+static void BlockCache_Drop(uint8_t i)
+{
+    BlockCache_Slot_t *slot = &BlockCache.Slot[i];
+
+    if (slot->Pinned)
+        BlockCache.Pinned--;
+    slot->Valid = false;
+    slot->Dirty = false;
+    slot->Pinned = false;
+}
+
+/**
+ * @brief Take an empty slot for a sector
+ */
+static void BlockCache_Fill(uint8_t i, uint32_t sector)
+{
+    BlockCache_Slot_t *slot = &BlockCache.Slot[i];
+
+    slot->Sector = sector;
+    slot->Valid = true;
+    slot->Dirty = false;
+    slot->Pinned = false;
+}
+
+/**
+ * @brief Mark a slot most recently used, pin it if asked
+ */
+static void BlockCache_Touch(uint8_t i, uint8_t flags)
+{
+    BlockCache_Slot_t *slot = &BlockCache.Slot[i];
+
+    slot->Used = ++BlockCache.Stamp;
+    if (!(flags & BLOCKCACHE_PIN) || slot->Pinned)
+        return;
+
+    // Too many pins: the least recently used pinned slot becomes an ordinary one
+    if (BlockCache.Pinned >= BLOCKCACHE_PIN_MAX)
+    {
+        uint8_t oldest = BLOCKCACHE_NONE;
+
+        for (uint8_t j = 0; j < BLOCKCACHE_SLOTS; j++)
+        {
+            if (BlockCache.Slot[j].Pinned && (oldest == BLOCKCACHE_NONE || BlockCache.Slot[j].Used < BlockCache.Slot[oldest].Used))
+                oldest = j;
+        }
+        BlockCache.Slot[oldest].Pinned = false;
+        BlockCache.Pinned--;
+    }
+
+    slot->Pinned = true;
+    BlockCache.Pinned++;
+}
+
+/**
+ * @brief Write back the dirty run around a slot as one multi-block write
+ */
+static BlockCache_Status_t BlockCache_WriteBack(uint8_t i)
+{
+    static const uint8_t *list[BLOCKCACHE_SLOTS];
+    uint8_t run[BLOCKCACHE_SLOTS];
+    uint32_t first = BlockCache.Slot[i].Sector;
+    uint8_t count = 0;
+    uint8_t j = 0;
+
+    // Back to the start of the run, then collect it forward
+    while (first > 0 && (j = BlockCache_Find(first - 1)) != BLOCKCACHE_NONE && BlockCache.Slot[j].Dirty)
+    {
+        first--;
+    }
+    while (count < BLOCKCACHE_SLOTS && (j = BlockCache_Find(first + count)) != BLOCKCACHE_NONE && BlockCache.Slot[j].Dirty)
+    {
+        run[count] = j;
+        list[count] = BlockCache_Data[j];
+        count++;
+    }
+
+    if (BlockCache_Idle() != BLOCKCACHE_OK || BlockCache_Finish(BlockDev_WriteList(first, list, count)) != BLOCKCACHE_OK)
+        return BLOCKCACHE_ERROR;
+
+    for (j = 0; j < count; j++)
+    {
+        BlockCache.Slot[run[j]].Dirty = false;
+    }
+    BlockCache.Stats.WriteBacks++;
+    BlockCache.Stats.Written += count;
+    return BLOCKCACHE_OK;
+}
+
+/**
+ * @brief Free slot for a new sector: an empty one, else the least recently used unpinned one
+ */
+static BlockCache_Status_t BlockCache_Evict(uint8_t *victim)
+{
+    uint8_t best = BLOCKCACHE_NONE;
+    BlockCache_Slot_t *slot = NULL;
+
+    for (uint8_t i = 0; i < BLOCKCACHE_SLOTS; i++)
+    {
+        slot = &BlockCache.Slot[i];
+        if (!slot->Valid)
+        {
+            *victim = i;
+            return BLOCKCACHE_OK;
+        }
+        if (!slot->Pinned && (best == BLOCKCACHE_NONE || slot->Used < BlockCache.Slot[best].Used))
+            best = i;
+    }
+
+    if (BlockCache.Slot[best].Dirty && BlockCache_WriteBack(best) != BLOCKCACHE_OK)
+        return BLOCKCACHE_ERROR;
+
+    BlockCache_Drop(best);
+    BlockCache.Stats.Evictions++;
+    *victim = best;
+    return BLOCKCACHE_OK;
+}
+
+/**
+ * @brief Battery low handler (MicroOS event context)
+ */
+static void BlockCache_OnPowerLow(void *data)
+{
+    BlockCache.WriteThrough = true;
+    BlockCache_Flush();
+}
+
+BlockCache_Status_t BlockCache_Init(void)
+{
+    if (MicroOS_RegisterEvent(BATTERY_EVENT_LOW, BlockCache_OnPowerLow, NULL) != MICROOS_OK)
+        return BLOCKCACHE_ERROR;
+
+    return BLOCKCACHE_OK;
+}
+
+BlockCache_Status_t BlockCache_Read(uint32_t sector, uint8_t flags, const uint8_t **data)
+{
+    uint8_t i = 0;
+
+    if (data == NULL)
+        return BLOCKCACHE_INVALID_PARAM;
+
+    i = BlockCache_Find(sector);
+    if (i != BLOCKCACHE_NONE)
+    {
+        BlockCache.Stats.Hits++;
+    }
+    else
+    {
+        BlockCache.Stats.Misses++;
+        if (BlockCache_Evict(&i) != BLOCKCACHE_OK)
+            return BLOCKCACHE_ERROR;
+        if (BlockCache_CardRead(sector, BlockCache_Data[i], 1) != BLOCKCACHE_OK)
+            return BLOCKCACHE_ERROR;
+        BlockCache_Fill(i, sector);
+    }
+
+    BlockCache_Touch(i, flags);
+    *data = BlockCache_Data[i];
+    return BLOCKCACHE_OK;
+}
+
+BlockCache_Status_t BlockCache_ReadBlocks(uint32_t sector, uint8_t *buf, uint32_t count)
+{
+    if (buf == NULL || count == 0)
+        return BLOCKCACHE_INVALID_PARAM;
+
+    if (BlockCache_CardRead(sector, buf, count) != BLOCKCACHE_OK)
+        return BLOCKCACHE_ERROR;
+    BlockCache.Stats.Bypassed += count;
+
+    // Dirty copies are newer than the card
+    for (uint8_t i = 0; i < BLOCKCACHE_SLOTS; i++)
+    {
+        BlockCache_Slot_t *slot = &BlockCache.Slot[i];
+
+        if (slot->Valid && slot->Dirty && slot->Sector - sector < count)
+            memcpy(&buf[(slot->Sector - sector) * BLOCKDEV_SECTOR_SIZE], BlockCache_Data[i], BLOCKDEV_SECTOR_SIZE);
+    }
+
+    return BLOCKCACHE_OK;
+}
+
+BlockCache_Status_t BlockCache_Write(uint32_t sector, const uint8_t *data, uint8_t flags)
+{
+    BlockCache_Slot_t *slot = NULL;
+    uint8_t i = 0;
+
+    if (data == NULL)
+        return BLOCKCACHE_INVALID_PARAM;
+
+    i = BlockCache_Find(sector);
+    if (i == BLOCKCACHE_NONE)
+    {
+        // A whole sector: no need to read it first
+        if (BlockCache_Evict(&i) != BLOCKCACHE_OK)
+            return BLOCKCACHE_ERROR;
+        BlockCache_Fill(i, sector);
+    }
+
+    slot = &BlockCache.Slot[i];
+    memcpy(BlockCache_Data[i], data, BLOCKDEV_SECTOR_SIZE);
+    if (!slot->Dirty)
+        slot->DirtyTick = HAL_GetTick();
+    slot->Dirty = true;
+    BlockCache_Touch(i, flags);
+
+    if (BlockCache.WriteThrough)
+        return BlockCache_WriteBack(i);
+    return BLOCKCACHE_OK;
+}
+
+BlockCache_Status_t BlockCache_WriteBlocks(uint32_t sector, const uint8_t *buf, uint32_t count)
+{
+    if (buf == NULL || count == 0)
+        return BLOCKCACHE_INVALID_PARAM;
+
+    // Cached copies take the new data and are clean once it is on the card
+    for (uint8_t i = 0; i < BLOCKCACHE_SLOTS; i++)
+    {
+        BlockCache_Slot_t *slot = &BlockCache.Slot[i];
+
+        if (slot->Valid && slot->Sector - sector < count)
+        {
+            memcpy(BlockCache_Data[i], &buf[(slot->Sector - sector) * BLOCKDEV_SECTOR_SIZE], BLOCKDEV_SECTOR_SIZE);
+            slot->Dirty = false;
+        }
+    }
+
+    if (BlockCache_Idle() != BLOCKCACHE_OK || BlockCache_Finish(BlockDev_Write(sector, buf, count)) != BLOCKCACHE_OK)
+    {
+        // The card may hold old or new data now, the cache must not claim either
+        for (uint8_t i = 0; i < BLOCKCACHE_SLOTS; i++)
+        {
+            if (BlockCache.Slot[i].Valid && BlockCache.Slot[i].Sector - sector < count)
+                BlockCache_Drop(i);
+        }
+        return BLOCKCACHE_ERROR;
+    }
+
+    BlockCache.Stats.Bypassed += count;
+    return BLOCKCACHE_OK;
+}
+
+BlockCache_Status_t BlockCache_Flush(void)
+{
+    for (;;)
+    {
+        uint8_t lowest = BLOCKCACHE_NONE;
+
+        // Lowest dirty sector first, so each write-back starts at the beginning of its run
+        for (uint8_t i = 0; i < BLOCKCACHE_SLOTS; i++)
+        {
+            BlockCache_Slot_t *slot = &BlockCache.Slot[i];
+
+            if (slot->Valid && slot->Dirty && (lowest == BLOCKCACHE_NONE || slot->Sector < BlockCache.Slot[lowest].Sector))
+                lowest = i;
+        }
+
+        if (lowest == BLOCKCACHE_NONE)
+            return BLOCKCACHE_OK;
+        if (BlockCache_WriteBack(lowest) != BLOCKCACHE_OK)
+            return BLOCKCACHE_ERROR;
+    }
+}
+
+void BlockCache_Invalidate(void)
+{
+    for (uint8_t i = 0; i < BLOCKCACHE_SLOTS; i++)
+    {
+        BlockCache_Drop(i);
+    }
+}
+
+void BlockCache_GetStats(BlockCache_Stats_t *stats)
+{
+    if (stats == NULL)
+        return;
+
+    *stats = BlockCache.Stats;
+    stats->Dirty = 0;
+    for (uint8_t i = 0; i < BLOCKCACHE_SLOTS; i++)
+    {
+        if (BlockCache.Slot[i].Valid && BlockCache.Slot[i].Dirty)
+            stats->Dirty++;
+    }
+    stats->Pinned = BlockCache.Pinned;
+}
+
+void BlockCache_ResetStats(void)
+{
+    BlockCache_Stats_t empty = {0};
+
+    BlockCache.Stats = empty;
+}
+
+void BlockCache_Task(void *data)
+{
+    uint32_t now = HAL_GetTick();
+
+    // Recovered battery (charger): back to write-back
+    if (BlockCache.WriteThrough && !Battery_IsLow())
+        BlockCache.WriteThrough = false;
+
+    for (uint8_t i = 0; i < BLOCKCACHE_SLOTS; i++)
+    {
+        BlockCache_Slot_t *slot = &BlockCache.Slot[i];
+
+        // Leave the card to a background transfer, the next period will do; once it has ended its
+        // result is with its owner (BlockDev_IsBusy() hands it over) and the write-back may start
+        if (BlockDev_IsBusy())
+            return;
+        if (slot->Valid && slot->Dirty && now - slot->DirtyTick >= BLOCKCACHE_WRITE_DELAY)
+            BlockCache_WriteBack(i);
+    }
+}
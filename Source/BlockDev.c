@@ -0,0 +1,117 @@
+#include "BlockDev.h"
+
+#include "main.h"
+#include "SD.h"
+
+#if SD_EVENT_DONE != BLOCKDEV_EVENT_DONE
+#error "SD_EVENT_DONE and BLOCKDEV_EVENT_DONE must be the same event"
+#endif
+
+#if SD_BLOCK_SIZE != BLOCKDEV_SECTOR_SIZE
+#error "SD_BLOCK_SIZE and BLOCKDEV_SECTOR_SIZE differ"
+#endif
+
+static BlockDev_Status_t BlockDev_FromSd(SD_Status_t status)
+{
+    switch (status)
+    {
+    case SD_OK:
+        return BLOCKDEV_OK;
+    case SD_BUSY:
+        return BLOCKDEV_BUSY;
+    case SD_TIMEOUT:
+        return BLOCKDEV_TIMEOUT;
+    case SD_INVALID_PARAM:
+        return BLOCKDEV_INVALID_PARAM;
+    case SD_NO_CARD:
+        return BLOCKDEV_NO_MEDIA;
+    default:
+        return BLOCKDEV_ERROR;
+    }
+}
+
+// Request of the running BlockDev_ReadAsync() transfer, NULL for any other
+static BlockDev_Request_t *BlockDev_Owner = NULL;
+
+/**
+ * @brief Hand the result of an ended transfer to the request it was started with
+ * @note Every call below runs this first, so the result is stored before the next transfer starts
+ */
+static void BlockDev_Settle(void)
+{
+    BlockDev_Request_t *req = BlockDev_Owner;
+
+    if (req == NULL || SD_IsBusy())
+        return;
+
+    BlockDev_Owner = NULL;
+    req->Result = BlockDev_FromSd(SD_GetResult());
+    req->EndTick = HAL_GetTick();
+    req->Done = true;
+}
+
+BlockDev_Status_t BlockDev_Init(void)
+{
+    if (!SD_IsInserted())
+        return BLOCKDEV_NO_MEDIA;
+    return BlockDev_FromSd(SD_Init());
+}
+
+uint32_t BlockDev_GetSectorCount(void)
+{
+    return SD_GetSectorCount();
+}
+
+BlockDev_Status_t BlockDev_Read(uint32_t sector, uint8_t *buf, uint32_t count)
+{
+    BlockDev_Settle();
+    return BlockDev_FromSd(SD_ReadBlocks(sector, buf, count));
+}
+
+BlockDev_Status_t BlockDev_ReadAsync(uint32_t sector, uint8_t *buf, uint32_t count, BlockDev_Request_t *req)
+{
+    BlockDev_Status_t ret = BLOCKDEV_OK;
+
+    if (req == NULL)
+        return BLOCKDEV_INVALID_PARAM;
+
+    BlockDev_Settle();
+    req->Done = false;
+    req->Result = BLOCKDEV_BUSY;
+    ret = BlockDev_FromSd(SD_ReadBlocks(sector, buf, count));
+    if (ret == BLOCKDEV_OK)
+        BlockDev_Owner = req;
+    return ret;
+}
+
+BlockDev_Status_t BlockDev_Write(uint32_t sector, const uint8_t *buf, uint32_t count)
+{
+    BlockDev_Settle();
+    return BlockDev_FromSd(SD_WriteBlocks(sector, buf, count));
+}
+
+BlockDev_Status_t BlockDev_WriteList(uint32_t sector, const uint8_t *const *list, uint32_t count)
+{
+    BlockDev_Settle();
+    return BlockDev_FromSd(SD_WriteBlockList(sector, list, count));
+}
+
+bool BlockDev_IsBusy(void)
+{
+    BlockDev_Settle();
+    return SD_IsBusy();
+}
+
+BlockDev_Status_t BlockDev_GetResult(void)
+{
+    BlockDev_Settle();
+    return BlockDev_FromSd(SD_GetResult());
+}
+
+BlockDev_Status_t BlockDev_WaitIdle(uint32_t timeout_ms)
+{
+    BlockDev_Status_t ret = BlockDev_FromSd(SD_WaitIdle(timeout_ms));
+
+    BlockDev_Settle();
+    return ret;
+}
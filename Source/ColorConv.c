@@ -0,0 +1,172 @@
+#include "ColorConv.h"
+
+#include "main.h"
+#include "math.h"
+
+#if defined(__ARM_FEATURE_DSP) && (__ARM_FEATURE_DSP == 1) && !defined(COLORCONV_NO_SIMD)
+#define COLORCONV_SIMD 1
+#else
+#define COLORCONV_SIMD 0
+#endif
+
+typedef struct
+{
+    uint8_t Lut[3][256];   // Gamma and gain per channel
+    uint32_t Dither[4][4]; // Thresholds per screen row and column, packed like a pixel: R | G << 8 | B << 16
+    bool Enabled;
+} ColorConv_Handle_t;
+
+static ColorConv_Handle_t ColorConv = {0};
+
+static const uint32_t ColorConv_NoDither[4] = {0};
+
+// 4x4 Bayer matrix, 0..15
+static const uint8_t ColorConv_Bayer[4][4] = {
+    {0, 8, 2, 10},
+    {12, 4, 14, 6},
+    {3, 11, 1, 9},
+    {15, 7, 13, 5},
+};
+
+// Thresholds in units of the 5-bit (step 8) and 6-bit (step 4) quantizer
+#define COLORCONV_D5(b) ((uint32_t)(b) >> 1)
+#define COLORCONV_D6(b) ((uint32_t)(b) >> 2)
+
+/**
+ * @brief Table lookup, dither and pack of one pixel
+ */
+static inline uint16_t ColorConv_Pixel(const uint8_t *s, uint32_t dither)
+{
+    uint32_t v = ColorConv.Lut[0][s[0]] | ((uint32_t)ColorConv.Lut[1][s[1]] << 8) | ((uint32_t)ColorConv.Lut[2][s[2]] << 16);
+
+#if COLORCONV_SIMD
+    v = __UQADD8(v, dither);
+#else
+    {
+        // Dither bytes are below 0x80, so only a carry out of a byte with its top bit set can overflow
+        uint32_t hi = v & 0x80808080UL;
+        uint32_t t = (v & 0x7F7F7F7FUL) + dither;
+
+        v = (t ^ hi) | (((hi & t) >> 7) * 0xFF);
+    }
+#endif
+
+    return (uint16_t)(((v << 8) & 0xF800) | ((v >> 5) & 0x07E0) | ((v >> 19) & 0x001F));
+}
+
+void ColorConv_Init(void)
+{
+    for (uint32_t i = 0; i < 256; i++)
+    {
+        ColorConv.Lut[0][i] = (uint8_t)i;
+        ColorConv.Lut[1][i] = (uint8_t)i;
+        ColorConv.Lut[2][i] = (uint8_t)i;
+    }
+
+    for (uint8_t y = 0; y < 4; y++)
+    {
+        for (uint8_t x = 0; x < 4; x++)
+        {
+            uint8_t b = ColorConv_Bayer[y][x];
+
+            ColorConv.Dither[y][x] = COLORCONV_D5(b) | (COLORCONV_D6(b) << 8) | (COLORCONV_D5(b) << 16);
+        }
+    }
+
+    ColorConv.Enabled = true;
+}
+
+ColorConv_Status_t ColorConv_SetCurve(ColorConv_Channel_t channel, float gamma, uint8_t gain)
+{
+    uint8_t first = (uint8_t)channel;
+    uint8_t last = (uint8_t)channel;
+
+    // Also rejects NaN
+    if (channel > COLORCONV_ALL || !(gamma >= 0.1f && gamma <= 10.0f))
+        return COLORCONV_INVALID_PARAM;
+
+    if (channel == COLORCONV_ALL)
+    {
+        first = COLORCONV_RED;
+        last = COLORCONV_BLUE;
+    }
+
+    for (uint32_t i = 0; i < 256; i++)
+    {
+        uint8_t v = (uint8_t)(gain * powf(i / 255.0f, gamma) + 0.5f);
+
+        for (uint8_t c = first; c <= last; c++)
+        {
+            ColorConv.Lut[c][i] = v;
+        }
+    }
+
+    return COLORCONV_OK;
+}
+
+void ColorConv_SetDither(bool enable)
+{
+    ColorConv.Enabled = enable;
+}
+
+void ColorConv_Convert(uint16_t *dst, uint16_t dst_stride, const uint8_t *src, uint32_t src_stride,
+                       uint16_t w, uint16_t h, uint16_t x, uint16_t y)
+{
+    for (uint16_t row = 0; row < h; row++)
+    {
+        const uint32_t *dither = ColorConv.Enabled ? ColorConv.Dither[(y + row) & 3] : ColorConv_NoDither;
+        const uint8_t *s = src;
+        uint16_t *d = dst;
+        uint16_t n = w;
+        uint16_t px = x;
+        uint32_t *dw = NULL;
+
+        if (((uintptr_t)d & 2) && n > 0)
+        {
+            *d++ = ColorConv_Pixel(s, dither[px & 3]);
+            s += 3;
+            px++;
+            n--;
+        }
+
+        dw = (uint32_t *)d;
+        while (n >= 2)
+        {
+            uint32_t p0 = ColorConv_Pixel(s, dither[px & 3]);
+            uint32_t p1 = ColorConv_Pixel(s + 3, dither[(px + 1) & 3]);
+
+            *dw++ = p0 | (p1 << 16);
+            s += 6;
+            px += 2;
+            n -= 2;
+        }
+
+        d = (uint16_t *)dw;
+        if (n > 0)
+            *d = ColorConv_Pixel(s, dither[px & 3]);
+
+        dst += dst_stride;
+        src += src_stride;
+    }
+}
+
+void ColorConv_Convert_Ref(uint16_t *dst, uint16_t dst_stride, const uint8_t *src, uint32_t src_stride,
+                           uint16_t w, uint16_t h, uint16_t x, uint16_t y)
+{
+    for (uint16_t row = 0; row < h; row++)
+    {
+        for (uint16_t col = 0; col < w; col++)
+        {
+            const uint8_t *s = &src[row * src_stride + col * 3u];
+            uint32_t b = ColorConv.Enabled ? ColorConv_Bayer[(y + row) & 3][(x + col) & 3] : 0;
+            uint32_t r5 = ColorConv.Lut[0][s[0]] + COLORCONV_D5(b);
+            uint32_t g6 = ColorConv.Lut[1][s[1]] + COLORCONV_D6(b);
+            uint32_t b5 = ColorConv.Lut[2][s[2]] + COLORCONV_D5(b);
+
+            r5 = (r5 > 255 ? 255 : r5) >> 3;
+            g6 = (g6 > 255 ? 255 : g6) >> 2;
+            b5 = (b5 > 255 ? 255 : b5) >> 3;
+            dst[(uint32_t)row * dst_stride + col] = (uint16_t)((r5 << 11) | (g6 << 5) | b5);
+        }
+    }
+}
@@ -0,0 +1,241 @@
+#include "Dirty.h"
+
+#include "main.h"
+
+typedef struct
+{
+    LCD_Rect_t Pending[DIRTY_MAX_RECTS]; // Collected since the last Dirty_Start()
+    uint8_t PendingNum;
+    LCD_Rect_t Flushing[DIRTY_MAX_RECTS]; // Snapshot being sent
+    uint8_t FlushingNum;
+    uint8_t FlushIndex; // Next rectangle to hand to Render
+    bool Active;
+    Render_DrawFunction_t Draw;
+    void *Userdata;
+} Dirty_Handle_t;
+
+static Dirty_Handle_t Dirty = {0};
+
+static uint32_t Dirty_Area(const LCD_Rect_t *r)
+{
+    return (uint32_t)r->w * r->h;
+}
+
+static LCD_Rect_t Dirty_Union(const LCD_Rect_t *a, const LCD_Rect_t *b)
+{
+    LCD_Rect_t u;
+    uint16_t x1 = (a->x + a->w > b->x + b->w) ? a->x + a->w : b->x + b->w;
+    uint16_t y1 = (a->y + a->h > b->y + b->h) ? a->y + a->h : b->y + b->h;
+
+    u.x = (a->x < b->x) ? a->x : b->x;
+    u.y = (a->y < b->y) ? a->y : b->y;
+    u.w = x1 - u.x;
+    u.h = y1 - u.y;
+    return u;
+}
+
+static uint32_t Dirty_Overlap(const LCD_Rect_t *a, const LCD_Rect_t *b)
+{
+    int32_t x0 = (a->x > b->x) ? a->x : b->x;
+    int32_t y0 = (a->y > b->y) ? a->y : b->y;
+    int32_t x1 = (a->x + a->w < b->x + b->w) ? a->x + a->w : b->x + b->w;
+    int32_t y1 = (a->y + a->h < b->y + b->h) ? a->y + a->h : b->y + b->h;
+
+    if (x1 <= x0 || y1 <= y0)
+        return 0;
+    return (uint32_t)(x1 - x0) * (uint32_t)(y1 - y0);
+}
+
+/**
+ * @brief Pixels that would be sent needlessly if a and b were replaced by their bounding box
+ */
+static uint32_t Dirty_Waste(const LCD_Rect_t *a, const LCD_Rect_t *b)
+{
+    LCD_Rect_t u = Dirty_Union(a, b);
+    uint32_t covered = Dirty_Area(a) + Dirty_Area(b) - Dirty_Overlap(a, b);
+
+    return Dirty_Area(&u) - covered;
+}
+
+static bool Dirty_ShouldMerge(const LCD_Rect_t *a, const LCD_Rect_t *b)
+{
+    LCD_Rect_t u = Dirty_Union(a, b);
+    uint32_t area = Dirty_Area(&u);
+    uint32_t waste = Dirty_Waste(a, b);
+
+    if (waste <= DIRTY_WINDOW_COST)
+        return true;
+    return (area - waste) * 100 >= area * DIRTY_MERGE_COVERAGE;
+}
+
+static void Dirty_Remove(uint8_t index)
+{
+    Dirty.PendingNum--;
+    Dirty.Pending[index] = Dirty.Pending[Dirty.PendingNum];
+}
+
+void Dirty_Invalidate(const LCD_Rect_t *rect)
+{
+    LCD_Rect_t r;
+    uint8_t i = 0;
+    uint8_t best = 0;
+    uint32_t best_waste = 0xFFFFFFFF;
+
+    if (rect == NULL || rect->w == 0 || rect->h == 0 || rect->x >= LCD_WIDTH || rect->y >= LCD_HEIGHT)
+        return;
+
+    r = *rect;
+    if (r.x + r.w > LCD_WIDTH)
+        r.w = LCD_WIDTH - r.x;
+    if (r.y + r.h > LCD_HEIGHT)
+        r.h = LCD_HEIGHT - r.y;
+
+    // A merged rectangle can now reach others, so keep merging until nothing changes
+    i = 0;
+    while (i < Dirty.PendingNum)
+    {
+        if (Dirty_ShouldMerge(&r, &Dirty.Pending[i]))
+        {
+            r = Dirty_Union(&r, &Dirty.Pending[i]);
+            Dirty_Remove(i);
+            i = 0;
+            continue;
+        }
+        i++;
+    }
+
+    if (Dirty.PendingNum < DIRTY_MAX_RECTS)
+    {
+        Dirty.Pending[Dirty.PendingNum++] = r;
+        return;
+    }
+
+    // List full: fold into the cheapest neighbour
+    for (i = 0; i < Dirty.PendingNum; i++)
+    {
+        uint32_t waste = Dirty_Waste(&r, &Dirty.Pending[i]);
+        if (waste < best_waste)
+        {
+            best_waste = waste;
+            best = i;
+        }
+    }
+    r = Dirty_Union(&r, &Dirty.Pending[best]);
+    Dirty_Remove(best);
+    Dirty_Invalidate(&r);
+}
+
+void Dirty_InvalidateAll(void)
+{
+    Dirty.Pending[0].x = 0;
+    Dirty.Pending[0].y = 0;
+    Dirty.Pending[0].w = LCD_WIDTH;
+    Dirty.Pending[0].h = LCD_HEIGHT;
+    Dirty.PendingNum = 1;
+}
+
+void Dirty_Clear(void)
+{
+    Dirty.PendingNum = 0;
+}
+
+uint8_t Dirty_Count(void)
+{
+    return Dirty.PendingNum;
+}
+
+uint32_t Dirty_Pixels(void)
+{
+    uint32_t pixels = 0;
+    uint8_t i = 0;
+
+    for (i = 0; i < Dirty.PendingNum; i++)
+    {
+        pixels += Dirty_Area(&Dirty.Pending[i]);
+    }
+    return pixels;
+}
+
+Render_Status_t Dirty_Start(Render_DrawFunction_t Draw, void *Userdata)
+{
+    uint8_t i = 0;
+
+    if (Draw == NULL)
+        return RENDER_INVALID_PARAM;
+    if (Dirty.Active)
+        return RENDER_BUSY;
+
+    for (i = 0; i < Dirty.PendingNum; i++)
+    {
+        Dirty.Flushing[i] = Dirty.Pending[i];
+    }
+    Dirty.FlushingNum = Dirty.PendingNum;
+    Dirty.PendingNum = 0;
+    Dirty.FlushIndex = 0;
+    Dirty.Draw = Draw;
+    Dirty.Userdata = Userdata;
+    Dirty.Active = (Dirty.FlushingNum > 0);
+
+    return RENDER_OK;
+}
+
+Render_Status_t Dirty_Process(void)
+{
+    Render_Status_t ret = RENDER_OK;
+
+    if (!Dirty.Active)
+        return RENDER_OK;
+
+    ret = Render_Process();
+    if (ret != RENDER_OK)
+    {
+        if (ret == RENDER_ERROR)
+            Dirty.Active = false;
+        return ret;
+    }
+
+    if (Dirty.FlushIndex >= Dirty.FlushingNum)
+    {
+        Dirty.Active = false;
+        return RENDER_OK;
+    }
+
+    // Render is idle once the previous rectangle is out; start the next one
+    ret = Render_Start(&Dirty.Flushing[Dirty.FlushIndex], Dirty.Draw, Dirty.Userdata);
+    if (ret == RENDER_BUSY)
+        return RENDER_BUSY;
+    if (ret != RENDER_OK)
+    {
+        Dirty.Active = false;
+        return ret;
+    }
+    Dirty.FlushIndex++;
+
+    if (Render_Process() == RENDER_ERROR)
+    {
+        Dirty.Active = false;
+        return RENDER_ERROR;
+    }
+    return RENDER_BUSY;
+}
+
+Render_Status_t Dirty_Flush(Render_DrawFunction_t Draw, void *Userdata)
+{
+    Render_Status_t ret = Dirty_Start(Draw, Userdata);
+    uint32_t start = HAL_GetTick();
+
+    if (ret != RENDER_OK)
+        return ret;
+
+    while ((ret = Dirty_Process()) == RENDER_BUSY)
+    {
+        if (HAL_GetTick() - start >= RENDER_FRAME_TIMEOUT)
+        {
+            Render_Abort();
+            Dirty.Active = false;
+            return RENDER_TIMEOUT;
+        }
+    }
+
+    return ret;
+}
@@ -0,0 +1,864 @@
+#include "Fat.h"
+
+#include "string.h"
+#include "BlockCache.h"
+
+#if FAT_FILE_EXTENTS < 2
+#error "FAT_FILE_EXTENTS must be at least 2"
+#endif
+
+#define FAT_SECTOR_SIZE (512)
+#define FAT_SECTOR_SHIFT (9)
+#define FAT_UNKNOWN_SIZE (0xFFFFFFFFUL) // FAT32 directories have no size, they end with their chain
+
+#define FAT_ENTRY_SIZE (32)
+#define FAT_LFN_CHARS (260) // 20 LFN entries of 13 characters
+
+// FAT32 boot sector (BPB) fields
+#define FAT32_BPB_BYTES_PER_SECTOR (11)
+#define FAT32_BPB_SECTORS_PER_CLUSTER (13)
+#define FAT32_BPB_RESERVED_SECTORS (14)
+#define FAT32_BPB_FATS (16)
+#define FAT32_BPB_TOTAL_SECTORS_16 (19)
+#define FAT32_BPB_FAT_SIZE_16 (22)
+#define FAT32_BPB_TOTAL_SECTORS_32 (32)
+#define FAT32_BPB_FAT_SIZE_32 (36)
+#define FAT32_BPB_ROOT_CLUSTER (44)
+#define FAT32_MASK (0x0FFFFFFFUL)
+#define FAT32_EOC (0x0FFFFFF8UL)
+
+// exFAT boot sector fields
+#define EXFAT_BS_NAME (3)
+#define EXFAT_BS_FAT_OFFSET (80)
+#define EXFAT_BS_CLUSTER_HEAP_OFFSET (88)
+#define EXFAT_BS_CLUSTER_COUNT (92)
+#define EXFAT_BS_ROOT_CLUSTER (96)
+#define EXFAT_BS_BYTES_PER_SECTOR_SHIFT (108)
+#define EXFAT_BS_SECTORS_PER_CLUSTER_SHIFT (109)
+#define EXFAT_EOC (0xFFFFFFF8UL)
+
+// exFAT directory entry types
+#define EXFAT_ENTRY_END (0x00)
+#define EXFAT_ENTRY_FILE (0x85)
+#define EXFAT_ENTRY_STREAM (0xC0)
+#define EXFAT_ENTRY_NAME (0xC1)
+#define EXFAT_STREAM_NO_FAT_CHAIN (0x02)
+#define EXFAT_NAME_CHARS (15)
+
+// Partition tables
+#define MBR_TABLE (446)
+#define MBR_ENTRY_SIZE (16)
+#define MBR_TYPE_EXFAT (0x07)
+#define MBR_TYPE_FAT32_CHS (0x0B)
+#define MBR_TYPE_FAT32_LBA (0x0C)
+#define MBR_TYPE_GPT (0xEE)
+#define GPT_ENTRIES_LBA (72)
+#define GPT_ENTRY_COUNT (80)
+#define GPT_ENTRY_SIZE (84)
+#define GPT_ENTRY_FIRST_LBA (32)
+
+#define FAT_LFN_ATTR (0x0F)
+#define FAT_VOLUME_ATTR (0x08)
+#define FAT_LFN_LAST (0x40)
+#define FAT_DELETED (0xE5)
+
+typedef struct
+{
+    bool Mounted;
+    bool ExFat;
+    uint8_t ClusterShift;               // log2 of sectors per cluster
+    uint32_t FatStart;                  // Card sector of the first FAT
+    uint32_t DataStart;                 // Card sector of cluster 2
+    uint32_t ClusterCount;
+    uint32_t RootCluster;
+    Fat_Info_t Info;                    // Scratch entry for path lookups
+} Fat_Handle_t;
+
+static Fat_Handle_t Fat = {0};
+
+static uint16_t Fat_Lfn[FAT_LFN_CHARS]; // UTF-16 long name being collected
+
+static uint16_t Fat_Get16(const uint8_t *p)
+{
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static uint32_t Fat_Get32(const uint8_t *p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+/**
+ * @brief Get a sector through the block cache
+ * @param data Cached copy, valid until the next card access
+ */
+static Fat_Status_t Fat_LoadSector(uint32_t sector, uint8_t flags, const uint8_t **data)
+{
+    return (BlockCache_Read(sector, flags, data) == BLOCKCACHE_OK) ? FAT_OK : FAT_ERROR;
+}
+
+static uint32_t Fat_ClusterSector(uint32_t cluster)
+{
+    return Fat.DataStart + ((cluster - 2) << Fat.ClusterShift);
+}
+
+static bool Fat_IsCluster(uint32_t cluster)
+{
+    return cluster >= 2 && cluster - 2 < Fat.ClusterCount;
+}
+
+/**
+ * @brief Cluster that follows in the chain
+ * @param next Next cluster, 0 at the end of the chain
+ */
+static Fat_Status_t Fat_Next(uint32_t cluster, uint32_t *next)
+{
+    uint32_t sector = Fat.FatStart + (cluster >> 7); // 128 entries per sector
+    const uint8_t *fat = NULL;
+    uint32_t value = 0;
+
+    if (Fat_LoadSector(sector, BLOCKCACHE_PIN, &fat) != FAT_OK)
+        return FAT_ERROR;
+
+    value = Fat_Get32(&fat[(cluster & 127) * 4]);
+    if (!Fat.ExFat)
+        value &= FAT32_MASK;
+
+    if (value >= (Fat.ExFat ? EXFAT_EOC : FAT32_EOC))
+        value = 0;
+    else if (!Fat_IsCluster(value))
+        return FAT_CORRUPT;
+
+    *next = value;
+    return FAT_OK;
+}
+
+/**
+ * @brief Follow the chain from cluster while the clusters are consecutive
+ * @param after First cluster of the next run, 0 at the end of the chain
+ */
+static Fat_Status_t Fat_WalkRun(Fat_Extent_t *extent, uint32_t file_cluster, uint32_t cluster, uint32_t *after)
+{
+    Fat_Status_t ret = FAT_OK;
+    uint32_t next = 0;
+
+    extent->FileCluster = file_cluster;
+    extent->Cluster = cluster;
+    extent->Count = 1;
+
+    for (;;)
+    {
+        ret = Fat_Next(cluster, &next);
+        if (ret != FAT_OK)
+            return ret;
+        if (next != cluster + 1)
+            break;
+        cluster = next;
+        if (++extent->Count > Fat.ClusterCount)
+            return FAT_CORRUPT;
+    }
+
+    *after = next;
+    return FAT_OK;
+}
+
+/**
+ * @brief Turn the cluster chain of an opened file into extents
+ */
+static Fat_Status_t Fat_BuildExtents(Fat_File_t *file)
+{
+    uint32_t cluster = file->FirstCluster;
+    uint32_t file_cluster = 0;
+    uint8_t bits = Fat.ClusterShift + FAT_SECTOR_SHIFT;
+
+    file->Extents = 0;
+    file->Complete = true;
+
+    if (cluster == 0)
+        return FAT_OK;
+    if (!Fat_IsCluster(cluster))
+        return FAT_CORRUPT;
+
+    if (file->NoChain)
+    {
+        uint32_t count = (file->Size >> bits) + ((file->Size & ((1UL << bits) - 1)) != 0);
+
+        file->Extent[0].FileCluster = 0;
+        file->Extent[0].Cluster = cluster;
+        file->Extent[0].Count = (count > 0) ? count : 1;
+        file->Extents = 1;
+        return FAT_OK;
+    }
+
+    while (cluster != 0)
+    {
+        Fat_Status_t ret = FAT_OK;
+
+        // Out of entries: the last one stays as the sliding window of Fat_FindExtent()
+        if (file->Extents == FAT_FILE_EXTENTS)
+        {
+            file->Complete = false;
+            break;
+        }
+
+        ret = Fat_WalkRun(&file->Extent[file->Extents], file_cluster, cluster, &cluster);
+        if (ret != FAT_OK)
+            return ret;
+
+        file_cluster += file->Extent[file->Extents].Count;
+        file->Extents++;
+        if (file_cluster > Fat.ClusterCount)
+            return FAT_CORRUPT;
+    }
+
+    return FAT_OK;
+}
+
+/**
+ * @brief Extent holding a cluster of the file
+ * @return FAT_NOT_FOUND past the end of the chain
+ */
+static Fat_Status_t Fat_FindExtent(Fat_File_t *file, uint32_t file_cluster, const Fat_Extent_t **extent)
+{
+    Fat_Extent_t *window = NULL;
+    const Fat_Extent_t *from = NULL;
+    uint32_t cluster = 0;
+    uint32_t next_file_cluster = 0;
+    Fat_Status_t ret = FAT_OK;
+
+    for (uint8_t i = 0; i < file->Extents; i++)
+    {
+        const Fat_Extent_t *e = &file->Extent[i];
+
+        if (file_cluster >= e->FileCluster && file_cluster - e->FileCluster < e->Count)
+        {
+            *extent = e;
+            return FAT_OK;
+        }
+    }
+
+    if (file->Complete || file->Extents < 2)
+        return FAT_NOT_FOUND;
+
+    // Slide the last extent along the chain, restarting behind the one before it when seeking back
+    window = &file->Extent[file->Extents - 1];
+    from = (file_cluster < window->FileCluster) ? &file->Extent[file->Extents - 2] : window;
+    next_file_cluster = from->FileCluster + from->Count;
+    ret = Fat_Next(from->Cluster + from->Count - 1, &cluster);
+
+    while (ret == FAT_OK)
+    {
+        if (cluster == 0)
+            return FAT_NOT_FOUND;
+
+        ret = Fat_WalkRun(window, next_file_cluster, cluster, &cluster);
+        if (ret == FAT_OK && file_cluster < window->FileCluster + window->Count)
+        {
+            *extent = window;
+            return FAT_OK;
+        }
+        next_file_cluster = window->FileCluster + window->Count;
+    }
+
+    return ret;
+}
+
+/**
+ * @brief UTF-16 name to UTF-8, cut at FAT_NAME_MAX
+ */
+static void Fat_PutName(char *out, const uint16_t *name, uint16_t length)
+{
+    uint16_t o = 0;
+
+    for (uint16_t i = 0; i < length && name[i] != 0; i++)
+    {
+        uint32_t c = name[i];
+        uint8_t bytes = 0;
+
+        // Surrogate pair
+        if (c >= 0xD800 && c < 0xDC00 && i + 1 < length && name[i + 1] >= 0xDC00 && name[i + 1] < 0xE000)
+        {
+            c = 0x10000 + ((c - 0xD800) << 10) + (name[i + 1] - 0xDC00);
+            i++;
+        }
+
+        bytes = (c < 0x80) ? 1 : (c < 0x800) ? 2 : (c < 0x10000) ? 3 : 4;
+        if (o + bytes >= FAT_NAME_MAX)
+            break;
+
+        switch (bytes)
+        {
+        case 1:
+            out[o++] = (char)c;
+            break;
+        case 2:
+            out[o++] = (char)(0xC0 | (c >> 6));
+            out[o++] = (char)(0x80 | (c & 0x3F));
+            break;
+        case 3:
+            out[o++] = (char)(0xE0 | (c >> 12));
+            out[o++] = (char)(0x80 | ((c >> 6) & 0x3F));
+            out[o++] = (char)(0x80 | (c & 0x3F));
+            break;
+        default:
+            out[o++] = (char)(0xF0 | (c >> 18));
+            out[o++] = (char)(0x80 | ((c >> 12) & 0x3F));
+            out[o++] = (char)(0x80 | ((c >> 6) & 0x3F));
+            out[o++] = (char)(0x80 | (c & 0x3F));
+            break;
+        }
+    }
+    out[o] = '\0';
+}
+
+/**
+ * @brief 8.3 name of a FAT32 entry, with the NT lower case flags applied
+ */
+static void Fat_ShortName(char *out, const uint8_t *entry)
+{
+    uint8_t o = 0;
+    bool lower_base = (entry[12] & 0x08) != 0;
+    bool lower_ext = (entry[12] & 0x10) != 0;
+
+    for (uint8_t i = 0; i < 8 && entry[i] != ' '; i++)
+    {
+        char c = (i == 0 && entry[0] == 0x05) ? (char)FAT_DELETED : (char)entry[i];
+
+        out[o++] = (lower_base && c >= 'A' && c <= 'Z') ? (char)(c + 32) : c;
+    }
+    if (entry[8] != ' ')
+    {
+        out[o++] = '.';
+        for (uint8_t i = 8; i < 11 && entry[i] != ' '; i++)
+        {
+            char c = (char)entry[i];
+
+            out[o++] = (lower_ext && c >= 'A' && c <= 'Z') ? (char)(c + 32) : c;
+        }
+    }
+    out[o] = '\0';
+}
+
+static uint8_t Fat_ShortNameSum(const uint8_t *entry)
+{
+    uint8_t sum = 0;
+
+    for (uint8_t i = 0; i < 11; i++)
+    {
+        sum = (uint8_t)(((sum & 1) << 7) + (sum >> 1) + entry[i]);
+    }
+    return sum;
+}
+
+/**
+ * @brief Next 32-byte directory entry
+ * @return FAT_NOT_FOUND at the end of the directory
+ */
+static Fat_Status_t Fat_ReadEntry(Fat_File_t *dir, uint8_t *entry)
+{
+    uint32_t read = 0;
+    Fat_Status_t ret = Fat_Read(dir, entry, FAT_ENTRY_SIZE, &read);
+
+    if (ret != FAT_OK)
+        return ret;
+    if (read < FAT_ENTRY_SIZE)
+        return FAT_NOT_FOUND;
+
+    if (entry[0] == 0x00)
+    {
+        // End marker: stay on it so further calls also report the end
+        dir->Pos -= FAT_ENTRY_SIZE;
+        return FAT_NOT_FOUND;
+    }
+    return FAT_OK;
+}
+
+static Fat_Status_t Fat_ReadDirFat32(Fat_File_t *dir, Fat_Info_t *info)
+{
+    uint8_t entry[FAT_ENTRY_SIZE];
+    uint8_t sum = 0;
+    uint8_t expect = 0; // Sequence number of the next LFN entry, 0 once complete
+    uint16_t length = 0;
+    bool lfn = false;
+
+    for (;;)
+    {
+        Fat_Status_t ret = Fat_ReadEntry(dir, entry);
+
+        if (ret != FAT_OK)
+            return ret;
+
+        if (entry[0] == FAT_DELETED)
+        {
+            lfn = false;
+            continue;
+        }
+
+        if ((entry[11] & 0x3F) == FAT_LFN_ATTR)
+        {
+            uint8_t seq = entry[0] & 0x1F;
+            static const uint8_t offsets[13] = {1, 3, 5, 7, 9, 14, 16, 18, 20, 22, 24, 28, 30};
+
+            if (entry[0] & FAT_LFN_LAST)
+            {
+                lfn = (seq > 0 && seq * 13 <= FAT_LFN_CHARS);
+                sum = entry[13];
+                length = seq * 13;
+            }
+            else if (!lfn || seq == 0 || seq != expect || entry[13] != sum)
+            {
+                lfn = false;
+            }
+
+            if (lfn)
+            {
+                for (uint8_t i = 0; i < 13; i++)
+                {
+                    Fat_Lfn[(seq - 1) * 13 + i] = Fat_Get16(&entry[offsets[i]]);
+                }
+                expect = seq - 1;
+            }
+            continue;
+        }
+
+        if (entry[11] & FAT_VOLUME_ATTR)
+        {
+            lfn = false;
+            continue;
+        }
+
+        // "." and ".."
+        if (entry[0] == '.')
+        {
+            lfn = false;
+            continue;
+        }
+
+        if (lfn && expect == 0 && Fat_ShortNameSum(entry) == sum)
+            Fat_PutName(info->Name, Fat_Lfn, length);
+        else
+            Fat_ShortName(info->Name, entry);
+
+        info->Attr = entry[11];
+        info->Size = Fat_Get32(&entry[28]);
+        info->FirstCluster = ((uint32_t)Fat_Get16(&entry[20]) << 16) | Fat_Get16(&entry[26]);
+        info->NoChain = false;
+        return FAT_OK;
+    }
+}
+
+static Fat_Status_t Fat_ReadDirExFat(Fat_File_t *dir, Fat_Info_t *info)
+{
+    uint8_t entry[FAT_ENTRY_SIZE];
+
+    for (;;)
+    {
+        Fat_Status_t ret = Fat_ReadEntry(dir, entry);
+        uint8_t secondary = 0;
+        uint8_t name_length = 0;
+        uint16_t chars = 0;
+        uint32_t size_high = 0;
+
+        if (ret != FAT_OK)
+            return ret;
+        if (entry[0] != EXFAT_ENTRY_FILE)
+            continue;
+
+        secondary = entry[1];
+        info->Attr = (uint8_t)Fat_Get16(&entry[4]);
+
+        ret = Fat_ReadEntry(dir, entry);
+        if (ret != FAT_OK)
+            return ret;
+        if (entry[0] != EXFAT_ENTRY_STREAM || secondary < 2)
+            continue;
+
+        info->NoChain = (entry[1] & EXFAT_STREAM_NO_FAT_CHAIN) != 0;
+        name_length = entry[3];
+        info->FirstCluster = Fat_Get32(&entry[20]);
+        info->Size = Fat_Get32(&entry[24]);
+        size_high = Fat_Get32(&entry[28]);
+        // Files of 4 GiB and more are cut
+        if (size_high != 0 || info->Size == FAT_UNKNOWN_SIZE)
+            info->Size = FAT_UNKNOWN_SIZE - 1;
+
+        for (uint8_t s = 1; s < secondary; s++)
+        {
+            ret = Fat_ReadEntry(dir, entry);
+            if (ret != FAT_OK)
+                return ret;
+            if (entry[0] != EXFAT_ENTRY_NAME)
+                continue;
+
+            for (uint8_t i = 0; i < EXFAT_NAME_CHARS && chars < name_length && chars < FAT_LFN_CHARS; i++)
+            {
+                Fat_Lfn[chars++] = Fat_Get16(&entry[2 + i * 2]);
+            }
+        }
+
+        Fat_PutName(info->Name, Fat_Lfn, chars);
+        return FAT_OK;
+    }
+}
+
+static bool Fat_NameEqual(const char *name, const char *segment, uint32_t length)
+{
+    for (uint32_t i = 0; i < length; i++)
+    {
+        char a = name[i];
+        char b = segment[i];
+
+        if (a == '\0')
+            return false;
+        if (a >= 'a' && a <= 'z')
+            a = (char)(a - 32);
+        if (b >= 'a' && b <= 'z')
+            b = (char)(b - 32);
+        if (a != b)
+            return false;
+    }
+    return name[length] == '\0';
+}
+
+static bool Fat_IsFat32(const uint8_t *bs)
+{
+    uint8_t spc = bs[FAT32_BPB_SECTORS_PER_CLUSTER];
+
+    return (bs[0] == 0xEB || bs[0] == 0xE9) && Fat_Get16(&bs[FAT32_BPB_BYTES_PER_SECTOR]) == FAT_SECTOR_SIZE &&
+           spc != 0 && (spc & (spc - 1)) == 0 && bs[FAT32_BPB_FATS] != 0 &&
+           Fat_Get16(&bs[FAT32_BPB_FAT_SIZE_16]) == 0 && Fat_Get32(&bs[FAT32_BPB_FAT_SIZE_32]) != 0;
+}
+
+static bool Fat_IsExFatBoot(const uint8_t *bs)
+{
+    return memcmp(&bs[EXFAT_BS_NAME], "EXFAT   ", 8) == 0 && bs[EXFAT_BS_BYTES_PER_SECTOR_SHIFT] == FAT_SECTOR_SHIFT &&
+           bs[EXFAT_BS_SECTORS_PER_CLUSTER_SHIFT] <= 16;
+}
+
+static bool Fat_HasSignature(const uint8_t *sector)
+{
+    return sector[510] == 0x55 && sector[511] == 0xAA;
+}
+
+/**
+ * @brief Start of the first FAT32/exFAT partition
+ * @param mbr Sector 0
+ */
+static Fat_Status_t Fat_FindPartition(const uint8_t *mbr, uint32_t *start)
+{
+    const uint8_t *table = &mbr[MBR_TABLE];
+    const uint8_t *sector = NULL;
+
+    if (!Fat_HasSignature(mbr))
+        return FAT_NO_FS;
+
+    if (Fat_IsFat32(mbr) || Fat_IsExFatBoot(mbr))
+    {
+        *start = 0;
+        return FAT_OK;
+    }
+
+    if (table[4] == MBR_TYPE_GPT)
+    {
+        uint32_t entries = 0;
+        uint32_t count = 0;
+        uint32_t size = 0;
+
+        if (Fat_LoadSector(1, 0, &sector) != FAT_OK)
+            return FAT_ERROR;
+        if (memcmp(sector, "EFI PART", 8) != 0)
+            return FAT_NO_FS;
+
+        entries = Fat_Get32(&sector[GPT_ENTRIES_LBA]);
+        count = Fat_Get32(&sector[GPT_ENTRY_COUNT]);
+        size = Fat_Get32(&sector[GPT_ENTRY_SIZE]);
+        if (size < 128 || size > FAT_SECTOR_SIZE || count == 0)
+            return FAT_NO_FS;
+
+        // First used entry of the first table sector
+        if (Fat_LoadSector(entries, 0, &sector) != FAT_OK)
+            return FAT_ERROR;
+        for (uint32_t i = 0; i < count && (i + 1) * size <= FAT_SECTOR_SIZE; i++)
+        {
+            const uint8_t *e = &sector[i * size];
+            static const uint8_t unused[16] = {0};
+
+            if (memcmp(e, unused, sizeof(unused)) != 0)
+            {
+                *start = Fat_Get32(&e[GPT_ENTRY_FIRST_LBA]);
+                return FAT_OK;
+            }
+        }
+        return FAT_NO_FS;
+    }
+
+    for (uint8_t i = 0; i < 4; i++)
+    {
+        const uint8_t *e = &table[i * MBR_ENTRY_SIZE];
+
+        if (e[4] == MBR_TYPE_FAT32_CHS || e[4] == MBR_TYPE_FAT32_LBA || e[4] == MBR_TYPE_EXFAT)
+        {
+            *start = Fat_Get32(&e[8]);
+            return FAT_OK;
+        }
+    }
+    return FAT_NO_FS;
+}
+
+Fat_Status_t Fat_Mount(void)
+{
+    uint32_t start = 0;
+    Fat_Status_t ret = FAT_OK;
+    const uint8_t *bs = NULL;
+
+    Fat.Mounted = false;
+
+    if (Fat_LoadSector(0, 0, &bs) != FAT_OK)
+        return FAT_ERROR;
+    ret = Fat_FindPartition(bs, &start);
+    if (ret != FAT_OK)
+        return ret;
+    if (Fat_LoadSector(start, 0, &bs) != FAT_OK)
+        return FAT_ERROR;
+
+    if (Fat_IsExFatBoot(bs))
+    {
+        Fat.ExFat = true;
+        Fat.ClusterShift = bs[EXFAT_BS_SECTORS_PER_CLUSTER_SHIFT];
+        Fat.FatStart = start + Fat_Get32(&bs[EXFAT_BS_FAT_OFFSET]);
+        Fat.DataStart = start + Fat_Get32(&bs[EXFAT_BS_CLUSTER_HEAP_OFFSET]);
+        Fat.ClusterCount = Fat_Get32(&bs[EXFAT_BS_CLUSTER_COUNT]);
+        Fat.RootCluster = Fat_Get32(&bs[EXFAT_BS_ROOT_CLUSTER]);
+    }
+    else if (Fat_IsFat32(bs) && Fat_HasSignature(bs))
+    {
+        uint8_t spc = bs[FAT32_BPB_SECTORS_PER_CLUSTER];
+        uint32_t reserved = Fat_Get16(&bs[FAT32_BPB_RESERVED_SECTORS]);
+        uint32_t fats = bs[FAT32_BPB_FATS] * Fat_Get32(&bs[FAT32_BPB_FAT_SIZE_32]);
+        uint32_t total = Fat_Get16(&bs[FAT32_BPB_TOTAL_SECTORS_16]);
+
+        if (total == 0)
+            total = Fat_Get32(&bs[FAT32_BPB_TOTAL_SECTORS_32]);
+        if (total <= reserved + fats)
+            return FAT_NO_FS;
+
+        Fat.ExFat = false;
+        Fat.ClusterShift = 0;
+        while ((1U << Fat.ClusterShift) < spc)
+        {
+            Fat.ClusterShift++;
+        }
+        Fat.FatStart = start + reserved;
+        Fat.DataStart = Fat.FatStart + fats;
+        Fat.ClusterCount = (total - reserved - fats) >> Fat.ClusterShift;
+        Fat.RootCluster = Fat_Get32(&bs[FAT32_BPB_ROOT_CLUSTER]);
+    }
+    else
+    {
+        return FAT_NO_FS;
+    }
+
+    if (!Fat_IsCluster(Fat.RootCluster))
+        return FAT_CORRUPT;
+
+    Fat.Mounted = true;
+    return FAT_OK;
+}
+
+bool Fat_IsExFat(void)
+{
+    return Fat.ExFat;
+}
+
+uint32_t Fat_GetClusterSize(void)
+{
+    return Fat.Mounted ? (uint32_t)FAT_SECTOR_SIZE << Fat.ClusterShift : 0;
+}
+
+Fat_Status_t Fat_OpenInfo(Fat_File_t *file, const Fat_Info_t *info)
+{
+    if (file == NULL || info == NULL)
+        return FAT_INVALID_PARAM;
+    if (!Fat.Mounted)
+        return FAT_NO_FS;
+
+    file->FirstCluster = info->FirstCluster;
+    file->Attr = info->Attr;
+    file->NoChain = info->NoChain;
+    file->Pos = 0;
+    file->Size = info->Size;
+    if ((info->Attr & FAT_ATTR_DIRECTORY) && !Fat.ExFat)
+        file->Size = FAT_UNKNOWN_SIZE;
+
+    return Fat_BuildExtents(file);
+}
+
+Fat_Status_t Fat_Open(Fat_File_t *file, const char *path)
+{
+    Fat_Status_t ret = FAT_OK;
+
+    if (file == NULL || path == NULL)
+        return FAT_INVALID_PARAM;
+    if (!Fat.Mounted)
+        return FAT_NO_FS;
+
+    // Root directory
+    Fat.Info.FirstCluster = Fat.RootCluster;
+    Fat.Info.Attr = FAT_ATTR_DIRECTORY;
+    Fat.Info.NoChain = false;
+    Fat.Info.Size = FAT_UNKNOWN_SIZE;
+    ret = Fat_OpenInfo(file, &Fat.Info);
+
+    while (ret == FAT_OK)
+    {
+        const char *segment = NULL;
+        uint32_t length = 0;
+
+        while (*path == '/')
+        {
+            path++;
+        }
+        if (*path == '\0')
+            break;
+
+        segment = path;
+        while (*path != '\0' && *path != '/')
+        {
+            path++;
+        }
+        length = (uint32_t)(path - segment);
+
+        if ((file->Attr & FAT_ATTR_DIRECTORY) == 0)
+            return FAT_NOT_FOUND;
+
+        do
+        {
+            ret = Fat_ReadDir(file, &Fat.Info);
+        } while (ret == FAT_OK && !Fat_NameEqual(Fat.Info.Name, segment, length));
+
+        if (ret == FAT_OK)
+            ret = Fat_OpenInfo(file, &Fat.Info);
+    }
+
+    return ret;
+}
+
+Fat_Status_t Fat_GetRun(Fat_File_t *file, uint32_t pos, uint32_t *sector, uint32_t *count)
+{
+    const Fat_Extent_t *extent = NULL;
+    uint32_t file_cluster = 0;
+    uint32_t in_cluster = 0;
+    uint32_t left = 0;
+    Fat_Status_t ret = FAT_OK;
+
+    if (file == NULL || sector == NULL || count == NULL || pos >= file->Size)
+        return FAT_INVALID_PARAM;
+    if (!Fat.Mounted)
+        return FAT_NO_FS;
+
+    file_cluster = pos >> (Fat.ClusterShift + FAT_SECTOR_SHIFT);
+    ret = Fat_FindExtent(file, file_cluster, &extent);
+    if (ret != FAT_OK)
+        return ret;
+
+    in_cluster = (pos >> FAT_SECTOR_SHIFT) & ((1UL << Fat.ClusterShift) - 1);
+    *sector = Fat_ClusterSector(extent->Cluster + (file_cluster - extent->FileCluster)) + in_cluster;
+    *count = ((extent->Count - (file_cluster - extent->FileCluster)) << Fat.ClusterShift) - in_cluster;
+
+    // Not past the last sector of the file
+    left = ((file->Size - 1) >> FAT_SECTOR_SHIFT) - (pos >> FAT_SECTOR_SHIFT) + 1;
+    if (*count > left)
+        *count = left;
+    return FAT_OK;
+}
+
+Fat_Status_t Fat_Read(Fat_File_t *file, void *buf, uint32_t len, uint32_t *read)
+{
+    uint8_t *dst = (uint8_t *)buf;
+    uint32_t done = 0;
+
+    if (read != NULL)
+        *read = 0;
+    if (file == NULL || (buf == NULL && len > 0))
+        return FAT_INVALID_PARAM;
+    if (!Fat.Mounted)
+        return FAT_NO_FS;
+
+    if (file->Pos >= file->Size)
+        return FAT_OK;
+    if (len > file->Size - file->Pos)
+        len = file->Size - file->Pos;
+
+    while (done < len)
+    {
+        uint32_t offset = file->Pos & (FAT_SECTOR_SIZE - 1);
+        uint32_t sector = 0;
+        uint32_t count = 0;
+        uint32_t n = 0;
+        Fat_Status_t ret = Fat_GetRun(file, file->Pos, &sector, &count);
+
+        if (ret == FAT_NOT_FOUND)
+        {
+            // The end of a directory chain; a file must not end before its size
+            if (file->Size == FAT_UNKNOWN_SIZE)
+                break;
+            ret = FAT_CORRUPT;
+        }
+        if (ret != FAT_OK)
+            return ret;
+
+        if (offset != 0 || len - done < FAT_SECTOR_SIZE)
+        {
+            n = FAT_SECTOR_SIZE - offset;
+            if (n > len - done)
+                n = len - done;
+            const uint8_t *data = NULL;
+
+            // Directory sectors are read over and over while browsing
+            if (Fat_LoadSector(sector, (file->Attr & FAT_ATTR_DIRECTORY) ? BLOCKCACHE_PIN : 0, &data) != FAT_OK)
+                return FAT_ERROR;
+            memcpy(dst, &data[offset], n);
+        }
+        else
+        {
+            // Whole sectors of one extent: one multi-block read straight into the caller's buffer
+            if (count > (len - done) >> FAT_SECTOR_SHIFT)
+                count = (len - done) >> FAT_SECTOR_SHIFT;
+            if (BlockCache_ReadBlocks(sector, dst, count) != BLOCKCACHE_OK)
+                return FAT_ERROR;
+            n = count << FAT_SECTOR_SHIFT;
+        }
+
+        dst += n;
+        done += n;
+        file->Pos += n;
+        if (read != NULL)
+            *read = done;
+    }
+
+    return FAT_OK;
+}
+
+Fat_Status_t Fat_Seek(Fat_File_t *file, uint32_t pos)
+{
+    if (file == NULL)
+        return FAT_INVALID_PARAM;
+
+    file->Pos = (pos < file->Size) ? pos : file->Size;
+    return FAT_OK;
+}
+
+bool Fat_IsContiguous(const Fat_File_t *file)
+{
+    return file != NULL && file->Complete && file->Extents <= 1;
+}
+
+Fat_Status_t Fat_ReadDir(Fat_File_t *dir, Fat_Info_t *info)
+{
+    if (dir == NULL || info == NULL || (dir->Attr & FAT_ATTR_DIRECTORY) == 0)
+        return FAT_INVALID_PARAM;
+    if (!Fat.Mounted)
+        return FAT_NO_FS;
+
+    return Fat.ExFat ? Fat_ReadDirExFat(dir, info) : Fat_ReadDirFat32(dir, info);
+}
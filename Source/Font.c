@@ -0,0 +1,356 @@
+#include "Font.h"
+
+#include "main.h"
+#include "Blit.h"
+
+typedef struct
+{
+    const Font_Glyph_t *Glyph; // NULL while the slot is unused
+    uint16_t Fg;
+    uint16_t Bg;
+    uint32_t LastUse;
+} Font_CacheEntry_t;
+
+typedef struct
+{
+    Font_CacheEntry_t Entries[FONT_CACHE_SLOTS];
+    uint32_t UseCount;
+    uint32_t Hits;
+    uint32_t Misses;
+    uint16_t Palette[16]; // Coverage level -> RGB565 for PaletteFg/PaletteBg
+    uint16_t PaletteFg;
+    uint16_t PaletteBg;
+    uint8_t PaletteBpp; // 0 while the palette is not set up
+} Font_Handle_t;
+
+static Font_Handle_t Font = {0};
+
+static __ALIGNED(4) uint16_t Font_CachePixels[FONT_CACHE_SLOTS][FONT_CACHE_SLOT_PIXELS];
+
+/**
+ * @brief Decode one UTF-8 sequence and advance the text pointer
+ * @return Code point, U+FFFD for malformed input
+ */
+static uint32_t Font_NextCodepoint(const char **text)
+{
+    const uint8_t *p = (const uint8_t *)*text;
+    uint32_t cp = *p++;
+    uint8_t extra = 0;
+
+    if (cp >= 0xF8)
+    {
+        // Never a lead byte: replace it alone, whatever follows is decoded on its own
+        cp = 0xFFFD;
+    }
+    else if (cp >= 0xF0)
+    {
+        cp &= 0x07;
+        extra = 3;
+    }
+    else if (cp >= 0xE0)
+    {
+        cp &= 0x0F;
+        extra = 2;
+    }
+    else if (cp >= 0xC0)
+    {
+        cp &= 0x1F;
+        extra = 1;
+    }
+    else if (cp >= 0x80)
+    {
+        cp = 0xFFFD;
+    }
+
+    while (extra--)
+    {
+        if ((*p & 0xC0) != 0x80)
+        {
+            // Truncated sequence: stop in front of the offending byte
+            cp = 0xFFFD;
+            break;
+        }
+        cp = (cp << 6) | (*p++ & 0x3F);
+    }
+
+    *text = (const char *)p;
+    return cp;
+}
+
+static uint8_t Font_Level(const Font_t *font, const Font_Glyph_t *glyph, uint32_t index)
+{
+    uint32_t bit = index * font->Bpp;
+    uint8_t byte = font->Bitmap[glyph->Offset + (bit >> 3)];
+
+    return (byte >> (8 - font->Bpp - (bit & 7))) & ((1 << font->Bpp) - 1);
+}
+
+static void Font_SetPalette(uint8_t bpp, uint16_t fg, uint16_t bg)
+{
+    uint8_t top = (1 << bpp) - 1;
+
+    if (Font.PaletteBpp == bpp && Font.PaletteFg == fg && Font.PaletteBg == bg)
+        return;
+
+    for (uint8_t i = 0; i <= top; i++)
+    {
+        Font.Palette[i] = bg;
+        Blit_Blend(&Font.Palette[i], 1, &fg, 1, 1, 1, (uint8_t)(i * 255 / top));
+    }
+    Font.PaletteBpp = bpp;
+    Font.PaletteFg = fg;
+    Font.PaletteBg = bg;
+}
+
+/**
+ * @brief Get the glyph converted to RGB565 for fg/bg, converting it on a miss
+ * @return Width * Height pixels, NULL if the glyph is too large for a slot
+ */
+static const uint16_t *Font_CacheGet(const Font_t *font, const Font_Glyph_t *glyph, uint16_t fg, uint16_t bg)
+{
+    Font_CacheEntry_t *entry = NULL;
+    uint16_t *pixels = NULL;
+    uint32_t oldest = 0xFFFFFFFF;
+    uint8_t victim = 0;
+    uint32_t count = (uint32_t)glyph->Width * glyph->Height;
+
+    if (count > FONT_CACHE_SLOT_PIXELS)
+        return NULL;
+
+    Font.UseCount++;
+    for (uint8_t i = 0; i < FONT_CACHE_SLOTS; i++)
+    {
+        entry = &Font.Entries[i];
+        if (entry->Glyph == glyph && entry->Fg == fg && entry->Bg == bg)
+        {
+            entry->LastUse = Font.UseCount;
+            Font.Hits++;
+            return Font_CachePixels[i];
+        }
+        // Unused slots have LastUse 0 and are taken first
+        if (entry->LastUse < oldest)
+        {
+            oldest = entry->LastUse;
+            victim = i;
+        }
+    }
+
+    Font.Misses++;
+    Font_SetPalette(font->Bpp, fg, bg);
+    pixels = Font_CachePixels[victim];
+    for (uint32_t i = 0; i < count; i++)
+    {
+        pixels[i] = Font.Palette[Font_Level(font, glyph, i)];
+    }
+
+    entry = &Font.Entries[victim];
+    entry->Glyph = glyph;
+    entry->Fg = fg;
+    entry->Bg = bg;
+    entry->LastUse = Font.UseCount;
+    return pixels;
+}
+
+/**
+ * @brief Clip a glyph box against the strip
+ * @return false if nothing of the glyph is inside the strip
+ */
+static bool Font_Clip(const LCD_Rect_t *area, uint16_t y, uint16_t lines, int16_t gx, int16_t gy,
+                      const Font_Glyph_t *glyph, LCD_Rect_t *clip)
+{
+    int32_t x0 = (gx > area->x) ? gx : area->x;
+    int32_t y0 = (gy > area->y + y) ? gy : area->y + y;
+    int32_t x1 = (gx + glyph->Width < area->x + area->w) ? gx + glyph->Width : area->x + area->w;
+    int32_t y1 = (gy + glyph->Height < area->y + y + lines) ? gy + glyph->Height : area->y + y + lines;
+
+    if (x1 <= x0 || y1 <= y0)
+        return false;
+
+    clip->x = (uint16_t)x0;
+    clip->y = (uint16_t)y0;
+    clip->w = (uint16_t)(x1 - x0);
+    clip->h = (uint16_t)(y1 - y0);
+    return true;
+}
+
+const Font_Glyph_t *Font_FindGlyph(const Font_t *font, uint32_t codepoint)
+{
+    uint16_t low = 0;
+    uint16_t high = font->GlyphNum;
+
+    while (low < high)
+    {
+        uint16_t mid = (low + high) / 2;
+        if (font->Glyphs[mid].Codepoint < codepoint)
+            low = mid + 1;
+        else
+            high = mid;
+    }
+
+    if (low < font->GlyphNum && font->Glyphs[low].Codepoint == codepoint)
+        return &font->Glyphs[low];
+    if (codepoint != font->Fallback)
+        return Font_FindGlyph(font, font->Fallback);
+    return NULL;
+}
+
+uint16_t Font_TextWidth(const Font_t *font, const char *text)
+{
+    uint16_t width = 0;
+
+    if (font == NULL || text == NULL)
+        return 0;
+
+    while (*text)
+    {
+        const Font_Glyph_t *glyph = Font_FindGlyph(font, Font_NextCodepoint(&text));
+        if (glyph != NULL)
+            width += glyph->Advance;
+    }
+    return width;
+}
+
+uint16_t Font_TextFit(const Font_t *font, const char *text, uint16_t width)
+{
+    const char *start = text;
+    uint16_t used = 0;
+
+    if (font == NULL || text == NULL)
+        return 0;
+
+    while (*text)
+    {
+        const char *next = text;
+        const Font_Glyph_t *glyph = Font_FindGlyph(font, Font_NextCodepoint(&next));
+        if (glyph != NULL)
+        {
+            if (used + glyph->Advance > width)
+                break;
+            used += glyph->Advance;
+        }
+        text = next;
+    }
+    return (uint16_t)(text - start);
+}
+
+int16_t Font_DrawText(uint16_t *strip, const LCD_Rect_t *area, uint16_t y, uint16_t lines,
+                      int16_t x, int16_t top, const Font_t *font, const char *text, uint16_t fg, uint16_t bg)
+{
+    if (font == NULL || text == NULL)
+        return x;
+    // Line entirely above or below the strip
+    if (top + font->LineHeight <= area->y + y || top >= area->y + y + lines)
+        return x + Font_TextWidth(font, text);
+
+    while (*text)
+    {
+        const Font_Glyph_t *glyph = Font_FindGlyph(font, Font_NextCodepoint(&text));
+        int16_t gx = 0;
+        int16_t gy = 0;
+        LCD_Rect_t clip;
+
+        if (glyph == NULL)
+            continue;
+
+        gx = x + glyph->OffsetX;
+        gy = top + glyph->OffsetY;
+        if (glyph->Width > 0 && Font_Clip(area, y, lines, gx, gy, glyph, &clip))
+        {
+            uint16_t *dst = strip + (uint32_t)(clip.y - area->y - y) * area->w + (clip.x - area->x);
+            uint32_t first = (uint32_t)(clip.y - gy) * glyph->Width + (clip.x - gx);
+            const uint16_t *pixels = Font_CacheGet(font, glyph, fg, bg);
+
+            if (pixels != NULL)
+            {
+                // Blank pixels are skipped so neighbouring glyph boxes may overlap
+                Blit_CopyKey(dst, area->w, pixels + first, glyph->Width, clip.w, clip.h, bg);
+            }
+            else
+            {
+                Font_SetPalette(font->Bpp, fg, bg);
+                for (uint16_t row = 0; row < clip.h; row++)
+                {
+                    for (uint16_t col = 0; col < clip.w; col++)
+                    {
+                        uint8_t level = Font_Level(font, glyph, first + col);
+                        if (level != 0)
+                            dst[col] = Font.Palette[level];
+                    }
+                    dst += area->w;
+                    first += glyph->Width;
+                }
+            }
+        }
+        x += glyph->Advance;
+    }
+
+    return x;
+}
+
+int16_t Font_DrawTextBlend(uint16_t *strip, const LCD_Rect_t *area, uint16_t y, uint16_t lines,
+                           int16_t x, int16_t top, const Font_t *font, const char *text, uint16_t fg)
+{
+    __ALIGNED(4) uint8_t coverage[FONT_MAX_GLYPH_WIDTH];
+    uint8_t scale = 0;
+
+    if (font == NULL || text == NULL)
+        return x;
+    if (top + font->LineHeight <= area->y + y || top >= area->y + y + lines)
+        return x + Font_TextWidth(font, text);
+
+    // 255 / (2^bpp - 1): 85 for 2 bpp, 17 for 4 bpp
+    scale = 255 / ((1 << font->Bpp) - 1);
+
+    while (*text)
+    {
+        const Font_Glyph_t *glyph = Font_FindGlyph(font, Font_NextCodepoint(&text));
+        int16_t gx = 0;
+        int16_t gy = 0;
+        LCD_Rect_t clip;
+
+        if (glyph == NULL)
+            continue;
+
+        gx = x + glyph->OffsetX;
+        gy = top + glyph->OffsetY;
+        if (glyph->Width > 0 && Font_Clip(area, y, lines, gx, gy, glyph, &clip))
+        {
+            uint16_t *dst = strip + (uint32_t)(clip.y - area->y - y) * area->w + (clip.x - area->x);
+            uint32_t first = (uint32_t)(clip.y - gy) * glyph->Width + (clip.x - gx);
+
+            if (clip.w > FONT_MAX_GLYPH_WIDTH)
+                clip.w = FONT_MAX_GLYPH_WIDTH;
+            for (uint16_t row = 0; row < clip.h; row++)
+            {
+                for (uint16_t col = 0; col < clip.w; col++)
+                {
+                    coverage[col] = Font_Level(font, glyph, first + col) * scale;
+                }
+                Blit_BlendMask(dst, area->w, coverage, FONT_MAX_GLYPH_WIDTH, clip.w, 1, fg);
+                dst += area->w;
+                first += glyph->Width;
+            }
+        }
+        x += glyph->Advance;
+    }
+
+    return x;
+}
+
+void Font_CacheClear(void)
+{
+    for (uint8_t i = 0; i < FONT_CACHE_SLOTS; i++)
+    {
+        Font.Entries[i].Glyph = NULL;
+        Font.Entries[i].LastUse = 0;
+    }
+    Font.UseCount = 0;
+}
+
+void Font_CacheStats(uint32_t *hits, uint32_t *misses)
+{
+    if (hits != NULL)
+        *hits = Font.Hits;
+    if (misses != NULL)
+        *misses = Font.Misses;
+}
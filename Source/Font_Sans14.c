@@ -0,0 +1,361 @@
+// Generated by Tools/fontgen/fontgen.py from DejaVuSans.ttf, 14 px, 4 bpp, 95 glyphs, 5066 bytes
+// Do not edit, regenerate instead.
+
+#include "Font_Sans14.h"
+
+static const uint8_t Font_Sans14_Bitmap[3926] = {
+    0x00, 0xD8, 0x00, 0x00, 0xD8, 0x00, 0x00, 0xD8, 0x00, 0x00, 0xD7, 0x00, 0x00, 0xD7, 0x00, 0x00,
+    0xC6, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xD8, 0x00, 0x00, 0xD8, 0x00, 0x0A, 0x81,
+    0xF1, 0x0A, 0x81, 0xF1, 0x0A, 0x81, 0xF1, 0x0A, 0x81, 0xF1, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x1F, 0x00,
+    0xE2, 0x00, 0x00, 0x00, 0x5C, 0x03, 0xD0, 0x00, 0x00, 0x00, 0x88, 0x07, 0xA0, 0x00, 0x02, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xA0, 0x00, 0x01, 0xF1, 0x0E, 0x20, 0x00, 0x00, 0x06, 0xB0, 0x4D, 0x00, 0x00,
+    0x0E, 0xFF, 0xFF, 0xFF, 0xFD, 0x00, 0x00, 0x0D, 0x30, 0xC5, 0x00, 0x00, 0x00, 0x2E, 0x01, 0xF1,
+    0x00, 0x00, 0x00, 0x5B, 0x04, 0xD0, 0x00, 0x00, 0x00, 0x00, 0xA0, 0x00, 0x00, 0x00, 0x0A, 0x00,
+    0x00, 0x01, 0x9D, 0xFC, 0x60, 0x00, 0x9C, 0x2A, 0x39, 0x20, 0x0C, 0x70, 0xA0, 0x00, 0x00, 0x9D,
+    0x3A, 0x00, 0x00, 0x01, 0x8D, 0xFB, 0x60, 0x00, 0x00, 0x0B, 0x5E, 0x70, 0x00, 0x00, 0xA0, 0x9B,
+    0x00, 0xA5, 0x1A, 0x3D, 0x70, 0x03, 0xAE, 0xFD, 0x80, 0x00, 0x00, 0x0A, 0x00, 0x00, 0x00, 0x00,
+    0xA0, 0x00, 0x00, 0x04, 0xDE, 0x70, 0x00, 0x1D, 0x20, 0x00, 0xE5, 0x2E, 0x30, 0x0A, 0x60, 0x00,
+    0x3E, 0x00, 0xA6, 0x05, 0xC0, 0x00, 0x03, 0xE0, 0x0A, 0x61, 0xD3, 0x00, 0x00, 0x0E, 0x52, 0xE3,
+    0x98, 0x3D, 0xE7, 0x00, 0x4D, 0xE7, 0x3D, 0x1D, 0x52, 0xE3, 0x00, 0x00, 0x0C, 0x42, 0xE0, 0x09,
+    0x70, 0x00, 0x07, 0x90, 0x2E, 0x00, 0x97, 0x00, 0x02, 0xD1, 0x00, 0xD5, 0x2E, 0x30, 0x00, 0xC5,
+    0x00, 0x04, 0xDE, 0x80, 0x00, 0x2A, 0xED, 0x60, 0x00, 0x00, 0x0B, 0xB1, 0x29, 0x10, 0x00, 0x00,
+    0xE6, 0x00, 0x00, 0x00, 0x00, 0x0A, 0xB0, 0x00, 0x00, 0x00, 0x00, 0x9F, 0x90, 0x00, 0x00, 0x00,
+    0x9C, 0x3D, 0xA0, 0x06, 0xE0, 0x1F, 0x40, 0x1C, 0xB1, 0xA9, 0x01, 0xF5, 0x00, 0x1B, 0xDE, 0x10,
+    0x0A, 0xD4, 0x12, 0x8F, 0xD2, 0x00, 0x07, 0xDF, 0xE9, 0x2A, 0xD2, 0x0A, 0x80, 0x0A, 0x80, 0x0A,
+    0x80, 0x0A, 0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x1E, 0x20, 0x09, 0x80, 0x01, 0xF2, 0x00, 0x6D, 0x00, 0x0A, 0xA0, 0x00, 0xB9, 0x00, 0x0B, 0x90,
+    0x00, 0xAA, 0x00, 0x06, 0xD0, 0x00, 0x1F, 0x20, 0x00, 0x99, 0x00, 0x01, 0xE2, 0x09, 0x80, 0x00,
+    0x2E, 0x20, 0x00, 0xB8, 0x00, 0x06, 0xD0, 0x00, 0x3F, 0x20, 0x02, 0xF3, 0x00, 0x2F, 0x30, 0x03,
+    0xF2, 0x00, 0x6D, 0x00, 0x0B, 0x80, 0x02, 0xE2, 0x00, 0x98, 0x00, 0x00, 0x0C, 0x00, 0x05, 0x91,
+    0xC1, 0x95, 0x04, 0xBE, 0xB4, 0x00, 0x4B, 0xEB, 0x40, 0x59, 0x1C, 0x19, 0x50, 0x00, 0xC0, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x0B, 0x70, 0x00, 0x00, 0x00, 0x00, 0x0B, 0x70, 0x00, 0x00, 0x00, 0x00, 0x0B, 0x70, 0x00, 0x00,
+    0x00, 0x00, 0x0B, 0x70, 0x00, 0x00, 0x08, 0xFF, 0xFF, 0xFF, 0xFF, 0x40, 0x00, 0x00, 0x0B, 0x70,
+    0x00, 0x00, 0x00, 0x00, 0x0B, 0x70, 0x00, 0x00, 0x00, 0x00, 0x0B, 0x70, 0x00, 0x00, 0x00, 0x00,
+    0x0B, 0x70, 0x00, 0x00, 0x05, 0xF1, 0x07, 0xC0, 0x0C, 0x40, 0x5F, 0xFF, 0x60, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x08, 0xE0, 0x08, 0xE0, 0x00, 0x09, 0x90, 0x00, 0xD4, 0x00, 0x3E, 0x00,
+    0x07, 0xA0, 0x00, 0xC6, 0x00, 0x1F, 0x10, 0x06, 0xC0, 0x00, 0xA7, 0x00, 0x0E, 0x30, 0x04, 0xD0,
+    0x00, 0x89, 0x00, 0x0D, 0x50, 0x00, 0x00, 0x6D, 0xFC, 0x50, 0x00, 0x4F, 0x61, 0x7F, 0x30, 0x0B,
+    0xA0, 0x00, 0xCA, 0x00, 0xE6, 0x00, 0x08, 0xD0, 0x1F, 0x50, 0x00, 0x7E, 0x01, 0xF5, 0x00, 0x07,
+    0xE0, 0x0E, 0x60, 0x00, 0x8D, 0x00, 0xBA, 0x00, 0x0C, 0xA0, 0x04, 0xF6, 0x17, 0xF3, 0x00, 0x06,
+    0xDF, 0xC5, 0x00, 0x01, 0x6C, 0xF5, 0x00, 0x00, 0x69, 0x3F, 0x50, 0x00, 0x00, 0x00, 0xF5, 0x00,
+    0x00, 0x00, 0x0F, 0x50, 0x00, 0x00, 0x00, 0xF5, 0x00, 0x00, 0x00, 0x0F, 0x50, 0x00, 0x00, 0x00,
+    0xF5, 0x00, 0x00, 0x00, 0x0F, 0x50, 0x00, 0x00, 0x00, 0xF5, 0x00, 0x00, 0x4F, 0xFF, 0xFF, 0x90,
+    0x03, 0xAE, 0xEB, 0x30, 0x00, 0xB5, 0x11, 0x9E, 0x20, 0x00, 0x00, 0x00, 0xF6, 0x00, 0x00, 0x00,
+    0x1F, 0x50, 0x00, 0x00, 0x0A, 0xD1, 0x00, 0x00, 0x08, 0xE3, 0x00, 0x00, 0x08, 0xE4, 0x00, 0x00,
+    0x07, 0xE4, 0x00, 0x00, 0x07, 0xE4, 0x00, 0x00, 0x00, 0xFF, 0xFF, 0xFF, 0x80, 0x01, 0x9D, 0xEC,
+    0x50, 0x00, 0x86, 0x21, 0x6F, 0x40, 0x00, 0x00, 0x00, 0xD7, 0x00, 0x00, 0x01, 0x6E, 0x30, 0x00,
+    0x3F, 0xFF, 0x50, 0x00, 0x00, 0x01, 0x6F, 0x50, 0x00, 0x00, 0x00, 0xAB, 0x00, 0x00, 0x00, 0x0B,
+    0xB0, 0x0A, 0x41, 0x17, 0xF5, 0x00, 0x4B, 0xEE, 0xB4, 0x00, 0x00, 0x00, 0x6F, 0xA0, 0x00, 0x00,
+    0x3D, 0xCA, 0x00, 0x00, 0x1D, 0x4B, 0xA0, 0x00, 0x09, 0x90, 0xBA, 0x00, 0x05, 0xD1, 0x0B, 0xA0,
+    0x02, 0xE3, 0x00, 0xBA, 0x00, 0x5F, 0xFF, 0xFF, 0xFF, 0x20, 0x00, 0x00, 0xBA, 0x00, 0x00, 0x00,
+    0x0B, 0xA0, 0x00, 0x00, 0x00, 0xBA, 0x00, 0x07, 0xFF, 0xFF, 0xE0, 0x00, 0x7C, 0x00, 0x00, 0x00,
+    0x07, 0xC0, 0x00, 0x00, 0x00, 0x7F, 0xEE, 0xB3, 0x00, 0x06, 0x51, 0x2A, 0xE2, 0x00, 0x00, 0x00,
+    0x0D, 0x80, 0x00, 0x00, 0x00, 0xBA, 0x00, 0x00, 0x00, 0x0D, 0x80, 0x0A, 0x41, 0x2A, 0xE2, 0x00,
+    0x3B, 0xEE, 0xA3, 0x00, 0x00, 0x2A, 0xEE, 0x91, 0x00, 0x1D, 0xA2, 0x16, 0x50, 0x08, 0xE1, 0x00,
+    0x00, 0x00, 0xD9, 0x00, 0x00, 0x00, 0x0F, 0x8B, 0xFD, 0x81, 0x00, 0xFF, 0x51, 0x3D, 0x90, 0x0D,
+    0xA0, 0x00, 0x7E, 0x00, 0xAA, 0x00, 0x07, 0xE0, 0x03, 0xF5, 0x13, 0xD9, 0x00, 0x04, 0xCF, 0xD8,
+    0x00, 0x0D, 0xFF, 0xFF, 0xFA, 0x00, 0x00, 0x00, 0x2F, 0x50, 0x00, 0x00, 0x08, 0xE0, 0x00, 0x00,
+    0x00, 0xE8, 0x00, 0x00, 0x00, 0x5F, 0x30, 0x00, 0x00, 0x0A, 0xC0, 0x00, 0x00, 0x01, 0xF6, 0x00,
+    0x00, 0x00, 0x7E, 0x10, 0x00, 0x00, 0x0D, 0x90, 0x00, 0x00, 0x04, 0xF3, 0x00, 0x00, 0x01, 0x8D,
+    0xFD, 0x80, 0x00, 0x9D, 0x30, 0x4E, 0x70, 0x0B, 0x90, 0x00, 0xBA, 0x00, 0x6D, 0x30, 0x4E, 0x50,
+    0x00, 0x8F, 0xFF, 0x70, 0x00, 0x8D, 0x31, 0x4E, 0x60, 0x0E, 0x70, 0x00, 0x8D, 0x00, 0xE6, 0x00,
+    0x08, 0xD0, 0x0A, 0xD3, 0x14, 0xE8, 0x00, 0x18, 0xDF, 0xD8, 0x00, 0x01, 0x9D, 0xFC, 0x30, 0x00,
+    0xAD, 0x31, 0x6E, 0x20, 0x1F, 0x50, 0x00, 0xC8, 0x01, 0xF5, 0x00, 0x0C, 0xC0, 0x0B, 0xC3, 0x16,
+    0xFD, 0x00, 0x19, 0xEE, 0xA9, 0xD0, 0x00, 0x00, 0x00, 0xAB, 0x00, 0x00, 0x00, 0x1E, 0x70, 0x06,
+    0x51, 0x2B, 0xC0, 0x00, 0x19, 0xEE, 0x91, 0x00, 0x05, 0xF1, 0x00, 0x5F, 0x10, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x5F, 0x10, 0x05, 0xF1, 0x00, 0x05, 0xF1, 0x00, 0x5F, 0x10, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x5F, 0x10, 0x07, 0xC0, 0x00, 0xC4, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x5B, 0x40, 0x00, 0x00, 0x02, 0x8E, 0xE9, 0x10, 0x00, 0x16, 0xCF, 0xB6, 0x10, 0x00,
+    0x05, 0xED, 0x82, 0x00, 0x00, 0x00, 0x05, 0xED, 0x82, 0x00, 0x00, 0x00, 0x00, 0x16, 0xCF, 0xB5,
+    0x10, 0x00, 0x00, 0x00, 0x02, 0x8E, 0xE9, 0x10, 0x00, 0x00, 0x00, 0x00, 0x5B, 0x40, 0x08, 0xFF,
+    0xFF, 0xFF, 0xFF, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x08, 0xFF, 0xFF, 0xFF, 0xFF, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x07, 0x93, 0x00, 0x00, 0x00, 0x00, 0x03, 0xBF,
+    0xC7, 0x10, 0x00, 0x00, 0x00, 0x02, 0x7D, 0xFA, 0x40, 0x00, 0x00, 0x00, 0x00, 0x39, 0xED, 0x20,
+    0x00, 0x00, 0x00, 0x39, 0xED, 0x20, 0x00, 0x02, 0x7D, 0xFA, 0x40, 0x00, 0x03, 0xBF, 0xD7, 0x10,
+    0x00, 0x00, 0x07, 0x93, 0x00, 0x00, 0x00, 0x00, 0x04, 0xCE, 0xD7, 0x00, 0xB3, 0x05, 0xF4, 0x00,
+    0x00, 0x0F, 0x50, 0x00, 0x09, 0xD1, 0x00, 0x0A, 0xD2, 0x00, 0x03, 0xF2, 0x00, 0x00, 0x4F, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x5F, 0x10, 0x00, 0x05, 0xF1, 0x00, 0x00, 0x00, 0x6B, 0xEE, 0xD8,
+    0x10, 0x00, 0x00, 0x2C, 0xB4, 0x10, 0x38, 0xE4, 0x00, 0x01, 0xD6, 0x00, 0x00, 0x00, 0x3E, 0x20,
+    0x08, 0x90, 0x19, 0xED, 0x6E, 0x06, 0xA0, 0x0D, 0x20, 0x8B, 0x22, 0xBE, 0x01, 0xE0, 0x0E, 0x00,
+    0xC4, 0x00, 0x4E, 0x00, 0xF0, 0x0E, 0x00, 0xC4, 0x00, 0x4E, 0x03, 0xC0, 0x0D, 0x20, 0x8B, 0x21,
+    0xBE, 0x3D, 0x40, 0x08, 0x90, 0x19, 0xED, 0x7E, 0xB3, 0x00, 0x01, 0xD6, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x2D, 0xA4, 0x11, 0x39, 0xA0, 0x00, 0x00, 0x01, 0x7C, 0xEE, 0xC9, 0x30, 0x00, 0x00,
+    0x03, 0xFC, 0x00, 0x00, 0x00, 0x09, 0xCF, 0x20, 0x00, 0x00, 0x1E, 0x4B, 0x80, 0x00, 0x00, 0x5D,
+    0x05, 0xE0, 0x00, 0x00, 0xB7, 0x00, 0xE5, 0x00, 0x02, 0xF2, 0x00, 0x8B, 0x00, 0x08, 0xFF, 0xFF,
+    0xFF, 0x20, 0x0E, 0x50, 0x00, 0x0B, 0x70, 0x5F, 0x10, 0x00, 0x07, 0xD0, 0xAB, 0x00, 0x00, 0x02,
+    0xF4, 0x09, 0xFF, 0xFE, 0xB3, 0x00, 0x09, 0xB0, 0x01, 0xAE, 0x00, 0x09, 0xB0, 0x00, 0x4F, 0x20,
+    0x09, 0xB0, 0x01, 0xAD, 0x00, 0x09, 0xFF, 0xFF, 0xE3, 0x00, 0x09, 0xB0, 0x01, 0x7E, 0x20, 0x09,
+    0xB0, 0x00, 0x0E, 0x80, 0x09, 0xB0, 0x00, 0x0E, 0x80, 0x09, 0xB0, 0x01, 0x7F, 0x30, 0x09, 0xFF,
+    0xFE, 0xC5, 0x00, 0x00, 0x18, 0xDF, 0xDB, 0x40, 0x02, 0xDB, 0x30, 0x14, 0xB0, 0x0A, 0xD0, 0x00,
+    0x00, 0x00, 0x1F, 0x70, 0x00, 0x00, 0x00, 0x3F, 0x50, 0x00, 0x00, 0x00, 0x3F, 0x50, 0x00, 0x00,
+    0x00, 0x1F, 0x70, 0x00, 0x00, 0x00, 0x0A, 0xD0, 0x00, 0x00, 0x00, 0x02, 0xDB, 0x30, 0x14, 0xB0,
+    0x00, 0x18, 0xDF, 0xDB, 0x40, 0x09, 0xFF, 0xFE, 0xB6, 0x00, 0x00, 0x9B, 0x00, 0x15, 0xDB, 0x00,
+    0x09, 0xB0, 0x00, 0x02, 0xF7, 0x00, 0x9B, 0x00, 0x00, 0x0A, 0xC0, 0x09, 0xB0, 0x00, 0x00, 0x8E,
+    0x00, 0x9B, 0x00, 0x00, 0x08, 0xE0, 0x09, 0xB0, 0x00, 0x00, 0xAC, 0x00, 0x9B, 0x00, 0x00, 0x2F,
+    0x70, 0x09, 0xB0, 0x01, 0x5D, 0xC1, 0x00, 0x9F, 0xFF, 0xEB, 0x60, 0x00, 0x09, 0xFF, 0xFF, 0xFC,
+    0x00, 0x9B, 0x00, 0x00, 0x00, 0x09, 0xB0, 0x00, 0x00, 0x00, 0x9B, 0x00, 0x00, 0x00, 0x09, 0xFF,
+    0xFF, 0xF9, 0x00, 0x9B, 0x00, 0x00, 0x00, 0x09, 0xB0, 0x00, 0x00, 0x00, 0x9B, 0x00, 0x00, 0x00,
+    0x09, 0xB0, 0x00, 0x00, 0x00, 0x9F, 0xFF, 0xFF, 0xE0, 0x09, 0xFF, 0xFF, 0xF4, 0x09, 0xB0, 0x00,
+    0x00, 0x09, 0xB0, 0x00, 0x00, 0x09, 0xB0, 0x00, 0x00, 0x09, 0xFF, 0xFF, 0xC0, 0x09, 0xB0, 0x00,
+    0x00, 0x09, 0xB0, 0x00, 0x00, 0x09, 0xB0, 0x00, 0x00, 0x09, 0xB0, 0x00, 0x00, 0x09, 0xB0, 0x00,
+    0x00, 0x00, 0x18, 0xDF, 0xEC, 0x61, 0x00, 0x2D, 0xB4, 0x11, 0x39, 0x60, 0x0A, 0xD0, 0x00, 0x00,
+    0x00, 0x01, 0xF7, 0x00, 0x00, 0x00, 0x00, 0x3F, 0x50, 0x00, 0x00, 0x00, 0x03, 0xF5, 0x00, 0x0E,
+    0xFF, 0xB0, 0x1F, 0x70, 0x00, 0x00, 0xAB, 0x00, 0xAD, 0x00, 0x00, 0x0A, 0xB0, 0x02, 0xDC, 0x41,
+    0x13, 0xCB, 0x00, 0x01, 0x8D, 0xFE, 0xC8, 0x10, 0x09, 0xB0, 0x00, 0x04, 0xF2, 0x00, 0x9B, 0x00,
+    0x00, 0x4F, 0x20, 0x09, 0xB0, 0x00, 0x04, 0xF2, 0x00, 0x9B, 0x00, 0x00, 0x4F, 0x20, 0x09, 0xFF,
+    0xFF, 0xFF, 0xF2, 0x00, 0x9B, 0x00, 0x00, 0x4F, 0x20, 0x09, 0xB0, 0x00, 0x04, 0xF2, 0x00, 0x9B,
+    0x00, 0x00, 0x4F, 0x20, 0x09, 0xB0, 0x00, 0x04, 0xF2, 0x00, 0x9B, 0x00, 0x00, 0x4F, 0x20, 0x09,
+    0xB0, 0x09, 0xB0, 0x09, 0xB0, 0x09, 0xB0, 0x09, 0xB0, 0x09, 0xB0, 0x09, 0xB0, 0x09, 0xB0, 0x09,
+    0xB0, 0x09, 0xB0, 0x00, 0x9B, 0x00, 0x09, 0xB0, 0x00, 0x9B, 0x00, 0x09, 0xB0, 0x00, 0x9B, 0x00,
+    0x09, 0xB0, 0x00, 0x9B, 0x00, 0x09, 0xB0, 0x00, 0x9B, 0x00, 0x09, 0xB0, 0x00, 0xBA, 0x00, 0x3E,
+    0x60, 0xBE, 0x80, 0x00, 0x09, 0xB0, 0x00, 0x4E, 0x80, 0x09, 0xB0, 0x05, 0xF7, 0x00, 0x09, 0xB0,
+    0x6F, 0x60, 0x00, 0x09, 0xB7, 0xF5, 0x00, 0x00, 0x09, 0xFF, 0x50, 0x00, 0x00, 0x09, 0xCD, 0xC1,
+    0x00, 0x00, 0x09, 0xB1, 0xCC, 0x10, 0x00, 0x09, 0xB0, 0x1C, 0xD1, 0x00, 0x09, 0xB0, 0x01, 0xCD,
+    0x10, 0x09, 0xB0, 0x00, 0x1C, 0xD2, 0x09, 0xB0, 0x00, 0x00, 0x09, 0xB0, 0x00, 0x00, 0x09, 0xB0,
+    0x00, 0x00, 0x09, 0xB0, 0x00, 0x00, 0x09, 0xB0, 0x00, 0x00, 0x09, 0xB0, 0x00, 0x00, 0x09, 0xB0,
+    0x00, 0x00, 0x09, 0xB0, 0x00, 0x00, 0x09, 0xB0, 0x00, 0x00, 0x09, 0xFF, 0xFF, 0xFB, 0x09, 0xF9,
+    0x00, 0x00, 0x8F, 0xB0, 0x09, 0xDE, 0x10, 0x00, 0xED, 0xB0, 0x09, 0xBC, 0x60, 0x05, 0xDA, 0xB0,
+    0x09, 0xB6, 0xC0, 0x0B, 0x7A, 0xB0, 0x09, 0xB1, 0xE3, 0x2F, 0x1A, 0xB0, 0x09, 0xB0, 0x98, 0x7A,
+    0x0A, 0xB0, 0x09, 0xB0, 0x4E, 0xD5, 0x0A, 0xB0, 0x09, 0xB0, 0x0D, 0xE0, 0x0A, 0xB0, 0x09, 0xB0,
+    0x00, 0x00, 0x0A, 0xB0, 0x09, 0xB0, 0x00, 0x00, 0x0A, 0xB0, 0x09, 0xF8, 0x00, 0x04, 0xF1, 0x09,
+    0xFE, 0x10, 0x04, 0xF1, 0x09, 0xBC, 0x90, 0x04, 0xF1, 0x09, 0xB4, 0xF2, 0x04, 0xF1, 0x09, 0xB0,
+    0xBA, 0x04, 0xF1, 0x09, 0xB0, 0x3F, 0x34, 0xF1, 0x09, 0xB0, 0x0A, 0xB4, 0xF1, 0x09, 0xB0, 0x02,
+    0xF8, 0xF1, 0x09, 0xB0, 0x00, 0x9F, 0xF1, 0x09, 0xB0, 0x00, 0x1E, 0xF1, 0x00, 0x29, 0xDF, 0xD9,
+    0x20, 0x00, 0x2E, 0xB3, 0x02, 0xBE, 0x20, 0x0A, 0xD0, 0x00, 0x00, 0xDA, 0x01, 0xF7, 0x00, 0x00,
+    0x07, 0xF1, 0x3F, 0x50, 0x00, 0x00, 0x4F, 0x33, 0xF5, 0x00, 0x00, 0x04, 0xF3, 0x1F, 0x70, 0x00,
+    0x00, 0x7F, 0x10, 0xAD, 0x00, 0x00, 0x0D, 0xA0, 0x02, 0xEB, 0x30, 0x2A, 0xE2, 0x00, 0x02, 0x9D,
+    0xFE, 0x92, 0x00, 0x09, 0xFF, 0xFD, 0x81, 0x09, 0xB0, 0x04, 0xE9, 0x09, 0xB0, 0x00, 0x9D, 0x09,
+    0xB0, 0x00, 0x9D, 0x09, 0xB0, 0x04, 0xE9, 0x09, 0xFF, 0xFD, 0x81, 0x09, 0xB0, 0x00, 0x00, 0x09,
+    0xB0, 0x00, 0x00, 0x09, 0xB0, 0x00, 0x00, 0x09, 0xB0, 0x00, 0x00, 0x00, 0x29, 0xDF, 0xD9, 0x20,
+    0x00, 0x2E, 0xB3, 0x02, 0xBE, 0x20, 0x0A, 0xD0, 0x00, 0x00, 0xDA, 0x01, 0xF7, 0x00, 0x00, 0x07,
+    0xF1, 0x3F, 0x50, 0x00, 0x00, 0x4F, 0x33, 0xF5, 0x00, 0x00, 0x04, 0xF3, 0x1F, 0x70, 0x00, 0x00,
+    0x7F, 0x10, 0xAD, 0x00, 0x00, 0x0D, 0xA0, 0x02, 0xEB, 0x30, 0x2A, 0xE2, 0x00, 0x02, 0x9D, 0xFF,
+    0xC1, 0x00, 0x00, 0x00, 0x00, 0x8E, 0x20, 0x00, 0x00, 0x00, 0x00, 0xCD, 0x10, 0x09, 0xFF, 0xFD,
+    0x81, 0x00, 0x09, 0xB0, 0x04, 0xE9, 0x00, 0x09, 0xB0, 0x00, 0x8D, 0x00, 0x09, 0xB0, 0x00, 0x8E,
+    0x00, 0x09, 0xB0, 0x03, 0xE8, 0x00, 0x09, 0xFF, 0xFF, 0xA0, 0x00, 0x09, 0xB0, 0x05, 0xF5, 0x00,
+    0x09, 0xB0, 0x00, 0x8E, 0x10, 0x09, 0xB0, 0x00, 0x1E, 0x80, 0x09, 0xB0, 0x00, 0x06, 0xE1, 0x01,
+    0x8D, 0xEC, 0x71, 0x00, 0xAC, 0x31, 0x27, 0x70, 0x0F, 0x60, 0x00, 0x00, 0x00, 0xE9, 0x00, 0x00,
+    0x00, 0x05, 0xEE, 0xA7, 0x20, 0x00, 0x01, 0x59, 0xDF, 0x60, 0x00, 0x00, 0x00, 0x9E, 0x00, 0x00,
+    0x00, 0x06, 0xF1, 0x0B, 0x52, 0x13, 0xDB, 0x00, 0x4A, 0xDE, 0xD8, 0x10, 0x1F, 0xFF, 0xFF, 0xFF,
+    0xF9, 0x00, 0x00, 0x6F, 0x00, 0x00, 0x00, 0x00, 0x6F, 0x00, 0x00, 0x00, 0x00, 0x6F, 0x00, 0x00,
+    0x00, 0x00, 0x6F, 0x00, 0x00, 0x00, 0x00, 0x6F, 0x00, 0x00, 0x00, 0x00, 0x6F, 0x00, 0x00, 0x00,
+    0x00, 0x6F, 0x00, 0x00, 0x00, 0x00, 0x6F, 0x00, 0x00, 0x00, 0x00, 0x6F, 0x00, 0x00, 0x0C, 0x90,
+    0x00, 0x05, 0xF0, 0x0C, 0x90, 0x00, 0x05, 0xF0, 0x0C, 0x90, 0x00, 0x05, 0xF0, 0x0C, 0x90, 0x00,
+    0x05, 0xF0, 0x0C, 0x90, 0x00, 0x05, 0xF0, 0x0C, 0x90, 0x00, 0x05, 0xF0, 0x0B, 0xA0, 0x00, 0x06,
+    0xF0, 0x09, 0xD0, 0x00, 0x09, 0xC0, 0x02, 0xF8, 0x11, 0x5E, 0x60, 0x00, 0x3B, 0xEE, 0xC5, 0x00,
+    0xBB, 0x00, 0x00, 0x02, 0xF4, 0x5F, 0x20, 0x00, 0x08, 0xD0, 0x0E, 0x80, 0x00, 0x0E, 0x70, 0x08,
+    0xD0, 0x00, 0x5F, 0x20, 0x02, 0xF4, 0x00, 0xBB, 0x00, 0x00, 0xBA, 0x02, 0xF5, 0x00, 0x00, 0x5F,
+    0x17, 0xE0, 0x00, 0x00, 0x1E, 0x6D, 0x80, 0x00, 0x00, 0x09, 0xEF, 0x20, 0x00, 0x00, 0x03, 0xFC,
+    0x00, 0x00, 0x6E, 0x00, 0x00, 0xEC, 0x00, 0x02, 0xF4, 0x2F, 0x40, 0x04, 0xEF, 0x10, 0x06, 0xF0,
+    0x0D, 0x70, 0x07, 0xAC, 0x50, 0x0A, 0xB0, 0x0A, 0xB0, 0x0B, 0x68, 0x90, 0x0E, 0x70, 0x06, 0xF0,
+    0x0F, 0x24, 0xD0, 0x2F, 0x40, 0x02, 0xF4, 0x4D, 0x01, 0xF1, 0x6E, 0x00, 0x00, 0xD8, 0x8A, 0x00,
+    0xC5, 0xAB, 0x00, 0x00, 0x9B, 0xB6, 0x00, 0x89, 0xE7, 0x00, 0x00, 0x6F, 0xF2, 0x00, 0x4E, 0xF3,
+    0x00, 0x00, 0x2F, 0xD0, 0x00, 0x1F, 0xE0, 0x00, 0x0C, 0xA0, 0x00, 0x1D, 0x90, 0x02, 0xE6, 0x00,
+    0x9D, 0x10, 0x00, 0x6E, 0x25, 0xF3, 0x00, 0x00, 0x0B, 0xBE, 0x70, 0x00, 0x00, 0x02, 0xFC, 0x00,
+    0x00, 0x00, 0x06, 0xFE, 0x20, 0x00, 0x00, 0x2E, 0x6B, 0xC0, 0x00, 0x00, 0xCA, 0x01, 0xE7, 0x00,
+    0x08, 0xD1, 0x00, 0x5F, 0x20, 0x4F, 0x40, 0x00, 0x0A, 0xC0, 0x0A, 0xC0, 0x00, 0x04, 0xF4, 0x01,
+    0xE7, 0x00, 0x1D, 0x80, 0x00, 0x5F, 0x30, 0x9C, 0x00, 0x00, 0x09, 0xC5, 0xF3, 0x00, 0x00, 0x01,
+    0xDF, 0x70, 0x00, 0x00, 0x00, 0x7F, 0x00, 0x00, 0x00, 0x00, 0x6F, 0x00, 0x00, 0x00, 0x00, 0x6F,
+    0x00, 0x00, 0x00, 0x00, 0x6F, 0x00, 0x00, 0x00, 0x00, 0x6F, 0x00, 0x00, 0x3F, 0xFF, 0xFF, 0xFF,
+    0xC0, 0x00, 0x00, 0x00, 0x5F, 0x70, 0x00, 0x00, 0x03, 0xEA, 0x00, 0x00, 0x00, 0x1D, 0xC0, 0x00,
+    0x00, 0x00, 0xBE, 0x20, 0x00, 0x00, 0x09, 0xF3, 0x00, 0x00, 0x00, 0x6F, 0x60, 0x00, 0x00, 0x03,
+    0xF9, 0x00, 0x00, 0x00, 0x2E, 0xB0, 0x00, 0x00, 0x00, 0x6F, 0xFF, 0xFF, 0xFF, 0xF0, 0x0C, 0xFF,
+    0x20, 0xC7, 0x00, 0x0C, 0x70, 0x00, 0xC7, 0x00, 0x0C, 0x70, 0x00, 0xC7, 0x00, 0x0C, 0x70, 0x00,
+    0xC7, 0x00, 0x0C, 0x70, 0x00, 0xC7, 0x00, 0x0C, 0x70, 0x00, 0xCF, 0xF2, 0xD5, 0x00, 0x08, 0x90,
+    0x00, 0x4D, 0x00, 0x00, 0xE3, 0x00, 0x0A, 0x70, 0x00, 0x6C, 0x00, 0x01, 0xF1, 0x00, 0x0C, 0x60,
+    0x00, 0x7A, 0x00, 0x03, 0xE0, 0x00, 0x0D, 0x40, 0x00, 0x99, 0x0A, 0xFF, 0x40, 0x00, 0xF4, 0x00,
+    0x0F, 0x40, 0x00, 0xF4, 0x00, 0x0F, 0x40, 0x00, 0xF4, 0x00, 0x0F, 0x40, 0x00, 0xF4, 0x00, 0x0F,
+    0x40, 0x00, 0xF4, 0x00, 0x0F, 0x40, 0xAF, 0xF4, 0x00, 0x00, 0x4F, 0xD2, 0x00, 0x00, 0x00, 0x03,
+    0xE8, 0xBD, 0x10, 0x00, 0x00, 0x3E, 0x70, 0x0A, 0xC1, 0x00, 0x02, 0xE6, 0x00, 0x00, 0xAB, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x2F, 0xFF, 0xFF,
+    0xFF, 0x20, 0x07, 0xC0, 0x00, 0x00, 0x0B, 0x70, 0x00, 0x00, 0x1D, 0x20, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x09, 0xFF, 0xEB, 0x20, 0x00, 0x00, 0x01,
+    0x9D, 0x00, 0x00, 0x00, 0x00, 0xF3, 0x00, 0x3A, 0xEF, 0xFF, 0x40, 0x0D, 0x92, 0x00, 0xF5, 0x02,
+    0xF2, 0x00, 0x3F, 0x50, 0x0E, 0x81, 0x3C, 0xF5, 0x00, 0x4D, 0xFD, 0x7E, 0x50, 0x0B, 0x80, 0x00,
+    0x00, 0x00, 0xB8, 0x00, 0x00, 0x00, 0x0B, 0x80, 0x00, 0x00, 0x00, 0xB9, 0xAE, 0xE8, 0x00, 0x0B,
+    0xF7, 0x14, 0xE7, 0x00, 0xBC, 0x00, 0x07, 0xD0, 0x0B, 0x90, 0x00, 0x4F, 0x10, 0xB9, 0x00, 0x04,
+    0xF1, 0x0B, 0xC0, 0x00, 0x7D, 0x00, 0xBF, 0x71, 0x4E, 0x70, 0x0B, 0x9A, 0xEE, 0x80, 0x00, 0x00,
+    0x7D, 0xFC, 0x40, 0x08, 0xE5, 0x13, 0x90, 0x1E, 0x60, 0x00, 0x00, 0x3F, 0x20, 0x00, 0x00, 0x3F,
+    0x20, 0x00, 0x00, 0x1E, 0x60, 0x00, 0x00, 0x08, 0xE5, 0x13, 0x90, 0x00, 0x7D, 0xFC, 0x40, 0x00,
+    0x00, 0x00, 0xA9, 0x00, 0x00, 0x00, 0x0A, 0x90, 0x00, 0x00, 0x00, 0xA9, 0x00, 0x09, 0xED, 0x9A,
+    0x90, 0x08, 0xD3, 0x18, 0xF9, 0x01, 0xF5, 0x00, 0x0D, 0x90, 0x3F, 0x20, 0x00, 0xB9, 0x03, 0xF2,
+    0x00, 0x0B, 0x90, 0x1F, 0x50, 0x00, 0xD9, 0x00, 0x8D, 0x31, 0x8F, 0x90, 0x01, 0x9E, 0xE9, 0xA9,
+    0x00, 0x00, 0x7D, 0xFD, 0x60, 0x00, 0x7D, 0x31, 0x4E, 0x50, 0x0E, 0x40, 0x00, 0x7B, 0x03, 0xFF,
+    0xFF, 0xFF, 0xD0, 0x3F, 0x20, 0x00, 0x00, 0x01, 0xE7, 0x00, 0x00, 0x00, 0x08, 0xE5, 0x12, 0x67,
+    0x00, 0x06, 0xDF, 0xD9, 0x10, 0x00, 0x9E, 0xF3, 0x05, 0xE2, 0x00, 0x07, 0xC0, 0x00, 0xAF, 0xFF,
+    0xD0, 0x07, 0xC0, 0x00, 0x07, 0xC0, 0x00, 0x07, 0xC0, 0x00, 0x07, 0xC0, 0x00, 0x07, 0xC0, 0x00,
+    0x07, 0xC0, 0x00, 0x07, 0xC0, 0x00, 0x01, 0x9E, 0xD9, 0xA9, 0x00, 0x9D, 0x31, 0x8F, 0x90, 0x1F,
+    0x50, 0x00, 0xD9, 0x03, 0xF2, 0x00, 0x0A, 0x90, 0x3F, 0x20, 0x00, 0xB9, 0x01, 0xF5, 0x00, 0x0D,
+    0x90, 0x09, 0xD3, 0x18, 0xF9, 0x00, 0x19, 0xEE, 0x9B, 0x90, 0x00, 0x00, 0x00, 0xD7, 0x00, 0x46,
+    0x11, 0x8E, 0x20, 0x01, 0x9D, 0xEB, 0x30, 0x00, 0x0B, 0x80, 0x00, 0x00, 0x00, 0xB8, 0x00, 0x00,
+    0x00, 0x0B, 0x80, 0x00, 0x00, 0x00, 0xB9, 0xAE, 0xE9, 0x00, 0x0B, 0xF6, 0x13, 0xE6, 0x00, 0xBA,
+    0x00, 0x0A, 0x90, 0x0B, 0x80, 0x00, 0x9A, 0x00, 0xB8, 0x00, 0x09, 0xA0, 0x0B, 0x80, 0x00, 0x9A,
+    0x00, 0xB8, 0x00, 0x09, 0xA0, 0x0B, 0x80, 0x00, 0x9A, 0x00, 0x0A, 0x90, 0x0A, 0x90, 0x00, 0x00,
+    0x0A, 0x90, 0x0A, 0x90, 0x0A, 0x90, 0x0A, 0x90, 0x0A, 0x90, 0x0A, 0x90, 0x0A, 0x90, 0x0A, 0x90,
+    0x00, 0xA9, 0x00, 0x0A, 0x90, 0x00, 0x00, 0x00, 0x0A, 0x90, 0x00, 0xA9, 0x00, 0x0A, 0x90, 0x00,
+    0xA9, 0x00, 0x0A, 0x90, 0x00, 0xA9, 0x00, 0x0A, 0x90, 0x00, 0xA9, 0x00, 0x0B, 0x80, 0x01, 0xD6,
+    0x04, 0xEA, 0x00, 0x0B, 0x80, 0x00, 0x00, 0x00, 0xB8, 0x00, 0x00, 0x00, 0x0B, 0x80, 0x00, 0x00,
+    0x00, 0xB8, 0x00, 0x4E, 0x50, 0x0B, 0x80, 0x5E, 0x40, 0x00, 0xB8, 0x7E, 0x40, 0x00, 0x0B, 0xDF,
+    0x30, 0x00, 0x00, 0xBA, 0xE9, 0x00, 0x00, 0x0B, 0x82, 0xE8, 0x00, 0x00, 0xB8, 0x02, 0xE8, 0x00,
+    0x0B, 0x80, 0x02, 0xE8, 0x00, 0x0A, 0x90, 0x0A, 0x90, 0x0A, 0x90, 0x0A, 0x90, 0x0A, 0x90, 0x0A,
+    0x90, 0x0A, 0x90, 0x0A, 0x90, 0x0A, 0x90, 0x0A, 0x90, 0x0A, 0x90, 0x0B, 0xAA, 0xEE, 0x82, 0xAE,
+    0xD6, 0x00, 0x0B, 0xF5, 0x14, 0xFE, 0x51, 0x5F, 0x20, 0x0B, 0xA0, 0x00, 0xCA, 0x00, 0x0D, 0x60,
+    0x0B, 0x80, 0x00, 0xC8, 0x00, 0x0C, 0x70, 0x0B, 0x80, 0x00, 0xC8, 0x00, 0x0C, 0x70, 0x0B, 0x80,
+    0x00, 0xC8, 0x00, 0x0C, 0x70, 0x0B, 0x80, 0x00, 0xC8, 0x00, 0x0C, 0x70, 0x0B, 0x80, 0x00, 0xC8,
+    0x00, 0x0C, 0x70, 0x0B, 0x9A, 0xEE, 0x90, 0x00, 0xBF, 0x61, 0x3E, 0x60, 0x0B, 0xA0, 0x00, 0xA9,
+    0x00, 0xB8, 0x00, 0x09, 0xA0, 0x0B, 0x80, 0x00, 0x9A, 0x00, 0xB8, 0x00, 0x09, 0xA0, 0x0B, 0x80,
+    0x00, 0x9A, 0x00, 0xB8, 0x00, 0x09, 0xA0, 0x00, 0x8E, 0xFC, 0x40, 0x00, 0x8D, 0x31, 0x8F, 0x20,
+    0x0F, 0x50, 0x00, 0xC8, 0x02, 0xF2, 0x00, 0x09, 0xB0, 0x3F, 0x20, 0x00, 0x9B, 0x00, 0xF5, 0x00,
+    0x0C, 0x80, 0x08, 0xD3, 0x17, 0xF2, 0x00, 0x08, 0xEF, 0xC4, 0x00, 0x0B, 0x9A, 0xEE, 0x80, 0x00,
+    0xBF, 0x71, 0x4E, 0x70, 0x0B, 0xC0, 0x00, 0x7D, 0x00, 0xB9, 0x00, 0x04, 0xF1, 0x0B, 0x90, 0x00,
+    0x4F, 0x10, 0xBC, 0x00, 0x07, 0xD0, 0x0B, 0xF7, 0x14, 0xE7, 0x00, 0xB9, 0xAE, 0xE8, 0x00, 0x0B,
+    0x80, 0x00, 0x00, 0x00, 0xB8, 0x00, 0x00, 0x00, 0x0B, 0x80, 0x00, 0x00, 0x00, 0x00, 0x9E, 0xD9,
+    0xA9, 0x00, 0x8D, 0x31, 0x8F, 0x90, 0x1F, 0x50, 0x00, 0xD9, 0x03, 0xF2, 0x00, 0x0B, 0x90, 0x3F,
+    0x20, 0x00, 0xB9, 0x01, 0xF5, 0x00, 0x0D, 0x90, 0x08, 0xD3, 0x18, 0xF9, 0x00, 0x19, 0xEE, 0x9A,
+    0x90, 0x00, 0x00, 0x00, 0xA9, 0x00, 0x00, 0x00, 0x0A, 0x90, 0x00, 0x00, 0x00, 0xA9, 0x00, 0x0B,
+    0x9A, 0xEB, 0x0B, 0xF6, 0x10, 0x0B, 0xB0, 0x00, 0x0B, 0x80, 0x00, 0x0B, 0x80, 0x00, 0x0B, 0x80,
+    0x00, 0x0B, 0x80, 0x00, 0x0B, 0x80, 0x00, 0x04, 0xCE, 0xD7, 0x01, 0xE6, 0x12, 0x83, 0x2F, 0x20,
+    0x00, 0x00, 0xBD, 0x84, 0x10, 0x00, 0x48, 0xCD, 0x20, 0x00, 0x00, 0xC8, 0x39, 0x30, 0x3E, 0x60,
+    0x6C, 0xED, 0x80, 0x0B, 0x80, 0x00, 0x0B, 0x80, 0x00, 0x9F, 0xFF, 0xF2, 0x0B, 0x80, 0x00, 0x0B,
+    0x80, 0x00, 0x0B, 0x80, 0x00, 0x0B, 0x80, 0x00, 0x0A, 0x90, 0x00, 0x08, 0xB1, 0x00, 0x02, 0xCE,
+    0xF2, 0x0C, 0x70, 0x00, 0xA9, 0x00, 0xC7, 0x00, 0x0A, 0x90, 0x0C, 0x70, 0x00, 0xA9, 0x00, 0xC7,
+    0x00, 0x0A, 0x90, 0x0C, 0x70, 0x00, 0xA9, 0x00, 0xB8, 0x00, 0x0C, 0x90, 0x08, 0xD2, 0x17, 0xF9,
+    0x00, 0x1A, 0xED, 0x9A, 0x90, 0x6E, 0x00, 0x00, 0xAA, 0x1F, 0x40, 0x01, 0xE5, 0x0A, 0xA0, 0x05,
+    0xE0, 0x05, 0xE1, 0x0B, 0x90, 0x00, 0xE5, 0x1F, 0x40, 0x00, 0x9B, 0x6D, 0x00, 0x00, 0x4F, 0xD8,
+    0x00, 0x00, 0x0D, 0xF3, 0x00, 0x4E, 0x00, 0x2F, 0x90, 0x08, 0xB1, 0xF3, 0x06, 0xED, 0x00, 0xC7,
+    0x0C, 0x70, 0xA7, 0xF1, 0x1F, 0x30, 0x8B, 0x0D, 0x3B, 0x54, 0xE0, 0x04, 0xE2, 0xE0, 0x89, 0x8B,
+    0x00, 0x1F, 0x9B, 0x04, 0xDC, 0x70, 0x00, 0xCF, 0x70, 0x0F, 0xF3, 0x00, 0x08, 0xF3, 0x00, 0xBE,
+    0x00, 0x1E, 0x70, 0x03, 0xF5, 0x04, 0xF3, 0x1D, 0x90, 0x00, 0x8D, 0x9D, 0x10, 0x00, 0x0D, 0xF3,
+    0x00, 0x00, 0x2E, 0xF5, 0x00, 0x00, 0xCA, 0x7E, 0x20, 0x08, 0xD1, 0x0B, 0xB0, 0x4F, 0x40, 0x01,
+    0xE7, 0x6E, 0x00, 0x00, 0xAA, 0x1E, 0x50, 0x01, 0xF4, 0x09, 0xB0, 0x06, 0xE0, 0x03, 0xF1, 0x0C,
+    0x80, 0x00, 0xC7, 0x3F, 0x20, 0x00, 0x6D, 0x9B, 0x00, 0x00, 0x1F, 0xF6, 0x00, 0x00, 0x0A, 0xE1,
+    0x00, 0x00, 0x0B, 0x90, 0x00, 0x00, 0x4F, 0x30, 0x00, 0x0D, 0xE7, 0x00, 0x00, 0x4F, 0xFF, 0xFF,
+    0xB0, 0x00, 0x02, 0xE7, 0x00, 0x01, 0xDA, 0x00, 0x00, 0xAC, 0x10, 0x00, 0x8E, 0x20, 0x00, 0x5F,
+    0x40, 0x00, 0x3E, 0x60, 0x00, 0x06, 0xFF, 0xFF, 0xFB, 0x00, 0x00, 0x7D, 0xF2, 0x00, 0x00, 0x1F,
+    0x60, 0x00, 0x00, 0x02, 0xF2, 0x00, 0x00, 0x00, 0x2F, 0x20, 0x00, 0x00, 0x02, 0xF2, 0x00, 0x00,
+    0x01, 0x8E, 0x00, 0x00, 0x04, 0xFF, 0x50, 0x00, 0x00, 0x01, 0x8E, 0x00, 0x00, 0x00, 0x03, 0xF2,
+    0x00, 0x00, 0x00, 0x2F, 0x20, 0x00, 0x00, 0x02, 0xF2, 0x00, 0x00, 0x00, 0x0F, 0x60, 0x00, 0x00,
+    0x00, 0x6D, 0xF2, 0x00, 0x03, 0xE0, 0x00, 0x3E, 0x00, 0x03, 0xE0, 0x00, 0x3E, 0x00, 0x03, 0xE0,
+    0x00, 0x3E, 0x00, 0x03, 0xE0, 0x00, 0x3E, 0x00, 0x03, 0xE0, 0x00, 0x3E, 0x00, 0x03, 0xE0, 0x00,
+    0x3E, 0x00, 0x03, 0xE0, 0x00, 0x3E, 0x00, 0x04, 0xFD, 0x60, 0x00, 0x00, 0x00, 0x8E, 0x00, 0x00,
+    0x00, 0x04, 0xF0, 0x00, 0x00, 0x00, 0x4F, 0x00, 0x00, 0x00, 0x03, 0xF1, 0x00, 0x00, 0x00, 0x1F,
+    0x70, 0x00, 0x00, 0x00, 0x6F, 0xF2, 0x00, 0x00, 0x1F, 0x71, 0x00, 0x00, 0x03, 0xF1, 0x00, 0x00,
+    0x00, 0x4F, 0x00, 0x00, 0x00, 0x04, 0xF0, 0x00, 0x00, 0x00, 0x8D, 0x00, 0x00, 0x04, 0xFD, 0x50,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x9D, 0xEA, 0x51, 0x29, 0x40, 0x07, 0x61,
+    0x16, 0xCE, 0xD7, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+};
+
+static const Font_Glyph_t Font_Sans14_Glyphs[95] = {
+    {0x0020, 0, 0, 0, 0, 4, 0}, // U+0020
+    {0x0021, 6, 10, 0, 3, 6, 0}, // !
+    {0x0022, 6, 10, 0, 3, 6, 30}, // "
+    {0x0023, 12, 10, 0, 3, 12, 60}, // #
+    {0x0024, 9, 13, 0, 2, 9, 120}, // $
+    {0x0025, 13, 10, 0, 3, 13, 179}, // %
+    {0x0026, 11, 10, 0, 3, 11, 244}, // &
+    {0x0027, 4, 10, 0, 3, 4, 299}, // '
+    {0x0028, 5, 12, 0, 2, 5, 319}, // (
+    {0x0029, 5, 12, 0, 2, 5, 349}, // )
+    {0x002A, 7, 10, 0, 3, 7, 379}, // *
+    {0x002B, 12, 9, 0, 4, 12, 414}, // +
+    {0x002C, 4, 3, 0, 11, 4, 468}, // ,
+    {0x002D, 5, 4, 0, 9, 5, 474}, // -
+    {0x002E, 4, 2, 0, 11, 4, 484}, // .
+    {0x002F, 5, 12, 0, 3, 5, 488}, // /
+    {0x0030, 9, 10, 0, 3, 9, 518}, // 0
+    {0x0031, 9, 10, 0, 3, 9, 563}, // 1
+    {0x0032, 9, 10, 0, 3, 9, 608}, // 2
+    {0x0033, 9, 10, 0, 3, 9, 653}, // 3
+    {0x0034, 9, 10, 0, 3, 9, 698}, // 4
+    {0x0035, 9, 10, 0, 3, 9, 743}, // 5
+    {0x0036, 9, 10, 0, 3, 9, 788}, // 6
+    {0x0037, 9, 10, 0, 3, 9, 833}, // 7
+    {0x0038, 9, 10, 0, 3, 9, 878}, // 8
+    {0x0039, 9, 10, 0, 3, 9, 923}, // 9
+    {0x003A, 5, 7, 0, 6, 5, 968}, // :
+    {0x003B, 5, 8, 0, 6, 5, 986}, // ;
+    {0x003C, 12, 8, 0, 5, 12, 1006}, // <
+    {0x003D, 12, 7, 0, 6, 12, 1054}, // =
+    {0x003E, 12, 8, 0, 5, 12, 1096}, // >
+    {0x003F, 7, 10, 0, 3, 7, 1144}, // ?
+    {0x0040, 14, 12, 0, 3, 14, 1179}, // @
+    {0x0041, 10, 10, 0, 3, 10, 1263}, // A
+    {0x0042, 10, 10, 0, 3, 10, 1313}, // B
+    {0x0043, 10, 10, 0, 3, 10, 1363}, // C
+    {0x0044, 11, 10, 0, 3, 11, 1413}, // D
+    {0x0045, 9, 10, 0, 3, 9, 1468}, // E
+    {0x0046, 8, 10, 0, 3, 8, 1513}, // F
+    {0x0047, 11, 10, 0, 3, 11, 1553}, // G
+    {0x0048, 11, 10, 0, 3, 11, 1608}, // H
+    {0x0049, 4, 10, 0, 3, 4, 1663}, // I
+    {0x004A, 5, 13, -1, 3, 4, 1683}, // J
+    {0x004B, 10, 10, 0, 3, 9, 1716}, // K
+    {0x004C, 8, 10, 0, 3, 8, 1766}, // L
+    {0x004D, 12, 10, 0, 3, 12, 1806}, // M
+    {0x004E, 10, 10, 0, 3, 10, 1866}, // N
+    {0x004F, 11, 10, 0, 3, 11, 1916}, // O
+    {0x0050, 8, 10, 0, 3, 8, 1971}, // P
+    {0x0051, 11, 12, 0, 3, 11, 2011}, // Q
+    {0x0052, 10, 10, 0, 3, 10, 2077}, // R
+    {0x0053, 9, 10, 0, 3, 9, 2127}, // S
+    {0x0054, 10, 10, -1, 3, 9, 2172}, // T
+    {0x0055, 10, 10, 0, 3, 10, 2222}, // U
+    {0x0056, 10, 10, 0, 3, 10, 2272}, // V
+    {0x0057, 14, 10, 0, 3, 14, 2322}, // W
+    {0x0058, 10, 10, 0, 3, 10, 2392}, // X
+    {0x0059, 10, 10, -1, 3, 9, 2442}, // Y
+    {0x005A, 10, 10, 0, 3, 10, 2492}, // Z
+    {0x005B, 5, 12, 0, 2, 5, 2542}, // [
+    {0x005C, 5, 12, 0, 3, 5, 2572}, // U+005C
+    {0x005D, 5, 12, 0, 2, 5, 2602}, // ]
+    {0x005E, 12, 10, 0, 3, 12, 2632}, // ^
+    {0x005F, 9, 3, -1, 13, 7, 2692}, // _
+    {0x0060, 7, 11, 0, 2, 7, 2706}, // `
+    {0x0061, 9, 8, 0, 5, 9, 2745}, // a
+    {0x0062, 9, 11, 0, 2, 9, 2781}, // b
+    {0x0063, 8, 8, 0, 5, 8, 2831}, // c
+    {0x0064, 9, 11, 0, 2, 9, 2863}, // d
+    {0x0065, 9, 8, 0, 5, 9, 2913}, // e
+    {0x0066, 6, 11, 0, 2, 5, 2949}, // f
+    {0x0067, 9, 11, 0, 5, 9, 2982}, // g
+    {0x0068, 9, 11, 0, 2, 9, 3032}, // h
+    {0x0069, 4, 11, 0, 2, 4, 3082}, // i
+    {0x006A, 5, 14, -1, 2, 4, 3104}, // j
+    {0x006B, 9, 11, 0, 2, 8, 3139}, // k
+    {0x006C, 4, 11, 0, 2, 4, 3189}, // l
+    {0x006D, 14, 8, 0, 5, 14, 3211}, // m
+    {0x006E, 9, 8, 0, 5, 9, 3267}, // n
+    {0x006F, 9, 8, 0, 5, 9, 3303}, // o
+    {0x0070, 9, 11, 0, 5, 9, 3339}, // p
+    {0x0071, 9, 11, 0, 5, 9, 3389}, // q
+    {0x0072, 6, 8, 0, 5, 6, 3439}, // r
+    {0x0073, 7, 8, 0, 5, 7, 3463}, // s
+    {0x0074, 6, 10, 0, 3, 5, 3491}, // t
+    {0x0075, 9, 8, 0, 5, 9, 3521}, // u
+    {0x0076, 8, 8, 0, 5, 8, 3557}, // v
+    {0x0077, 11, 8, 0, 5, 11, 3589}, // w
+    {0x0078, 8, 8, 0, 5, 8, 3633}, // x
+    {0x0079, 8, 11, 0, 5, 8, 3665}, // y
+    {0x007A, 7, 8, 0, 5, 7, 3709}, // z
+    {0x007B, 9, 13, 0, 2, 9, 3737}, // {
+    {0x007C, 5, 14, 0, 2, 5, 3796}, // |
+    {0x007D, 9, 13, 0, 2, 9, 3831}, // }
+    {0x007E, 12, 6, 0, 7, 12, 3890}, // ~
+};
+
+const Font_t Font_Sans14 = {
+    Font_Sans14_Glyphs,
+    Font_Sans14_Bitmap,
+    95, // GlyphNum
+    4, // Bpp
+    17, // LineHeight
+    13, // Baseline
+    0x003F, // Fallback
+};
@@ -0,0 +1,479 @@
+#include "LCD.h"
+
+#include "main.h"
+#include "spi.h"
+#include "MicroOS.h"
+
+// ST7789 commands
+#define LCD_CMD_SWRESET (0x01)
+#define LCD_CMD_SLPOUT (0x11)
+#define LCD_CMD_NORON (0x13)
+#define LCD_CMD_INVON (0x21)
+#define LCD_CMD_DISPON (0x29)
+#define LCD_CMD_CASET (0x2A)
+#define LCD_CMD_RASET (0x2B)
+#define LCD_CMD_RAMWR (0x2C)
+#define LCD_CMD_VSCRDEF (0x33)
+#define LCD_CMD_TEOFF (0x34)
+#define LCD_CMD_TEON (0x35)
+#define LCD_CMD_MADCTL (0x36)
+#define LCD_CMD_VSCSAD (0x37)
+#define LCD_CMD_COLMOD (0x3A)
+
+#define LCD_COLMOD_RGB565 (0x55)
+
+#define LCD_SPI_TIMEOUT (10)        // Command transfer timeout in ms
+#define LCD_FILL_TIMEOUT (1000)     // LCD_Fill() timeout in ms
+#define LCD_DMA_MAX_FRAMES (0xFFFF) // HAL_SPI_Transmit_DMA() counts in uint16_t
+
+typedef struct
+{
+    volatile bool Busy;          // DMA transfer running
+    volatile bool Error;         // Last transfer failed
+    bool Notify;                 // Trigger LCD_EVENT_FLUSH_DONE at the end
+    bool Frame16;                // SPI is in 16-bit frame mode
+    const uint16_t *Src;         // Next chunk source
+    volatile uint32_t Remaining; // Pixels of the current window not handed to DMA yet
+    bool Increment;              // Source advances (false for LCD_Fill)
+    LCD_Rect_t Rect;             // Target of the running transfer, screen coordinates
+    uint16_t Row;                // Next screen row of Rect without a window yet
+    uint16_t ScrollTop;          // Scroll area in screen rows
+    uint16_t ScrollHeight;       // 0 while vertical scrolling is off
+    uint16_t ScrollOffset;       // Area row shown at the top of the scroll area
+} LCD_Handle_t;
+
+static LCD_Handle_t LCD = {0};
+
+static uint16_t LCD_FillColor = 0; // DMA source for LCD_Fill
+
+static void LCD_Select(void)
+{
+    HAL_GPIO_WritePin(SPI1_CS_GPIO_Port, SPI1_CS_Pin, GPIO_PIN_RESET);
+}
+
+static void LCD_Deselect(void)
+{
+    HAL_GPIO_WritePin(SPI1_CS_GPIO_Port, SPI1_CS_Pin, GPIO_PIN_SET);
+}
+
+/**
+ * @brief Pick the smallest SPI1 prescaler that keeps SCK at or below LCD_SPI_MAX_HZ
+ */
+static void LCD_SetBaudRate(void)
+{
+    uint32_t pclk = HAL_RCC_GetPCLK2Freq();
+    uint32_t br = 0;
+
+    while ((br < 7) && ((pclk >> (br + 1)) > LCD_SPI_MAX_HZ))
+    {
+        br++;
+    }
+
+    __HAL_SPI_DISABLE(&hspi1);
+    MODIFY_REG(hspi1.Instance->CR1, SPI_CR1_BR, br << SPI_CR1_BR_Pos);
+    hspi1.Init.BaudRatePrescaler = br << SPI_CR1_BR_Pos;
+}
+
+/**
+ * @brief Switch SPI1 and its TX DMA channel between 8-bit and 16-bit frames
+ * @note SPI and DMA must be idle; both are disabled while their size fields change
+ */
+static void LCD_SetFrame16(bool on)
+{
+    DMA_HandleTypeDef *hdma = hspi1.hdmatx;
+
+    if (LCD.Frame16 == on)
+        return;
+
+    __HAL_SPI_DISABLE(&hspi1);
+    __HAL_DMA_DISABLE(hdma);
+    if (on)
+    {
+        MODIFY_REG(hspi1.Instance->CR2, SPI_CR2_DS | SPI_CR2_FRXTH, SPI_DATASIZE_16BIT);
+        MODIFY_REG(hdma->Instance->CCR, DMA_CCR_PSIZE | DMA_CCR_MSIZE, DMA_PDATAALIGN_HALFWORD | DMA_MDATAALIGN_HALFWORD);
+        hspi1.Init.DataSize = SPI_DATASIZE_16BIT;
+        hdma->Init.PeriphDataAlignment = DMA_PDATAALIGN_HALFWORD;
+        hdma->Init.MemDataAlignment = DMA_MDATAALIGN_HALFWORD;
+    }
+    else
+    {
+        MODIFY_REG(hspi1.Instance->CR2, SPI_CR2_DS | SPI_CR2_FRXTH, SPI_DATASIZE_8BIT | SPI_RXFIFO_THRESHOLD);
+        MODIFY_REG(hdma->Instance->CCR, DMA_CCR_PSIZE | DMA_CCR_MSIZE, DMA_PDATAALIGN_BYTE | DMA_MDATAALIGN_BYTE);
+        hspi1.Init.DataSize = SPI_DATASIZE_8BIT;
+        hdma->Init.PeriphDataAlignment = DMA_PDATAALIGN_BYTE;
+        hdma->Init.MemDataAlignment = DMA_MDATAALIGN_BYTE;
+    }
+    LCD.Frame16 = on;
+}
+
+/**
+ * @brief Enable or disable memory increment of the TX DMA channel
+ */
+static void LCD_SetIncrement(bool on)
+{
+    DMA_HandleTypeDef *hdma = hspi1.hdmatx;
+
+    if (LCD.Increment == on)
+        return;
+
+    __HAL_DMA_DISABLE(hdma);
+    if (on)
+    {
+        SET_BIT(hdma->Instance->CCR, DMA_CCR_MINC);
+        hdma->Init.MemInc = DMA_MINC_ENABLE;
+    }
+    else
+    {
+        CLEAR_BIT(hdma->Instance->CCR, DMA_CCR_MINC);
+        hdma->Init.MemInc = DMA_MINC_DISABLE;
+    }
+    LCD.Increment = on;
+}
+
+/**
+ * @brief Send a command and its parameters, CS must already be low
+ */
+static LCD_Status_t LCD_WriteCommand(uint8_t cmd, const uint8_t *data, uint16_t len)
+{
+    LCD_SetFrame16(false);
+
+    HAL_GPIO_WritePin(LCD_DC_GPIO_Port, LCD_DC_Pin, GPIO_PIN_RESET);
+    if (HAL_SPI_Transmit(&hspi1, &cmd, 1, LCD_SPI_TIMEOUT) != HAL_OK)
+        return LCD_ERROR;
+
+    HAL_GPIO_WritePin(LCD_DC_GPIO_Port, LCD_DC_Pin, GPIO_PIN_SET);
+    if (len > 0 && HAL_SPI_Transmit(&hspi1, (uint8_t *)data, len, LCD_SPI_TIMEOUT) != HAL_OK)
+        return LCD_ERROR;
+
+    return LCD_OK;
+}
+
+/**
+ * @brief Set the address window and start a memory write, leaves DC high for pixel data
+ */
+static LCD_Status_t LCD_SetWindow(const LCD_Rect_t *rect)
+{
+    uint16_t x0 = rect->x + LCD_X_OFFSET;
+    uint16_t x1 = x0 + rect->w - 1;
+    uint16_t y0 = rect->y + LCD_Y_OFFSET;
+    uint16_t y1 = y0 + rect->h - 1;
+    uint8_t col[4] = {x0 >> 8, x0 & 0xFF, x1 >> 8, x1 & 0xFF};
+    uint8_t row[4] = {y0 >> 8, y0 & 0xFF, y1 >> 8, y1 & 0xFF};
+
+    if (LCD_WriteCommand(LCD_CMD_CASET, col, sizeof(col)) != LCD_OK)
+        return LCD_ERROR;
+    if (LCD_WriteCommand(LCD_CMD_RASET, row, sizeof(row)) != LCD_OK)
+        return LCD_ERROR;
+
+    return LCD_WriteCommand(LCD_CMD_RAMWR, NULL, 0);
+}
+
+/**
+ * @brief Map screen rows to frame memory rows
+ * @param y First screen row
+ * @param h Rows wanted
+ * @param mem_y Frame memory row showing screen row y (without LCD_Y_OFFSET)
+ * @return Rows from y on that are contiguous in frame memory
+ */
+static uint16_t LCD_MapRows(uint16_t y, uint16_t h, uint16_t *mem_y)
+{
+    uint16_t end = LCD.ScrollTop + LCD.ScrollHeight;
+    uint16_t pos = 0;
+    uint16_t rows = 0;
+
+    *mem_y = y;
+    if (LCD.ScrollHeight == 0 || y >= end)
+        return h;
+    if (y < LCD.ScrollTop)
+        return (y + h > LCD.ScrollTop) ? LCD.ScrollTop - y : h;
+
+    // Inside the scroll area the memory rows form a ring starting at ScrollOffset
+    pos = (y - LCD.ScrollTop + LCD.ScrollOffset) % LCD.ScrollHeight;
+    *mem_y = LCD.ScrollTop + pos;
+    rows = LCD.ScrollHeight - pos;
+    if (rows > end - y)
+        rows = end - y;
+    return (rows < h) ? rows : h;
+}
+
+/**
+ * @brief Hand the next chunk of at most LCD_DMA_MAX_FRAMES pixels to DMA
+ */
+static LCD_Status_t LCD_StartChunk(void)
+{
+    uint16_t frames = (LCD.Remaining > LCD_DMA_MAX_FRAMES) ? LCD_DMA_MAX_FRAMES : (uint16_t)LCD.Remaining;
+
+    LCD.Remaining -= frames;
+    if (HAL_SPI_Transmit_DMA(&hspi1, (uint8_t *)LCD.Src, frames) != HAL_OK)
+        return LCD_ERROR;
+
+    if (LCD.Increment)
+        LCD.Src += frames;
+
+    return LCD_OK;
+}
+
+/**
+ * @brief Open the address window for the next run of rows that is contiguous in frame memory
+ *        and start sending it
+ * @note Also called from the DMA complete interrupt; the window commands are short polled transfers
+ */
+static LCD_Status_t LCD_StartWindow(void)
+{
+    LCD_Rect_t window = LCD.Rect;
+
+    window.h = LCD_MapRows(LCD.Row, LCD.Rect.y + LCD.Rect.h - LCD.Row, &window.y);
+    LCD.Row += window.h;
+    if (LCD_SetWindow(&window) != LCD_OK)
+        return LCD_ERROR;
+
+    LCD_SetFrame16(true);
+    LCD.Remaining = (uint32_t)window.w * window.h;
+    return LCD_StartChunk();
+}
+
+/**
+ * @brief Common path of LCD_Flush() and LCD_Fill()
+ */
+static LCD_Status_t LCD_Start(const LCD_Rect_t *rect, const uint16_t *src, bool increment, bool notify)
+{
+    if (rect == NULL || src == NULL || ((uintptr_t)src & 1) != 0)
+        return LCD_INVALID_PARAM;
+    if (rect->w == 0 || rect->h == 0 || rect->x + rect->w > LCD_WIDTH || rect->y + rect->h > LCD_HEIGHT)
+        return LCD_INVALID_PARAM;
+    if (LCD.Busy)
+        return LCD_BUSY;
+
+    LCD_Select();
+    LCD_SetIncrement(increment);
+    LCD.Src = src;
+    LCD.Rect = *rect;
+    LCD.Row = rect->y;
+    LCD.Notify = notify;
+    LCD.Error = false;
+    LCD.Busy = true;
+
+    if (LCD_StartWindow() != LCD_OK)
+    {
+        LCD.Busy = false;
+        LCD_Deselect();
+        return LCD_ERROR;
+    }
+
+    return LCD_OK;
+}
+
+LCD_Status_t LCD_Init(void)
+{
+    static const uint8_t colmod = LCD_COLMOD_RGB565;
+    static const uint8_t madctl = LCD_MADCTL;
+    LCD_Status_t ret = LCD_OK;
+
+    LCD.Frame16 = (hspi1.Init.DataSize == SPI_DATASIZE_16BIT);
+    LCD.Increment = (hspi1.hdmatx->Init.MemInc == DMA_MINC_ENABLE);
+    LCD_SetBaudRate();
+
+    LCD_SetBacklight(false);
+    LCD_Deselect();
+    HAL_GPIO_WritePin(LCD_RESET_GPIO_Port, LCD_RESET_Pin, GPIO_PIN_RESET);
+    HAL_Delay(10);
+    HAL_GPIO_WritePin(LCD_RESET_GPIO_Port, LCD_RESET_Pin, GPIO_PIN_SET);
+    HAL_Delay(120);
+
+    LCD_Select();
+    if (LCD_WriteCommand(LCD_CMD_SWRESET, NULL, 0) != LCD_OK)
+        ret = LCD_ERROR;
+    HAL_Delay(120);
+    if (LCD_WriteCommand(LCD_CMD_SLPOUT, NULL, 0) != LCD_OK)
+        ret = LCD_ERROR;
+    HAL_Delay(10);
+    if (LCD_WriteCommand(LCD_CMD_COLMOD, &colmod, 1) != LCD_OK ||
+        LCD_WriteCommand(LCD_CMD_MADCTL, &madctl, 1) != LCD_OK ||
+        LCD_WriteCommand(LCD_CMD_INVON, NULL, 0) != LCD_OK ||
+        LCD_WriteCommand(LCD_CMD_NORON, NULL, 0) != LCD_OK)
+        ret = LCD_ERROR;
+    LCD_Deselect();
+    if (ret != LCD_OK)
+        return ret;
+
+    // Clear the RAM before the display is switched on, so no garbage shows up
+    ret = LCD_Fill(NULL, 0x0000);
+    if (ret != LCD_OK)
+        return ret;
+
+    LCD_Select();
+    ret = LCD_WriteCommand(LCD_CMD_DISPON, NULL, 0);
+    LCD_Deselect();
+
+    LCD_SetBacklight(true);
+    return ret;
+}
+
+LCD_Status_t LCD_Flush(const LCD_Rect_t *rect, const uint16_t *buf)
+{
+    return LCD_Start(rect, buf, true, true);
+}
+
+LCD_Status_t LCD_Fill(const LCD_Rect_t *rect, uint16_t color)
+{
+    static const LCD_Rect_t screen = {0, 0, LCD_WIDTH, LCD_HEIGHT};
+    LCD_Status_t ret = LCD_OK;
+
+    if (LCD.Busy)
+        return LCD_BUSY;
+
+    LCD_FillColor = color;
+    ret = LCD_Start((rect != NULL) ? rect : &screen, &LCD_FillColor, false, false);
+    if (ret != LCD_OK)
+        return ret;
+
+    return LCD_WaitIdle(LCD_FILL_TIMEOUT);
+}
+
+bool LCD_IsBusy(void)
+{
+    return LCD.Busy;
+}
+
+LCD_Status_t LCD_GetResult(void)
+{
+    if (LCD.Busy)
+        return LCD_BUSY;
+
+    return LCD.Error ? LCD_ERROR : LCD_OK;
+}
+
+LCD_Status_t LCD_WaitIdle(uint32_t timeout_ms)
+{
+    uint32_t start = HAL_GetTick();
+
+    while (LCD.Busy)
+    {
+        if (HAL_GetTick() - start >= timeout_ms)
+            return LCD_TIMEOUT;
+    }
+
+    return LCD.Error ? LCD_ERROR : LCD_OK;
+}
+
+LCD_Status_t LCD_SetTearing(bool on)
+{
+    static const uint8_t vblank_only = 0x00;
+    LCD_Status_t ret = LCD_OK;
+
+    if (LCD.Busy)
+        return LCD_BUSY;
+
+    LCD_Select();
+    if (on)
+        ret = LCD_WriteCommand(LCD_CMD_TEON, &vblank_only, 1);
+    else
+        ret = LCD_WriteCommand(LCD_CMD_TEOFF, NULL, 0);
+    LCD_Deselect();
+
+    return ret;
+}
+
+LCD_Status_t LCD_SetScrollArea(uint16_t top, uint16_t height)
+{
+    uint16_t tfa = 0;
+    uint16_t vsa = LCD_MEMORY_HEIGHT;
+    uint16_t bfa = 0;
+    uint8_t def[6] = {0};
+    uint8_t start[2] = {0};
+    LCD_Status_t ret = LCD_OK;
+
+    if (height > 0 && top + height > LCD_HEIGHT)
+        return LCD_INVALID_PARAM;
+    if (LCD.Busy)
+        return LCD_BUSY;
+
+    if (height > 0)
+    {
+        tfa = top + LCD_Y_OFFSET;
+        vsa = height;
+        bfa = LCD_MEMORY_HEIGHT - tfa - vsa;
+    }
+    def[0] = tfa >> 8;
+    def[1] = tfa & 0xFF;
+    def[2] = vsa >> 8;
+    def[3] = vsa & 0xFF;
+    def[4] = bfa >> 8;
+    def[5] = bfa & 0xFF;
+    // Start at the first area row, so the screen looks the same as before
+    start[0] = tfa >> 8;
+    start[1] = tfa & 0xFF;
+
+    LCD_Select();
+    if (LCD_WriteCommand(LCD_CMD_VSCRDEF, def, sizeof(def)) != LCD_OK ||
+        LCD_WriteCommand(LCD_CMD_VSCSAD, start, sizeof(start)) != LCD_OK)
+        ret = LCD_ERROR;
+    LCD_Deselect();
+
+    LCD.ScrollTop = (height > 0) ? top : 0;
+    LCD.ScrollHeight = height;
+    LCD.ScrollOffset = 0;
+    return ret;
+}
+
+LCD_Status_t LCD_SetScroll(uint16_t offset)
+{
+    uint16_t vsp = LCD.ScrollTop + LCD_Y_OFFSET + offset;
+    uint8_t start[2] = {vsp >> 8, vsp & 0xFF};
+    LCD_Status_t ret = LCD_OK;
+
+    if (LCD.ScrollHeight == 0 || offset >= LCD.ScrollHeight)
+        return LCD_INVALID_PARAM;
+    if (LCD.Busy)
+        return LCD_BUSY;
+
+    LCD_Select();
+    ret = LCD_WriteCommand(LCD_CMD_VSCSAD, start, sizeof(start));
+    LCD_Deselect();
+
+    LCD.ScrollOffset = offset;
+    return ret;
+}
+
+void LCD_SetBacklight(bool on)
+{
+    HAL_GPIO_WritePin(LCD_BLK_GPIO_Port, LCD_BLK_Pin, on ? GPIO_PIN_SET : GPIO_PIN_RESET);
+}
+
+void LCD_TxCpltCallback(void)
+{
+    if (!LCD.Busy)
+        return;
+
+    if (LCD.Remaining > 0)
+    {
+        if (LCD_StartChunk() == LCD_OK)
+            return;
+        LCD.Error = true;
+    }
+    else if (LCD.Row < LCD.Rect.y + LCD.Rect.h)
+    {
+        // The rectangle wraps around the scroll area: continue in a new window
+        if (LCD_StartWindow() == LCD_OK)
+            return;
+        LCD.Error = true;
+    }
+
+    LCD_Deselect();
+    LCD.Busy = false;
+    if (LCD.Notify)
+        MicroOS_TriggerEvent(LCD_EVENT_FLUSH_DONE);
+}
+
+void LCD_ErrorCallback(void)
+{
+    if (!LCD.Busy)
+        return;
+
+    LCD.Error = true;
+    LCD.Remaining = 0;
+    LCD_Deselect();
+    LCD.Busy = false;
+    if (LCD.Notify)
+        MicroOS_TriggerEvent(LCD_EVENT_FLUSH_DONE);
+}
@@ -1,4 +1,5 @@
 #include "flag.h"
+#include "spi.h"
 
 void UserTask_Testdelay(void *data)
 {
@@ -32,3 +33,47 @@ void UserTask_DelayClear(void *data)
 		MicroOS_OSdelay_Remove(4);
 	}
 }
+
+void HAL_SPI_TxCpltCallback(SPI_HandleTypeDef *hspi)
+{
+	if(hspi->Instance == SPI1)
+	{
+		LCD_TxCpltCallback();
+	}
+	else if(hspi->Instance == SPI3)
+	{
+		SD_TxCpltCallback();
+	}
+}
+
+void HAL_SPI_TxRxCpltCallback(SPI_HandleTypeDef *hspi)
+{
+	if(hspi->Instance == SPI3)
+	{
+		SD_TxRxCpltCallback();
+	}
+}
+
+void HAL_SPI_ErrorCallback(SPI_HandleTypeDef *hspi)
+{
+	if(hspi->Instance == SPI1)
+	{
+		LCD_ErrorCallback();
+	}
+	else if(hspi->Instance == SPI3)
+	{
+		SD_ErrorCallback();
+	}
+}
+
+void HAL_GPIO_EXTI_Callback(uint16_t GPIO_Pin)
+{
+	if(GPIO_Pin == LCD_TE_Pin)
+	{
+		Present_TeCallback();
+	}
+	else if(GPIO_Pin == RETURN_KEY_Pin || GPIO_Pin == UP_KEY_Pin || GPIO_Pin == DOWN_KEY_Pin || GPIO_Pin == ENTER_KEY_Pin)
+	{
+		Widget_KeyCallback(GPIO_Pin);
+	}
+}
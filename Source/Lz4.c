@@ -0,0 +1,226 @@
+#include "Lz4.h"
+
+#include "main.h"
+#include "string.h"
+
+#define LZ4_MIN_MATCH (4)
+// Literal runs up to this long are copied as one fixed block
+#define LZ4_SHORT_COPY (16)
+
+static inline void Lz4_Copy4(uint8_t *dst, const uint8_t *src)
+{
+    __UNALIGNED_UINT32_WRITE(dst, __UNALIGNED_UINT32_READ(src));
+}
+
+static inline void Lz4_Copy16(uint8_t *dst, const uint8_t *src)
+{
+    Lz4_Copy4(dst, src);
+    Lz4_Copy4(dst + 4, src + 4);
+    Lz4_Copy4(dst + 8, src + 8);
+    Lz4_Copy4(dst + 12, src + 12);
+}
+
+/**
+ * @brief Read the extension bytes of a length field
+ * @return false if the block ends inside them
+ */
+static inline bool Lz4_Length(const uint8_t **ip, const uint8_t *iend, uint32_t *length)
+{
+    uint8_t b = 0;
+
+    do
+    {
+        if (*ip >= iend)
+            return false;
+        b = *(*ip)++;
+        *length += b;
+    } while (b == 255);
+    return true;
+}
+
+Lz4_Status_t Lz4_Decompress(const uint8_t *src, uint32_t size, uint8_t *dst, uint32_t capacity, uint32_t *written)
+{
+    const uint8_t *ip = src;
+    const uint8_t *iend = src + size;
+    uint8_t *op = dst;
+    uint8_t *oend = dst + capacity;
+
+    if (src == NULL || dst == NULL || size == 0)
+        return LZ4_INVALID_PARAM;
+
+    for (;;)
+    {
+        uint32_t token = *ip++;
+        uint32_t length = token >> 4;
+        uint32_t offset = 0;
+        const uint8_t *match = NULL;
+
+        // Literals
+        if (length == 15 && !Lz4_Length(&ip, iend, &length))
+            return LZ4_FORMAT;
+        if (length > (uint32_t)(iend - ip))
+            return LZ4_FORMAT;
+        if (length > (uint32_t)(oend - op))
+            return LZ4_OVERFLOW;
+
+        if (length <= LZ4_SHORT_COPY && iend - ip >= LZ4_SHORT_COPY && oend - op >= LZ4_SHORT_COPY)
+        {
+            Lz4_Copy16(op, ip);
+        }
+        else
+        {
+            uint32_t n = length;
+            uint8_t *o = op;
+            const uint8_t *i = ip;
+
+            while (n >= 4)
+            {
+                Lz4_Copy4(o, i);
+                o += 4;
+                i += 4;
+                n -= 4;
+            }
+            while (n--)
+                *o++ = *i++;
+        }
+        op += length;
+        ip += length;
+
+        // The last sequence has literals only
+        if (ip == iend)
+            break;
+
+        // Match
+        if (iend - ip < 2)
+            return LZ4_FORMAT;
+        offset = ip[0] | ((uint32_t)ip[1] << 8);
+        ip += 2;
+        if (offset == 0 || offset > (uint32_t)(op - dst))
+            return LZ4_FORMAT;
+
+        length = token & 0x0F;
+        if (length == 15 && !Lz4_Length(&ip, iend, &length))
+            return LZ4_FORMAT;
+        length += LZ4_MIN_MATCH;
+        if (length > (uint32_t)(oend - op))
+            return LZ4_OVERFLOW;
+        if (ip >= iend)
+            return LZ4_FORMAT;
+
+        match = op - offset;
+        if (offset == 1)
+        {
+            memset(op, *match, length);
+        }
+        else if (offset == 2 && (uint32_t)(oend - op) >= length + 3)
+        {
+            // One repeated RGB565 pixel, the common case in flat picture areas
+            uint32_t pattern = match[0] | ((uint32_t)match[1] << 8);
+            uint8_t *o = op;
+            uint8_t *end = op + length;
+
+            pattern |= pattern << 16;
+            do
+            {
+                __UNALIGNED_UINT32_WRITE(o, pattern);
+                o += 4;
+            } while (o < end);
+        }
+        else if (offset >= 4 && (uint32_t)(oend - op) >= length + 3)
+        {
+            // Every word read lies at least 4 bytes back, so it is written already
+            uint8_t *o = op;
+            uint8_t *end = op + length;
+
+            do
+            {
+                Lz4_Copy4(o, match);
+                o += 4;
+                match += 4;
+            } while (o < end);
+        }
+        else
+        {
+            uint8_t *o = op;
+            uint32_t n = length;
+
+            while (n--)
+                *o++ = *match++;
+        }
+        op += length;
+    }
+
+    if (written != NULL)
+        *written = (uint32_t)(op - dst);
+    return LZ4_OK;
+}
+
+Lz4_Status_t Lz4_Decompress_Ref(const uint8_t *src, uint32_t size, uint8_t *dst, uint32_t capacity, uint32_t *written)
+{
+    uint32_t ip = 0;
+    uint32_t op = 0;
+
+    if (src == NULL || dst == NULL || size == 0)
+        return LZ4_INVALID_PARAM;
+
+    for (;;)
+    {
+        uint32_t token = src[ip++];
+        uint32_t length = token >> 4;
+        uint32_t offset = 0;
+        uint8_t b = 0;
+
+        if (length == 15)
+        {
+            do
+            {
+                if (ip >= size)
+                    return LZ4_FORMAT;
+                b = src[ip++];
+                length += b;
+            } while (b == 255);
+        }
+        if (length > size - ip)
+            return LZ4_FORMAT;
+        if (length > capacity - op)
+            return LZ4_OVERFLOW;
+        while (length--)
+            dst[op++] = src[ip++];
+
+        if (ip == size)
+            break;
+
+        if (size - ip < 2)
+            return LZ4_FORMAT;
+        offset = src[ip] | ((uint32_t)src[ip + 1] << 8);
+        ip += 2;
+        if (offset == 0 || offset > op)
+            return LZ4_FORMAT;
+
+        length = token & 0x0F;
+        if (length == 15)
+        {
+            do
+            {
+                if (ip >= size)
+                    return LZ4_FORMAT;
+                b = src[ip++];
+                length += b;
+            } while (b == 255);
+        }
+        length += LZ4_MIN_MATCH;
+        if (length > capacity - op)
+            return LZ4_OVERFLOW;
+        if (ip >= size)
+            return LZ4_FORMAT;
+        while (length--)
+        {
+            dst[op] = dst[op - offset];
+            op++;
+        }
+    }
+
+    if (written != NULL)
+        *written = op;
+    return LZ4_OK;
+}
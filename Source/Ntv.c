@@ -0,0 +1,400 @@
+#include "Ntv.h"
+
+#include "main.h"
+#include "string.h"
+#include "BlockDev.h"
+#include "Lz4.h"
+
+#if NTV_QUEUE < 2 || NTV_QUEUE > 255
+#error "NTV_QUEUE must be 2..255"
+#endif
+
+#if NTV_SECTOR_SIZE != BLOCKDEV_SECTOR_SIZE
+#error "NTV_SECTOR_SIZE and BLOCKDEV_SECTOR_SIZE differ"
+#endif
+
+typedef struct
+{
+    Fat_File_t *File;     // Open file, NULL when closed
+    Ntv_Header_t Header;
+    uint32_t NextPos;     // File position of the next chunk to read
+    uint16_t NextSectors; // Its size, 0 after the last chunk
+    bool Failed;          // Broken chunk or file system error, no more reads until a seek
+
+    uint16_t Start[NTV_QUEUE];   // Buffer sector of every queued chunk
+    uint16_t Sectors[NTV_QUEUE]; // Its size
+    uint8_t First;               // Queue entry of the oldest chunk
+    uint8_t Count;               // Queued chunks, the one being read included
+    bool Reading;                // Newest queued chunk is not complete yet
+    uint16_t Got;                // Sectors of it read so far
+
+    bool InFlight;              // Card read running into the buffer
+    bool Stale;                 // Dropped while in flight: ignore it when it ends
+    uint16_t ReadCount;         // Sectors of the read in flight
+    uint32_t IssueTick;         // HAL tick when it was issued
+    BlockDev_Request_t Request; // Its result, kept for us whoever waits for the card
+
+#if NTV_LZ4_BUFFER > 0
+    Ntv_Chunk_t UnpackedChunk; // Header handed out for the unpacked oldest chunk
+    bool Unpacked;             // Oldest chunk is unpacked already
+#endif
+
+    Ntv_Stats_t Stats;
+} Ntv_Handle_t;
+
+static Ntv_Handle_t Ntv = {0};
+
+static __ALIGNED(4) uint8_t Ntv_Buffer[NTV_BUFFER_SECTORS][NTV_SECTOR_SIZE];
+
+#if NTV_LZ4_BUFFER > 0
+static __ALIGNED(4) uint8_t Ntv_UnpackBuffer[NTV_LZ4_BUFFER];
+#endif
+
+/**
+ * @brief Buffer sector where a chunk of the given size fits in one piece
+ * @return false if there is no room before the oldest chunk
+ */
+static bool Ntv_Place(uint16_t sectors, uint16_t *start)
+{
+    uint8_t last = 0;
+    uint16_t tail = 0;
+    uint16_t head = 0;
+
+    if (Ntv.Count == 0)
+    {
+        *start = 0;
+        return true;
+    }
+    if (Ntv.Count >= NTV_QUEUE)
+        return false;
+
+    last = (uint8_t)((Ntv.First + Ntv.Count - 1) % NTV_QUEUE);
+    tail = Ntv.Start[Ntv.First];
+    head = Ntv.Start[last] + Ntv.Sectors[last];
+
+    if (head > tail)
+    {
+        // Free space behind the newest chunk and in front of the oldest; the end is skipped if short
+        if (head + sectors <= NTV_BUFFER_SECTORS)
+            *start = head;
+        else if (sectors <= tail)
+            *start = 0;
+        else
+            return false;
+        return true;
+    }
+
+    if (head + sectors > tail)
+        return false;
+    *start = head;
+    return true;
+}
+
+/**
+ * @brief Drop the queue and continue reading at pos
+ */
+static void Ntv_Restart(uint32_t pos, uint16_t sectors)
+{
+    // The buffer under a read in flight stays taken until it ends, Ntv_Issue() waits for that
+    Ntv.Stale = Ntv.InFlight;
+    Ntv.NextPos = pos;
+    Ntv.NextSectors = sectors;
+    Ntv.Failed = false;
+    Ntv.First = 0;
+    Ntv.Count = 0;
+    Ntv.Reading = false;
+    Ntv.Got = 0;
+#if NTV_LZ4_BUFFER > 0
+    Ntv.Unpacked = false;
+#endif
+}
+
+/**
+ * @brief A chunk has been read completely: check it and move on to the next one
+ */
+static void Ntv_Complete(void)
+{
+    uint8_t last = (uint8_t)((Ntv.First + Ntv.Count - 1) % NTV_QUEUE);
+    const Ntv_Chunk_t *chunk = (const Ntv_Chunk_t *)Ntv_Buffer[Ntv.Start[last]];
+
+    Ntv.Reading = false;
+    if (chunk->Sectors != Ntv.Sectors[last] || chunk->NextSectors > NTV_BUFFER_SECTORS ||
+        chunk->Size > (uint32_t)chunk->Sectors * NTV_SECTOR_SIZE - sizeof(Ntv_Chunk_t))
+    {
+        Ntv.Count--;
+        Ntv.Failed = true;
+        return;
+    }
+
+    Ntv.NextPos += (uint32_t)chunk->Sectors * NTV_SECTOR_SIZE;
+    Ntv.NextSectors = chunk->NextSectors;
+    Ntv.Stats.Chunks++;
+}
+
+/**
+ * @brief Take the result of the read in flight once the card is done with it
+ */
+static void Ntv_Done(void)
+{
+    uint32_t latency = 0;
+
+    if (!Ntv.InFlight)
+        return;
+    // A BlockCache read or write-back, or a Prefetch read, may have run since ours ended; the
+    // request still holds our result, BlockDev_IsBusy() fills it in once the read has ended
+    (void)BlockDev_IsBusy();
+    if (!Ntv.Request.Done)
+        return;
+
+    Ntv.InFlight = false;
+    if (Ntv.Stale)
+    {
+        Ntv.Stale = false;
+        return;
+    }
+
+    latency = Ntv.Request.EndTick - Ntv.IssueTick;
+    if (latency > Ntv.Stats.LatencyMaxMs)
+        Ntv.Stats.LatencyMaxMs = latency;
+
+    if (Ntv.Request.Result != BLOCKDEV_OK)
+    {
+        Ntv.Stats.Errors++;
+        return;
+    }
+
+    Ntv.Stats.Reads++;
+    Ntv.Stats.Sectors += Ntv.ReadCount;
+    Ntv.Got += Ntv.ReadCount;
+    if (Ntv.Got == Ntv.Sectors[(Ntv.First + Ntv.Count - 1) % NTV_QUEUE])
+        Ntv_Complete();
+}
+
+/**
+ * @brief Start reading the next chunk, or the rest of one split by fragmentation
+ */
+static void Ntv_Issue(void)
+{
+    Fat_Status_t fat = FAT_OK;
+    BlockDev_Status_t ret = BLOCKDEV_OK;
+    uint32_t sector = 0;
+    uint32_t run = 0;
+    uint16_t start = 0;
+    uint8_t last = 0;
+
+    if (Ntv.File == NULL || Ntv.Failed || Ntv.InFlight || BlockDev_IsBusy())
+        return;
+
+    if (!Ntv.Reading)
+    {
+        if (Ntv.NextSectors == 0 || !Ntv_Place(Ntv.NextSectors, &start))
+            return;
+        last = (uint8_t)((Ntv.First + Ntv.Count) % NTV_QUEUE);
+        Ntv.Start[last] = start;
+        Ntv.Sectors[last] = Ntv.NextSectors;
+        Ntv.Count++;
+        Ntv.Reading = true;
+        Ntv.Got = 0;
+    }
+    last = (uint8_t)((Ntv.First + Ntv.Count - 1) % NTV_QUEUE);
+
+    // Chunks are sector-aligned: one read covers the chunk unless an extent ends inside it
+    fat = Fat_GetRun(Ntv.File, Ntv.NextPos + (uint32_t)Ntv.Got * NTV_SECTOR_SIZE, &sector, &run);
+    if (fat == FAT_ERROR)
+    {
+        Ntv.Stats.Errors++;
+        return;
+    }
+    if (fat != FAT_OK)
+    {
+        Ntv.Failed = true;
+        return;
+    }
+    if (run > (uint32_t)(Ntv.Sectors[last] - Ntv.Got))
+        run = Ntv.Sectors[last] - Ntv.Got;
+
+    Ntv.InFlight = true;
+    Ntv.Stale = false;
+    Ntv.ReadCount = (uint16_t)run;
+    Ntv.IssueTick = HAL_GetTick();
+
+    ret = BlockDev_ReadAsync(sector, Ntv_Buffer[Ntv.Start[last] + Ntv.Got], run, &Ntv.Request);
+    if (ret != BLOCKDEV_OK)
+    {
+        Ntv.InFlight = false;
+        // Busy: another card user got in first, try again later
+        if (ret != BLOCKDEV_BUSY)
+            Ntv.Stats.Errors++;
+    }
+}
+
+/**
+ * @brief Read bytes at a file position through the file system (header, index)
+ */
+static Ntv_Status_t Ntv_Load(uint32_t pos, void *buf, uint32_t len)
+{
+    uint32_t read = 0;
+
+    if (Fat_Seek(Ntv.File, pos) != FAT_OK || Fat_Read(Ntv.File, buf, len, &read) != FAT_OK)
+        return NTV_ERROR;
+    return (read == len) ? NTV_OK : NTV_FORMAT;
+}
+
+Ntv_Status_t Ntv_Open(Fat_File_t *file)
+{
+    Ntv_Header_t *header = &Ntv.Header;
+    Ntv_Status_t ret = NTV_OK;
+
+    if (file == NULL)
+        return NTV_INVALID_PARAM;
+
+    Ntv_Close();
+    Ntv.File = file;
+    ret = Ntv_Load(0, header, sizeof(Ntv_Header_t));
+    if (ret == NTV_OK &&
+        (header->Magic != NTV_MAGIC || header->Version != NTV_VERSION || header->HeaderSize < sizeof(Ntv_Header_t) ||
+         header->DataSector == 0 || header->FirstSectors == 0 || header->MaxSectors > NTV_BUFFER_SECTORS ||
+         header->FirstSectors > header->MaxSectors || (header->IndexEntries > 0 && header->IndexPeriodMs == 0)))
+        ret = NTV_FORMAT;
+    if (ret != NTV_OK)
+    {
+        Ntv.File = NULL;
+        return ret;
+    }
+
+    Ntv_Restart(header->DataSector * NTV_SECTOR_SIZE, header->FirstSectors);
+    Ntv_Issue();
+    return NTV_OK;
+}
+
+void Ntv_Close(void)
+{
+    Ntv_Restart(0, 0);
+    Ntv.File = NULL;
+}
+
+const Ntv_Header_t *Ntv_GetHeader(void)
+{
+    return (Ntv.File != NULL) ? &Ntv.Header : NULL;
+}
+
+Ntv_Status_t Ntv_Seek(uint32_t ms)
+{
+    Ntv_IndexEntry_t entry = {0};
+    uint32_t i = 0;
+    Ntv_Status_t ret = NTV_OK;
+
+    if (Ntv.File == NULL)
+        return NTV_INVALID_PARAM;
+    if (Ntv.Header.IndexEntries == 0)
+        return NTV_FORMAT;
+
+    i = ms / Ntv.Header.IndexPeriodMs;
+    if (i >= Ntv.Header.IndexEntries)
+        i = Ntv.Header.IndexEntries - 1;
+
+    // Waits for a chunk read in flight (BlockCache does), its data is dropped below
+    ret = Ntv_Load(Ntv.Header.IndexSector * NTV_SECTOR_SIZE + i * sizeof(Ntv_IndexEntry_t), &entry, sizeof(entry));
+    if (ret != NTV_OK)
+        return ret;
+    if (entry.Sectors == 0 || entry.Sectors > Ntv.Header.MaxSectors || entry.Sector < Ntv.Header.DataSector)
+        return NTV_FORMAT;
+
+    Ntv_Restart(entry.Sector * NTV_SECTOR_SIZE, entry.Sectors);
+    Ntv_Issue();
+    return NTV_OK;
+}
+
+/**
+ * @brief Unpack the oldest chunk, an LZ4 one, unless that is done already
+ */
+static Ntv_Status_t Ntv_Unpack(const Ntv_Chunk_t **chunk, const uint8_t **payload)
+{
+#if NTV_LZ4_BUFFER > 0
+    uint32_t size = 0;
+    uint32_t got = 0;
+
+    if (!Ntv.Unpacked)
+    {
+        if ((*chunk)->Size <= sizeof(uint32_t))
+            return NTV_FORMAT;
+        memcpy(&size, *payload, sizeof(size));
+        if (size > NTV_LZ4_BUFFER ||
+            Lz4_Decompress(*payload + sizeof(uint32_t), (*chunk)->Size - sizeof(uint32_t), Ntv_UnpackBuffer, size,
+                           &got) != LZ4_OK ||
+            got != size)
+            return NTV_FORMAT;
+
+        Ntv.UnpackedChunk = **chunk;
+        Ntv.UnpackedChunk.Flags &= (uint8_t)~NTV_CHUNK_LZ4;
+        Ntv.UnpackedChunk.Size = size;
+        Ntv.Unpacked = true;
+        Ntv.Stats.Unpacked++;
+    }
+
+    *chunk = &Ntv.UnpackedChunk;
+    *payload = Ntv_UnpackBuffer;
+    return NTV_OK;
+#else
+    return NTV_FORMAT;
+#endif
+}
+
+Ntv_Status_t Ntv_GetChunk(const Ntv_Chunk_t **chunk, const uint8_t **payload)
+{
+    uint8_t complete = 0;
+
+    if (Ntv.File == NULL || chunk == NULL || payload == NULL)
+        return NTV_INVALID_PARAM;
+
+    complete = Ntv.Count - (Ntv.Reading ? 1 : 0);
+    if (complete == 0)
+    {
+        if (Ntv.Failed)
+            return NTV_ERROR;
+        if (Ntv.NextSectors == 0 && !Ntv.Reading)
+            return NTV_END;
+        Ntv.Stats.Underruns++;
+        return NTV_UNDERRUN;
+    }
+
+    *chunk = (const Ntv_Chunk_t *)Ntv_Buffer[Ntv.Start[Ntv.First]];
+    *payload = Ntv_Buffer[Ntv.Start[Ntv.First]] + sizeof(Ntv_Chunk_t);
+    if ((*chunk)->Flags & NTV_CHUNK_LZ4)
+        return Ntv_Unpack(chunk, payload);
+    return NTV_OK;
+}
+
+Ntv_Status_t Ntv_Release(void)
+{
+    if (Ntv.File == NULL || Ntv.Count - (Ntv.Reading ? 1 : 0) == 0)
+        return NTV_INVALID_PARAM;
+
+    Ntv.First = (uint8_t)((Ntv.First + 1) % NTV_QUEUE);
+    Ntv.Count--;
+#if NTV_LZ4_BUFFER > 0
+    Ntv.Unpacked = false;
+#endif
+    Ntv_Issue();
+    return NTV_OK;
+}
+
+void Ntv_GetStats(Ntv_Stats_t *stats)
+{
+    if (stats == NULL)
+        return;
+
+    *stats = Ntv.Stats;
+    stats->Queued = Ntv.Count - (Ntv.Reading ? 1 : 0);
+}
+
+void Ntv_ResetStats(void)
+{
+    memset(&Ntv.Stats, 0, sizeof(Ntv.Stats));
+}
+
+void Ntv_Task(void *data)
+{
+    Ntv_Done();
+    Ntv_Issue();
+}
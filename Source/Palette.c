@@ -0,0 +1,225 @@
+#include "Palette.h"
+
+#include "main.h"
+#include "string.h"
+
+#if (LCD_WIDTH % 8) != 0
+#error "Palette needs LCD_WIDTH in multiples of 8 so that every line of indices starts on a word"
+#endif
+
+typedef struct
+{
+    uint16_t Colors[PALETTE_COLORS_MAX]; // Current palette, unused entries black
+    uint32_t Pairs[256];                 // PAL4: index byte -> two pixels
+    uint8_t Bits;                        // Of the current palette, 0 before the first
+    const uint8_t *Indices;              // Of the running slice
+    uint8_t SliceBits;
+    LCD_Rect_t Rect;
+    bool Started;
+    bool Active;
+    Palette_Stats_t Stats;
+} Palette_Handle_t;
+
+static Palette_Handle_t Palette = {0};
+
+void Palette_Expand8(uint16_t *dst, const uint8_t *src, const uint16_t *palette, uint32_t pixels)
+{
+    uint32_t *d = (uint32_t *)dst;
+    const uint32_t *s = (const uint32_t *)src;
+
+    while (pixels >= 8)
+    {
+        uint32_t a = s[0];
+        uint32_t b = s[1];
+
+        d[0] = palette[a & 0xFF] | ((uint32_t)palette[(a >> 8) & 0xFF] << 16);
+        d[1] = palette[(a >> 16) & 0xFF] | ((uint32_t)palette[a >> 24] << 16);
+        d[2] = palette[b & 0xFF] | ((uint32_t)palette[(b >> 8) & 0xFF] << 16);
+        d[3] = palette[(b >> 16) & 0xFF] | ((uint32_t)palette[b >> 24] << 16);
+        d += 4;
+        s += 2;
+        pixels -= 8;
+    }
+
+    dst = (uint16_t *)d;
+    src = (const uint8_t *)s;
+    while (pixels--)
+        *dst++ = palette[*src++];
+}
+
+void Palette_Expand4(uint16_t *dst, const uint8_t *src, const uint32_t *pairs, uint32_t pixels)
+{
+    uint32_t *d = (uint32_t *)dst;
+    const uint32_t *s = (const uint32_t *)src;
+
+    while (pixels >= 8)
+    {
+        uint32_t a = *s++;
+
+        d[0] = pairs[a & 0xFF];
+        d[1] = pairs[(a >> 8) & 0xFF];
+        d[2] = pairs[(a >> 16) & 0xFF];
+        d[3] = pairs[a >> 24];
+        d += 4;
+        pixels -= 8;
+    }
+
+    src = (const uint8_t *)s;
+    while (pixels >= 2)
+    {
+        *d++ = pairs[*src++];
+        pixels -= 2;
+    }
+
+    // An odd last pixel is the low nibble, the low half of its pair
+    if (pixels)
+        *(uint16_t *)d = (uint16_t)pairs[*src];
+}
+
+void Palette_MakePairs(uint32_t *pairs, const uint16_t *palette)
+{
+    for (uint32_t b = 0; b < 256; b++)
+        pairs[b] = palette[b & 0x0F] | ((uint32_t)palette[b >> 4] << 16);
+}
+
+void Palette_Expand8_Ref(uint16_t *dst, const uint8_t *src, const uint16_t *palette, uint32_t pixels)
+{
+    for (uint32_t i = 0; i < pixels; i++)
+        dst[i] = palette[src[i]];
+}
+
+void Palette_Expand4_Ref(uint16_t *dst, const uint8_t *src, const uint16_t *palette, uint32_t pixels)
+{
+    for (uint32_t i = 0; i < pixels; i++)
+        dst[i] = palette[(src[i / 2] >> ((i & 1) * 4)) & 0x0F];
+}
+
+/**
+ * @brief Render draw callback: expand the indices under a strip
+ */
+static bool Palette_DrawStrip(uint16_t *strip, const LCD_Rect_t *area, uint16_t y, uint16_t lines, void *Userdata)
+{
+    uint32_t pixels = (uint32_t)lines * LCD_WIDTH;
+
+    if (Palette.SliceBits == 8)
+        Palette_Expand8(strip, Palette.Indices + (uint32_t)y * LCD_WIDTH, Palette.Colors, pixels);
+    else
+        Palette_Expand4(strip, Palette.Indices + (uint32_t)y * (LCD_WIDTH / 2), Palette.Pairs, pixels);
+    return true;
+}
+
+Render_Status_t Palette_Start(const uint8_t *data, uint32_t size, uint16_t line, uint16_t lines, uint8_t bits)
+{
+    uint16_t colors = 0;
+    uint32_t header = 0;
+
+    if (data == NULL || ((uintptr_t)data & 3) != 0 || (bits != 8 && bits != 4) || lines == 0 ||
+        line + lines > LCD_HEIGHT)
+        return RENDER_INVALID_PARAM;
+    if (Palette.Active)
+        return RENDER_BUSY;
+
+    Palette.Stats.Slices++;
+    colors = (size >= 4) ? *(const uint16_t *)data : 0;
+    header = 4 + (((uint32_t)colors * sizeof(uint16_t) + 3) & ~3UL);
+    if (size < header || colors > (1U << bits) || size - header < (uint32_t)lines * LCD_WIDTH * bits / 8 ||
+        (colors == 0 && Palette.Bits != bits))
+    {
+        Palette.Stats.Errors++;
+        return RENDER_ERROR;
+    }
+
+    if (colors > 0)
+    {
+        memcpy(Palette.Colors, &data[4], colors * sizeof(uint16_t));
+        memset(&Palette.Colors[colors], 0, (PALETTE_COLORS_MAX - colors) * sizeof(uint16_t));
+        if (bits == 4)
+            Palette_MakePairs(Palette.Pairs, Palette.Colors);
+        Palette.Bits = bits;
+        Palette.Stats.Palettes++;
+    }
+
+    Palette.Indices = &data[header];
+    Palette.SliceBits = bits;
+    Palette.Rect.x = 0;
+    Palette.Rect.y = line;
+    Palette.Rect.w = LCD_WIDTH;
+    Palette.Rect.h = lines;
+    Palette.Started = false;
+    Palette.Active = true;
+    return RENDER_OK;
+}
+
+Render_Status_t Palette_Process(void)
+{
+    Render_Status_t ret = RENDER_OK;
+
+    if (!Palette.Active)
+        return RENDER_OK;
+
+    ret = Render_Process();
+    if (ret != RENDER_OK)
+    {
+        if (ret == RENDER_ERROR)
+            Palette.Active = false;
+        return ret;
+    }
+
+    // Render is idle: either the slice is out, or the frame before it is
+    if (Palette.Started)
+    {
+        Palette.Active = false;
+        return RENDER_OK;
+    }
+
+    ret = Render_Start(&Palette.Rect, Palette_DrawStrip, NULL);
+    if (ret == RENDER_BUSY)
+        return RENDER_BUSY;
+    if (ret != RENDER_OK)
+    {
+        Palette.Active = false;
+        return ret;
+    }
+    Palette.Started = true;
+
+    if (Render_Process() == RENDER_ERROR)
+    {
+        Palette.Active = false;
+        return RENDER_ERROR;
+    }
+    return RENDER_BUSY;
+}
+
+Render_Status_t Palette_Draw(const uint8_t *data, uint32_t size, uint16_t line, uint16_t lines, uint8_t bits)
+{
+    Render_Status_t ret = Palette_Start(data, size, line, lines, bits);
+    uint32_t start = HAL_GetTick();
+
+    if (ret != RENDER_OK)
+        return ret;
+
+    while ((ret = Palette_Process()) == RENDER_BUSY)
+    {
+        if (HAL_GetTick() - start >= RENDER_FRAME_TIMEOUT)
+        {
+            Render_Abort();
+            Palette.Active = false;
+            return RENDER_TIMEOUT;
+        }
+    }
+
+    return ret;
+}
+
+void Palette_GetStats(Palette_Stats_t *stats)
+{
+    if (stats == NULL)
+        return;
+
+    *stats = Palette.Stats;
+}
+
+void Palette_ResetStats(void)
+{
+    memset(&Palette.Stats, 0, sizeof(Palette.Stats));
+}
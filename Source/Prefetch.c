@@ -0,0 +1,418 @@
+#include "Prefetch.h"
+
+#include "main.h"
+#include "string.h"
+#include "MicroOS.h"
+#include "BlockDev.h"
+
+#define PREFETCH_SECTOR_SIZE (512)
+#define PREFETCH_SECTOR_SHIFT (9)
+
+// The worst read loses 1/PREFETCH_PEAK_DECAY every rate period (half-life about 11 periods)
+#define PREFETCH_PEAK_DECAY (16)
+
+typedef struct
+{
+    Fat_File_t *File;  // Stream, NULL when stopped
+    uint32_t Pos;      // Read position
+    uint32_t FirstPos; // File position of the sector in slot First
+    uint16_t First;    // Ring slot of the oldest buffered sector
+    uint16_t Filled;   // Sectors buffered from First on
+    uint16_t Depth;    // Sectors to keep buffered
+    bool Refill;       // Reading up to Depth, started once a whole burst fits
+    bool Failed;       // File system error, no more reads until a restart
+
+    bool InFlight;              // Card read running into the slots behind the buffered ones
+    bool Stale;                 // Restarted while in flight: drop the data when it arrives
+    uint16_t Count;             // Sectors of the read in flight
+    uint32_t IssueTick;         // HAL tick when it was issued
+    BlockDev_Request_t Request; // Its result, kept for us whoever waits for the card
+
+    uint32_t Consumed; // Bytes consumed in the current rate period
+    uint32_t RateTick; // HAL tick when the period began
+
+    Prefetch_Stats_t Stats;
+} Prefetch_Handle_t;
+
+static Prefetch_Handle_t Prefetch = {0};
+
+static __ALIGNED(4) uint8_t Prefetch_Ring[PREFETCH_SECTORS][PREFETCH_SECTOR_SIZE];
+
+/**
+ * @brief Bytes buffered from the read position on
+ */
+static uint32_t Prefetch_Buffered(void)
+{
+    uint32_t end = Prefetch.FirstPos + ((uint32_t)Prefetch.Filled << PREFETCH_SECTOR_SHIFT);
+
+    if (end > Prefetch.File->Size)
+        end = Prefetch.File->Size;
+    return (end > Prefetch.Pos) ? end - Prefetch.Pos : 0;
+}
+
+/**
+ * @brief Window depth for the measured stream rate and card latency
+ */
+static void Prefetch_SetDepth(void)
+{
+    uint32_t budget = 2 * Prefetch.Stats.PeakMs;
+    uint32_t depth = 0;
+
+    if (budget < PREFETCH_SPIKE_MS)
+        budget = PREFETCH_SPIKE_MS;
+
+    depth = (uint32_t)(((uint64_t)Prefetch.Stats.Rate * budget / 1000 + PREFETCH_SECTOR_SIZE - 1) >> PREFETCH_SECTOR_SHIFT);
+    // Headroom for the refill hysteresis
+    depth += PREFETCH_MAX_BURST;
+    Prefetch.Depth = (depth > PREFETCH_SECTORS) ? PREFETCH_SECTORS : (uint16_t)depth;
+}
+
+/**
+ * @brief Drop the ring and continue reading at pos
+ */
+static void Prefetch_Restart(uint32_t pos)
+{
+    if (pos > Prefetch.File->Size)
+        pos = Prefetch.File->Size;
+
+    // The slots of a read in flight stay taken until it ends, Prefetch_Issue() waits for that
+    Prefetch.Stale = Prefetch.InFlight;
+    Prefetch.Pos = pos;
+    Prefetch.FirstPos = pos & ~(uint32_t)(PREFETCH_SECTOR_SIZE - 1);
+    Prefetch.First = 0;
+    Prefetch.Filled = 0;
+    Prefetch.Refill = true;
+    Prefetch.Failed = false;
+}
+
+/**
+ * @brief Take the result of the read in flight once the card is done with it
+ */
+static void Prefetch_Done(void)
+{
+    uint32_t latency = 0;
+
+    if (!Prefetch.InFlight)
+        return;
+    // The request holds the result of our read, even if another card user has waited for it and
+    // started its own transfer since; BlockDev_IsBusy() fills it in once the read has ended
+    (void)BlockDev_IsBusy();
+    if (!Prefetch.Request.Done)
+        return;
+
+    Prefetch.InFlight = false;
+    if (Prefetch.Stale)
+    {
+        Prefetch.Stale = false;
+        return;
+    }
+
+    // Failed reads count as well, a timeout is exactly the stall the window must cover
+    latency = Prefetch.Request.EndTick - Prefetch.IssueTick;
+    Prefetch.Stats.LatencyMs = latency;
+    if (latency > Prefetch.Stats.LatencyMaxMs)
+        Prefetch.Stats.LatencyMaxMs = latency;
+    if (latency > Prefetch.Stats.PeakMs)
+        Prefetch.Stats.PeakMs = latency;
+
+    if (Prefetch.Request.Result != BLOCKDEV_OK)
+    {
+        Prefetch.Stats.Errors++;
+        return;
+    }
+
+    Prefetch.Filled += Prefetch.Count;
+    Prefetch.Stats.Reads++;
+    Prefetch.Stats.Sectors += Prefetch.Count;
+}
+
+/**
+ * @brief Start the next card read if the window is not full
+ */
+static void Prefetch_Issue(void)
+{
+    Fat_Status_t fat = FAT_OK;
+    BlockDev_Status_t ret = BLOCKDEV_OK;
+    uint32_t fetch = 0;
+    uint32_t sector = 0;
+    uint32_t run = 0;
+    uint32_t count = 0;
+    uint16_t slot = 0;
+
+    if (Prefetch.File == NULL || Prefetch.Failed || Prefetch.InFlight || BlockDev_IsBusy())
+        return;
+    // Refill in bursts rather than a sector at a time: every card command costs its access time
+    if (!Prefetch.Refill && Prefetch.Filled + PREFETCH_MAX_BURST <= Prefetch.Depth)
+        Prefetch.Refill = true;
+    if (Prefetch.Filled >= Prefetch.Depth)
+        Prefetch.Refill = false;
+    if (!Prefetch.Refill)
+        return;
+
+    fetch = Prefetch.FirstPos + ((uint32_t)Prefetch.Filled << PREFETCH_SECTOR_SHIFT);
+    if (fetch >= Prefetch.File->Size)
+        return;
+
+    // May read the FAT (long fragmented files), nothing is in flight here
+    fat = Fat_GetRun(Prefetch.File, fetch, &sector, &run);
+    if (fat == FAT_ERROR)
+    {
+        Prefetch.Stats.Errors++;
+        return;
+    }
+    if (fat != FAT_OK)
+    {
+        Prefetch.Failed = true;
+        return;
+    }
+
+    // One read per extent and never across the ring wrap
+    slot = (uint16_t)((Prefetch.First + Prefetch.Filled) % PREFETCH_SECTORS);
+    count = Prefetch.Depth - Prefetch.Filled;
+    if (count > (uint32_t)(PREFETCH_SECTORS - slot))
+        count = PREFETCH_SECTORS - slot;
+    if (count > PREFETCH_MAX_BURST)
+        count = PREFETCH_MAX_BURST;
+    if (count > run)
+        count = run;
+
+    Prefetch.InFlight = true;
+    Prefetch.Stale = false;
+    Prefetch.Count = (uint16_t)count;
+    Prefetch.IssueTick = HAL_GetTick();
+
+    ret = BlockDev_ReadAsync(sector, Prefetch_Ring[slot], count, &Prefetch.Request);
+    if (ret != BLOCKDEV_OK)
+    {
+        Prefetch.InFlight = false;
+        // Busy: another card user got in first, try again later
+        if (ret != BLOCKDEV_BUSY)
+            Prefetch.Stats.Errors++;
+    }
+}
+
+/**
+ * @brief BLOCKDEV_EVENT_DONE handler (MicroOS event context): chain the next read
+ */
+static void Prefetch_OnDone(void *data)
+{
+    Prefetch_Done();
+    Prefetch_Issue();
+}
+
+/**
+ * @brief Contiguous buffered bytes at the read position
+ */
+static uint32_t Prefetch_Contiguous(const uint8_t **data)
+{
+    uint32_t offset = Prefetch.Pos - Prefetch.FirstPos;
+    uint32_t sectors = PREFETCH_SECTORS - Prefetch.First;
+    uint32_t len = Prefetch_Buffered();
+
+    if (sectors > Prefetch.Filled)
+        sectors = Prefetch.Filled;
+    if (len > (sectors << PREFETCH_SECTOR_SHIFT) - offset)
+        len = (sectors << PREFETCH_SECTOR_SHIFT) - offset;
+
+    *data = &Prefetch_Ring[Prefetch.First][offset];
+    return len;
+}
+
+/**
+ * @brief Advance the read position, len must be buffered
+ */
+static void Prefetch_Advance(uint32_t len)
+{
+    bool freed = false;
+
+    Prefetch.Pos += len;
+    Prefetch.Consumed += len;
+
+    while (Prefetch.Filled > 0 && Prefetch.Pos - Prefetch.FirstPos >= PREFETCH_SECTOR_SIZE)
+    {
+        Prefetch.First = (uint16_t)((Prefetch.First + 1) % PREFETCH_SECTORS);
+        Prefetch.FirstPos += PREFETCH_SECTOR_SIZE;
+        Prefetch.Filled--;
+        freed = true;
+    }
+
+    if (freed)
+        Prefetch_Issue();
+}
+
+Prefetch_Status_t Prefetch_Init(void)
+{
+    Prefetch.Depth = PREFETCH_SECTORS;
+
+    if (MicroOS_RegisterEvent(BLOCKDEV_EVENT_DONE, Prefetch_OnDone, NULL) != MICROOS_OK)
+        return PREFETCH_ERROR;
+
+    return PREFETCH_OK;
+}
+
+Prefetch_Status_t Prefetch_Start(Fat_File_t *file, uint32_t pos)
+{
+    if (file == NULL)
+        return PREFETCH_INVALID_PARAM;
+
+    Prefetch.File = file;
+    Prefetch_Restart(pos);
+
+    // New stream, new rate; the card latency carries over
+    Prefetch.Depth = PREFETCH_SECTORS;
+    Prefetch.Stats.Rate = 0;
+    Prefetch.Consumed = 0;
+    Prefetch.RateTick = HAL_GetTick();
+
+    Prefetch_Issue();
+    return PREFETCH_OK;
+}
+
+void Prefetch_Stop(void)
+{
+    // A read in flight still ends into the ring, Prefetch_Done() drops it
+    Prefetch.Stale = Prefetch.InFlight;
+    Prefetch.File = NULL;
+    Prefetch.Filled = 0;
+}
+
+Prefetch_Status_t Prefetch_Seek(uint32_t pos)
+{
+    uint32_t end = 0;
+
+    if (Prefetch.File == NULL)
+        return PREFETCH_INVALID_PARAM;
+    if (pos > Prefetch.File->Size)
+        pos = Prefetch.File->Size;
+
+    end = Prefetch.FirstPos + ((uint32_t)Prefetch.Filled << PREFETCH_SECTOR_SHIFT);
+    if (pos >= Prefetch.FirstPos && pos < end)
+    {
+        // Skipped data does not count towards the stream rate
+        Prefetch.Pos = pos;
+        Prefetch_Advance(0);
+        return PREFETCH_OK;
+    }
+
+    Prefetch_Restart(pos);
+    Prefetch_Issue();
+    return PREFETCH_OK;
+}
+
+uint32_t Prefetch_Tell(void)
+{
+    return Prefetch.Pos;
+}
+
+uint32_t Prefetch_Available(void)
+{
+    return (Prefetch.File != NULL) ? Prefetch_Buffered() : 0;
+}
+
+Prefetch_Status_t Prefetch_Read(void *buf, uint32_t len, uint32_t *read)
+{
+    uint8_t *dst = (uint8_t *)buf;
+    uint32_t done = 0;
+
+    if (read != NULL)
+        *read = 0;
+    if (Prefetch.File == NULL || (buf == NULL && len > 0))
+        return PREFETCH_INVALID_PARAM;
+
+    while (done < len)
+    {
+        const uint8_t *data = NULL;
+        uint32_t n = Prefetch_Contiguous(&data);
+
+        if (n == 0)
+            break;
+        if (n > len - done)
+            n = len - done;
+
+        memcpy(&dst[done], data, n);
+        Prefetch_Advance(n);
+        done += n;
+    }
+
+    if (read != NULL)
+        *read = done;
+    if (done == len)
+        return PREFETCH_OK;
+    if (Prefetch.Pos >= Prefetch.File->Size)
+        return PREFETCH_END;
+
+    Prefetch.Stats.Underruns++;
+    return PREFETCH_UNDERRUN;
+}
+
+Prefetch_Status_t Prefetch_Peek(const uint8_t **data, uint32_t *len)
+{
+    if (Prefetch.File == NULL || data == NULL || len == NULL)
+        return PREFETCH_INVALID_PARAM;
+
+    *len = Prefetch_Contiguous(data);
+    if (*len > 0)
+        return PREFETCH_OK;
+    if (Prefetch.Pos >= Prefetch.File->Size)
+        return PREFETCH_END;
+
+    Prefetch.Stats.Underruns++;
+    return PREFETCH_UNDERRUN;
+}
+
+Prefetch_Status_t Prefetch_Consume(uint32_t len)
+{
+    if (Prefetch.File == NULL || len > Prefetch_Buffered())
+        return PREFETCH_INVALID_PARAM;
+
+    Prefetch_Advance(len);
+    return PREFETCH_OK;
+}
+
+void Prefetch_GetStats(Prefetch_Stats_t *stats)
+{
+    if (stats == NULL)
+        return;
+
+    *stats = Prefetch.Stats;
+    stats->Depth = Prefetch.Depth;
+    stats->Ahead = Prefetch.Filled;
+}
+
+void Prefetch_ResetStats(void)
+{
+    Prefetch_Stats_t empty = {0};
+
+    // Rate and peak drive the depth, they are not counters
+    empty.Rate = Prefetch.Stats.Rate;
+    empty.PeakMs = Prefetch.Stats.PeakMs;
+    Prefetch.Stats = empty;
+}
+
+void Prefetch_Task(void *data)
+{
+    uint32_t now = HAL_GetTick();
+    uint32_t elapsed = now - Prefetch.RateTick;
+
+    // BLOCKDEV_EVENT_DONE may have gone to a blocking card user, do not rely on it alone
+    Prefetch_Done();
+    if (Prefetch.File == NULL)
+        return;
+
+    if (elapsed >= PREFETCH_RATE_PERIOD)
+    {
+        uint32_t rate = (uint32_t)((uint64_t)Prefetch.Consumed * 1000 / elapsed);
+
+        // Paused streams keep the window they had
+        if (rate > 0)
+        {
+            Prefetch.Stats.Rate = (Prefetch.Stats.Rate > 0) ? (3 * Prefetch.Stats.Rate + rate) / 4 : rate;
+            Prefetch_SetDepth();
+        }
+        Prefetch.Stats.PeakMs -= (Prefetch.Stats.PeakMs + PREFETCH_PEAK_DECAY - 1) / PREFETCH_PEAK_DECAY;
+        Prefetch.Consumed = 0;
+        Prefetch.RateTick = now;
+    }
+
+    Prefetch_Issue();
+}
@@ -0,0 +1,186 @@
+#include "Present.h"
+
+#include "main.h"
+#include "MicroOS.h"
+
+typedef struct
+{
+    Present_Mode_t Mode;
+    volatile uint32_t TeTick;     // HAL tick of the last TE edge
+    volatile uint32_t VsyncCycle; // DWT cycle count of the last V-blank
+    uint32_t NextTimedVsync;      // Fallback timer, HAL tick of the next V-blank
+
+    bool Pending; // Frame queued, not started
+    LCD_Rect_t Area;
+    bool FullScreen;
+    Render_DrawFunction_t Draw;
+    void *Userdata;
+    uint32_t Due;
+
+    bool Sending;        // Frame handed to Render
+    uint32_t StartCycle; // DWT cycle count at transfer start
+
+    Present_Stats_t Stats;
+} Present_Handle_t;
+
+static Present_Handle_t Present = {0};
+
+static void Present_CycleCounterInit(void)
+{
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+static uint32_t Present_CyclesToUs(uint32_t cycles)
+{
+    return cycles / (SystemCoreClock / 1000000);
+}
+
+/**
+ * @brief V-blank handler (MicroOS event context): start the queued frame if it is due
+ */
+static void Present_OnVsync(void *data)
+{
+    uint32_t now = HAL_GetTick();
+    uint32_t latency = 0;
+
+    if (!Present.Pending || Present.Sending)
+        return;
+    // Too early: leave it for a later V-blank
+    if ((int32_t)(Present.Due - now) > PRESENT_PANEL_PERIOD / 2)
+        return;
+    // Stale trigger (the scheduler was held up): the scan line is already too far down
+    latency = Present_CyclesToUs(DWT->CYCCNT - Present.VsyncCycle);
+    if (latency > PRESENT_PANEL_PERIOD * 1000 / 4)
+        return;
+
+    if (Render_Start(Present.FullScreen ? NULL : &Present.Area, Present.Draw, Present.Userdata) != RENDER_OK)
+        return;
+
+    Present.StartCycle = DWT->CYCCNT;
+    Present.Pending = false;
+    Present.Sending = true;
+
+    latency = Present_CyclesToUs(Present.StartCycle - Present.VsyncCycle);
+    Present.Stats.Presented++;
+    Present.Stats.LatencyUs = latency;
+    if (latency > Present.Stats.LatencyMaxUs)
+        Present.Stats.LatencyMaxUs = latency;
+    if ((int32_t)(now - Present.Due) > PRESENT_PANEL_PERIOD)
+        Present.Stats.Late++;
+
+    // Draw the first strip and get DMA going without waiting for the next task tick
+    if (Render_Process() == RENDER_ERROR)
+        Present.Sending = false;
+}
+
+Present_Status_t Present_Init(void)
+{
+    Present_CycleCounterInit();
+
+    Present.Mode = PRESENT_MODE_TE;
+    Present.TeTick = HAL_GetTick();
+    Present.NextTimedVsync = Present.TeTick + PRESENT_PANEL_PERIOD;
+
+    if (MicroOS_RegisterEvent(PRESENT_EVENT_VSYNC, Present_OnVsync, NULL) != MICROOS_OK)
+        return PRESENT_ERROR;
+    if (LCD_SetTearing(true) != LCD_OK)
+        return PRESENT_ERROR;
+
+    return PRESENT_OK;
+}
+
+Present_Status_t Present_Submit(const LCD_Rect_t *area, Render_DrawFunction_t Draw, void *Userdata, uint32_t due_ms)
+{
+    if (Draw == NULL)
+        return PRESENT_INVALID_PARAM;
+    if (area != NULL && (area->w == 0 || area->h == 0 || area->x + area->w > LCD_WIDTH || area->y + area->h > LCD_HEIGHT))
+        return PRESENT_INVALID_PARAM;
+
+    if (Present.Pending)
+        Present.Stats.Dropped++;
+
+    Present.FullScreen = (area == NULL);
+    if (area != NULL)
+        Present.Area = *area;
+    Present.Draw = Draw;
+    Present.Userdata = Userdata;
+    Present.Due = due_ms;
+    Present.Pending = true;
+
+    return PRESENT_OK;
+}
+
+bool Present_IsBusy(void)
+{
+    return Present.Pending || Present.Sending;
+}
+
+Present_Mode_t Present_GetMode(void)
+{
+    return Present.Mode;
+}
+
+void Present_GetStats(Present_Stats_t *stats)
+{
+    if (stats != NULL)
+        *stats = Present.Stats;
+}
+
+void Present_ResetStats(void)
+{
+    Present_Stats_t empty = {0};
+
+    Present.Stats = empty;
+}
+
+void Present_Task(void *data)
+{
+    uint32_t now = HAL_GetTick();
+
+    if (Present.Sending)
+    {
+        Render_Status_t ret = Render_Process();
+
+        if (ret != RENDER_BUSY)
+        {
+            uint32_t transfer = Present_CyclesToUs(DWT->CYCCNT - Present.StartCycle);
+
+            Present.Sending = false;
+            Present.Stats.TransferUs = transfer;
+            if (transfer > Present.Stats.TransferMaxUs)
+                Present.Stats.TransferMaxUs = transfer;
+        }
+    }
+
+    if (Present.Mode == PRESENT_MODE_TE)
+    {
+        if (now - Present.TeTick >= PRESENT_TE_TIMEOUT)
+        {
+            Present.Mode = PRESENT_MODE_TIMER;
+            Present.NextTimedVsync = now;
+        }
+        return;
+    }
+
+    // Timer fallback: the phase is unknown, only the rate matches the panel
+    if ((int32_t)(now - Present.NextTimedVsync) >= 0)
+    {
+        Present.NextTimedVsync += PRESENT_PANEL_PERIOD;
+        if ((int32_t)(now - Present.NextTimedVsync) >= 0)
+            Present.NextTimedVsync = now + PRESENT_PANEL_PERIOD;
+        Present.VsyncCycle = DWT->CYCCNT;
+        Present.Stats.Vsyncs++;
+        MicroOS_TriggerEvent(PRESENT_EVENT_VSYNC);
+    }
+}
+
+void Present_TeCallback(void)
+{
+    Present.VsyncCycle = DWT->CYCCNT;
+    Present.TeTick = HAL_GetTick();
+    Present.Mode = PRESENT_MODE_TE;
+    Present.Stats.Vsyncs++;
+    MicroOS_TriggerEvent(PRESENT_EVENT_VSYNC);
+}
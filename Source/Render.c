@@ -0,0 +1,181 @@
+#include "Render.h"
+
+#include "main.h"
+#include "MicroOS.h"
+
+typedef enum
+{
+    RENDER_STRIP_FREE = 0, // Can be drawn into
+    RENDER_STRIP_READY,    // Drawn, waiting for the LCD
+    RENDER_STRIP_SENDING,  // Handed to DMA
+} Render_StripState_t;
+
+typedef struct
+{
+    Render_StripState_t State;
+    LCD_Rect_t Rect; // Screen rectangle covered by the strip
+} Render_Strip_t;
+
+typedef struct
+{
+    bool Active;
+    Render_DrawFunction_t Draw;
+    void *Userdata;
+    LCD_Rect_t Area;
+    uint16_t Lines;    // Lines per strip for this area
+    uint16_t NextRow;  // Next row to draw, relative to Area.y
+    uint8_t DrawIndex; // Strip to draw into next
+    uint8_t SendIndex; // Strip to send next
+    Render_Strip_t Strips[2];
+} Render_Handle_t;
+
+static Render_Handle_t Render = {0};
+
+static __ALIGNED(4) uint16_t Render_Buffer[2][RENDER_STRIP_PIXELS];
+
+static void Render_Finish(void)
+{
+    Render.Active = false;
+    Render.Draw = NULL;
+}
+
+// The LCD sends one strip at a time, so once it is idle the strip in flight is done.
+// Its result is read here, before the next flush clears it; false if the transfer failed.
+static bool Render_Retire(void)
+{
+    uint8_t i = 0;
+
+    if (LCD_IsBusy())
+        return true;
+
+    for (i = 0; i < 2; i++)
+    {
+        if (Render.Strips[i].State != RENDER_STRIP_SENDING)
+            continue;
+        if (LCD_GetResult() != LCD_OK)
+            return false;
+        Render.Strips[i].State = RENDER_STRIP_FREE;
+    }
+
+    return true;
+}
+
+Render_Status_t Render_Start(const LCD_Rect_t *area, Render_DrawFunction_t Draw, void *Userdata)
+{
+    static const LCD_Rect_t screen = {0, 0, LCD_WIDTH, LCD_HEIGHT};
+
+    if (Draw == NULL)
+        return RENDER_INVALID_PARAM;
+    if (area == NULL)
+        area = &screen;
+    if (area->w == 0 || area->h == 0 || area->x + area->w > LCD_WIDTH || area->y + area->h > LCD_HEIGHT)
+        return RENDER_INVALID_PARAM;
+    // Both strips must be free before they are drawn into again
+    if (Render.Active || LCD_IsBusy())
+        return RENDER_BUSY;
+
+    Render.Draw = Draw;
+    Render.Userdata = Userdata;
+    Render.Area = *area;
+    Render.Lines = RENDER_STRIP_PIXELS / area->w;
+    if (Render.Lines > area->h)
+        Render.Lines = area->h;
+    Render.NextRow = 0;
+    Render.DrawIndex = 0;
+    Render.SendIndex = 0;
+    Render.Strips[0].State = RENDER_STRIP_FREE;
+    Render.Strips[1].State = RENDER_STRIP_FREE;
+    Render.Active = true;
+
+    return RENDER_OK;
+}
+
+Render_Status_t Render_Process(void)
+{
+    Render_Strip_t *strip = NULL;
+
+    if (!Render.Active)
+        return RENDER_OK;
+
+    if (!Render_Retire())
+    {
+        Render_Finish();
+        return RENDER_ERROR;
+    }
+
+    for (;;)
+    {
+        // Send the next drawn strip as soon as the bus is free
+        strip = &Render.Strips[Render.SendIndex];
+        if (strip->State == RENDER_STRIP_READY && !LCD_IsBusy())
+        {
+            if (!Render_Retire() || LCD_Flush(&strip->Rect, Render_Buffer[Render.SendIndex]) != LCD_OK)
+            {
+                Render_Finish();
+                return RENDER_ERROR;
+            }
+            strip->State = RENDER_STRIP_SENDING;
+            Render.SendIndex ^= 1;
+        }
+
+        // Draw into the other strip while DMA runs
+        strip = &Render.Strips[Render.DrawIndex];
+        if (strip->State != RENDER_STRIP_FREE || Render.NextRow >= Render.Area.h)
+            break;
+
+        strip->Rect.x = Render.Area.x;
+        strip->Rect.y = Render.Area.y + Render.NextRow;
+        strip->Rect.w = Render.Area.w;
+        strip->Rect.h = Render.Area.h - Render.NextRow;
+        if (strip->Rect.h > Render.Lines)
+            strip->Rect.h = Render.Lines;
+
+        if (!Render.Draw(Render_Buffer[Render.DrawIndex], &Render.Area, Render.NextRow, strip->Rect.h, Render.Userdata))
+        {
+            Render_Finish();
+            return RENDER_ERROR;
+        }
+        Render.NextRow += strip->Rect.h;
+        strip->State = RENDER_STRIP_READY;
+        Render.DrawIndex ^= 1;
+    }
+
+    if (Render.NextRow < Render.Area.h ||
+        Render.Strips[0].State != RENDER_STRIP_FREE ||
+        Render.Strips[1].State != RENDER_STRIP_FREE)
+        return RENDER_BUSY;
+
+    Render_Finish();
+    MicroOS_TriggerEvent(RENDER_EVENT_FRAME_DONE);
+    return RENDER_OK;
+}
+
+Render_Status_t Render_Frame(const LCD_Rect_t *area, Render_DrawFunction_t Draw, void *Userdata)
+{
+    Render_Status_t ret = Render_Start(area, Draw, Userdata);
+    uint32_t start = HAL_GetTick();
+
+    if (ret != RENDER_OK)
+        return ret;
+
+    while ((ret = Render_Process()) == RENDER_BUSY)
+    {
+        if (HAL_GetTick() - start >= RENDER_FRAME_TIMEOUT)
+        {
+            Render_Abort();
+            return RENDER_TIMEOUT;
+        }
+    }
+
+    return ret;
+}
+
+void Render_Abort(void)
+{
+    Render_Finish();
+}
+
+bool Render_IsActive(void)
+{
+    return Render.Active;
+}
@@ -0,0 +1,719 @@
+#include "SD.h"
+
+#include "main.h"
+#include "spi.h"
+#include "MicroOS.h"
+
+// SD commands used in SPI mode
+#define SD_CMD_GO_IDLE_STATE (0)
+#define SD_CMD_SEND_IF_COND (8)
+#define SD_CMD_SEND_CSD (9)
+#define SD_CMD_STOP_TRANSMISSION (12)
+#define SD_CMD_SET_BLOCKLEN (16)
+#define SD_CMD_READ_SINGLE_BLOCK (17)
+#define SD_CMD_READ_MULTIPLE_BLOCK (18)
+#define SD_CMD_WRITE_BLOCK (24)
+#define SD_CMD_WRITE_MULTIPLE_BLOCK (25)
+#define SD_CMD_APP_CMD (55)
+#define SD_CMD_READ_OCR (58)
+#define SD_CMD_CRC_ON_OFF (59)
+#define SD_ACMD_SET_WR_BLK_ERASE_COUNT (23)
+#define SD_ACMD_SEND_OP_COND (41)
+
+#define SD_R1_IDLE (0x01)
+#define SD_R1_ILLEGAL_COMMAND (0x04)
+
+#define SD_TOKEN_START (0xFE)       // Single block read/write, every block of CMD18
+#define SD_TOKEN_START_MULTI (0xFC) // Every block of CMD25
+#define SD_TOKEN_STOP (0xFD)        // End of CMD25
+
+#define SD_DATA_RESPONSE_MASK (0x1F)
+#define SD_DATA_ACCEPTED (0x05)
+#define SD_DATA_CRC_ERROR (0x0B)
+
+#define SD_IF_COND_ARG (0x1AA) // 2.7-3.6 V, check pattern 0xAA
+#define SD_OCR_CCS (0x40)      // First OCR byte: card uses block addresses
+#define SD_ACMD41_HCS (1UL << 30)
+
+#define SD_NCR (10) // Bytes to wait for a command response
+
+typedef enum
+{
+    SD_STATE_IDLE = 0,
+    SD_STATE_READ_TOKEN, // Waiting for the start token of the next block
+    SD_STATE_READ_DATA,  // Block DMA running
+    SD_STATE_WRITE_DATA, // Block DMA running
+    SD_STATE_WRITE_BUSY, // Card programming a written block
+    SD_STATE_STOP_BUSY,  // Card busy after CMD12 or the stop token
+} SD_State_t;
+
+typedef struct
+{
+    volatile SD_State_t State;
+    volatile SD_Status_t Result; // Result of the running or last transfer
+    bool Ready;                  // Card initialized
+    bool HighCapacity;           // Block addresses instead of byte addresses
+    bool Write;
+    bool Multi;                  // CMD18/CMD25 transfer, needs a stop
+    bool TxIncrement;            // TX DMA memory increment
+    uint8_t *Buf;                // Current block
+    const uint8_t *const *List;  // SD_WriteBlockList(): the block after Buf, NULL for one buffer
+    uint32_t Remaining;          // Blocks not finished, the current one included
+    uint32_t Start;              // HAL_GetTick() when the current wait began
+    uint32_t Sectors;
+} SD_Handle_t;
+
+static SD_Handle_t SD = {0};
+
+static const uint8_t SD_Idle = 0xFF; // TX DMA source while reading
+
+#ifdef SD_USE_CRC
+// CRC16-CCITT of one nibble
+static const uint16_t SD_Crc16Table[16] = {
+    0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+    0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF,
+};
+#endif
+
+static void SD_Select(void)
+{
+    HAL_GPIO_WritePin(SD_CS_GPIO_Port, SD_CS_Pin, GPIO_PIN_RESET);
+}
+
+/**
+ * @brief Shift one byte in and out with CS low
+ * @note Polled on the registers, also used from the DMA interrupt between blocks
+ */
+static uint8_t SD_Xchg(uint8_t b)
+{
+    SPI_TypeDef *spi = hspi3.Instance;
+
+    while ((spi->SR & SPI_SR_TXE) == 0)
+    {
+    }
+    *(volatile uint8_t *)&spi->DR = b;
+    while ((spi->SR & SPI_SR_RXNE) == 0)
+    {
+    }
+    return *(volatile uint8_t *)&spi->DR;
+}
+
+static void SD_Deselect(void)
+{
+    HAL_GPIO_WritePin(SD_CS_GPIO_Port, SD_CS_Pin, GPIO_PIN_SET);
+    // The card releases MISO on the next clock edge
+    SD_Xchg(0xFF);
+}
+
+/**
+ * @brief Pick the smallest SPI3 prescaler that keeps SCK at or below hz
+ */
+static void SD_SetBaudRate(uint32_t hz)
+{
+    uint32_t pclk = HAL_RCC_GetPCLK1Freq();
+    uint32_t br = 0;
+
+    while ((br < 7) && ((pclk >> (br + 1)) > hz))
+    {
+        br++;
+    }
+
+    __HAL_SPI_DISABLE(&hspi3);
+    MODIFY_REG(hspi3.Instance->CR1, SPI_CR1_BR, br << SPI_CR1_BR_Pos);
+    hspi3.Init.BaudRatePrescaler = br << SPI_CR1_BR_Pos;
+    __HAL_SPI_ENABLE(&hspi3);
+}
+
+/**
+ * @brief Enable or disable memory increment of the TX DMA channel
+ */
+static void SD_SetTxIncrement(bool on)
+{
+    DMA_HandleTypeDef *hdma = hspi3.hdmatx;
+
+    if (SD.TxIncrement == on)
+        return;
+
+    __HAL_DMA_DISABLE(hdma);
+    if (on)
+    {
+        SET_BIT(hdma->Instance->CCR, DMA_CCR_MINC);
+        hdma->Init.MemInc = DMA_MINC_ENABLE;
+    }
+    else
+    {
+        CLEAR_BIT(hdma->Instance->CCR, DMA_CCR_MINC);
+        hdma->Init.MemInc = DMA_MINC_DISABLE;
+    }
+    SD.TxIncrement = on;
+}
+
+static uint8_t SD_Crc7(const uint8_t *data, uint8_t len)
+{
+    uint8_t crc = 0;
+
+    while (len--)
+    {
+        uint8_t b = *data++;
+
+        for (uint8_t i = 0; i < 8; i++)
+        {
+            crc <<= 1;
+            if ((b ^ crc) & 0x80)
+                crc ^= 0x09;
+            b <<= 1;
+        }
+    }
+    return crc & 0x7F;
+}
+
+#ifdef SD_USE_CRC
+static uint16_t SD_Crc16(const uint8_t *data, uint32_t len)
+{
+    uint16_t crc = 0;
+
+    while (len--)
+    {
+        uint8_t b = *data++;
+
+        crc = (uint16_t)(crc << 4) ^ SD_Crc16Table[(crc >> 12) ^ (b >> 4)];
+        crc = (uint16_t)(crc << 4) ^ SD_Crc16Table[(crc >> 12) ^ (b & 0x0F)];
+    }
+    return crc;
+}
+#endif
+
+/**
+ * @brief Send a command frame and wait for its R1 response, CS must already be low
+ * @return R1, 0xFF if the card did not answer
+ */
+static uint8_t SD_Command(uint8_t cmd, uint32_t arg)
+{
+    uint8_t frame[6];
+    uint8_t r1 = 0xFF;
+
+    frame[0] = 0x40 | cmd;
+    frame[1] = (uint8_t)(arg >> 24);
+    frame[2] = (uint8_t)(arg >> 16);
+    frame[3] = (uint8_t)(arg >> 8);
+    frame[4] = (uint8_t)arg;
+    frame[5] = (uint8_t)((SD_Crc7(frame, 5) << 1) | 1);
+
+    for (uint8_t i = 0; i < sizeof(frame); i++)
+    {
+        SD_Xchg(frame[i]);
+    }
+
+    // CMD12 is followed by a stuff byte before the response
+    if (cmd == SD_CMD_STOP_TRANSMISSION)
+        SD_Xchg(0xFF);
+
+    for (uint8_t i = 0; i < SD_NCR; i++)
+    {
+        r1 = SD_Xchg(0xFF);
+        if ((r1 & 0x80) == 0)
+            break;
+    }
+    return r1;
+}
+
+static uint8_t SD_AppCommand(uint8_t cmd, uint32_t arg)
+{
+    uint8_t r1 = SD_Command(SD_CMD_APP_CMD, 0);
+
+    if (r1 > SD_R1_IDLE)
+        return r1;
+    return SD_Command(cmd, arg);
+}
+
+static uint32_t SD_Address(uint32_t sector)
+{
+    return SD.HighCapacity ? sector : sector * SD_BLOCK_SIZE;
+}
+
+/**
+ * @brief Polled read of a short data block (CSD), CS must already be low
+ */
+static SD_Status_t SD_ReadPolled(uint8_t *buf, uint16_t len)
+{
+    uint32_t start = HAL_GetTick();
+    uint8_t token = 0xFF;
+    uint16_t crc = 0;
+
+    do
+    {
+        token = SD_Xchg(0xFF);
+        if (HAL_GetTick() - start >= SD_READ_TIMEOUT)
+            return SD_TIMEOUT;
+    } while (token == 0xFF);
+
+    if (token != SD_TOKEN_START)
+        return SD_ERROR;
+
+    for (uint16_t i = 0; i < len; i++)
+    {
+        buf[i] = SD_Xchg(0xFF);
+    }
+    crc = (uint16_t)(SD_Xchg(0xFF) << 8);
+    crc |= SD_Xchg(0xFF);
+
+#ifdef SD_USE_CRC
+    if (crc != SD_Crc16(buf, len))
+        return SD_CRC_ERROR;
+#else
+    (void)crc;
+#endif
+    return SD_OK;
+}
+
+/**
+ * @brief Card size from the CSD register
+ */
+static uint32_t SD_CsdSectors(const uint8_t *csd)
+{
+    if ((csd[0] >> 6) == 1)
+    {
+        // CSD 2.0: (C_SIZE + 1) * 512 KiB
+        uint32_t c_size = ((uint32_t)(csd[7] & 0x3F) << 16) | ((uint32_t)csd[8] << 8) | csd[9];
+
+        return (c_size + 1) << 10;
+    }
+    else
+    {
+        // CSD 1.0: (C_SIZE + 1) * 2^(C_SIZE_MULT + 2) blocks of 2^READ_BL_LEN bytes
+        uint32_t read_bl_len = csd[5] & 0x0F;
+        uint32_t c_size = ((uint32_t)(csd[6] & 0x03) << 10) | ((uint32_t)csd[7] << 2) | (csd[8] >> 6);
+        uint32_t c_size_mult = ((uint32_t)(csd[9] & 0x03) << 1) | (csd[10] >> 7);
+
+        return (c_size + 1) << (c_size_mult + 2 + read_bl_len - 9);
+    }
+}
+
+/**
+ * @brief Identification sequence, CS must already be low
+ */
+static SD_Status_t SD_Identify(void)
+{
+    uint8_t r7[4] = {0};
+    uint8_t csd[16] = {0};
+    uint32_t hcs = 0;
+    uint32_t start = 0;
+    uint8_t r1 = 0xFF;
+    bool v2 = false;
+    SD_Status_t ret = SD_OK;
+
+    for (uint8_t i = 0; i < 10 && r1 != SD_R1_IDLE; i++)
+    {
+        r1 = SD_Command(SD_CMD_GO_IDLE_STATE, 0);
+    }
+    if (r1 != SD_R1_IDLE)
+        return SD_TIMEOUT;
+
+    // CMD8 is only known to version 2.00+ cards, which may be high capacity
+    r1 = SD_Command(SD_CMD_SEND_IF_COND, SD_IF_COND_ARG);
+    if (r1 == SD_R1_IDLE)
+    {
+        for (uint8_t i = 0; i < sizeof(r7); i++)
+        {
+            r7[i] = SD_Xchg(0xFF);
+        }
+        if ((r7[2] & 0x0F) != 0x01 || r7[3] != 0xAA)
+            return SD_ERROR;
+        v2 = true;
+        hcs = SD_ACMD41_HCS;
+    }
+    else if ((r1 & SD_R1_ILLEGAL_COMMAND) == 0)
+    {
+        return SD_ERROR;
+    }
+
+    start = HAL_GetTick();
+    do
+    {
+        r1 = SD_AppCommand(SD_ACMD_SEND_OP_COND, hcs);
+        if (HAL_GetTick() - start >= SD_INIT_TIMEOUT)
+            return SD_TIMEOUT;
+    } while (r1 == SD_R1_IDLE);
+    if (r1 != 0)
+        return SD_ERROR;
+
+    SD.HighCapacity = false;
+    if (v2)
+    {
+        if (SD_Command(SD_CMD_READ_OCR, 0) != 0)
+            return SD_ERROR;
+        for (uint8_t i = 0; i < sizeof(r7); i++)
+        {
+            r7[i] = SD_Xchg(0xFF);
+        }
+        SD.HighCapacity = (r7[0] & SD_OCR_CCS) != 0;
+    }
+
+    if (!SD.HighCapacity && SD_Command(SD_CMD_SET_BLOCKLEN, SD_BLOCK_SIZE) != 0)
+        return SD_ERROR;
+
+#ifdef SD_USE_CRC
+    if (SD_Command(SD_CMD_CRC_ON_OFF, 1) != 0)
+        return SD_ERROR;
+#endif
+
+    SD_SetBaudRate(SD_SPI_MAX_HZ);
+
+    if (SD_Command(SD_CMD_SEND_CSD, 0) != 0)
+        return SD_ERROR;
+    ret = SD_ReadPolled(csd, sizeof(csd));
+    if (ret != SD_OK)
+        return ret;
+
+    SD.Sectors = SD_CsdSectors(csd);
+    return SD_OK;
+}
+
+/**
+ * @brief End the transfer and report it
+ */
+static void SD_Finish(SD_Status_t result)
+{
+    SD_Deselect();
+    SD.Result = result;
+    SD.State = SD_STATE_IDLE;
+    MicroOS_TriggerEvent(SD_EVENT_DONE);
+}
+
+static void SD_PollBusy(void);
+
+/**
+ * @brief Close a transfer: CMD12 after CMD18, stop token after CMD25, then wait for the card
+ */
+static void SD_Stop(SD_Status_t result)
+{
+    SD.Result = result;
+
+    // A single block needs no stop, its busy time has already been waited for
+    if (!SD.Multi)
+    {
+        SD_Finish(result);
+        return;
+    }
+
+    if (SD.Write)
+    {
+        SD_Xchg(SD_TOKEN_STOP);
+        SD_Xchg(0xFF);
+    }
+    else
+    {
+        SD_Command(SD_CMD_STOP_TRANSMISSION, 0);
+    }
+
+    SD.Start = HAL_GetTick();
+    SD.State = SD_STATE_STOP_BUSY;
+    SD_PollBusy();
+}
+
+/**
+ * @brief Start the DMA of the next block to the card, after its start token
+ */
+static void SD_StartWrite(void)
+{
+    SD_Xchg(SD.Multi ? SD_TOKEN_START_MULTI : SD_TOKEN_START);
+    SD.State = SD_STATE_WRITE_DATA;
+    if (HAL_SPI_Transmit_DMA(&hspi3, SD.Buf, SD_BLOCK_SIZE) != HAL_OK)
+        SD_Stop(SD_ERROR);
+}
+
+/**
+ * @brief Look for the start token of the next block for a few bytes, start its DMA when found
+ */
+static void SD_PollToken(void)
+{
+    for (uint8_t i = 0; i < SD_TOKEN_POLL; i++)
+    {
+        uint8_t token = SD_Xchg(0xFF);
+
+        if (token == SD_TOKEN_START)
+        {
+            SD.State = SD_STATE_READ_DATA;
+            if (HAL_SPI_TransmitReceive_DMA(&hspi3, &SD_Idle, SD.Buf, SD_BLOCK_SIZE) != HAL_OK)
+                SD_Stop(SD_ERROR);
+            return;
+        }
+        if (token != 0xFF)
+        {
+            // Data error token
+            SD_Stop(SD_ERROR);
+            return;
+        }
+    }
+}
+
+/**
+ * @brief Check for a few bytes whether the card has released MISO, then go on
+ */
+static void SD_PollBusy(void)
+{
+    for (uint8_t i = 0; i < SD_TOKEN_POLL; i++)
+    {
+        if (SD_Xchg(0xFF) != 0xFF)
+            continue;
+
+        if (SD.State == SD_STATE_STOP_BUSY)
+            SD_Finish(SD.Result);
+        else if (SD.Remaining == 0)
+            SD_Stop(SD_OK);
+        else
+            SD_StartWrite();
+        return;
+    }
+}
+
+/**
+ * @brief Common checks of SD_ReadBlocks() and SD_WriteBlocks()
+ */
+static SD_Status_t SD_Begin(uint32_t sector, const uint8_t *buf, uint32_t count, bool write)
+{
+    if (buf == NULL || count == 0)
+        return SD_INVALID_PARAM;
+    if (!SD.Ready)
+        return SD_NO_CARD;
+    if (sector >= SD.Sectors || count > SD.Sectors - sector)
+        return SD_INVALID_PARAM;
+    if (SD.State != SD_STATE_IDLE)
+        return SD_BUSY;
+
+    SD.Buf = (uint8_t *)buf;
+    SD.List = NULL;
+    SD.Remaining = count;
+    SD.Multi = (count > 1);
+    SD.Write = write;
+    SD.Result = SD_OK;
+    SD_SetTxIncrement(write);
+    SD_Select();
+    return SD_OK;
+}
+
+SD_Status_t SD_Init(void)
+{
+    SD_Status_t ret = SD_OK;
+
+    SD.Ready = false;
+    SD.State = SD_STATE_IDLE;
+    SD.Sectors = 0;
+    SD.TxIncrement = (hspi3.hdmatx->Init.MemInc == DMA_MINC_ENABLE);
+
+    if (!SD_IsInserted())
+        return SD_NO_CARD;
+
+    SD_SetBaudRate(SD_INIT_HZ);
+
+    // At least 74 clocks with CS high put the card into SPI mode
+    HAL_GPIO_WritePin(SD_CS_GPIO_Port, SD_CS_Pin, GPIO_PIN_SET);
+    for (uint8_t i = 0; i < 10; i++)
+    {
+        SD_Xchg(0xFF);
+    }
+
+    SD_Select();
+    ret = SD_Identify();
+    SD_Deselect();
+
+    SD.Ready = (ret == SD_OK);
+    return ret;
+}
+
+bool SD_IsInserted(void)
+{
+    return HAL_GPIO_ReadPin(SD_CD_GPIO_Port, SD_CD_Pin) == SD_CD_INSERTED;
+}
+
+uint32_t SD_GetSectorCount(void)
+{
+    return SD.Sectors;
+}
+
+SD_Status_t SD_ReadBlocks(uint32_t sector, uint8_t *buf, uint32_t count)
+{
+    SD_Status_t ret = SD_Begin(sector, buf, count, false);
+
+    if (ret != SD_OK)
+        return ret;
+
+    if (SD_Command(SD.Multi ? SD_CMD_READ_MULTIPLE_BLOCK : SD_CMD_READ_SINGLE_BLOCK, SD_Address(sector)) != 0)
+    {
+        SD_Deselect();
+        return SD_ERROR;
+    }
+
+    SD.Start = HAL_GetTick();
+    SD.State = SD_STATE_READ_TOKEN;
+    SD_PollToken();
+    return SD_OK;
+}
+
+/**
+ * @brief Start a write from one buffer or, with list, from one buffer per block
+ */
+static SD_Status_t SD_Write(uint32_t sector, const uint8_t *buf, const uint8_t *const *list, uint32_t count)
+{
+    SD_Status_t ret = SD_Begin(sector, buf, count, true);
+
+    if (ret != SD_OK)
+        return ret;
+    if (list != NULL)
+        SD.List = &list[1];
+
+    // Pre-erase lets the card program the whole run at once; only a hint, errors are ignored
+    if (SD.Multi)
+        SD_AppCommand(SD_ACMD_SET_WR_BLK_ERASE_COUNT, count);
+
+    if (SD_Command(SD.Multi ? SD_CMD_WRITE_MULTIPLE_BLOCK : SD_CMD_WRITE_BLOCK, SD_Address(sector)) != 0)
+    {
+        SD_Deselect();
+        return SD_ERROR;
+    }
+
+    // One byte gap before the first data token
+    SD_Xchg(0xFF);
+    SD_StartWrite();
+    return SD_OK;
+}
+
+SD_Status_t SD_WriteBlocks(uint32_t sector, const uint8_t *buf, uint32_t count)
+{
+    return SD_Write(sector, buf, NULL, count);
+}
+
+SD_Status_t SD_WriteBlockList(uint32_t sector, const uint8_t *const *list, uint32_t count)
+{
+    if (list == NULL || count == 0)
+        return SD_INVALID_PARAM;
+
+    for (uint32_t i = 0; i < count; i++)
+    {
+        if (list[i] == NULL)
+            return SD_INVALID_PARAM;
+    }
+
+    return SD_Write(sector, list[0], list, count);
+}
+
+bool SD_IsBusy(void)
+{
+    return SD.State != SD_STATE_IDLE;
+}
+
+SD_Status_t SD_GetResult(void)
+{
+    return SD.Result;
+}
+
+SD_Status_t SD_WaitIdle(uint32_t timeout_ms)
+{
+    uint32_t start = HAL_GetTick();
+
+    while (SD.State != SD_STATE_IDLE)
+    {
+        SD_Task(NULL);
+        if (HAL_GetTick() - start >= timeout_ms)
+            return SD_TIMEOUT;
+    }
+
+    return SD.Result;
+}
+
+void SD_Task(void *data)
+{
+    switch (SD.State)
+    {
+    case SD_STATE_READ_TOKEN:
+        if (HAL_GetTick() - SD.Start >= SD_READ_TIMEOUT)
+            SD_Stop(SD_TIMEOUT);
+        else
+            SD_PollToken();
+        break;
+
+    case SD_STATE_WRITE_BUSY:
+        if (HAL_GetTick() - SD.Start >= SD_WRITE_TIMEOUT)
+            SD_Stop(SD_TIMEOUT);
+        else
+            SD_PollBusy();
+        break;
+
+    case SD_STATE_STOP_BUSY:
+        if (HAL_GetTick() - SD.Start >= SD_WRITE_TIMEOUT)
+            SD_Finish(SD_TIMEOUT);
+        else
+            SD_PollBusy();
+        break;
+
+    default:
+        break;
+    }
+}
+
+void SD_TxRxCpltCallback(void)
+{
+    uint16_t crc = 0;
+
+    if (SD.State != SD_STATE_READ_DATA)
+        return;
+
+    crc = (uint16_t)(SD_Xchg(0xFF) << 8);
+    crc |= SD_Xchg(0xFF);
+#ifdef SD_USE_CRC
+    if (crc != SD_Crc16(SD.Buf, SD_BLOCK_SIZE))
+    {
+        SD_Stop(SD_CRC_ERROR);
+        return;
+    }
+#else
+    (void)crc;
+#endif
+
+    SD.Buf += SD_BLOCK_SIZE;
+    if (--SD.Remaining == 0)
+    {
+        SD_Stop(SD_OK);
+        return;
+    }
+
+    SD.Start = HAL_GetTick();
+    SD.State = SD_STATE_READ_TOKEN;
+    SD_PollToken();
+}
+
+void SD_TxCpltCallback(void)
+{
+    uint16_t crc = 0xFFFF;
+    uint8_t response = 0;
+
+    if (SD.State != SD_STATE_WRITE_DATA)
+        return;
+
+#ifdef SD_USE_CRC
+    crc = SD_Crc16(SD.Buf, SD_BLOCK_SIZE);
+#endif
+    SD_Xchg((uint8_t)(crc >> 8));
+    SD_Xchg((uint8_t)crc);
+
+    response = SD_Xchg(0xFF) & SD_DATA_RESPONSE_MASK;
+    if (response != SD_DATA_ACCEPTED)
+    {
+        SD_Stop(response == SD_DATA_CRC_ERROR ? SD_CRC_ERROR : SD_ERROR);
+        return;
+    }
+
+    if (--SD.Remaining > 0)
+        SD.Buf = (SD.List != NULL) ? (uint8_t *)*SD.List++ : SD.Buf + SD_BLOCK_SIZE;
+    SD.Start = HAL_GetTick();
+    SD.State = SD_STATE_WRITE_BUSY;
+    SD_PollBusy();
+}
+
+void SD_ErrorCallback(void)
+{
+    if (SD.State != SD_STATE_READ_DATA && SD.State != SD_STATE_WRITE_DATA)
+        return;
+
+    SD_Stop(SD_ERROR);
+}
@@ -0,0 +1,350 @@
+#include "Scale.h"
+
+#include "main.h"
+#include "string.h"
+#include "Blit.h"
+
+#if defined(__ARM_FEATURE_DSP) && (__ARM_FEATURE_DSP == 1) && !defined(SCALE_NO_FAST_PATH)
+#define SCALE_SIMD 1
+#else
+#define SCALE_SIMD 0
+#endif
+
+// Same spread form and 50% mask as in Blit.c
+#define SCALE_SPREAD_MASK (0x07E0F81FUL)
+#define SCALE_HALF_MASK (0xF7DEF7DEUL)
+
+// 5-bit weights of the 1.5x phases: source positions 2/3 and 1/3 past a pixel (16.16, rounded down)
+#define SCALE_A5_TWO_THIRDS (21)
+#define SCALE_A5_ONE_THIRD (10)
+
+typedef struct
+{
+    const Scale_t *Owner; // Setup the cached lines were scaled for
+    int32_t Row[2];       // Source row held by each line, -1 when empty
+} Scale_Handle_t;
+
+static Scale_Handle_t Scale = {0};
+
+// Source rows already scaled horizontally, reused by the following screen rows
+static __ALIGNED(4) uint16_t Scale_Lines[2][LCD_WIDTH];
+
+/**
+ * @brief d + (s - d) * a5 / 32 on all three channels, see Blit_Blend()
+ */
+static inline uint16_t Scale_Mix(uint32_t s, uint32_t d, uint32_t a5)
+{
+    uint32_t se = (s | (s << 16)) & SCALE_SPREAD_MASK;
+    uint32_t de = (d | (d << 16)) & SCALE_SPREAD_MASK;
+    uint32_t e = ((((se - de) * a5) >> 5) + de) & SCALE_SPREAD_MASK;
+
+    return (uint16_t)(e | (e >> 16));
+}
+
+/**
+ * @brief Per-channel floor average, equal to Scale_Mix() with a5 = 16
+ */
+static inline uint16_t Scale_Half(uint32_t a, uint32_t b)
+{
+    return (uint16_t)((a & b) + (((a ^ b) & SCALE_HALF_MASK) >> 1));
+}
+
+/**
+ * @brief Screen pixel j of a scaled row, the reference every path has to match
+ */
+static uint16_t Scale_Sample(const Scale_t *scale, const uint16_t *src, uint32_t j)
+{
+    uint32_t pos = j * scale->StepX;
+    uint32_t x = pos >> 16;
+    uint32_t a5 = (pos >> 11) & 31;
+
+    if (scale->Filter == SCALE_NEAREST || a5 == 0 || x + 1 >= scale->SrcW)
+        return src[x];
+    return Scale_Mix(src[x + 1], src[x], a5);
+}
+
+static void Scale_HGeneric(const Scale_t *scale, uint16_t *dst, const uint16_t *src)
+{
+    uint32_t pos = 0;
+    uint16_t j = 0;
+
+    if (scale->Filter == SCALE_NEAREST)
+    {
+        for (j = 0; j < scale->Dst.w; j++)
+        {
+            dst[j] = src[pos >> 16];
+            pos += scale->StepX;
+        }
+        return;
+    }
+
+    for (j = 0; j < scale->Dst.w; j++)
+    {
+        uint32_t x = pos >> 16;
+        uint32_t a5 = (pos >> 11) & 31;
+
+        dst[j] = (a5 == 0 || x + 1 >= scale->SrcW) ? src[x] : Scale_Mix(src[x + 1], src[x], a5);
+        pos += scale->StepX;
+    }
+}
+
+static void Scale_H2x(const Scale_t *scale, uint16_t *dst, const uint16_t *src)
+{
+    uint16_t last = scale->SrcW - 1;
+    uint16_t i = 0;
+
+    if (scale->Filter == SCALE_NEAREST)
+    {
+        for (i = 0; i < scale->SrcW; i++)
+        {
+            dst[2 * i] = src[i];
+            dst[2 * i + 1] = src[i];
+        }
+        return;
+    }
+
+#if SCALE_SIMD
+    if ((((uintptr_t)src | (uintptr_t)dst) & 3) == 0)
+    {
+        const uint32_t *s = (const uint32_t *)src;
+        uint32_t *d = (uint32_t *)dst;
+
+        // Source pixels a, b in one word give a, (a+b)/2, b, (b+c)/2 with c the next pixel; c alone is
+        // read, the word holding it may end past the row when SrcW is odd
+        for (; i + 2 <= last; i += 2)
+        {
+            uint32_t ab = *s++;
+            uint32_t bc = __PKHBT(ab >> 16, src[i + 2], 16);
+            uint32_t avg = (ab & bc) + (((ab ^ bc) & SCALE_HALF_MASK) >> 1);
+
+            *d++ = __PKHBT(ab, avg, 16);
+            *d++ = __PKHTB(avg, ab, 16);
+        }
+    }
+#endif
+
+    for (; i < scale->SrcW; i++)
+    {
+        dst[2 * i] = src[i];
+        dst[2 * i + 1] = (i < last) ? Scale_Half(src[i], src[i + 1]) : src[i];
+    }
+}
+
+static void Scale_H15(const Scale_t *scale, uint16_t *dst, const uint16_t *src)
+{
+    uint16_t groups = scale->Dst.w / 3;
+    uint16_t k = 0;
+    uint16_t j = 0;
+
+    // Three screen pixels per two source pixels; the last group touches the edge and is sampled below
+    for (k = 0; k + 1 < groups; k++)
+    {
+        uint16_t a = src[2 * k];
+        uint16_t b = src[2 * k + 1];
+
+        dst[3 * k] = a;
+        if (scale->Filter == SCALE_NEAREST)
+        {
+            dst[3 * k + 1] = a;
+            dst[3 * k + 2] = b;
+        }
+        else
+        {
+            dst[3 * k + 1] = Scale_Mix(b, a, SCALE_A5_TWO_THIRDS);
+            dst[3 * k + 2] = Scale_Mix(src[2 * k + 2], b, SCALE_A5_ONE_THIRD);
+        }
+    }
+
+    for (j = 3 * k; j < scale->Dst.w; j++)
+    {
+        dst[j] = Scale_Sample(scale, src, j);
+    }
+}
+
+/**
+ * @brief Get a source row scaled horizontally to Dst.w pixels, scaling it on a miss
+ */
+static const uint16_t *Scale_GetLine(const Scale_t *scale, uint16_t row, Scale_RowFunction_t GetRow, void *Userdata)
+{
+    const uint16_t *src = NULL;
+    uint16_t *line = NULL;
+    uint8_t victim = 0;
+
+    if (Scale.Row[0] == row)
+        return Scale_Lines[0];
+    if (Scale.Row[1] == row)
+        return Scale_Lines[1];
+
+    src = GetRow(row, Userdata);
+    if (src == NULL)
+        return NULL;
+
+    // Rows come in increasing order, so the lower one is not needed again
+    victim = (Scale.Row[0] < Scale.Row[1]) ? 0 : 1;
+    line = Scale_Lines[victim];
+    Scale.Row[victim] = row;
+
+    switch (scale->Path)
+    {
+    case SCALE_PATH_1X:
+        memcpy(line, src, (size_t)scale->Dst.w * 2);
+        break;
+    case SCALE_PATH_2X:
+        Scale_H2x(scale, line, src);
+        break;
+    case SCALE_PATH_1_5X:
+        Scale_H15(scale, line, src);
+        break;
+    default:
+        Scale_HGeneric(scale, line, src);
+        break;
+    }
+    return line;
+}
+
+/**
+ * @brief Produce count pixels of screen row dy (relative to Dst), starting at picture column first
+ */
+static Scale_Status_t Scale_Row(const Scale_t *scale, uint16_t *out, uint16_t dy, uint16_t first, uint16_t count,
+                                Scale_RowFunction_t GetRow, void *Userdata)
+{
+    uint32_t pos = (uint32_t)dy * scale->StepY;
+    uint16_t row = pos >> 16;
+    uint32_t a5 = (scale->Filter == SCALE_BILINEAR) ? (pos >> 11) & 31 : 0;
+    const uint16_t *line = NULL;
+
+    if (row + 1 >= scale->SrcH)
+        a5 = 0;
+
+    // Unscaled rows go straight from the source
+    if (scale->Path == SCALE_PATH_1X && a5 == 0)
+    {
+        line = GetRow(row, Userdata);
+        if (line == NULL)
+            return SCALE_ERROR;
+        memcpy(out, line + first, (size_t)count * 2);
+        return SCALE_OK;
+    }
+
+    line = Scale_GetLine(scale, row, GetRow, Userdata);
+    if (line == NULL)
+        return SCALE_ERROR;
+    memcpy(out, line + first, (size_t)count * 2);
+
+    if (a5 != 0)
+    {
+        line = Scale_GetLine(scale, row + 1, GetRow, Userdata);
+        if (line == NULL)
+            return SCALE_ERROR;
+        // alpha = a5 * 8 gives back exactly a5 in Blit_Blend()
+        Blit_Blend(out, count, line + first, count, count, 1, (uint8_t)(a5 * 8));
+    }
+    return SCALE_OK;
+}
+
+Scale_Status_t Scale_Init(Scale_t *scale, uint16_t src_w, uint16_t src_h, const LCD_Rect_t *box,
+                          Scale_Filter_t filter, uint16_t border)
+{
+    static const LCD_Rect_t screen = {0, 0, LCD_WIDTH, LCD_HEIGHT};
+    uint32_t dst_w = 0;
+    uint32_t dst_h = 0;
+
+    if (scale == NULL || src_w == 0 || src_h == 0 || src_w > SCALE_MAX_SRC_WIDTH)
+        return SCALE_INVALID_PARAM;
+    if (box == NULL)
+        box = &screen;
+    if (box->w == 0 || box->h == 0 || box->x + box->w > LCD_WIDTH || box->y + box->h > LCD_HEIGHT)
+        return SCALE_INVALID_PARAM;
+
+    // Fit the width first, then the height if the picture came out too tall
+    dst_w = box->w;
+    dst_h = (uint32_t)src_h * box->w / src_w;
+    if (dst_h > box->h)
+    {
+        dst_h = box->h;
+        dst_w = (uint32_t)src_w * box->h / src_h;
+    }
+    if (dst_w == 0)
+        dst_w = 1;
+    if (dst_h == 0)
+        dst_h = 1;
+
+    scale->SrcW = src_w;
+    scale->SrcH = src_h;
+    scale->Box = *box;
+    scale->Dst.x = box->x + (box->w - dst_w) / 2;
+    scale->Dst.y = box->y + (box->h - dst_h) / 2;
+    scale->Dst.w = (uint16_t)dst_w;
+    scale->Dst.h = (uint16_t)dst_h;
+    // Rounded up, so 3 * (2/3) does not fall just short of the next source pixel
+    scale->StepX = (((uint32_t)src_w << 16) + dst_w - 1) / dst_w;
+    scale->StepY = (((uint32_t)src_h << 16) + dst_h - 1) / dst_h;
+    scale->Filter = filter;
+    scale->Border = border;
+
+    scale->Path = SCALE_PATH_GENERIC;
+#ifndef SCALE_NO_FAST_PATH
+    if (dst_w == src_w)
+        scale->Path = SCALE_PATH_1X;
+    else if (dst_w == 2 * (uint32_t)src_w)
+        scale->Path = SCALE_PATH_2X;
+    else if (2 * dst_w == 3 * (uint32_t)src_w)
+        scale->Path = SCALE_PATH_1_5X;
+#endif
+
+    Scale.Owner = NULL;
+    return SCALE_OK;
+}
+
+Scale_Status_t Scale_Draw(const Scale_t *scale, uint16_t *strip, const LCD_Rect_t *area, uint16_t y, uint16_t lines,
+                          Scale_RowFunction_t GetRow, void *Userdata)
+{
+    int32_t box_x0 = 0;
+    int32_t box_x1 = 0;
+    int32_t pic_x0 = 0;
+    int32_t pic_x1 = 0;
+    uint16_t r = 0;
+
+    if (scale == NULL || strip == NULL || area == NULL || GetRow == NULL)
+        return SCALE_INVALID_PARAM;
+
+    if (y == 0 || scale != Scale.Owner)
+    {
+        Scale.Owner = scale;
+        Scale.Row[0] = -1;
+        Scale.Row[1] = -1;
+    }
+
+    // Columns of the box and of the picture inside the strip
+    box_x0 = (scale->Box.x > area->x) ? scale->Box.x : area->x;
+    box_x1 = (scale->Box.x + scale->Box.w < area->x + area->w) ? scale->Box.x + scale->Box.w : area->x + area->w;
+    pic_x0 = (scale->Dst.x > area->x) ? scale->Dst.x : area->x;
+    pic_x1 = (scale->Dst.x + scale->Dst.w < area->x + area->w) ? scale->Dst.x + scale->Dst.w : area->x + area->w;
+    if (box_x1 <= box_x0)
+        return SCALE_OK;
+
+    for (r = 0; r < lines; r++)
+    {
+        uint16_t sy = area->y + y + r;
+        uint16_t *row = strip + (uint32_t)r * area->w - area->x;
+
+        if (sy < scale->Box.y || sy >= scale->Box.y + scale->Box.h)
+            continue;
+
+        if (sy < scale->Dst.y || sy >= scale->Dst.y + scale->Dst.h || pic_x1 <= pic_x0)
+        {
+            Blit_Fill(row + box_x0, area->w, box_x1 - box_x0, 1, scale->Border);
+            continue;
+        }
+
+        if (pic_x0 > box_x0)
+            Blit_Fill(row + box_x0, area->w, pic_x0 - box_x0, 1, scale->Border);
+        if (box_x1 > pic_x1)
+            Blit_Fill(row + pic_x1, area->w, box_x1 - pic_x1, 1, scale->Border);
+
+        if (Scale_Row(scale, row + pic_x0, sy - scale->Dst.y, pic_x0 - scale->Dst.x, pic_x1 - pic_x0, GetRow, Userdata) != SCALE_OK)
+            return SCALE_ERROR;
+    }
+
+    return SCALE_OK;
+}
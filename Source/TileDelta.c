@@ -0,0 +1,335 @@
+#include "TileDelta.h"
+
+#include "main.h"
+#include "string.h"
+
+#if (LCD_WIDTH % TILEDELTA_SIZE) != 0 || (LCD_HEIGHT % TILEDELTA_SIZE) != 0
+#error "TileDelta needs a panel size in whole tiles"
+#endif
+
+#define TILEDELTA_TILES (TILEDELTA_COLUMNS * TILEDELTA_ROWS)
+#define TILEDELTA_PIXELS (TILEDELTA_SIZE * TILEDELTA_SIZE)
+
+typedef struct
+{
+    const uint8_t *Map;                    // 2 bits per tile
+    const uint8_t *Data;                   // Tile data, behind the map
+    uint16_t Offset[TILEDELTA_TILES];      // Data offset of every tile in the slice
+    uint8_t Sent[(TILEDELTA_TILES + 7) / 8]; // Tiles already covered by a rectangle
+    uint16_t Line;                         // First screen line of the slice
+    uint16_t Tiles;                        // Tiles in the slice
+    uint16_t Next;                         // Where to look for the next rectangle
+    LCD_Rect_t Rect;                       // Next rectangle to send
+    bool HaveRect;
+    bool Active;
+    TileDelta_Stats_t Stats;
+} TileDelta_Handle_t;
+
+static TileDelta_Handle_t TileDelta = {0};
+
+static inline uint8_t TileDelta_Type(uint16_t tile)
+{
+    return (TileDelta.Map[tile >> 2] >> ((tile & 3) * 2)) & 3;
+}
+
+static inline bool TileDelta_IsSent(uint16_t tile)
+{
+    return (TileDelta.Sent[tile >> 3] >> (tile & 7)) & 1;
+}
+
+/**
+ * @brief Tile run [c0, c1) of a tile row is changed and bounded by skipped tiles or the edge
+ */
+static bool TileDelta_SameRun(uint16_t row, uint16_t c0, uint16_t c1)
+{
+    uint16_t base = row * TILEDELTA_COLUMNS;
+    uint16_t c = 0;
+
+    if (c0 > 0 && TileDelta_Type(base + c0 - 1) != TILEDELTA_SKIP)
+        return false;
+    if (c1 < TILEDELTA_COLUMNS && TileDelta_Type(base + c1) != TILEDELTA_SKIP)
+        return false;
+    for (c = c0; c < c1; c++)
+    {
+        if (TileDelta_Type(base + c) == TILEDELTA_SKIP)
+            return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Next rectangle of changed tiles: a run in a tile row, joined with the same run below
+ */
+static bool TileDelta_NextRect(LCD_Rect_t *rect)
+{
+    uint16_t tile = TileDelta.Next;
+    uint16_t row = 0;
+    uint16_t c0 = 0;
+    uint16_t c1 = 0;
+    uint16_t rows = 1;
+    uint16_t c = 0;
+
+    while (tile < TileDelta.Tiles && (TileDelta_Type(tile) == TILEDELTA_SKIP || TileDelta_IsSent(tile)))
+        tile++;
+    if (tile >= TileDelta.Tiles)
+        return false;
+
+    row = tile / TILEDELTA_COLUMNS;
+    c0 = tile % TILEDELTA_COLUMNS;
+    c1 = c0 + 1;
+    while (c1 < TILEDELTA_COLUMNS && TileDelta_Type(tile + c1 - c0) != TILEDELTA_SKIP)
+        c1++;
+    while ((row + rows) * TILEDELTA_COLUMNS < TileDelta.Tiles && TileDelta_SameRun(row + rows, c0, c1))
+        rows++;
+
+    for (uint16_t r = row; r < row + rows; r++)
+    {
+        for (c = c0; c < c1; c++)
+        {
+            uint16_t t = r * TILEDELTA_COLUMNS + c;
+            TileDelta.Sent[t >> 3] |= (uint8_t)(1 << (t & 7));
+        }
+    }
+    TileDelta.Next = tile + (c1 - c0);
+
+    rect->x = c0 * TILEDELTA_SIZE;
+    rect->y = TileDelta.Line + row * TILEDELTA_SIZE;
+    rect->w = (c1 - c0) * TILEDELTA_SIZE;
+    rect->h = rows * TILEDELTA_SIZE;
+    return true;
+}
+
+/**
+ * @brief Decode rows r0..r1-1 of a tile
+ */
+static void TileDelta_DecodeRows(uint16_t *dst, uint16_t stride, uint16_t tile, uint8_t r0, uint8_t r1)
+{
+    const uint8_t *d = TileDelta.Data + TileDelta.Offset[tile];
+    uint8_t r = 0;
+
+    switch (TileDelta_Type(tile))
+    {
+    case TILEDELTA_SOLID:
+    {
+        uint32_t pair = *(const uint16_t *)d * 0x00010001UL;
+
+        // Strip rows and tile columns are 16 bytes apart, so whole words line up
+        for (r = r0; r < r1; r++, dst += stride)
+        {
+            uint32_t *p = (uint32_t *)dst;
+            p[0] = pair;
+            p[1] = pair;
+            p[2] = pair;
+            p[3] = pair;
+        }
+        break;
+    }
+    case TILEDELTA_RAW:
+    {
+        const uint16_t *src = (const uint16_t *)d + r0 * TILEDELTA_SIZE;
+
+        for (r = r0; r < r1; r++, dst += stride, src += TILEDELTA_SIZE)
+            memcpy(dst, src, TILEDELTA_SIZE * sizeof(uint16_t));
+        break;
+    }
+    case TILEDELTA_RLE:
+    {
+        uint8_t n = d[0];
+        const uint8_t *lens = &d[1];
+        const uint16_t *colors = (const uint16_t *)&d[(n + 2) & ~1U];
+        uint8_t from = r0 * TILEDELTA_SIZE;
+        uint8_t to = r1 * TILEDELTA_SIZE;
+        uint8_t pos = 0;
+
+        for (uint8_t i = 0; i < n && pos < to; i++)
+        {
+            uint8_t end = pos + lens[i] + 1;
+            uint8_t p = (pos > from) ? pos : from;
+
+            if (end > to)
+                end = to;
+            for (; p < end; p++)
+                dst[(p / TILEDELTA_SIZE - r0) * stride + (p % TILEDELTA_SIZE)] = colors[i];
+            pos += lens[i] + 1;
+        }
+        break;
+    }
+    default:
+        break;
+    }
+}
+
+/**
+ * @brief Render draw callback: decode the tiles under a strip
+ */
+static bool TileDelta_DrawStrip(uint16_t *strip, const LCD_Rect_t *area, uint16_t y, uint16_t lines, void *Userdata)
+{
+    uint16_t line = area->y + y - TileDelta.Line; // Slice line of the first strip row
+    uint16_t end = line + lines;
+    uint16_t c0 = area->x / TILEDELTA_SIZE;
+    uint16_t c1 = (area->x + area->w) / TILEDELTA_SIZE;
+
+    while (line < end)
+    {
+        uint16_t row = line / TILEDELTA_SIZE;
+        uint8_t r0 = line % TILEDELTA_SIZE;
+        uint8_t r1 = (end - row * TILEDELTA_SIZE < TILEDELTA_SIZE) ? end - row * TILEDELTA_SIZE : TILEDELTA_SIZE;
+        uint16_t *dst = strip;
+
+        for (uint16_t c = c0; c < c1; c++, dst += TILEDELTA_SIZE)
+            TileDelta_DecodeRows(dst, area->w, row * TILEDELTA_COLUMNS + c, r0, r1);
+
+        strip += (uint32_t)(r1 - r0) * area->w;
+        line += r1 - r0;
+    }
+    return true;
+}
+
+Render_Status_t TileDelta_Start(const uint8_t *data, uint32_t size, uint16_t line, uint16_t lines)
+{
+    uint32_t map = 0;
+    uint32_t offset = 0;
+    uint32_t room = 0;
+    uint16_t tile = 0;
+
+    if (data == NULL || line % TILEDELTA_SIZE != 0 || lines % TILEDELTA_SIZE != 0 || line + lines > LCD_HEIGHT)
+        return RENDER_INVALID_PARAM;
+    if (TileDelta.Active)
+        return RENDER_BUSY;
+
+    TileDelta.Stats.Slices++;
+    TileDelta.Tiles = (lines / TILEDELTA_SIZE) * TILEDELTA_COLUMNS;
+    map = ((TileDelta.Tiles + 3) / 4 + 1) & ~1UL;
+    if (size < map || size - map > 0xFFFF)
+    {
+        TileDelta.Stats.Errors++;
+        return RENDER_ERROR;
+    }
+
+    TileDelta.Map = data;
+    TileDelta.Data = data + map;
+    room = size - map;
+
+    // Locate every tile once; a slice that does not add up is dropped before anything is drawn
+    for (tile = 0; tile < TileDelta.Tiles; tile++)
+    {
+        uint8_t type = TileDelta_Type(tile);
+        uint32_t bytes = 0;
+
+        TileDelta.Offset[tile] = (uint16_t)offset;
+        if (type == TILEDELTA_SOLID)
+        {
+            bytes = sizeof(uint16_t);
+        }
+        else if (type == TILEDELTA_RAW)
+        {
+            bytes = TILEDELTA_PIXELS * sizeof(uint16_t);
+        }
+        else if (type == TILEDELTA_RLE)
+        {
+            uint32_t n = (offset < room) ? TileDelta.Data[offset] : 0;
+            uint32_t pixels = 0;
+
+            bytes = ((n + 2) & ~1UL) + n * sizeof(uint16_t);
+            if (n == 0 || n > TILEDELTA_PIXELS || offset + bytes > room)
+                break;
+            for (uint32_t i = 0; i < n; i++)
+                pixels += TileDelta.Data[offset + 1 + i] + 1U;
+            if (pixels != TILEDELTA_PIXELS)
+                break;
+        }
+        if (offset + bytes > room)
+            break;
+        TileDelta.Stats.Tiles[type]++;
+        offset += bytes;
+    }
+    if (tile < TileDelta.Tiles)
+    {
+        TileDelta.Stats.Errors++;
+        return RENDER_ERROR;
+    }
+
+    memset(TileDelta.Sent, 0, sizeof(TileDelta.Sent));
+    TileDelta.Line = line;
+    TileDelta.Next = 0;
+    TileDelta.HaveRect = false;
+    TileDelta.Active = (TileDelta.Tiles > 0);
+    return RENDER_OK;
+}
+
+Render_Status_t TileDelta_Process(void)
+{
+    Render_Status_t ret = RENDER_OK;
+
+    if (!TileDelta.Active)
+        return RENDER_OK;
+
+    ret = Render_Process();
+    if (ret != RENDER_OK)
+    {
+        if (ret == RENDER_ERROR)
+            TileDelta.Active = false;
+        return ret;
+    }
+
+    if (!TileDelta.HaveRect)
+        TileDelta.HaveRect = TileDelta_NextRect(&TileDelta.Rect);
+    if (!TileDelta.HaveRect)
+    {
+        TileDelta.Active = false;
+        return RENDER_OK;
+    }
+
+    // Render is idle once the previous rectangle is out; start the next one
+    ret = Render_Start(&TileDelta.Rect, TileDelta_DrawStrip, NULL);
+    if (ret == RENDER_BUSY)
+        return RENDER_BUSY;
+    if (ret != RENDER_OK)
+    {
+        TileDelta.Active = false;
+        return ret;
+    }
+    TileDelta.HaveRect = false;
+    TileDelta.Stats.Rects++;
+
+    if (Render_Process() == RENDER_ERROR)
+    {
+        TileDelta.Active = false;
+        return RENDER_ERROR;
+    }
+    return RENDER_BUSY;
+}
+
+Render_Status_t TileDelta_Draw(const uint8_t *data, uint32_t size, uint16_t line, uint16_t lines)
+{
+    Render_Status_t ret = TileDelta_Start(data, size, line, lines);
+    uint32_t start = HAL_GetTick();
+
+    if (ret != RENDER_OK)
+        return ret;
+
+    while ((ret = TileDelta_Process()) == RENDER_BUSY)
+    {
+        if (HAL_GetTick() - start >= RENDER_FRAME_TIMEOUT)
+        {
+            Render_Abort();
+            TileDelta.Active = false;
+            return RENDER_TIMEOUT;
+        }
+    }
+
+    return ret;
+}
+
+void TileDelta_GetStats(TileDelta_Stats_t *stats)
+{
+    if (stats == NULL)
+        return;
+
+    *stats = TileDelta.Stats;
+}
+
+void TileDelta_ResetStats(void)
+{
+    memset(&TileDelta.Stats, 0, sizeof(TileDelta.Stats));
+}
@@ -0,0 +1,1082 @@
+#include "Widget.h"
+
+#include "main.h"
+#include "MicroOS.h"
+#include "string.h"
+#include "Render.h"
+#include "Dirty.h"
+#include "Blit.h"
+#include "Font_Sans14.h"
+
+// Key presses waiting for the key event, must be a power of two
+#define WIDGET_KEY_QUEUE (8)
+
+typedef enum
+{
+    WIDGET_TYPE_FREE = 0, // Pool slot unused
+    WIDGET_TYPE_PANEL,
+    WIDGET_TYPE_LABEL,
+    WIDGET_TYPE_LIST,
+    WIDGET_TYPE_PROGRESS,
+    WIDGET_TYPE_ICON,
+    WIDGET_TYPE_SCROLL,
+} Widget_Type_t;
+
+struct Widget_t
+{
+    Widget_Type_t Type;
+    Widget_t *Parent;
+    Widget_t *Child; // First child
+    Widget_t *Next;  // Next sibling
+    int16_t X;       // Relative to the parent content
+    int16_t Y;
+    uint16_t W;
+    uint16_t H;
+    int16_t ScreenX; // Set by the layout pass
+    int16_t ScreenY;
+    LCD_Rect_t Clip; // Visible part on screen, w == 0 when nothing is visible
+    bool Visible;
+    bool Focusable;
+    bool Redraw; // Invalidate the new Clip after the next layout pass
+    uint16_t Fg;
+    uint16_t Bg;
+    const Font_t *Font;
+    Widget_Align_t Align;
+    Widget_KeyFunction_t OnKey;
+    void *Userdata;
+
+    const char *Text;         // Label
+    const char *const *Items; // List
+    uint16_t Count;           // List
+    uint16_t Selected;        // List
+    uint16_t Value;           // Progress
+    uint16_t Max;             // Progress
+    const uint8_t *Mask;      // Icon
+    int16_t Scroll;           // List and scroll view: content row shown at the top
+    int16_t ScrollTarget;     // Where the scroll animation is heading
+    uint16_t ContentH;        // Scroll view
+};
+
+typedef struct
+{
+    uint16_t *Strip;
+    const LCD_Rect_t *Area;
+    LCD_Rect_t Band; // Screen rows held by the strip
+} Widget_Canvas_t;
+
+typedef struct
+{
+    Widget_t Pool[WIDGET_POOL_SIZE]; // Pool[0] is the root
+    Widget_t *Focus;
+    bool Layout;  // Layout pass needed
+    bool Drawing; // Dirty flush in progress
+    uint32_t LastFrame;
+    Widget_Key_t Keys[WIDGET_KEY_QUEUE];
+    volatile uint8_t KeyHead; // Written by the key interrupt
+    volatile uint8_t KeyTail; // Written by the key event
+    uint32_t KeyTick[4];      // Last accepted press per key, for debouncing
+    Widget_t *HwScroll;       // List moved by the panel scroll area, NULL when none
+    bool HwActive;            // LCD scroll area programmed
+    LCD_Rect_t HwRect;        // Screen rows of the scroll area
+    uint16_t HwOffset;        // Current LCD scroll offset
+} Widget_Handle_t;
+
+static Widget_Handle_t Widget = {0};
+
+static const LCD_Rect_t Widget_Screen = {0, 0, LCD_WIDTH, LCD_HEIGHT};
+
+/**
+ * @brief Intersect a rectangle given in signed screen coordinates with a clip rectangle
+ * @return false (and an empty out) if they do not overlap
+ */
+static bool Widget_ClipRect(int32_t x, int32_t y, int32_t w, int32_t h, const LCD_Rect_t *clip, LCD_Rect_t *out)
+{
+    int32_t x0 = (x > clip->x) ? x : clip->x;
+    int32_t y0 = (y > clip->y) ? y : clip->y;
+    int32_t x1 = (x + w < clip->x + clip->w) ? x + w : clip->x + clip->w;
+    int32_t y1 = (y + h < clip->y + clip->h) ? y + h : clip->y + clip->h;
+
+    if (x1 <= x0 || y1 <= y0)
+    {
+        out->x = 0;
+        out->y = 0;
+        out->w = 0;
+        out->h = 0;
+        return false;
+    }
+
+    out->x = (uint16_t)x0;
+    out->y = (uint16_t)y0;
+    out->w = (uint16_t)(x1 - x0);
+    out->h = (uint16_t)(y1 - y0);
+    return true;
+}
+
+/**
+ * @brief Next widget in drawing order (parents before children, siblings in creation order)
+ * @param descend false skips the children of widget
+ */
+static Widget_t *Widget_NextNode(Widget_t *widget, bool descend)
+{
+    if (descend && widget->Child != NULL)
+        return widget->Child;
+
+    while (widget != NULL)
+    {
+        if (widget->Next != NULL)
+            return widget->Next;
+        widget = widget->Parent;
+    }
+    return NULL;
+}
+
+static bool Widget_IsInside(const Widget_t *widget, const Widget_t *ancestor)
+{
+    while (widget != NULL)
+    {
+        if (widget == ancestor)
+            return true;
+        widget = widget->Parent;
+    }
+    return false;
+}
+
+static bool Widget_IsShown(const Widget_t *widget)
+{
+    while (widget != NULL)
+    {
+        if (!widget->Visible)
+            return false;
+        widget = widget->Parent;
+    }
+    return true;
+}
+
+static uint16_t Widget_ItemHeight(const Widget_t *widget)
+{
+    return widget->Font->LineHeight + WIDGET_PADDING;
+}
+
+static uint16_t Widget_ContentHeight(const Widget_t *widget)
+{
+    if (widget->Type == WIDGET_TYPE_LIST)
+        return widget->Count * Widget_ItemHeight(widget);
+    return widget->ContentH;
+}
+
+static int16_t Widget_ClampScroll(const Widget_t *widget, int32_t y)
+{
+    int32_t content = Widget_ContentHeight(widget);
+    int32_t limit = (content > widget->H) ? content - widget->H : 0;
+
+    if (y > limit)
+        y = limit;
+    if (y < 0)
+        y = 0;
+    return (int16_t)y;
+}
+
+/**
+ * @brief Mark a widget for a new layout pass; its old area is redrawn now, its new area after the pass
+ */
+static void Widget_RequestLayout(Widget_t *widget)
+{
+    if (widget->Clip.w > 0)
+        Dirty_Invalidate(&widget->Clip);
+    widget->Redraw = true;
+    Widget.Layout = true;
+}
+
+static void Widget_LayoutNode(Widget_t *widget, int32_t x, int32_t y, const LCD_Rect_t *clip)
+{
+    Widget_t *child = NULL;
+    int32_t scroll = (widget->Type == WIDGET_TYPE_SCROLL) ? widget->Scroll : 0;
+
+    widget->ScreenX = (int16_t)(x + widget->X);
+    widget->ScreenY = (int16_t)(y + widget->Y);
+    if (widget->Visible)
+        Widget_ClipRect(widget->ScreenX, widget->ScreenY, widget->W, widget->H, clip, &widget->Clip);
+    else
+        Widget_ClipRect(0, 0, 0, 0, clip, &widget->Clip);
+
+    if (widget->Redraw)
+    {
+        widget->Redraw = false;
+        if (widget->Clip.w > 0)
+            Dirty_Invalidate(&widget->Clip);
+    }
+
+    for (child = widget->Child; child != NULL; child = child->Next)
+    {
+        Widget_LayoutNode(child, widget->ScreenX, widget->ScreenY - scroll, &widget->Clip);
+    }
+}
+
+static Widget_t *Widget_Alloc(Widget_t *parent, Widget_Type_t type, int16_t x, int16_t y, uint16_t w, uint16_t h)
+{
+    Widget_t *widget = NULL;
+    Widget_t **link = NULL;
+    uint8_t i = 0;
+
+    if (parent == NULL)
+        parent = Widget_Root();
+    if (parent->Type != WIDGET_TYPE_PANEL && parent->Type != WIDGET_TYPE_SCROLL)
+        return NULL;
+    if (w == 0 || h == 0)
+        return NULL;
+
+    for (i = 1; i < WIDGET_POOL_SIZE; i++)
+    {
+        if (Widget.Pool[i].Type == WIDGET_TYPE_FREE)
+        {
+            widget = &Widget.Pool[i];
+            break;
+        }
+    }
+    if (widget == NULL)
+        return NULL;
+
+    memset(widget, 0, sizeof(Widget_t));
+    widget->Type = type;
+    widget->Parent = parent;
+    widget->X = x;
+    widget->Y = y;
+    widget->W = w;
+    widget->H = h;
+    widget->Visible = true;
+    widget->Fg = parent->Fg;
+    widget->Bg = parent->Bg;
+    widget->Font = parent->Font;
+
+    // Append, so later siblings are drawn on top
+    link = &parent->Child;
+    while (*link != NULL)
+    {
+        link = &(*link)->Next;
+    }
+    *link = widget;
+
+    widget->Redraw = true;
+    Widget.Layout = true;
+    return widget;
+}
+
+static void Widget_Free(Widget_t *widget)
+{
+    Widget_t *child = widget->Child;
+
+    while (child != NULL)
+    {
+        Widget_t *next = child->Next;
+        Widget_Free(child);
+        child = next;
+    }
+    widget->Type = WIDGET_TYPE_FREE;
+}
+
+/**
+ * @brief Redraw one list item
+ */
+static void Widget_InvalidateItem(Widget_t *widget, uint16_t index)
+{
+    uint16_t height = Widget_ItemHeight(widget);
+    LCD_Rect_t rect;
+
+    if (Widget.Layout)
+    {
+        Widget_Invalidate(widget);
+        return;
+    }
+    if (Widget_ClipRect(widget->ScreenX, (int32_t)widget->ScreenY - widget->Scroll + (int32_t)index * height,
+                        widget->W, height, &widget->Clip, &rect))
+        Dirty_Invalidate(&rect);
+}
+
+/**
+ * @brief Scroll a list so the selected item is fully visible
+ */
+static void Widget_ListReveal(Widget_t *widget)
+{
+    int32_t height = Widget_ItemHeight(widget);
+    int32_t top = (int32_t)widget->Selected * height;
+
+    if (top < widget->ScrollTarget)
+        widget->ScrollTarget = Widget_ClampScroll(widget, top);
+    else if (top + height > widget->ScrollTarget + widget->H)
+        widget->ScrollTarget = Widget_ClampScroll(widget, top + height - widget->H);
+}
+
+/**
+ * @brief Scroll every scroll view around a widget so the widget is fully visible
+ */
+static void Widget_Reveal(Widget_t *widget)
+{
+    Widget_t *node = NULL;
+    int32_t y = 0;
+
+    for (node = widget; node->Parent != NULL; node = node->Parent)
+    {
+        Widget_t *view = node->Parent;
+
+        y += node->Y;
+        if (view->Type != WIDGET_TYPE_SCROLL)
+            continue;
+
+        if (y < view->ScrollTarget)
+            Widget_ScrollTo(view, (int16_t)y);
+        else if (y + widget->H > view->ScrollTarget + view->H)
+            Widget_ScrollTo(view, (int16_t)(y + widget->H - view->H));
+        // Continue in the coordinates of the view's parent
+        y -= view->ScrollTarget;
+    }
+}
+
+/**
+ * @brief Find the next or previous focusable widget in drawing order
+ * @param from Current focus, NULL to get the first (forward) or last (backward) one
+ */
+static Widget_t *Widget_FindFocusable(Widget_t *from, bool forward)
+{
+    Widget_t *widget = Widget_Root();
+    Widget_t *prev = NULL;
+    bool passed = (from == NULL);
+
+    while (widget != NULL)
+    {
+        if (widget->Visible && widget->Focusable)
+        {
+            if (widget == from)
+            {
+                if (!forward)
+                    return prev;
+                passed = true;
+            }
+            else if (forward && passed)
+            {
+                return widget;
+            }
+            else
+            {
+                prev = widget;
+            }
+        }
+        widget = Widget_NextNode(widget, widget->Visible);
+    }
+
+    return forward ? NULL : prev;
+}
+
+static void Widget_HandleKey(Widget_Key_t key)
+{
+    Widget_t *focus = Widget.Focus;
+    Widget_t *widget = NULL;
+
+    if (focus == NULL)
+    {
+        if (key == WIDGET_KEY_UP || key == WIDGET_KEY_DOWN)
+            Widget_Focus(Widget_FindFocusable(NULL, key == WIDGET_KEY_DOWN));
+        return;
+    }
+
+    if (focus->Type == WIDGET_TYPE_LIST)
+    {
+        if (key == WIDGET_KEY_UP && focus->Selected > 0)
+        {
+            Widget_ListSelect(focus, focus->Selected - 1);
+            return;
+        }
+        if (key == WIDGET_KEY_DOWN && focus->Selected + 1 < focus->Count)
+        {
+            Widget_ListSelect(focus, focus->Selected + 1);
+            return;
+        }
+    }
+
+    for (widget = focus; widget != NULL; widget = widget->Parent)
+    {
+        if (widget->OnKey != NULL && widget->OnKey(widget, key, widget->Userdata))
+            return;
+    }
+
+    if (key == WIDGET_KEY_UP || key == WIDGET_KEY_DOWN)
+    {
+        widget = Widget_FindFocusable(focus, key == WIDGET_KEY_DOWN);
+        if (widget != NULL)
+            Widget_Focus(widget);
+    }
+}
+
+/**
+ * @brief Key event handler (MicroOS event context)
+ */
+static void Widget_OnKey(void *data)
+{
+    while (Widget.KeyTail != Widget.KeyHead)
+    {
+        Widget_Key_t key = Widget.Keys[Widget.KeyTail];
+        Widget.KeyTail = (Widget.KeyTail + 1) & (WIDGET_KEY_QUEUE - 1);
+        Widget_HandleKey(key);
+    }
+}
+
+/**
+ * @brief Check whether a list can be scrolled by the panel: it must span the full screen width,
+ *        be fully visible and share its rows with nothing but its ancestors
+ */
+static bool Widget_CanHwScroll(const Widget_t *list)
+{
+    uint8_t i = 0;
+
+    if (list == NULL || list->Type != WIDGET_TYPE_LIST || !Widget_IsShown(list))
+        return false;
+    if (list->ScreenX != 0 || list->W != LCD_WIDTH || list->Clip.w != list->W ||
+        list->Clip.y != list->ScreenY || list->Clip.h != list->H)
+        return false;
+
+    for (i = 0; i < WIDGET_POOL_SIZE; i++)
+    {
+        const Widget_t *widget = &Widget.Pool[i];
+
+        if (widget->Type == WIDGET_TYPE_FREE || widget == list || widget->Clip.w == 0 || Widget_IsInside(list, widget))
+            continue;
+        if (widget->Clip.y < list->Clip.y + list->Clip.h && widget->Clip.y + widget->Clip.h > list->Clip.y)
+            return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Hand the panel scroll area to the focused list, or take it back
+ * @note Needs an idle LCD; otherwise it is retried on the next frame
+ */
+static void Widget_UpdateHwScroll(void)
+{
+    Widget_t *want = Widget.Focus;
+
+    if (!Widget_CanHwScroll(want))
+        want = Widget_CanHwScroll(Widget.HwScroll) ? Widget.HwScroll : NULL;
+    if (Widget.HwActive && want == Widget.HwScroll && want != NULL &&
+        memcmp(&want->Clip, &Widget.HwRect, sizeof(LCD_Rect_t)) == 0)
+        return;
+    if (!Widget.HwActive && want == NULL)
+        return;
+    if (Render_IsActive() || LCD_IsBusy())
+        return;
+
+    if (Widget.HwActive)
+    {
+        if (LCD_SetScrollArea(0, 0) != LCD_OK)
+            return;
+        Widget.HwActive = false;
+        Widget.HwScroll = NULL;
+        // The rows are shown in memory order again
+        if (Widget.HwOffset != 0)
+            Dirty_Invalidate(&Widget.HwRect);
+    }
+
+    if (want != NULL && LCD_SetScrollArea(want->Clip.y, want->Clip.h) == LCD_OK)
+    {
+        // Offset 0 maps the area one to one, so what is on screen stays valid
+        Widget.HwActive = true;
+        Widget.HwScroll = want;
+        Widget.HwRect = want->Clip;
+        Widget.HwOffset = 0;
+    }
+}
+
+/**
+ * @brief Move a list with the panel scroll area and invalidate only the exposed rows
+ * @return false if the panel cannot scroll now; the caller redraws the list instead
+ */
+static bool Widget_HwScrollStep(Widget_t *widget, int16_t step)
+{
+    int32_t offset = 0;
+    LCD_Rect_t exposed = Widget.HwRect;
+
+    if (!Widget.HwActive || widget != Widget.HwScroll)
+        return false;
+    // Pending rectangles were computed for the old scroll position
+    if (Dirty_Count() > 0 || Render_IsActive() || LCD_IsBusy())
+        return false;
+
+    offset = ((int32_t)Widget.HwOffset + step) % Widget.HwRect.h;
+    if (offset < 0)
+        offset += Widget.HwRect.h;
+    if (LCD_SetScroll((uint16_t)offset) != LCD_OK)
+        return false;
+    Widget.HwOffset = (uint16_t)offset;
+
+    if ((step > 0 ? step : -step) < exposed.h)
+    {
+        if (step > 0)
+            exposed.y += exposed.h - step;
+        exposed.h = (step > 0) ? step : -step;
+    }
+    Dirty_Invalidate(&exposed);
+    return true;
+}
+
+/**
+ * @brief Advance the scroll animations by one frame
+ */
+static void Widget_Animate(void)
+{
+    uint8_t i = 0;
+
+    for (i = 0; i < WIDGET_POOL_SIZE; i++)
+    {
+        Widget_t *widget = &Widget.Pool[i];
+        int16_t step = 0;
+
+        if (widget->Type != WIDGET_TYPE_LIST && widget->Type != WIDGET_TYPE_SCROLL)
+            continue;
+        if (widget->Scroll == widget->ScrollTarget)
+            continue;
+
+        step = (widget->ScrollTarget - widget->Scroll) / WIDGET_SCROLL_EASE;
+        if (step == 0)
+            step = (widget->ScrollTarget > widget->Scroll) ? 1 : -1;
+
+        // Scroll view children move, so they need a new layout; list items are drawn from Scroll directly
+        if (widget->Type == WIDGET_TYPE_SCROLL)
+        {
+            widget->Scroll += step;
+            Widget_RequestLayout(widget);
+        }
+        else if (Widget_HwScrollStep(widget, step))
+        {
+            widget->Scroll += step;
+        }
+        else if (widget == Widget.HwScroll && Widget.HwActive)
+        {
+            // Waiting a frame for the panel is cheaper than redrawing the whole list
+            continue;
+        }
+        else
+        {
+            widget->Scroll += step;
+            Widget_Invalidate(widget);
+        }
+    }
+}
+
+static void Widget_Fill(const Widget_Canvas_t *canvas, const LCD_Rect_t *clip, int32_t x, int32_t y, int32_t w, int32_t h, uint16_t color)
+{
+    LCD_Rect_t rect;
+
+    if (!Widget_ClipRect(x, y, w, h, clip, &rect))
+        return;
+    Blit_Fill(canvas->Strip + (uint32_t)(rect.y - canvas->Band.y) * canvas->Area->w + (rect.x - canvas->Area->x),
+              canvas->Area->w, rect.w, rect.h, color);
+}
+
+/**
+ * @brief Draw one line of text inside a box, truncated to the box width
+ * @param clip Part of the widget inside the strip; text is clipped to its rows
+ */
+static void Widget_Text(const Widget_Canvas_t *canvas, const LCD_Rect_t *clip, int32_t x, int32_t y, uint16_t w, uint16_t h,
+                        const Widget_t *widget, const char *text, uint16_t bg)
+{
+    char buffer[WIDGET_TEXT_MAX + 1];
+    LCD_Rect_t rows = {canvas->Area->x, clip->y, canvas->Area->w, clip->h};
+    const Font_t *font = widget->Font;
+    uint16_t width = (w > 2 * WIDGET_PADDING) ? w - 2 * WIDGET_PADDING : 0;
+    uint16_t fit = 0;
+    uint16_t used = 0;
+    int32_t top = y + ((int32_t)h - font->LineHeight) / 2;
+
+    if (text == NULL || width == 0)
+        return;
+    // Nothing of the line in these rows
+    if (top + font->LineHeight <= clip->y || top >= clip->y + clip->h)
+        return;
+
+    fit = Font_TextFit(font, text, width);
+    if (text[fit] != '\0')
+    {
+        if (fit > WIDGET_TEXT_MAX)
+        {
+            fit = WIDGET_TEXT_MAX;
+            while (fit > 0 && ((uint8_t)text[fit] & 0xC0) == 0x80)
+            {
+                fit--;
+            }
+        }
+        memcpy(buffer, text, fit);
+        buffer[fit] = '\0';
+        text = buffer;
+    }
+
+    x += WIDGET_PADDING;
+    if (widget->Align != WIDGET_ALIGN_LEFT)
+    {
+        used = Font_TextWidth(font, text);
+        if (used < width)
+            x += (widget->Align == WIDGET_ALIGN_CENTER) ? (width - used) / 2 : width - used;
+    }
+
+    Font_DrawText(canvas->Strip + (uint32_t)(clip->y - canvas->Band.y) * canvas->Area->w, &rows, 0, clip->h,
+                  (int16_t)x, (int16_t)top, font, text, widget->Fg, bg);
+}
+
+static void Widget_DrawList(const Widget_Canvas_t *canvas, const Widget_t *widget, const LCD_Rect_t *clip)
+{
+    uint16_t height = Widget_ItemHeight(widget);
+    int32_t origin = (int32_t)widget->ScreenY - widget->Scroll;
+    uint16_t index = (uint16_t)((clip->y - origin) / height);
+
+    Widget_Fill(canvas, clip, clip->x, clip->y, clip->w, clip->h, widget->Bg);
+
+    for (; index < widget->Count; index++)
+    {
+        int32_t y = origin + (int32_t)index * height;
+        uint16_t bg = widget->Bg;
+        LCD_Rect_t item;
+
+        if (y >= clip->y + clip->h)
+            break;
+        if (!Widget_ClipRect(widget->ScreenX, y, widget->W, height, clip, &item))
+            continue;
+
+        if (index == widget->Selected)
+        {
+            bg = (widget == Widget.Focus) ? WIDGET_COLOR_FOCUS : WIDGET_COLOR_SELECT;
+            Widget_Fill(canvas, &item, item.x, item.y, item.w, item.h, bg);
+        }
+        Widget_Text(canvas, &item, widget->ScreenX, y, widget->W, height, widget, widget->Items[index], bg);
+    }
+}
+
+static void Widget_DrawNode(const Widget_Canvas_t *canvas, const Widget_t *widget, const LCD_Rect_t *clip)
+{
+    uint16_t bg = (widget == Widget.Focus) ? WIDGET_COLOR_FOCUS : widget->Bg;
+
+    switch (widget->Type)
+    {
+    case WIDGET_TYPE_PANEL:
+    case WIDGET_TYPE_SCROLL:
+        Widget_Fill(canvas, clip, clip->x, clip->y, clip->w, clip->h, bg);
+        break;
+
+    case WIDGET_TYPE_LABEL:
+        Widget_Fill(canvas, clip, clip->x, clip->y, clip->w, clip->h, bg);
+        Widget_Text(canvas, clip, widget->ScreenX, widget->ScreenY, widget->W, widget->H, widget, widget->Text, bg);
+        break;
+
+    case WIDGET_TYPE_LIST:
+        Widget_DrawList(canvas, widget, clip);
+        break;
+
+    case WIDGET_TYPE_PROGRESS:
+    {
+        uint32_t filled = (uint32_t)widget->W * widget->Value / widget->Max;
+
+        Widget_Fill(canvas, clip, widget->ScreenX, widget->ScreenY, filled, widget->H, widget->Fg);
+        Widget_Fill(canvas, clip, widget->ScreenX + filled, widget->ScreenY, widget->W - filled, widget->H, bg);
+        break;
+    }
+
+    case WIDGET_TYPE_ICON:
+        Widget_Fill(canvas, clip, clip->x, clip->y, clip->w, clip->h, bg);
+        Blit_BlendMask(canvas->Strip + (uint32_t)(clip->y - canvas->Band.y) * canvas->Area->w + (clip->x - canvas->Area->x),
+                       canvas->Area->w,
+                       widget->Mask + (uint32_t)(clip->y - widget->ScreenY) * widget->W + (clip->x - widget->ScreenX),
+                       widget->W, clip->w, clip->h, widget->Fg);
+        break;
+
+    default:
+        break;
+    }
+}
+
+/**
+ * @brief Render draw callback: paint every widget that reaches into the strip
+ */
+static bool Widget_Draw(uint16_t *strip, const LCD_Rect_t *area, uint16_t y, uint16_t lines, void *Userdata)
+{
+    Widget_Canvas_t canvas;
+    Widget_t *widget = Widget_Root();
+
+    canvas.Strip = strip;
+    canvas.Area = area;
+    canvas.Band.x = area->x;
+    canvas.Band.y = area->y + y;
+    canvas.Band.w = area->w;
+    canvas.Band.h = lines;
+
+    while (widget != NULL)
+    {
+        LCD_Rect_t clip;
+        // Children never leave the parent's clip, so a parent outside the strip ends the subtree
+        bool inside = (widget->Clip.w > 0) &&
+                      Widget_ClipRect(widget->Clip.x, widget->Clip.y, widget->Clip.w, widget->Clip.h, &canvas.Band, &clip);
+
+        if (inside)
+            Widget_DrawNode(&canvas, widget, &clip);
+        widget = Widget_NextNode(widget, inside);
+    }
+    return true;
+}
+
+Widget_Status_t Widget_Init(void)
+{
+    Widget_t *root = &Widget.Pool[0];
+
+    memset(&Widget, 0, sizeof(Widget));
+    root->Type = WIDGET_TYPE_PANEL;
+    root->W = LCD_WIDTH;
+    root->H = LCD_HEIGHT;
+    root->Visible = true;
+    root->Fg = WIDGET_COLOR_FG;
+    root->Bg = WIDGET_COLOR_BG;
+    root->Font = &Font_Sans14;
+    root->Redraw = true;
+    Widget.Layout = true;
+
+    if (MicroOS_RegisterEvent(WIDGET_EVENT_KEY, Widget_OnKey, NULL) != MICROOS_OK)
+        return WIDGET_ERROR;
+    if (LCD_SetScrollArea(0, 0) != LCD_OK)
+        return WIDGET_ERROR;
+
+    return WIDGET_OK;
+}
+
+Widget_t *Widget_Root(void)
+{
+    return &Widget.Pool[0];
+}
+
+Widget_t *Widget_CreatePanel(Widget_t *parent, int16_t x, int16_t y, uint16_t w, uint16_t h)
+{
+    return Widget_Alloc(parent, WIDGET_TYPE_PANEL, x, y, w, h);
+}
+
+Widget_t *Widget_CreateLabel(Widget_t *parent, int16_t x, int16_t y, uint16_t w, uint16_t h, const char *text)
+{
+    Widget_t *widget = Widget_Alloc(parent, WIDGET_TYPE_LABEL, x, y, w, h);
+
+    if (widget != NULL)
+        widget->Text = text;
+    return widget;
+}
+
+Widget_t *Widget_CreateProgress(Widget_t *parent, int16_t x, int16_t y, uint16_t w, uint16_t h, uint16_t max)
+{
+    Widget_t *widget = NULL;
+
+    if (max == 0)
+        return NULL;
+
+    widget = Widget_Alloc(parent, WIDGET_TYPE_PROGRESS, x, y, w, h);
+    if (widget != NULL)
+        widget->Max = max;
+    return widget;
+}
+
+Widget_t *Widget_CreateList(Widget_t *parent, int16_t x, int16_t y, uint16_t w, uint16_t h,
+                            const char *const *items, uint16_t count)
+{
+    Widget_t *widget = NULL;
+
+    if (items == NULL && count > 0)
+        return NULL;
+
+    widget = Widget_Alloc(parent, WIDGET_TYPE_LIST, x, y, w, h);
+    if (widget != NULL)
+    {
+        widget->Items = items;
+        widget->Count = count;
+        widget->Focusable = true;
+    }
+    return widget;
+}
+
+Widget_t *Widget_CreateIcon(Widget_t *parent, int16_t x, int16_t y, uint16_t w, uint16_t h, const uint8_t *mask)
+{
+    Widget_t *widget = NULL;
+
+    if (mask == NULL)
+        return NULL;
+
+    widget = Widget_Alloc(parent, WIDGET_TYPE_ICON, x, y, w, h);
+    if (widget != NULL)
+        widget->Mask = mask;
+    return widget;
+}
+
+Widget_t *Widget_CreateScroll(Widget_t *parent, int16_t x, int16_t y, uint16_t w, uint16_t h, uint16_t content_h)
+{
+    Widget_t *widget = Widget_Alloc(parent, WIDGET_TYPE_SCROLL, x, y, w, h);
+
+    if (widget != NULL)
+        widget->ContentH = content_h;
+    return widget;
+}
+
+void Widget_Delete(Widget_t *widget)
+{
+    Widget_t **link = NULL;
+
+    if (widget == NULL || widget == Widget_Root() || widget->Type == WIDGET_TYPE_FREE)
+        return;
+
+    if (widget->Clip.w > 0)
+        Dirty_Invalidate(&widget->Clip);
+    if (Widget_IsInside(Widget.Focus, widget))
+        Widget.Focus = NULL;
+    // The scroll area is given back on the next frame
+    if (Widget_IsInside(Widget.HwScroll, widget))
+        Widget.HwScroll = NULL;
+
+    link = &widget->Parent->Child;
+    while (*link != widget)
+    {
+        link = &(*link)->Next;
+    }
+    *link = widget->Next;
+
+    Widget_Free(widget);
+}
+
+void Widget_SetText(Widget_t *widget, const char *text)
+{
+    if (widget == NULL || widget->Text == text)
+        return;
+
+    widget->Text = text;
+    Widget_Invalidate(widget);
+}
+
+void Widget_SetColors(Widget_t *widget, uint16_t fg, uint16_t bg)
+{
+    if (widget == NULL)
+        return;
+
+    widget->Fg = fg;
+    widget->Bg = bg;
+    Widget_Invalidate(widget);
+}
+
+void Widget_SetFont(Widget_t *widget, const Font_t *font)
+{
+    if (widget == NULL || font == NULL)
+        return;
+
+    widget->Font = font;
+    if (widget->Type == WIDGET_TYPE_LIST)
+    {
+        widget->Scroll = Widget_ClampScroll(widget, widget->Scroll);
+        widget->ScrollTarget = Widget_ClampScroll(widget, widget->ScrollTarget);
+        Widget_ListReveal(widget);
+    }
+    Widget_Invalidate(widget);
+}
+
+void Widget_SetAlign(Widget_t *widget, Widget_Align_t align)
+{
+    if (widget == NULL || widget->Align == align)
+        return;
+
+    widget->Align = align;
+    Widget_Invalidate(widget);
+}
+
+void Widget_SetVisible(Widget_t *widget, bool visible)
+{
+    if (widget == NULL || widget == Widget_Root() || widget->Visible == visible)
+        return;
+
+    widget->Visible = visible;
+    if (!visible && Widget_IsInside(Widget.Focus, widget))
+        Widget.Focus = NULL;
+    // The old area shows the parent again, the new one the widget
+    Widget_RequestLayout(widget);
+}
+
+void Widget_SetOnKey(Widget_t *widget, Widget_KeyFunction_t OnKey, void *Userdata)
+{
+    if (widget == NULL)
+        return;
+
+    widget->OnKey = OnKey;
+    widget->Userdata = Userdata;
+    widget->Focusable = (OnKey != NULL) || (widget->Type == WIDGET_TYPE_LIST);
+}
+
+void Widget_SetProgress(Widget_t *widget, uint16_t value)
+{
+    uint32_t from = 0;
+    uint32_t to = 0;
+    LCD_Rect_t rect;
+
+    if (widget == NULL || widget->Type != WIDGET_TYPE_PROGRESS)
+        return;
+    if (value > widget->Max)
+        value = widget->Max;
+    if (value == widget->Value)
+        return;
+
+    from = (uint32_t)widget->W * widget->Value / widget->Max;
+    to = (uint32_t)widget->W * value / widget->Max;
+    widget->Value = value;
+    if (from == to)
+        return;
+    if (Widget.Layout)
+    {
+        Widget_Invalidate(widget);
+        return;
+    }
+
+    // Only the span between the old and the new end of the bar changes
+    if (to < from)
+    {
+        uint32_t swap = from;
+        from = to;
+        to = swap;
+    }
+    if (Widget_ClipRect(widget->ScreenX + (int32_t)from, widget->ScreenY, (int32_t)(to - from), widget->H, &widget->Clip, &rect))
+        Dirty_Invalidate(&rect);
+}
+
+void Widget_ListSetItems(Widget_t *widget, const char *const *items, uint16_t count)
+{
+    if (widget == NULL || widget->Type != WIDGET_TYPE_LIST || (items == NULL && count > 0))
+        return;
+
+    widget->Items = items;
+    widget->Count = count;
+    widget->Selected = 0;
+    widget->Scroll = 0;
+    widget->ScrollTarget = 0;
+    Widget_Invalidate(widget);
+}
+
+void Widget_ListSelect(Widget_t *widget, uint16_t index)
+{
+    if (widget == NULL || widget->Type != WIDGET_TYPE_LIST || widget->Count == 0)
+        return;
+    if (index >= widget->Count)
+        index = widget->Count - 1;
+    if (index == widget->Selected)
+        return;
+
+    Widget_InvalidateItem(widget, widget->Selected);
+    widget->Selected = index;
+    Widget_InvalidateItem(widget, index);
+    Widget_ListReveal(widget);
+}
+
+uint16_t Widget_ListSelected(const Widget_t *widget)
+{
+    if (widget == NULL || widget->Type != WIDGET_TYPE_LIST)
+        return 0;
+    return widget->Selected;
+}
+
+void Widget_ScrollTo(Widget_t *widget, int16_t y)
+{
+    if (widget == NULL || (widget->Type != WIDGET_TYPE_SCROLL && widget->Type != WIDGET_TYPE_LIST))
+        return;
+
+    widget->ScrollTarget = Widget_ClampScroll(widget, y);
+}
+
+void Widget_Focus(Widget_t *widget)
+{
+    if (widget == Widget.Focus)
+        return;
+    if (widget != NULL && (!widget->Focusable || !Widget_IsShown(widget)))
+        return;
+
+    if (Widget.Focus != NULL)
+        Widget_Invalidate(Widget.Focus);
+    Widget.Focus = widget;
+    if (widget != NULL)
+    {
+        Widget_Invalidate(widget);
+        Widget_Reveal(widget);
+    }
+}
+
+Widget_t *Widget_GetFocus(void)
+{
+    return Widget.Focus;
+}
+
+void Widget_Invalidate(Widget_t *widget)
+{
+    if (widget == NULL)
+        return;
+
+    if (widget->Clip.w > 0)
+        Dirty_Invalidate(&widget->Clip);
+    // The widget may move in the pending layout pass
+    if (Widget.Layout)
+        widget->Redraw = true;
+}
+
+void Widget_KeyCallback(uint16_t GPIO_Pin)
+{
+    Widget_Key_t key = WIDGET_KEY_RETURN;
+    uint32_t now = HAL_GetTick();
+    uint8_t next = 0;
+
+    switch (GPIO_Pin)
+    {
+    case RETURN_KEY_Pin:
+        key = WIDGET_KEY_RETURN;
+        break;
+    case UP_KEY_Pin:
+        key = WIDGET_KEY_UP;
+        break;
+    case DOWN_KEY_Pin:
+        key = WIDGET_KEY_DOWN;
+        break;
+    case ENTER_KEY_Pin:
+        key = WIDGET_KEY_ENTER;
+        break;
+    default:
+        return;
+    }
+
+    if (now - Widget.KeyTick[key] < WIDGET_KEY_DEBOUNCE)
+        return;
+    Widget.KeyTick[key] = now;
+
+    next = (Widget.KeyHead + 1) & (WIDGET_KEY_QUEUE - 1);
+    // Queue full: drop the press
+    if (next == Widget.KeyTail)
+        return;
+    Widget.Keys[Widget.KeyHead] = key;
+    Widget.KeyHead = next;
+    MicroOS_TriggerEvent(WIDGET_EVENT_KEY);
+}
+
+void Widget_Task(void *data)
+{
+    uint32_t now = HAL_GetTick();
+
+    if (Widget.Drawing)
+    {
+        if (Dirty_Process() == RENDER_BUSY)
+            return;
+        Widget.Drawing = false;
+    }
+
+    if (now - Widget.LastFrame < WIDGET_FRAME_PERIOD)
+        return;
+    Widget.LastFrame = now;
+
+    Widget_Animate();
+    if (Widget.Layout)
+    {
+        Widget.Layout = false;
+        Widget_LayoutNode(Widget_Root(), 0, 0, &Widget_Screen);
+    }
+    Widget_UpdateHwScroll();
+
+    if (Dirty_Count() == 0 || Render_IsActive())
+        return;
+    if (Dirty_Start(Widget_Draw, NULL) == RENDER_OK)
+        Widget.Drawing = (Dirty_Process() == RENDER_BUSY);
+}
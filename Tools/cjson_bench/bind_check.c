@@ -0,0 +1,540 @@
+/**
+ * @file bind_check.c
+ * @brief Host check of the cJSON schema binder, cJSON_BindDecode() and cJSON_BindEncode().
+ *
+ * Build and run on Linux from this directory:
+ *   gcc -O1 -g -fsanitize=address,undefined -I../../Components/cJson bind_check.c \
+ *       ../../Components/cJson/cJSON.c ../../Components/cJson/cJSON_Bind.c -lm -o bind_check
+ *   ./bind_check
+ *
+ * A settings struct with every field type (bools of two sizes, signed and
+ * unsigned integers of 1, 2 and 4 bytes, a range-limited one, float, double,
+ * a string and a nested object) is decoded from hand-written documents:
+ * every field set, missing fields and null keeping the defaults, unknown keys
+ * of every kind skipped, numbers clamped to the member and to the schema range.
+ * Documents the binder must reject are each field given a value of the wrong
+ * type, strings one byte longer than their member (also when an escape makes
+ * them so), content after the top-level object, every truncation of a valid
+ * document, nesting past CJSON_NESTING_LIMIT and a set of malformed objects.
+ * Random structs are encoded, formatted and unformatted, must parse with
+ * cJSON_Parse() and decode back to the same struct, and the encoder must fail
+ * on every buffer shorter than the text without writing past it. The input
+ * buffers are allocated to their exact length, so a read beyond them trips
+ * the sanitizer. Exit status 0 when every check passes.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "cJSON.h"
+#include "cJSON_Bind.h"
+
+typedef struct
+{
+    uint8_t level;
+    int16_t offset;
+    char tag[8];
+} inner_t;
+
+typedef struct
+{
+    cJSON_bool enabled;
+    uint8_t flag;
+    int8_t i8;
+    int16_t i16;
+    int32_t i32;
+    uint8_t u8;
+    uint16_t u16;
+    uint32_t u32;
+    uint8_t percent;
+    float f;
+    double d;
+    char name[16];
+    inner_t inner;
+} settings_t;
+
+static const cJSON_BindField inner_fields[] = {
+    CJSON_BIND_NUMBER(inner_t, level, cJSON_BindUint, 0, 0),
+    CJSON_BIND_NUMBER(inner_t, offset, cJSON_BindInt, -1000, 1000),
+    CJSON_BIND_STRING(inner_t, tag),
+};
+static const cJSON_BindSchema inner_schema = CJSON_BIND_SCHEMA(inner_fields);
+
+static const cJSON_BindField settings_fields[] = {
+    CJSON_BIND_BOOL(settings_t, enabled),
+    CJSON_BIND_BOOL(settings_t, flag),
+    CJSON_BIND_NUMBER(settings_t, i8, cJSON_BindInt, 0, 0),
+    CJSON_BIND_NUMBER(settings_t, i16, cJSON_BindInt, 0, 0),
+    CJSON_BIND_NUMBER(settings_t, i32, cJSON_BindInt, 0, 0),
+    CJSON_BIND_NUMBER(settings_t, u8, cJSON_BindUint, 0, 0),
+    CJSON_BIND_NUMBER(settings_t, u16, cJSON_BindUint, 0, 0),
+    CJSON_BIND_NUMBER(settings_t, u32, cJSON_BindUint, 0, 0),
+    CJSON_BIND_NUMBER(settings_t, percent, cJSON_BindUint, 0, 100),
+    CJSON_BIND_NUMBER(settings_t, f, cJSON_BindFloat, 0, 0),
+    CJSON_BIND_NUMBER(settings_t, d, cJSON_BindDouble, 0, 0),
+    CJSON_BIND_STRING(settings_t, name),
+    CJSON_BIND_OBJECT(settings_t, inner, inner_schema),
+};
+static const cJSON_BindSchema settings_schema = CJSON_BIND_SCHEMA(settings_fields);
+
+static unsigned long checks = 0;
+static unsigned long failures = 0;
+
+static void fail(const char *what, const char *json)
+{
+    if (failures < 10)
+    {
+        printf("  %s: %.120s\n", what, json);
+    }
+    failures++;
+}
+
+/* the padding is zeroed too, so whole structs compare with memcmp() */
+static void set_defaults(settings_t *s)
+{
+    memset(s, 0, sizeof(*s));
+    s->enabled = 1;
+    s->flag = 0;
+    s->i8 = -7;
+    s->i16 = 1234;
+    s->i32 = -100000;
+    s->u8 = 200;
+    s->u16 = 60000;
+    s->u32 = 3000000000u;
+    s->percent = 50;
+    s->f = 0.25f;
+    s->d = -1.5;
+    strcpy(s->name, "default");
+    s->inner.level = 3;
+    s->inner.offset = -20;
+    strcpy(s->inner.tag, "in");
+}
+
+/* decode json[0..length) from an exact-size copy onto the defaults */
+static cJSON_bool decode_bytes(settings_t *s, const char *json, size_t length)
+{
+    char *copy = (char *)malloc(length ? length : 1);
+    cJSON_bool ok;
+
+    if (copy == NULL)
+    {
+        fprintf(stderr, "out of memory\n");
+        exit(1);
+    }
+    memcpy(copy, json, length);
+    set_defaults(s);
+    ok = cJSON_BindDecode(&settings_schema, s, copy, length);
+    free(copy);
+    return ok;
+}
+
+static cJSON_bool decode(settings_t *s, const char *json)
+{
+    return decode_bytes(s, json, strlen(json));
+}
+
+/* json must decode to the defaults with the changes apply() makes */
+static void expect_struct(const char *json, void (*apply)(settings_t *))
+{
+    settings_t got;
+    settings_t want;
+
+    set_defaults(&want);
+    if (apply != NULL)
+    {
+        apply(&want);
+    }
+    checks++;
+    if (!decode(&got, json))
+    {
+        fail("rejected", json);
+    }
+    else if (memcmp(&got, &want, sizeof(got)) != 0)
+    {
+        fail("decoded wrong", json);
+    }
+}
+
+static void expect_reject_bytes(const char *json, size_t length)
+{
+    settings_t got;
+
+    checks++;
+    if (decode_bytes(&got, json, length))
+    {
+        fail("accepted", json);
+    }
+}
+
+static void expect_reject(const char *json)
+{
+    expect_reject_bytes(json, strlen(json));
+}
+
+static void apply_all(settings_t *s)
+{
+    s->enabled = 0;
+    s->flag = 1;
+    s->i8 = -128;
+    s->i16 = -32768;
+    s->i32 = 2147483647;
+    s->u8 = 255;
+    s->u16 = 65535;
+    s->u32 = 4294967295u;
+    s->percent = 100;
+    s->f = -3.5f;
+    s->d = 1e-300;
+    strcpy(s->name, "a\"b\\c/\n\xC3\xA9\xF0\x9F\x98\x80");
+    s->inner.level = 9;
+    s->inner.offset = 999;
+    strcpy(s->inner.tag, "tag");
+}
+
+static void apply_partial(settings_t *s)
+{
+    s->i16 = 5;
+    s->inner.offset = 0;
+}
+
+static void apply_clamped(settings_t *s)
+{
+    s->i8 = 127;
+    s->i16 = -32768;
+    s->i32 = -2147483647 - 1;
+    s->u8 = 0;
+    s->u16 = 65535;
+    s->u32 = 4294967295u;
+    s->percent = 100;
+    s->inner.level = 255;
+    s->inner.offset = -1000;
+}
+
+static void apply_truncated(settings_t *s)
+{
+    s->i8 = 2;
+    s->i16 = -2;
+    s->u8 = 0;
+    s->percent = 0;
+}
+
+static void apply_name15(settings_t *s)
+{
+    strcpy(s->name, "abcdefghijklmno");
+}
+
+static void apply_name_escape(settings_t *s)
+{
+    strcpy(s->name, "abcdefghijklm\xC3\xA9");
+}
+
+static void apply_tag7(settings_t *s)
+{
+    strcpy(s->inner.tag, "1234567");
+}
+
+static void apply_u8_one(settings_t *s)
+{
+    s->u8 = 1;
+}
+
+static const char full_doc[] =
+    "{\"enabled\": false, \"flag\": true, \"i8\": -128, \"i16\": -32768, \"i32\": 2147483647,\n"
+    " \"u8\": 255, \"u16\": 65535, \"u32\": 4294967295, \"percent\": 100, \"f\": -3.5, \"d\": 1e-300,\n"
+    " \"name\": \"a\\\"b\\\\c\\/\\n\\u00e9\\ud83d\\ude00\",\n"
+    " \"inner\": {\"level\": 9, \"offset\": 999, \"tag\": \"tag\"}}";
+
+static void check_decode(void)
+{
+    expect_struct(full_doc, apply_all);
+    expect_struct("\xEF\xBB\xBF" " \t\r\n{}", NULL);
+
+    /* missing keys and null keep the defaults, the nested object included */
+    expect_struct("{}", NULL);
+    expect_struct("{\"i16\": 5, \"inner\": {\"offset\": 0}}", apply_partial);
+    expect_struct("{\"enabled\": null, \"i8\": null, \"f\": null, \"name\": null, \"inner\": null}", NULL);
+    expect_struct("{\"inner\": {\"level\": null, \"tag\": null}}", NULL);
+
+    /* unknown keys are skipped whatever their value, so are keys longer than any name */
+    expect_struct("{\"x\": 1, \"y\": \"s\\u0041\", \"z\": [1, [2, {\"a\": [true, false, null]}], \"q\"],"
+                  " \"w\": {\"u8\": 7, \"v\": {}}, \"t\": true, \"n\": null,"
+                  " \"a_key_that_is_longer_than_the_binder_key_buffer_of_sixty_four_bytes_so_it_is_skipped\": 1,"
+                  " \"U8\": 3, \"inner\": {\"other\": [[]]}}",
+                  NULL);
+
+    /* numbers are clamped to the member, then to the schema range, and truncated toward zero */
+    expect_struct("{\"i8\": 300, \"i16\": -1e9, \"i32\": -1e12, \"u8\": -5, \"u16\": 1e300, \"u32\": 1e12,"
+                  " \"percent\": 150, \"inner\": {\"level\": 256, \"offset\": -5000}}",
+                  apply_clamped);
+    expect_struct("{\"i8\": 2.9, \"i16\": -2.9, \"u8\": 0.5, \"percent\": -0.0}", apply_truncated);
+
+    /* strings that just fit, also when an escape takes two bytes */
+    expect_struct("{\"name\": \"abcdefghijklmno\"}", apply_name15);
+    expect_struct("{\"name\": \"abcdefghijklm\\u00E9\"}", apply_name_escape);
+    expect_struct("{\"inner\": {\"tag\": \"1234567\"}}", apply_tag7);
+
+    /* the last of repeated keys wins */
+    expect_struct("{\"u8\": 9, \"u8\": 1}", apply_u8_one);
+}
+
+static void check_type_mismatch(void)
+{
+    static const char *const bool_keys[] = { "enabled", "flag" };
+    static const char *const number_keys[] = { "i8", "i16", "i32", "u8", "u16", "u32", "percent", "f", "d" };
+    static const char *const not_bool[] = { "1", "0", "\"true\"", "{}", "[]", "tru", "True" };
+    static const char *const not_number[] = {
+        "\"1\"", "true", "false", "{}", "[1]", "-", ".", "e5", "Infinity", "NaN",
+    };
+    static const char *const not_string[] = { "1", "true", "{}", "[\"a\"]", "'a'" };
+    static const char *const not_object[] = { "1", "\"{}\"", "true", "[]", "[{}]" };
+    char json[128];
+    size_t k, v;
+
+    for (k = 0; k < sizeof(bool_keys) / sizeof(bool_keys[0]); k++)
+    {
+        for (v = 0; v < sizeof(not_bool) / sizeof(not_bool[0]); v++)
+        {
+            snprintf(json, sizeof(json), "{\"%s\": %s}", bool_keys[k], not_bool[v]);
+            expect_reject(json);
+        }
+    }
+    for (k = 0; k < sizeof(number_keys) / sizeof(number_keys[0]); k++)
+    {
+        for (v = 0; v < sizeof(not_number) / sizeof(not_number[0]); v++)
+        {
+            snprintf(json, sizeof(json), "{\"%s\": %s}", number_keys[k], not_number[v]);
+            expect_reject(json);
+        }
+    }
+    for (v = 0; v < sizeof(not_string) / sizeof(not_string[0]); v++)
+    {
+        snprintf(json, sizeof(json), "{\"name\": %s}", not_string[v]);
+        expect_reject(json);
+        snprintf(json, sizeof(json), "{\"inner\": {\"tag\": %s}}", not_string[v]);
+        expect_reject(json);
+    }
+    for (v = 0; v < sizeof(not_object) / sizeof(not_object[0]); v++)
+    {
+        snprintf(json, sizeof(json), "{\"inner\": %s}", not_object[v]);
+        expect_reject(json);
+    }
+}
+
+static void check_rejects(void)
+{
+    static const char *const trailing[] = { "x", "{}", ",", "}", "]", "0", "\"\"", "null", " {", "\n\t/" };
+    static const char *const malformed[] = {
+        "",
+        "   ",
+        "[]",
+        "null",
+        "\"{}\"",
+        "{",
+        "}",
+        "{\"u8\"}",
+        "{\"u8\":}",
+        "{\"u8\" 1}",
+        "{,}",
+        "{\"u8\": 1,}",
+        "{\"u8\": 1 \"u16\": 2}",
+        "{u8: 1}",
+        "{\"name\": \"abc}",
+        "{\"name\": \"a\nb\"}",
+        "{\"name\": \"\\x\"}",
+        "{\"name\": \"\\u12\"}",
+        "{\"name\": \"\\udc00\"}",
+        "{\"name\": \"\\ud83d\"}",
+        "{\"name\": \"\\ud83d\\u0041\"}",
+        "{\"x\": [1, 2}",
+        "{\"x\": {\"a\" 1}}",
+        "{\"x\": nul}",
+    };
+    static const char terminated[] = "{\"u8\": 1}\n\0garbage";
+    char json[64];
+    char *deep;
+    size_t depth = CJSON_NESTING_LIMIT + 1;
+    size_t i, length;
+    settings_t got;
+    settings_t want;
+    cJSON_bool ok;
+
+    /* content after the object, with and without whitespace in between */
+    for (i = 0; i < sizeof(trailing) / sizeof(trailing[0]); i++)
+    {
+        snprintf(json, sizeof(json), "{\"u8\": 1}%s", trailing[i]);
+        expect_reject(json);
+        snprintf(json, sizeof(json), "{} \r\n%s", trailing[i]);
+        expect_reject(json);
+    }
+    /* trailing whitespace is fine, and a NUL ends the text before length does */
+    expect_struct("{\"u8\": 1} \t\r\n", apply_u8_one);
+    checks++;
+    set_defaults(&want);
+    apply_u8_one(&want);
+    if (!decode_bytes(&got, terminated, sizeof(terminated)) || (memcmp(&got, &want, sizeof(got)) != 0))
+    {
+        fail("NUL terminated text", terminated);
+    }
+
+    for (i = 0; i < sizeof(malformed) / sizeof(malformed[0]); i++)
+    {
+        expect_reject(malformed[i]);
+    }
+
+    /* one byte more than the member holds */
+    expect_reject("{\"name\": \"abcdefghijklmnop\"}");
+    expect_reject("{\"name\": \"abcdefghijklmn\\u00e9\"}");
+    expect_reject("{\"name\": \"abcdefghijklmno\\\\\"}");
+    expect_reject("{\"inner\": {\"tag\": \"12345678\"}}");
+
+    /* every cut of a valid document */
+    length = strlen(full_doc);
+    for (i = 0; i < length; i++)
+    {
+        expect_reject_bytes(full_doc, i);
+    }
+
+    /* nesting in a skipped value, one level past the limit and at the limit */
+    deep = (char *)malloc(depth * 2 + 16);
+    if (deep == NULL)
+    {
+        fprintf(stderr, "out of memory\n");
+        exit(1);
+    }
+    for (; depth >= CJSON_NESTING_LIMIT; depth--)
+    {
+        memcpy(deep, "{\"x\":", 5);
+        length = 5;
+        for (i = 1; i < depth; i++)
+        {
+            deep[length++] = '[';
+        }
+        for (i = 1; i < depth; i++)
+        {
+            deep[length++] = ']';
+        }
+        deep[length++] = '}';
+        deep[length] = '\0';
+        ok = decode(&got, deep);
+        checks++;
+        if (ok != (depth <= CJSON_NESTING_LIMIT))
+        {
+            fail(ok ? "accepted nesting past the limit" : "rejected nesting at the limit", deep);
+        }
+    }
+    free(deep);
+}
+
+static void random_string(char *s, size_t size)
+{
+    size_t length = (size_t)rand() % size;
+    size_t i;
+
+    for (i = 0; i < length; i++)
+    {
+        s[i] = (char)(1 + rand() % 255);
+    }
+    s[length] = '\0';
+}
+
+static void random_settings(settings_t *s)
+{
+    memset(s, 0, sizeof(*s));
+    s->enabled = rand() & 1;
+    s->flag = (uint8_t)(rand() & 1);
+    s->i8 = (int8_t)rand();
+    s->i16 = (int16_t)rand();
+    s->i32 = (int32_t)(((uint32_t)rand() << 16) ^ (uint32_t)rand());
+    s->u8 = (uint8_t)rand();
+    s->u16 = (uint16_t)rand();
+    s->u32 = ((uint32_t)rand() << 16) ^ (uint32_t)rand();
+    s->percent = (uint8_t)(rand() % 101);
+    s->f = (float)(rand() - RAND_MAX / 2) / (float)(1 + rand() % 1000);
+    s->d = (double)(rand() - RAND_MAX / 2) / (double)(1 + rand()) * 1e-5;
+    random_string(s->name, sizeof(s->name));
+    s->inner.level = (uint8_t)rand();
+    s->inner.offset = (int16_t)(rand() % 2001 - 1000);
+    random_string(s->inner.tag, sizeof(s->inner.tag));
+}
+
+static void check_round_trip(void)
+{
+    char text[1024];
+    int round;
+
+    for (round = 0; round < 2000; round++)
+    {
+        settings_t original;
+        settings_t decoded;
+        cJSON *tree = NULL;
+        cJSON_bool format = round & 1;
+        size_t length, i;
+
+        random_settings(&original);
+        checks++;
+        if (!cJSON_BindEncode(&settings_schema, &original, text, sizeof(text), format))
+        {
+            fail("encode failed", original.name);
+            continue;
+        }
+        length = strlen(text);
+
+        /* the text is plain JSON */
+        checks++;
+        tree = cJSON_Parse(text);
+        if ((tree == NULL) || !cJSON_IsObject(tree) ||
+            (cJSON_GetNumberValue(cJSON_GetObjectItemCaseSensitive(tree, "u32")) != (double)original.u32) ||
+            (strcmp(cJSON_GetStringValue(cJSON_GetObjectItemCaseSensitive(tree, "name")), original.name) != 0))
+        {
+            fail("cJSON_Parse disagrees", text);
+        }
+        cJSON_Delete(tree);
+
+        checks++;
+        memset(&decoded, 0, sizeof(decoded));
+        if (!cJSON_BindDecode(&settings_schema, &decoded, text, length) ||
+            (memcmp(&decoded, &original, sizeof(decoded)) != 0))
+        {
+            fail("round trip differs", text);
+        }
+
+        /* every shorter buffer must fail, the exact one must hold the same text */
+        for (i = 0; i <= length + 1; i++)
+        {
+            char *out = (char *)malloc(i ? i : 1);
+            cJSON_bool ok;
+
+            if (out == NULL)
+            {
+                fprintf(stderr, "out of memory\n");
+                exit(1);
+            }
+            ok = cJSON_BindEncode(&settings_schema, &original, out, i, format);
+            checks++;
+            if (ok != (i > length))
+            {
+                fail(ok ? "encoded into a short buffer" : "failed with room to spare", text);
+            }
+            else if (ok && (strcmp(out, text) != 0))
+            {
+                fail("encoded differently", out);
+            }
+            free(out);
+        }
+    }
+}
+
+int main(void)
+{
+    srand(1);
+
+    check_decode();
+    check_type_mismatch();
+    check_rejects();
+    check_round_trip();
+
+    printf("%lu checks: %s\n", checks, (failures == 0) ? "ok" : "FAILED");
+    return (failures == 0) ? 0 : 1;
+}
@@ -0,0 +1,293 @@
+/**
+ * @file cbor_check.c
+ * @brief Host round-trip check of the cJSON CBOR encoder and decoder.
+ *
+ * Build and run on Linux from this directory:
+ *   gcc -O1 -g -fsanitize=address,undefined -I../../Components/cJson cbor_check.c \
+ *       cjson_corpus.c ../../Components/cJson/cJSON.c ../../Components/cJson/cJSON_CBOR.c \
+ *       -lm -o cbor_check
+ *   ./cbor_check [file.json ...]
+ *
+ * Every JSON document (the cjson_bench corpus, a set of nesting, escape and
+ * number edge cases, and the files given) is parsed, encoded to CBOR, decoded
+ * with the cJSON hooks and into an arena, and printed again; the result must
+ * equal what the text printer makes of the parsed tree, formatted and
+ * unformatted. The streamed encoder must produce the same bytes at several
+ * chunk sizes. Hand-written CBOR covers what JSON cannot produce: tags
+ * (including a long chain), indefinite arrays and maps, half floats and
+ * undefined, and input the decoder must reject.
+ * Exit status 0 when every check passes.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "cJSON.h"
+#include "cJSON_CBOR.h"
+#include "cjson_corpus.h"
+
+/* one-byte tags before the item of the tag chain case */
+#define TAG_CHAIN (2 * 1024 * 1024)
+
+typedef struct
+{
+    unsigned char *data;
+    size_t length;
+    size_t capacity;
+} sink_t;
+
+static unsigned failures = 0;
+static unsigned checks = 0;
+
+static const char *const edge_cases[] = {
+    /* nesting */
+    "[]", "{}", "[[]]", "{\"a\":{}}", "[[[[[[[[[[1]]]]]]]]]]", "{\"a\":[{\"b\":[{\"c\":[]}]}],\"d\":{\"e\":{\"f\":null}}}",
+    /* escapes and text */
+    "\"\"", "[\"\",\"\\u0000x\"]", "\"\\\"\\\\\\/\\b\\f\\n\\r\\t\"", "\"\\u001f\\u007f\\u0080\\u07ff\\u0800\\uffff\"",
+    "\"\\ud83d\\ude00 \\u00e9\\u4e2d\"", "{\"k\\ney\":\"v\",\"\\u00e9\":1,\"\":2}",
+    /* simple values */
+    "true", "false", "null", "[true,false,null]",
+    /* integers at every CBOR head size */
+    "[0,1,23,24,255,256,65535,65536,4294967295,4294967296,9007199254740992]",
+    "[-1,-24,-25,-256,-257,-65536,-65537,-4294967296,-4294967297,-9007199254740992]",
+    "[2147483647,2147483648,-2147483648,-2147483649,18446744073709551615,18446744073709551616]",
+    /* floats: float32 exact, float64 only, extremes */
+    "[0.5,1.5,-2.25,3.4028234663852886e38,1.1754943508222875e-38,1.401298464324817e-45]",
+    "[0.1,-0.1,3.141592653589793,1e300,-1e-300,2.2250738585072014e-308,5e-324,1.7976931348623157e308]",
+    "[-0,-0.0,0.0,1e0,123456789012345678901234567890]",
+};
+
+static cJSON_bool collect_sink(const char *chunk, size_t length, void *userdata)
+{
+    sink_t *sink = (sink_t *)userdata;
+
+    if (sink->length + length > sink->capacity)
+    {
+        return 0;
+    }
+    memcpy(sink->data + sink->length, chunk, length);
+    sink->length += length;
+    return 1;
+}
+
+static void fail(const char *name, const char *what)
+{
+    printf("  %s: %s\n", name, what);
+    failures++;
+}
+
+/* both printers of the decoded tree must give the text printers' output for the original */
+static void compare_prints(const char *name, const char *what, const cJSON *original, const cJSON *decoded)
+{
+    char *want = cJSON_PrintUnformatted(original);
+    char *got = cJSON_PrintUnformatted(decoded);
+    char *want_fmt = cJSON_Print(original);
+    char *got_fmt = cJSON_Print(decoded);
+
+    checks++;
+    if ((want == NULL) || (got == NULL) || (strcmp(want, got) != 0) || (want_fmt == NULL) || (got_fmt == NULL) ||
+        (strcmp(want_fmt, got_fmt) != 0))
+    {
+        fail(name, what);
+        if ((want != NULL) && (got != NULL) && (strlen(want) < 200))
+        {
+            printf("    want %s\n    got  %s\n", want, got);
+        }
+    }
+    cJSON_free(want);
+    cJSON_free(got);
+    cJSON_free(want_fmt);
+    cJSON_free(got_fmt);
+}
+
+static void check_json(const char *name, const char *text, size_t length)
+{
+    static const size_t chunks[] = { 2, 16, 130, 4096 };
+    cJSON *tree = cJSON_ParseWithLengthOpts(text, length, NULL, 0);
+    size_t capacity = length * 2 + 64;
+    unsigned char *cbor = (unsigned char *)malloc(capacity);
+    unsigned char *arena_memory = (unsigned char *)malloc(capacity * 16 + 4096);
+    cJSON_Arena arena;
+    cJSON *decoded = NULL;
+    size_t cbor_length = 0;
+    size_t i;
+
+    if ((tree == NULL) || (cbor == NULL) || (arena_memory == NULL))
+    {
+        fail(name, "parse failed");
+        goto done;
+    }
+
+    cbor_length = cJSON_EncodeCBOR(tree, cbor, capacity);
+    checks++;
+    if (cbor_length == 0)
+    {
+        fail(name, "encode failed");
+        goto done;
+    }
+
+    decoded = cJSON_DecodeCBOR(cbor, cbor_length, NULL);
+    compare_prints(name, "decode with hooks differs", tree, decoded);
+    cJSON_Delete(decoded);
+
+    cJSON_ArenaInit(&arena, arena_memory, capacity * 16 + 4096);
+    decoded = cJSON_DecodeCBOR(cbor, cbor_length, &arena);
+    compare_prints(name, "decode into arena differs", tree, decoded);
+    cJSON_ArenaReset(&arena);
+
+    /* a buffer one byte short must fail, not write past it */
+    checks++;
+    if (cJSON_EncodeCBOR(tree, cbor, cbor_length - 1) != 0)
+    {
+        fail(name, "encode into a short buffer succeeded");
+    }
+
+    for (i = 0; i < sizeof(chunks) / sizeof(chunks[0]); i++)
+    {
+        unsigned char buffer[4096];
+        sink_t sink = { NULL, 0, cbor_length };
+
+        sink.data = (unsigned char *)malloc(cbor_length);
+        checks++;
+        if ((sink.data == NULL) ||
+            !cJSON_EncodeCBORStreamed(tree, buffer, chunks[i], collect_sink, &sink) ||
+            (sink.length != cbor_length))
+        {
+            fail(name, "streamed encode failed");
+        }
+        else
+        {
+            cJSON_EncodeCBOR(tree, cbor, capacity);
+            if (memcmp(sink.data, cbor, cbor_length) != 0)
+            {
+                fail(name, "streamed encode differs");
+            }
+        }
+        free(sink.data);
+    }
+
+done:
+    cJSON_Delete(tree);
+    free(cbor);
+    free(arena_memory);
+}
+
+/* hand-written CBOR: decodes to json, or must be rejected with json == NULL */
+static void check_cbor(const char *name, const unsigned char *data, size_t length, const char *json)
+{
+    cJSON *decoded = cJSON_DecodeCBOR(data, length, NULL);
+
+    if (json == NULL)
+    {
+        checks++;
+        if (decoded != NULL)
+        {
+            fail(name, "accepted");
+        }
+    }
+    else
+    {
+        cJSON *want = cJSON_Parse(json);
+
+        compare_prints(name, "decoded differs", want, decoded);
+        cJSON_Delete(want);
+    }
+    cJSON_Delete(decoded);
+}
+
+#define CHECK_CBOR(name, json, ...)                                                         \
+    do                                                                                      \
+    {                                                                                       \
+        static const unsigned char bytes_[] = { __VA_ARGS__ };                              \
+        check_cbor(name, bytes_, sizeof(bytes_), json);                                     \
+    } while (0)
+
+static void check_handwritten(void)
+{
+    unsigned char *chain = NULL;
+    size_t i;
+
+    CHECK_CBOR("tag", "\"2013-03-21T20:04:00Z\"", 0xC0, 0x74, '2', '0', '1', '3', '-', '0', '3', '-', '2', '1', 'T',
+               '2', '0', ':', '0', '4', ':', '0', '0', 'Z');
+    CHECK_CBOR("tags in an array", "[1,{\"a\":1.5}]", 0x82, 0xD8, 0x20, 0x01, 0xD9, 0x01, 0x00, 0xA1, 0x61, 'a', 0xC6,
+               0xFA, 0x3F, 0xC0, 0x00, 0x00);
+    CHECK_CBOR("indefinite array", "[1,[2,3],[]]", 0x9F, 0x01, 0x9F, 0x02, 0x03, 0xFF, 0x9F, 0xFF, 0xFF);
+    CHECK_CBOR("indefinite map", "{\"a\":1,\"b\":{\"c\":[]}}", 0xBF, 0x61, 'a', 0x01, 0x61, 'b', 0xBF, 0x61, 'c', 0x80,
+               0xFF, 0xFF);
+    CHECK_CBOR("half floats", "[1,-2,0.5,65504,5.960464477539063e-8,0]", 0x86, 0xF9, 0x3C, 0x00, 0xF9, 0xC0, 0x00, 0xF9,
+               0x38, 0x00, 0xF9, 0x7B, 0xFF, 0xF9, 0x00, 0x01, 0xF9, 0x00, 0x00);
+    CHECK_CBOR("undefined", "[null,true,false,null]", 0x84, 0xF7, 0xF5, 0xF4, 0xF6);
+    CHECK_CBOR("uint64", "18446744073709551615", 0x1B, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF);
+
+    CHECK_CBOR("byte string", NULL, 0x42, 0x01, 0x02);
+    CHECK_CBOR("indefinite text", NULL, 0x7F, 0x61, 'a', 0xFF);
+    CHECK_CBOR("indefinite tag", NULL, 0xDF, 0x01);
+    CHECK_CBOR("tag without item", NULL, 0xC6, 0xC6);
+    CHECK_CBOR("lone break", NULL, 0xFF);
+    CHECK_CBOR("unclosed indefinite array", NULL, 0x9F, 0x01);
+    CHECK_CBOR("truncated text", NULL, 0x65, 'a', 'b');
+    CHECK_CBOR("truncated head", NULL, 0x1A, 0x00, 0x01);
+    CHECK_CBOR("integer map key", NULL, 0xA1, 0x01, 0x02);
+    CHECK_CBOR("short array", NULL, 0x83, 0x01, 0x02);
+    CHECK_CBOR("reserved additional info", NULL, 0x1C);
+    CHECK_CBOR("simple value 16", NULL, 0xF0);
+
+    /* a long chain of one-byte tags must not cost stack per tag */
+    chain = (unsigned char *)malloc(TAG_CHAIN + 1);
+    if (chain == NULL)
+    {
+        fail("tag chain", "out of memory");
+        return;
+    }
+    memset(chain, 0xC6, TAG_CHAIN);
+    chain[TAG_CHAIN] = 0x07;
+    check_cbor("tag chain", chain, TAG_CHAIN + 1, "7");
+    check_cbor("tag chain without item", chain, TAG_CHAIN, NULL);
+
+    /* nesting past CJSON_NESTING_LIMIT is rejected */
+    for (i = 0; i < TAG_CHAIN; i++)
+    {
+        chain[i] = 0x81;
+    }
+    check_cbor("array nesting", chain, TAG_CHAIN + 1, NULL);
+    free(chain);
+}
+
+int main(int argc, char **argv)
+{
+    bench_doc_t docs[CORPUS_DOCS];
+    size_t i;
+    int arg;
+
+    corpus_make(docs);
+    for (i = 0; i < CORPUS_DOCS; i++)
+    {
+        check_json(docs[i].name, docs[i].text, docs[i].length);
+        free(docs[i].text);
+    }
+
+    for (i = 0; i < sizeof(edge_cases) / sizeof(edge_cases[0]); i++)
+    {
+        check_json(edge_cases[i], edge_cases[i], strlen(edge_cases[i]));
+    }
+
+    check_handwritten();
+
+    for (arg = 1; arg < argc; arg++)
+    {
+        bench_doc_t doc;
+
+        if (corpus_load_file(argv[arg], &doc) != 0)
+        {
+            fprintf(stderr, "cannot read %s\n", argv[arg]);
+            failures++;
+            continue;
+        }
+        check_json(doc.name, doc.text, doc.length);
+        free(doc.text);
+    }
+
+    printf("%u checks: %s\n", checks, (failures == 0) ? "ok" : "FAILED");
+    return (failures == 0) ? 0 : 1;
+}
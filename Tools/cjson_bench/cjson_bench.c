@@ -0,0 +1,204 @@
+/**
+ * @file cjson_bench.c
+ * @brief Host throughput benchmark for Components/cJson.
+ *
+ * Build and run on Linux from this directory:
+ *   gcc -O2 -I../../Components/cJson cjson_bench.c cjson_corpus.c \
+ *       ../../Components/cJson/cJSON.c ../../Components/cJson/cJSON_CBOR.c -lm -o cjson_bench
+ *   ./cjson_bench [file.json ...]
+ *
+ * Without arguments a built-in corpus is generated (numbers, strings with
+ * escapes, deep nesting, a playlist-like document). Every JSON file given on
+ * the command line, such as the device config and playlist files, is added to
+ * the corpus. For every document the tool reports MB/s of the source text for
+ * parse, print, minify and CBOR, plus the number of heap allocations each
+ * operation makes (counted through cJSON_InitHooks).
+ */
+
+#define _POSIX_C_SOURCE 199309L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "cJSON.h"
+#include "cJSON_CBOR.h"
+#include "cjson_corpus.h"
+
+/* minimum measuring time per operation */
+#define BENCH_MIN_SECONDS 0.25
+
+static unsigned long alloc_count = 0;
+
+static void *counting_malloc(size_t size)
+{
+    alloc_count++;
+    return malloc(size);
+}
+
+static void counting_free(void *pointer)
+{
+    free(pointer);
+}
+
+static double now_seconds(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static cJSON_bool discard_sink(const char *chunk, size_t length, void *userdata)
+{
+    (void)chunk;
+    *(size_t *)userdata += length;
+    return 1;
+}
+
+typedef enum
+{
+    OP_PARSE = 0,
+    OP_PRINT_UNFORMATTED,
+    OP_PRINT_FORMATTED,
+    OP_PRINT_STREAMED,
+    OP_MINIFY,
+    OP_CBOR_ENCODE,
+    OP_CBOR_DECODE,
+    OP_COUNT
+} bench_op_t;
+
+static const char *const op_names[OP_COUNT] = {
+    "parse", "print", "print fmt", "print stream", "minify", "cbor enc", "cbor dec"
+};
+
+static int run_op(bench_op_t op, const bench_doc_t *doc, const cJSON *tree, char *scratch,
+                  unsigned char *cbor, size_t cbor_length)
+{
+    switch (op)
+    {
+        case OP_PARSE:
+        {
+            cJSON *item = cJSON_ParseWithLengthOpts(doc->text, doc->length, NULL, 0);
+            cJSON_Delete(item);
+            return item != NULL;
+        }
+        case OP_PRINT_UNFORMATTED:
+        case OP_PRINT_FORMATTED:
+        {
+            char *printed = (op == OP_PRINT_FORMATTED) ? cJSON_Print(tree) : cJSON_PrintUnformatted(tree);
+            cJSON_free(printed);
+            return printed != NULL;
+        }
+        case OP_PRINT_STREAMED:
+        {
+            char buffer[512];
+            size_t total = 0;
+            return cJSON_PrintStreamed(tree, buffer, sizeof(buffer), 0, discard_sink, &total);
+        }
+        case OP_MINIFY:
+            memcpy(scratch, doc->text, doc->length + 1);
+            cJSON_Minify(scratch);
+            return 1;
+        case OP_CBOR_ENCODE:
+            return cJSON_EncodeCBOR(tree, cbor, doc->length * 2 + 64) != 0;
+        case OP_CBOR_DECODE:
+        {
+            cJSON *item = cJSON_DecodeCBOR(cbor, cbor_length, NULL);
+            cJSON_Delete(item);
+            return item != NULL;
+        }
+        default:
+            return 0;
+    }
+}
+
+static void bench_doc(const bench_doc_t *doc)
+{
+    cJSON *tree = cJSON_ParseWithLengthOpts(doc->text, doc->length, NULL, 0);
+    char *scratch = (char *)malloc(doc->length + 1);
+    unsigned char *cbor = (unsigned char *)malloc(doc->length * 2 + 64);
+    size_t cbor_length = 0;
+    int op;
+
+    if ((tree == NULL) || (scratch == NULL) || (cbor == NULL))
+    {
+        printf("%-12s  %9zu B  parse failed\n", doc->name, doc->length);
+        cJSON_Delete(tree);
+        free(scratch);
+        free(cbor);
+        return;
+    }
+    cbor_length = cJSON_EncodeCBOR(tree, cbor, doc->length * 2 + 64);
+
+    printf("%-12s  %9zu B  cbor %zu B (%.0f%%)\n", doc->name, doc->length, cbor_length,
+           doc->length ? (100.0 * (double)cbor_length / (double)doc->length) : 0.0);
+
+    for (op = 0; op < OP_COUNT; op++)
+    {
+        unsigned long iterations = 0;
+        unsigned long allocations = 0;
+        double start = 0;
+        double elapsed = 0;
+
+        if (((op == OP_CBOR_ENCODE) || (op == OP_CBOR_DECODE)) && (cbor_length == 0))
+        {
+            continue;
+        }
+
+        /* one counted run for allocations per document */
+        alloc_count = 0;
+        if (!run_op((bench_op_t)op, doc, tree, scratch, cbor, cbor_length))
+        {
+            printf("    %-13s failed\n", op_names[op]);
+            continue;
+        }
+        allocations = alloc_count;
+
+        start = now_seconds();
+        do
+        {
+            run_op((bench_op_t)op, doc, tree, scratch, cbor, cbor_length);
+            iterations++;
+            elapsed = now_seconds() - start;
+        } while (elapsed < BENCH_MIN_SECONDS);
+
+        printf("    %-13s %9.2f MB/s  %9.1f us/doc  %8lu allocs/doc\n", op_names[op],
+               ((double)doc->length * (double)iterations) / (elapsed * 1e6),
+               (elapsed * 1e6) / (double)iterations, allocations);
+    }
+
+    cJSON_Delete(tree);
+    free(scratch);
+    free(cbor);
+}
+
+int main(int argc, char **argv)
+{
+    cJSON_Hooks hooks = { counting_malloc, counting_free };
+    bench_doc_t docs[CORPUS_DOCS];
+    int i;
+
+    cJSON_InitHooks(&hooks);
+
+    corpus_make(docs);
+    for (i = 0; i < CORPUS_DOCS; i++)
+    {
+        bench_doc(&docs[i]);
+        free(docs[i].text);
+    }
+
+    for (i = 1; i < argc; i++)
+    {
+        bench_doc_t doc;
+        if (corpus_load_file(argv[i], &doc) != 0)
+        {
+            fprintf(stderr, "cannot read %s\n", argv[i]);
+            continue;
+        }
+        bench_doc(&doc);
+        free(doc.text);
+    }
+
+    return 0;
+}
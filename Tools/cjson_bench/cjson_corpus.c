@@ -0,0 +1,150 @@
+/**
+ * @file cjson_corpus.c
+ * @brief Generated JSON corpus shared by cjson_bench and cbor_check.
+ */
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "cjson_corpus.h"
+
+/* growable text used by the corpus generators */
+typedef struct
+{
+    char *data;
+    size_t length;
+    size_t capacity;
+} text_t;
+
+static void text_append(text_t *text, const char *format, ...)
+{
+    va_list args;
+    int needed = 0;
+
+    va_start(args, format);
+    needed = vsnprintf(NULL, 0, format, args);
+    va_end(args);
+
+    if (text->length + (size_t)needed + 1 > text->capacity)
+    {
+        text->capacity = (text->length + (size_t)needed + 1) * 2;
+        text->data = (char *)realloc(text->data, text->capacity);
+        if (text->data == NULL)
+        {
+            fprintf(stderr, "out of memory\n");
+            exit(1);
+        }
+    }
+
+    va_start(args, format);
+    vsnprintf(text->data + text->length, (size_t)needed + 1, format, args);
+    va_end(args);
+    text->length += (size_t)needed;
+}
+
+static bench_doc_t make_numbers(void)
+{
+    text_t text = {0};
+    int i;
+
+    text_append(&text, "[");
+    for (i = 0; i < 20000; i++)
+    {
+        switch (i % 4)
+        {
+            case 0: text_append(&text, "%s%d", i ? "," : "", i * 37 - 5000); break;
+            case 1: text_append(&text, ",%.6f", i / 7.0); break;
+            case 2: text_append(&text, ",%.3e", i * 1234.5678); break;
+            default: text_append(&text, ",-0.%d", i); break;
+        }
+    }
+    text_append(&text, "]");
+
+    return (bench_doc_t){ "numbers", text.data, text.length };
+}
+
+static bench_doc_t make_strings(void)
+{
+    text_t text = {0};
+    int i;
+
+    text_append(&text, "[");
+    for (i = 0; i < 5000; i++)
+    {
+        text_append(&text, "%s\"line %d\\nwith \\\"quotes\\\", tab\\t, slash \\/ and \\u00e9\\u4e2d\\ud83d\\ude00\"", i ? "," : "", i);
+    }
+    text_append(&text, "]");
+
+    return (bench_doc_t){ "strings", text.data, text.length };
+}
+
+static bench_doc_t make_nesting(void)
+{
+    text_t text = {0};
+    int i;
+
+    for (i = 0; i < 500; i++)
+    {
+        text_append(&text, (i % 2) ? "[" : "{\"k%d\":", i);
+    }
+    text_append(&text, "null");
+    for (i = 499; i >= 0; i--)
+    {
+        text_append(&text, (i % 2) ? "]" : "}");
+    }
+
+    return (bench_doc_t){ "nesting", text.data, text.length };
+}
+
+static bench_doc_t make_playlist(void)
+{
+    text_t text = {0};
+    int i;
+
+    text_append(&text, "{\"settings\":{\"display\":{\"brightness\":80,\"timeout\":30},\"audio\":{\"volume\":12,\"eq\":[0,2,4,2,0]}},\"playlist\":[");
+    for (i = 0; i < 1000; i++)
+    {
+        text_append(&text, "%s{\"title\":\"Episode %d\",\"file\":\"/video/show_%04d.ntv\",\"duration\":%d,\"position\":0,\"watched\":%s,\"tags\":[\"cartoon\",\"s%02d\"]}",
+                    i ? "," : "", i, i, 600 + i, (i % 3) ? "false" : "true", i / 20);
+    }
+    text_append(&text, "]}");
+
+    return (bench_doc_t){ "playlist", text.data, text.length };
+}
+
+int corpus_load_file(const char *path, bench_doc_t *doc)
+{
+    FILE *file = fopen(path, "rb");
+    long size = 0;
+
+    if (file == NULL)
+    {
+        return -1;
+    }
+    fseek(file, 0, SEEK_END);
+    size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+
+    doc->name = path;
+    doc->text = (char *)malloc((size_t)size + 1);
+    doc->length = (size_t)size;
+    if ((doc->text == NULL) || (fread(doc->text, 1, (size_t)size, file) != (size_t)size))
+    {
+        fclose(file);
+        free(doc->text);
+        return -1;
+    }
+    doc->text[size] = '\0';
+    fclose(file);
+
+    return 0;
+}
+
+void corpus_make(bench_doc_t docs[CORPUS_DOCS])
+{
+    docs[0] = make_numbers();
+    docs[1] = make_strings();
+    docs[2] = make_nesting();
+    docs[3] = make_playlist();
+}
@@ -0,0 +1,27 @@
+/**
+ * @file cjson_corpus.h
+ * @brief Generated JSON corpus shared by the cJSON host tools.
+ */
+
+#ifndef CJSON_CORPUS_H
+#define CJSON_CORPUS_H
+
+#include <stddef.h>
+
+typedef struct
+{
+    const char *name;
+    char *text;
+    size_t length;
+} bench_doc_t;
+
+#define CORPUS_DOCS 4
+
+/* the generated documents: numbers, strings with escapes, deep nesting, a
+ * playlist-like document; free each text when done */
+void corpus_make(bench_doc_t docs[CORPUS_DOCS]);
+
+/* read a whole file as a document, 0 on success */
+int corpus_load_file(const char *path, bench_doc_t *doc);
+
+#endif
@@ -0,0 +1,213 @@
+/**
+ * @file cjson_fuzz.c
+ * @brief libFuzzer target for the cJSON parser, minifier and printers.
+ *
+ * Build and run on Linux from this directory:
+ *   clang -O1 -g -fsanitize=fuzzer,address,undefined -I../../Components/cJson cjson_fuzz.c \
+ *       ../../Components/cJson/cJSON.c -lm -o cjson_fuzz
+ *   ./cjson_fuzz -max_len=4096 corpus_dir/
+ *
+ * Without clang the same target replays inputs under gcc, for example the
+ * crash files libFuzzer leaves behind:
+ *   gcc -O1 -g -fsanitize=address,undefined -DCJSON_FUZZ_STANDALONE -I../../Components/cJson \
+ *       cjson_fuzz.c ../../Components/cJson/cJSON.c -lm -o cjson_fuzz
+ *   ./cjson_fuzz crash-... [file ...]
+ *
+ * The first input byte picks the options (NUL termination required,
+ * formatted output, the sizes of the print buffers), the rest is the JSON
+ * text, copied to a buffer of exactly its length so that any read past it
+ * is caught. A parsed tree goes through every printer: the buffered,
+ * preallocated and streamed output must equal cJSON_Print() /
+ * cJSON_PrintUnformatted(), and the printed text must parse again and print
+ * the same. cJSON_Minify() runs on a NUL-terminated copy and must not grow it.
+ * Any mismatch aborts, which libFuzzer reports like a crash.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "cJSON.h"
+
+#define FUZZ_REQUIRE_NULL 0x01
+#define FUZZ_FORMAT 0x02
+
+typedef struct
+{
+    const char *expected;
+    size_t offset;
+    int mismatch;
+} fuzz_sink_t;
+
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size);
+
+static void fuzz_check(int condition, const char *what)
+{
+    if (!condition)
+    {
+        fprintf(stderr, "cjson_fuzz: %s\n", what);
+        abort();
+    }
+}
+
+/* compares the streamed chunks with the text they must add up to */
+static cJSON_bool compare_sink(const char *chunk, size_t length, void *userdata)
+{
+    fuzz_sink_t *sink = (fuzz_sink_t *)userdata;
+
+    if ((strlen(sink->expected) - sink->offset < length) || (memcmp(sink->expected + sink->offset, chunk, length) != 0))
+    {
+        sink->mismatch = 1;
+        return 0;
+    }
+    sink->offset += length;
+    return 1;
+}
+
+static void fuzz_printers(cJSON *tree, unsigned char options)
+{
+    cJSON_bool format = (options & FUZZ_FORMAT) != 0;
+    char *printed = format ? cJSON_Print(tree) : cJSON_PrintUnformatted(tree);
+    char *buffered = NULL;
+    char *prealloc = NULL;
+    size_t stream_length = 4 + (size_t)(options >> 2) * 8;
+    char *stream_buffer = NULL;
+    fuzz_sink_t sink;
+    cJSON *again = NULL;
+
+    if (printed == NULL)
+    {
+        /* only allocation can fail, and the fuzzer does not limit it */
+        return;
+    }
+
+    buffered = cJSON_PrintBuffered(tree, (int)(options >> 2), format);
+    fuzz_check((buffered != NULL) && (strcmp(buffered, printed) == 0), "cJSON_PrintBuffered differs");
+    cJSON_free(buffered);
+
+    /* exactly the printed length plus the NUL, then a few bytes short of it */
+    prealloc = (char *)malloc(strlen(printed) + 1);
+    if (prealloc != NULL)
+    {
+        if (cJSON_PrintPreallocated(tree, prealloc, (int)strlen(printed) + 1, format))
+        {
+            fuzz_check(strcmp(prealloc, printed) == 0, "cJSON_PrintPreallocated differs");
+        }
+        if (strlen(printed) > 4)
+        {
+            fuzz_check(!cJSON_PrintPreallocated(tree, prealloc, (int)strlen(printed) - 4, format),
+                       "cJSON_PrintPreallocated fit a short buffer");
+        }
+        free(prealloc);
+    }
+
+    /* a token longer than half the buffer makes streaming fail, never truncate */
+    stream_buffer = (char *)malloc(stream_length);
+    if (stream_buffer != NULL)
+    {
+        sink.expected = printed;
+        sink.offset = 0;
+        sink.mismatch = 0;
+        if (cJSON_PrintStreamed(tree, stream_buffer, stream_length, format, compare_sink, &sink))
+        {
+            fuzz_check(sink.offset == strlen(printed), "cJSON_PrintStreamed stopped early");
+        }
+        fuzz_check(!sink.mismatch, "cJSON_PrintStreamed differs");
+        free(stream_buffer);
+    }
+
+    again = cJSON_Parse(printed);
+    fuzz_check(again != NULL, "printed text does not parse");
+    if (again != NULL)
+    {
+        char *reprinted = format ? cJSON_Print(again) : cJSON_PrintUnformatted(again);
+
+        fuzz_check((reprinted == NULL) || (strcmp(reprinted, printed) == 0), "reparsed tree prints differently");
+        cJSON_free(reprinted);
+        cJSON_Delete(again);
+    }
+
+    cJSON_free(printed);
+}
+
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size)
+{
+    unsigned char options = 0;
+    char *text = NULL;
+    size_t length = 0;
+    cJSON *tree = NULL;
+
+    if (size < 1)
+    {
+        return 0;
+    }
+    options = data[0];
+    length = size - 1;
+
+    /* no terminator: the parser gets exactly length bytes */
+    text = (char *)malloc(length ? length : 1);
+    if (text == NULL)
+    {
+        return 0;
+    }
+    memcpy(text, data + 1, length);
+    tree = cJSON_ParseWithLengthOpts(text, length, NULL, (options & FUZZ_REQUIRE_NULL) != 0);
+    if (tree != NULL)
+    {
+        fuzz_printers(tree, options);
+        cJSON_Delete(tree);
+    }
+    free(text);
+
+    text = (char *)malloc(length + 1);
+    if (text != NULL)
+    {
+        size_t before = 0;
+
+        memcpy(text, data + 1, length);
+        text[length] = '\0';
+        before = strlen(text);
+        cJSON_Minify(text);
+        fuzz_check(strlen(text) <= before, "cJSON_Minify grew the text");
+        free(text);
+    }
+
+    return 0;
+}
+
+#ifdef CJSON_FUZZ_STANDALONE
+int main(int argc, char **argv)
+{
+    int i;
+
+    for (i = 1; i < argc; i++)
+    {
+        FILE *file = fopen(argv[i], "rb");
+        uint8_t *data = NULL;
+        long size = 0;
+
+        if (file == NULL)
+        {
+            fprintf(stderr, "cannot read %s\n", argv[i]);
+            return 1;
+        }
+        fseek(file, 0, SEEK_END);
+        size = ftell(file);
+        fseek(file, 0, SEEK_SET);
+        data = (uint8_t *)malloc((size_t)size + 1);
+        if ((data == NULL) || (fread(data, 1, (size_t)size, file) != (size_t)size))
+        {
+            fprintf(stderr, "cannot read %s\n", argv[i]);
+            fclose(file);
+            free(data);
+            return 1;
+        }
+        fclose(file);
+        LLVMFuzzerTestOneInput(data, (size_t)size);
+        free(data);
+    }
+    printf("%d inputs ok\n", argc - 1);
+    return 0;
+}
+#endif
@@ -0,0 +1,413 @@
+/**
+ * @file lazy_check.c
+ * @brief Host check of cJSON_LazyFind()/cJSON_LazyGet() against a full cJSON_Parse() of the same text.
+ *
+ * Build and run on Linux from this directory:
+ *   gcc -O1 -g -fsanitize=address,undefined -I../../Components/cJson lazy_check.c \
+ *       cjson_corpus.c ../../Components/cJson/cJSON.c ../../Components/cJson/cJSON_Lazy.c \
+ *       -lm -o lazy_check
+ *   ./lazy_check [file.json ...]
+ *
+ * Every document (the cjson_bench corpus, random trees printed formatted and
+ * unformatted, and the files given) is parsed in full, and paths into the tree
+ * are looked up lazily: every member of small containers, a sample of large
+ * ones, some with a fresh document and the rest with one whose cache has seen
+ * the earlier lookups. The value cJSON_LazyGet() returns and the text
+ * cJSON_LazyFind() points at must both equal the item the path names in the
+ * parsed tree. Empty keys come up, so "a..b" and "a." (which names a itself)
+ * are both looked up after each other. Paths that name nothing must not be found: missing keys, the
+ * index one past the end, non-numeric and negative indexes, keys on scalars,
+ * and indexes too large for size_t, also those that would wrap around to an
+ * element. Long runs of leading zeros still name their element. Keys that
+ * cJSON would write escaped or that hold a '.' cannot be named and are left
+ * out. The text is allocated to its exact length, so a read beyond it trips
+ * the sanitizer. Exit status 0 when every check passes.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "cJSON.h"
+#include "cJSON_Lazy.h"
+#include "cjson_corpus.h"
+
+/* containers with more members than this are sampled */
+#define SAMPLE_ALL 48
+#define SAMPLE_COUNT 24
+#define PATH_MAX_LENGTH 8192
+
+typedef struct
+{
+    const char *name;
+    const char *text;
+    size_t length;
+    cJSON_LazyDoc shared;
+} lazy_input_t;
+
+static unsigned long checks = 0;
+static unsigned failures = 0;
+
+static void fail(const lazy_input_t *input, const char *path, const char *what)
+{
+    if (failures < 10)
+    {
+        printf("  %s \"%.100s\": %s\n", input->name, path, what);
+    }
+    failures++;
+}
+
+/* the item path names in the parsed tree, with the segment rules of cJSON_Lazy */
+static const cJSON *reference_find(const cJSON *root, const char *path)
+{
+    const cJSON *item = root;
+
+    while ((item != NULL) && (*path != '\0'))
+    {
+        size_t length = strcspn(path, ".");
+        const cJSON *child = NULL;
+
+        if (cJSON_IsObject(item))
+        {
+            for (child = item->child; child != NULL; child = child->next)
+            {
+                if ((strlen(child->string) == length) && (memcmp(child->string, path, length) == 0))
+                {
+                    break;
+                }
+            }
+        }
+        else if (cJSON_IsArray(item) && (length > 0) && (strspn(path, "0123456789") >= length))
+        {
+            size_t index = 0;
+            size_t i;
+
+            for (i = 0; (i < length) && (index <= (SIZE_MAX - (size_t)(path[i] - '0')) / 10); i++)
+            {
+                index = index * 10 + (size_t)(path[i] - '0');
+            }
+            child = item->child;
+            if (i < length)
+            {
+                /* more digits than any array has members */
+                child = NULL;
+            }
+            for (; (child != NULL) && (index > 0); index--)
+            {
+                child = child->next;
+            }
+        }
+        item = child;
+        path += length;
+        if (*path == '.')
+        {
+            path++;
+        }
+    }
+
+    return item;
+}
+
+/* cJSON_Compare() checks objects both ways at every level, which is exponential on deep
+ * nesting; both sides were parsed from the same text, so their printed forms must match */
+static int same_value(const cJSON *a, const cJSON *b)
+{
+    char *text_a = cJSON_PrintUnformatted(a);
+    char *text_b = cJSON_PrintUnformatted(b);
+    int same = (text_a != NULL) && (text_b != NULL) && (strcmp(text_a, text_b) == 0);
+
+    cJSON_free(text_a);
+    cJSON_free(text_b);
+    return same;
+}
+
+static void check_path(lazy_input_t *input, const cJSON *root, const char *path, int fresh)
+{
+    const cJSON *want = reference_find(root, path);
+    cJSON_LazyDoc own;
+    cJSON_LazyDoc *doc = &input->shared;
+    const char *value = NULL;
+    size_t value_length = 0;
+    cJSON_bool found;
+    cJSON *got = NULL;
+
+    if (fresh)
+    {
+        cJSON_LazyInit(&own, input->text, input->length);
+        doc = &own;
+    }
+
+    checks++;
+    got = cJSON_LazyGet(doc, path);
+    if ((got == NULL) != (want == NULL))
+    {
+        fail(input, path, (want == NULL) ? "cJSON_LazyGet found a missing value" : "cJSON_LazyGet missed the value");
+    }
+    else if ((got != NULL) && !same_value(got, want))
+    {
+        fail(input, path, "cJSON_LazyGet returned a different value");
+    }
+    cJSON_Delete(got);
+
+    checks++;
+    found = cJSON_LazyFind(doc, path, &value, &value_length);
+    if (found != (want != NULL))
+    {
+        fail(input, path, (want == NULL) ? "cJSON_LazyFind found a missing value" : "cJSON_LazyFind missed the value");
+    }
+    else if (found)
+    {
+        /* exactly one value: parsing it must consume all of value_length */
+        const char *end = NULL;
+
+        got = cJSON_ParseWithLengthOpts(value, value_length, &end, 0);
+        if ((got == NULL) || (end != value + value_length) || !same_value(got, want))
+        {
+            fail(input, path, "cJSON_LazyFind pointed at different text");
+        }
+        cJSON_Delete(got);
+    }
+}
+
+/* keys cJSON_Lazy can name: written without escapes and without a '.' */
+static int key_is_plain(const char *key)
+{
+    for (; *key != '\0'; key++)
+    {
+        if (((unsigned char)*key < 32) || (*key == '\"') || (*key == '\\') || (*key == '.'))
+        {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+/* paths that must not be found below the container at path */
+static void check_missing(lazy_input_t *input, const cJSON *root, char *path, size_t length, const cJSON *item)
+{
+    static const char *const object_segments[] = { "missing", "", "0", "settings.nothing" };
+    static const char *const array_segments[] = {
+        "-1", "1a", "a", "", "+0", "0x1", " 0",
+        /* 2^64 + 1 and 2^32 + 1 wrap around to element 1 */
+        "18446744073709551617", "4294967297", "36893488355328161793", "99999999999999999999999999",
+        /* zeros do not overflow */
+        "00000000000000000000000000000000", "000000000000000000000000000000001",
+    };
+    const char *const *segments = cJSON_IsObject(item) ? object_segments : array_segments;
+    size_t count = cJSON_IsObject(item) ? sizeof(object_segments) / sizeof(object_segments[0])
+                                        : sizeof(array_segments) / sizeof(array_segments[0]);
+    char *sep = path + length;
+    size_t i;
+
+    if (length + 64 >= PATH_MAX_LENGTH)
+    {
+        return;
+    }
+    if (length > 0)
+    {
+        *sep++ = '.';
+    }
+
+    for (i = 0; i < count; i++)
+    {
+        strcpy(sep, segments[i]);
+        check_path(input, root, path, i & 1);
+    }
+    if (cJSON_IsArray(item))
+    {
+        snprintf(sep, 16, "%d", cJSON_GetArraySize(item));
+        check_path(input, root, path, 0);
+        snprintf(sep, 16, "%d", cJSON_GetArraySize(item) + 1);
+        check_path(input, root, path, 1);
+    }
+    path[length] = '\0';
+}
+
+static void walk(lazy_input_t *input, const cJSON *root, char *path, size_t length, const cJSON *item)
+{
+    const cJSON *child = NULL;
+    int count = 0;
+    int index = 0;
+
+    check_path(input, root, path, (rand() % 8) == 0);
+    if (!cJSON_IsObject(item) && !cJSON_IsArray(item))
+    {
+        /* scalars have no members */
+        if (length + 3 < PATH_MAX_LENGTH)
+        {
+            strcpy(path + length, (length > 0) ? ".0" : "0");
+            check_path(input, root, path, 0);
+            path[length] = '\0';
+        }
+        return;
+    }
+
+    check_missing(input, root, path, length, item);
+    count = cJSON_GetArraySize(item);
+    for (child = item->child; child != NULL; child = child->next, index++)
+    {
+        char *segment = path + length + ((length > 0) ? 1 : 0);
+        size_t segment_length;
+
+        /* the first and the last always, a sample in between */
+        if ((count > SAMPLE_ALL) && (index != 0) && (index != count - 1) && ((rand() % count) >= SAMPLE_COUNT))
+        {
+            continue;
+        }
+        if (cJSON_IsObject(item))
+        {
+            if (!key_is_plain(child->string))
+            {
+                continue;
+            }
+            segment_length = strlen(child->string);
+        }
+        else
+        {
+            segment_length = (size_t)snprintf(NULL, 0, "%d", index);
+        }
+        if ((size_t)(segment - path) + segment_length + 1 >= PATH_MAX_LENGTH)
+        {
+            continue;
+        }
+
+        if (length > 0)
+        {
+            path[length] = '.';
+        }
+        if (cJSON_IsObject(item))
+        {
+            memcpy(segment, child->string, segment_length + 1);
+        }
+        else
+        {
+            sprintf(segment, "%d", index);
+        }
+        walk(input, root, path, (size_t)(segment - path) + segment_length, child);
+        path[length] = '\0';
+    }
+}
+
+static void check_document(const char *name, const char *text, size_t length)
+{
+    static char path[PATH_MAX_LENGTH];
+    lazy_input_t input;
+    char *copy = (char *)malloc(length ? length : 1);
+    cJSON *root = NULL;
+
+    if (copy == NULL)
+    {
+        fprintf(stderr, "out of memory\n");
+        exit(1);
+    }
+    memcpy(copy, text, length);
+
+    root = cJSON_ParseWithLength(copy, length);
+    if (root == NULL)
+    {
+        printf("  %s: not valid JSON, skipped\n", name);
+        free(copy);
+        return;
+    }
+
+    input.name = name;
+    input.text = copy;
+    input.length = length;
+    cJSON_LazyInit(&input.shared, copy, length);
+    path[0] = '\0';
+    walk(&input, root, path, 0, root);
+
+    cJSON_Delete(root);
+    free(copy);
+}
+
+static cJSON *random_value(int depth)
+{
+    static const char *const keys[] = { "a", "b", "0", "1", "ab", "k_2", "with space", "\xC3\xA9t\xC3\xA9",
+                                        "a.b", "q\"x", "tab\t", "" };
+    static const char *const strings[] = { "", "x", "a\"b", "back\\slash", "line\nbreak", "\xE4\xB8\xAD", "[{,}]" };
+    int kind = (depth > 4) ? (rand() % 5) : (rand() % 8);
+    cJSON *item = NULL;
+    int count, i;
+
+    switch (kind)
+    {
+        case 0: return cJSON_CreateNull();
+        case 1: return cJSON_CreateBool(rand() & 1);
+        case 2: return cJSON_CreateNumber((double)(rand() % 2001 - 1000));
+        case 3: return cJSON_CreateNumber((double)rand() / (double)(1 + rand()) * ((rand() & 1) ? 1e-12 : 1e12));
+        case 4: return cJSON_CreateString(strings[rand() % (int)(sizeof(strings) / sizeof(strings[0]))]);
+        case 5:
+        case 6:
+            item = cJSON_CreateObject();
+            count = rand() % 7;
+            for (i = 0; i < count; i++)
+            {
+                /* duplicate keys come up, both sides take the first */
+                cJSON_AddItemToObject(item, keys[rand() % (int)(sizeof(keys) / sizeof(keys[0]))],
+                                      random_value(depth + 1));
+            }
+            return item;
+        default:
+            item = cJSON_CreateArray();
+            /* a long array at the top, so the sampling and far indexes come up */
+            count = ((depth == 0) && (rand() & 1)) ? (100 + rand() % 100) : (rand() % 7);
+            for (i = 0; i < count; i++)
+            {
+                cJSON_AddItemToArray(item, random_value(depth + 1));
+            }
+            return item;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    bench_doc_t docs[CORPUS_DOCS];
+    char name[32];
+    int i;
+
+    srand(1);
+    corpus_make(docs);
+    for (i = 0; i < CORPUS_DOCS; i++)
+    {
+        check_document(docs[i].name, docs[i].text, docs[i].length);
+        free(docs[i].text);
+    }
+
+    for (i = 0; i < 1000; i++)
+    {
+        cJSON *tree = random_value(0);
+        char *text = (i & 1) ? cJSON_Print(tree) : cJSON_PrintUnformatted(tree);
+
+        snprintf(name, sizeof(name), "random %d", i);
+        if (text == NULL)
+        {
+            printf("  %s: cJSON_Print failed\n", name);
+            failures++;
+        }
+        else
+        {
+            check_document(name, text, strlen(text));
+        }
+        cJSON_free(text);
+        cJSON_Delete(tree);
+    }
+
+    for (i = 1; i < argc; i++)
+    {
+        bench_doc_t doc;
+
+        if (corpus_load_file(argv[i], &doc) != 0)
+        {
+            printf("  %s: cannot read\n", argv[i]);
+            failures++;
+            continue;
+        }
+        check_document(doc.name, doc.text, doc.length);
+        free(doc.text);
+    }
+
+    printf("%lu checks: %s\n", checks, (failures == 0) ? "ok" : "FAILED");
+    return (failures == 0) ? 0 : 1;
+}
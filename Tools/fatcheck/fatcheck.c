@@ -0,0 +1,268 @@
+/**
+ * @file fatcheck.c
+ * @brief Host check of the FAT32 directory reader against crafted and corrupt entries.
+ *
+ * Build and run on Linux from this directory:
+ *   gcc -O1 -g -fsanitize=address,undefined -I../sdbench -I../../Include \
+ *       -I../../Components/MicroOS/include fatcheck.c ../sdbench/BlockDev_Host.c \
+ *       ../../Source/Fat.c ../../Source/BlockCache.c -o fatcheck
+ *   ./fatcheck
+ *
+ * Builds a small unpartitioned FAT32 image in a temporary file, with a root
+ * directory holding good long names next to broken LFN sequences (orphans,
+ * gaps, wrong checksum, sequence 0 after a complete name, overlong names),
+ * mounts it through BlockDev_Host.c and checks every name Fat_ReadDir()
+ * returns. A broken sequence must fall back to the 8.3 name and never touch
+ * memory outside the name buffers, which is what the sanitizers watch.
+ * Exit status 0 when all names match.
+ */
+
+#define _DEFAULT_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "BlockCache.h"
+#include "BlockDev.h"
+#include "BlockDev_Host.h"
+#include "Fat.h"
+#include "MicroOS.h"
+#include "main.h"
+
+#define SECTOR 512
+#define RESERVED 32
+#define FAT_SECTORS 1
+#define DATA_SECTORS 8
+#define ROOT_SECTORS 4 /* clusters 2..5, one sector each */
+#define ENTRIES (ROOT_SECTORS * SECTOR / 32)
+
+static uint8_t image[(RESERVED + FAT_SECTORS + DATA_SECTORS) * SECTOR];
+static uint8_t *root = &image[(RESERVED + FAT_SECTORS) * SECTOR];
+static unsigned entry_count = 0;
+static const char *expected[ENTRIES];
+static unsigned expected_count = 0;
+
+MicroOS_Status_t MicroOS_RegisterEvent(uint8_t id, MicroOS_EventFunction_t function, void *data)
+{
+    (void)id;
+    (void)function;
+    (void)data;
+    return MICROOS_OK;
+}
+
+MicroOS_Status_t MicroOS_TriggerEvent(uint8_t id)
+{
+    (void)id;
+    return MICROOS_OK;
+}
+
+bool Battery_IsLow(void)
+{
+    return false;
+}
+
+static void put16(uint8_t *p, uint16_t v)
+{
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+}
+
+static void put32(uint8_t *p, uint32_t v)
+{
+    put16(p, (uint16_t)v);
+    put16(p + 2, (uint16_t)(v >> 16));
+}
+
+static uint8_t *next_entry(void)
+{
+    if (entry_count >= ENTRIES)
+    {
+        fprintf(stderr, "root directory full\n");
+        exit(1);
+    }
+    return &root[32 * entry_count++];
+}
+
+static uint8_t short_sum(const char *name83)
+{
+    uint8_t sum = 0;
+    int i;
+
+    for (i = 0; i < 11; i++)
+        sum = (uint8_t)(((sum & 1) << 7) + (sum >> 1) + (uint8_t)name83[i]);
+    return sum;
+}
+
+/* 8.3 entry, name83 is the 11 padded characters */
+static void add_short(const char *name83, uint8_t attr, uint8_t case_flags, const char *expect)
+{
+    uint8_t *e = next_entry();
+
+    memcpy(e, name83, 11);
+    e[11] = attr;
+    e[12] = case_flags;
+    if (expect != NULL)
+        expected[expected_count++] = expect;
+}
+
+/* one LFN entry with characters [13 * (seq - 1), 13 * seq) of name */
+static void add_lfn(uint8_t order, uint8_t seq, const char *name, uint8_t sum)
+{
+    static const uint8_t offsets[13] = {1, 3, 5, 7, 9, 14, 16, 18, 20, 22, 24, 28, 30};
+    uint8_t *e = next_entry();
+    size_t length = strlen(name);
+    int i;
+
+    e[0] = order;
+    e[11] = 0x0F;
+    e[13] = sum;
+    for (i = 0; i < 13; i++)
+    {
+        size_t c = (size_t)(seq > 0 ? seq - 1 : 0) * 13 + (size_t)i;
+
+        put16(&e[offsets[i]], c < length ? (uint16_t)(uint8_t)name[c] : c == length ? 0 : 0xFFFF);
+    }
+}
+
+/* a complete, valid long name for name83 */
+static void add_long(const char *name, const char *name83, const char *expect)
+{
+    uint8_t sum = short_sum(name83);
+    uint8_t count = (uint8_t)((strlen(name) + 12) / 13);
+    uint8_t seq;
+
+    for (seq = count; seq > 0; seq--)
+        add_lfn((uint8_t)(seq | (seq == count ? 0x40 : 0)), seq, name, sum);
+    add_short(name83, 0x20, 0, expect);
+}
+
+static void build_image(void)
+{
+    uint8_t *bs = image;
+    uint8_t *fat = &image[RESERVED * SECTOR];
+    char name[300];
+    uint8_t sum;
+    int i;
+
+    bs[0] = 0xEB;
+    bs[1] = 0x58;
+    bs[2] = 0x90;
+    memcpy(&bs[3], "MSWIN4.1", 8);
+    put16(&bs[11], SECTOR);
+    bs[13] = 1;
+    put16(&bs[14], RESERVED);
+    bs[16] = 1;
+    put32(&bs[32], sizeof(image) / SECTOR);
+    put32(&bs[36], FAT_SECTORS);
+    put32(&bs[44], 2);
+    bs[510] = 0x55;
+    bs[511] = 0xAA;
+
+    put32(&fat[0], 0x0FFFFFF8);
+    put32(&fat[4], 0x0FFFFFFF);
+    for (i = 0; i < ROOT_SECTORS; i++)
+        put32(&fat[4 * (2 + i)], i + 1 < ROOT_SECTORS ? (uint32_t)(3 + i) : 0x0FFFFFFF);
+
+    add_short("NANOTV     ", 0x08, 0, NULL);
+    add_long("Long file name.txt", "LONGFI~1TXT", "Long file name.txt");
+    add_short("README  TXT", 0x20, 0x18, "readme.txt");
+
+    /* sequence 0 after the complete name (0x20: a plain 0 would end the directory), must not
+       index the buffer at -13 */
+    sum = short_sum("SEQZER~1BIN");
+    add_lfn(0x41, 1, "seq zero.bin", sum);
+    add_lfn(0x20, 0, "seq zero.bin", sum);
+    add_short("SEQZER~1BIN", 0x20, 0, "SEQZER~1.BIN");
+    /* sequence 0 flagged as last */
+    add_lfn(0x40, 0, "zero last", short_sum("ZEROLA~1   "));
+    add_short("ZEROLA~1   ", 0x20, 0, "ZEROLA~1");
+
+    /* orphan without the last flag */
+    add_lfn(0x02, 2, "orphan entry name", short_sum("ORPHAN~1   "));
+    add_short("ORPHAN~1   ", 0x20, 0, "ORPHAN~1");
+
+    /* gap: 3 then 1 */
+    sum = short_sum("GAPNAM~1   ");
+    add_lfn(0x43, 3, "a name with a gap in it here", sum);
+    add_lfn(0x01, 1, "a name with a gap in it here", sum);
+    add_short("GAPNAM~1   ", 0x20, 0, "GAPNAM~1");
+
+    /* checksum of another short name */
+    add_lfn(0x41, 1, "bad sum", short_sum("OTHER   TXT"));
+    add_short("BADSUM~1   ", 0x20, 0, "BADSUM~1");
+
+    /* longer than the 260 characters the reader collects */
+    memset(name, 'x', 280);
+    name[280] = '\0';
+    sum = short_sum("TOOLON~1   ");
+    for (i = 22; i > 0; i--)
+        add_lfn((uint8_t)(i | (i == 22 ? 0x40 : 0)), (uint8_t)i, name, sum);
+    add_short("TOOLON~1   ", 0x20, 0, "TOOLON~1");
+
+    /* a deleted entry between the name and its 8.3 entry */
+    sum = short_sum("SPLIT~1    ");
+    add_lfn(0x41, 1, "split", sum);
+    next_entry()[0] = 0xE5;
+    add_short("SPLIT~1    ", 0x20, 0, "SPLIT~1");
+
+    /* a good name spanning a sector boundary follows the broken ones */
+    while (entry_count % 16 != 15)
+        add_short("\xE5UNUSED    ", 0x20, 0, NULL);
+    add_long("A long name across two sectors.ntv", "ALONGN~1NTV", "A long name across two sectors.ntv");
+    add_long("last.ntv", "LAST    NTV", "last.ntv");
+}
+
+int main(void)
+{
+    char path[] = "/tmp/fatcheckXXXXXX";
+    Fat_File_t dir;
+    Fat_Info_t info;
+    unsigned found = 0, bad = 0;
+    int fd;
+
+    build_image();
+    fd = mkstemp(path);
+    if (fd < 0 || write(fd, image, sizeof(image)) != (ssize_t)sizeof(image))
+    {
+        fprintf(stderr, "cannot write %s\n", path);
+        return 1;
+    }
+    close(fd);
+
+    if (blockdev_host_open(path) != 0)
+    {
+        fprintf(stderr, "cannot map %s\n", path);
+        return 1;
+    }
+    unlink(path);
+    blockdev_host_set_model(blockdev_host_profile("fast"), 1);
+    BlockCache_Init();
+    if (BlockDev_Init() != BLOCKDEV_OK || Fat_Mount() != FAT_OK || Fat_Open(&dir, "/") != FAT_OK)
+    {
+        fprintf(stderr, "cannot mount the image\n");
+        return 1;
+    }
+
+    while (Fat_ReadDir(&dir, &info) == FAT_OK)
+    {
+        const char *want = found < expected_count ? expected[found] : "(end)";
+
+        if (strcmp(info.Name, want) != 0)
+        {
+            printf("  entry %u: \"%s\", expected \"%s\"\n", found, info.Name, want);
+            bad++;
+        }
+        found++;
+    }
+    if (found != expected_count)
+    {
+        printf("  %u entries, expected %u\n", found, expected_count);
+        bad++;
+    }
+
+    blockdev_host_close();
+    printf("%u names checked: %s\n", expected_count, bad == 0 ? "ok" : "FAILED");
+    return bad == 0 ? 0 : 1;
+}
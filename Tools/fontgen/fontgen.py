@@ -0,0 +1,138 @@
+#!/usr/bin/env python3
+"""Convert a TrueType font into an anti-aliased bitmap font for Source/Font.c.
+
+Usage:
+    python3 fontgen.py DejaVuSans.ttf 14 --bpp 4 --name Font_Sans14 --out ../../
+
+Writes <out>/Source/<name>.c and <out>/Include/<name>.h. Glyphs are cropped to
+their ink box and packed MSB first at 2 or 4 bits per pixel, each glyph
+starting on a byte boundary. Requires Pillow (pip install pillow).
+"""
+
+import argparse
+import os
+import sys
+
+from PIL import Image, ImageDraw, ImageFont
+
+
+def parse_ranges(text):
+    """'0x20-0x7E,0xB0' -> sorted list of code points"""
+    points = set()
+    for part in text.split(","):
+        part = part.strip()
+        if not part:
+            continue
+        if "-" in part:
+            first, last = part.split("-", 1)
+            points.update(range(int(first, 0), int(last, 0) + 1))
+        else:
+            points.add(int(part, 0))
+    return sorted(points)
+
+
+def render_glyph(font, char, bpp):
+    """Returns (width, height, offset_x, offset_y, advance, levels)"""
+    advance = int(round(font.getlength(char)))
+    x0, y0, x1, y1 = font.getbbox(char, anchor="la")
+    width, height = max(0, x1 - x0), max(0, y1 - y0)
+    if width == 0 or height == 0:
+        return 0, 0, 0, 0, advance, []
+
+    image = Image.new("L", (width, height), 0)
+    ImageDraw.Draw(image).text((-x0, -y0), char, font=font, fill=255, anchor="la")
+    top = (1 << bpp) - 1
+    levels = [(value * top + 127) // 255 for value in image.tobytes()]
+    return width, height, x0, y0, advance, levels
+
+
+def pack(levels, bpp):
+    data = bytearray()
+    accumulator = 0
+    bits = 0
+    for level in levels:
+        accumulator = (accumulator << bpp) | level
+        bits += bpp
+        if bits == 8:
+            data.append(accumulator)
+            accumulator = 0
+            bits = 0
+    if bits:
+        data.append(accumulator << (8 - bits))
+    return data
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("ttf", help="TrueType/OpenType font file")
+    parser.add_argument("size", type=int, help="pixel size")
+    parser.add_argument("--bpp", type=int, choices=(2, 4), default=4, help="bits per pixel (default 4)")
+    parser.add_argument("--chars", default="0x20-0x7E", help="code point ranges, e.g. 0x20-0x7E,0xB0 (default ASCII)")
+    parser.add_argument("--name", required=True, help="C symbol, e.g. Font_Sans14")
+    parser.add_argument("--fallback", default="0x3F", help="code point drawn for missing glyphs (default '?')")
+    parser.add_argument("--out", default=".", help="directory holding Source/ and Include/")
+    args = parser.parse_args()
+
+    font = ImageFont.truetype(args.ttf, args.size)
+    ascent, descent = font.getmetrics()
+    codepoints = [cp for cp in parse_ranges(args.chars) if cp <= 0xFFFF]
+    fallback = int(args.fallback, 0)
+    if fallback not in codepoints:
+        sys.exit("fallback 0x%04X is not in --chars" % fallback)
+
+    glyphs = []
+    bitmap = bytearray()
+    for cp in codepoints:
+        width, height, offset_x, offset_y, advance, levels = render_glyph(font, chr(cp), args.bpp)
+        if width > 255 or height > 255 or not -128 <= offset_x <= 127 or not -128 <= offset_y <= 127 or advance > 255:
+            sys.exit("glyph 0x%04X does not fit the glyph table" % cp)
+        glyphs.append((cp, width, height, offset_x, offset_y, advance, len(bitmap)))
+        bitmap += pack(levels, args.bpp)
+
+    source_dir = os.path.join(args.out, "Source")
+    include_dir = os.path.join(args.out, "Include")
+    os.makedirs(source_dir, exist_ok=True)
+    os.makedirs(include_dir, exist_ok=True)
+    guard = args.name.upper() + "_H"
+    origin = "%s, %d px, %d bpp, %d glyphs, %d bytes" % (
+        os.path.basename(args.ttf), args.size, args.bpp, len(glyphs), len(bitmap) + len(glyphs) * 12)
+
+    with open(os.path.join(include_dir, args.name + ".h"), "w") as header:
+        header.write("#ifndef %s\n#define %s\n\n" % (guard, guard))
+        header.write("// Generated by Tools/fontgen/fontgen.py from %s\n\n" % origin)
+        header.write('#include "Font.h"\n\n')
+        header.write("#ifdef __cplusplus\nextern \"C\"\n{\n#endif\n\n")
+        header.write("extern const Font_t %s;\n\n" % args.name)
+        header.write("#ifdef __cplusplus\n}\n#endif\n\n#endif\n")
+
+    with open(os.path.join(source_dir, args.name + ".c"), "w") as source:
+        source.write("// Generated by Tools/fontgen/fontgen.py from %s\n" % origin)
+        source.write("// Do not edit, regenerate instead.\n\n")
+        source.write('#include "%s.h"\n\n' % args.name)
+        source.write("static const uint8_t %s_Bitmap[%d] = {\n" % (args.name, max(1, len(bitmap))))
+        for i in range(0, len(bitmap), 16):
+            source.write("    " + ", ".join("0x%02X" % b for b in bitmap[i:i + 16]) + ",\n")
+        if not bitmap:
+            source.write("    0x00,\n")
+        source.write("};\n\n")
+        source.write("static const Font_Glyph_t %s_Glyphs[%d] = {\n" % (args.name, len(glyphs)))
+        for cp, width, height, offset_x, offset_y, advance, offset in glyphs:
+            comment = chr(cp) if 0x20 < cp < 0x7F and cp != 0x5C else "U+%04X" % cp
+            source.write("    {0x%04X, %d, %d, %d, %d, %d, %d}, // %s\n" % (
+                cp, width, height, offset_x, offset_y, advance, offset, comment))
+        source.write("};\n\n")
+        source.write("const Font_t %s = {\n" % args.name)
+        source.write("    %s_Glyphs,\n" % args.name)
+        source.write("    %s_Bitmap,\n" % args.name)
+        source.write("    %d, // GlyphNum\n" % len(glyphs))
+        source.write("    %d, // Bpp\n" % args.bpp)
+        source.write("    %d, // LineHeight\n" % (ascent + descent))
+        source.write("    %d, // Baseline\n" % ascent)
+        source.write("    0x%04X, // Fallback\n" % fallback)
+        source.write("};\n")
+
+    print("%s: %s" % (args.name, origin))
+
+
+if __name__ == "__main__":
+    main()
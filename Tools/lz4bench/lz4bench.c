@@ -0,0 +1,490 @@
+/**
+ * @file lz4bench.c
+ * @brief Host benchmark for the LZ4 path: Source/Lz4.c and Tools/ntv/ntv_lz4.c against the reference lz4 library.
+ *
+ * Build and run on Linux from this directory (liblz4-dev):
+ *   gcc -O2 -I. -I../../Include -I../ntv lz4bench.c ../ntv/ntv_lz4.c ../../Source/Lz4.c -llz4 -o lz4bench
+ *   ./lz4bench [-b KB/s] [file ...]
+ *
+ * Without arguments a built-in corpus is generated: RGB565 cartoon and
+ * dithered photo-like frames, PAL8 indices, 4-bit anti-aliased UI masks and
+ * config-like text. Every file given is added, split into chunk-sized blocks
+ * the way ntvenc packs video chunks (NTV_BUFFER_SECTORS).
+ *
+ * Reported per input:
+ *   - ratio and compression speed of ntv_lz4 at levels 0, 2 and 4 and of
+ *     LZ4_compress_default() and LZ4_compress_HC() level 9
+ *   - decompression speed of Lz4_Decompress(), Lz4_Decompress_Ref() and
+ *     LZ4_decompress_safe() on the same blocks, in MB/s of output
+ *   - the card rate the ratio turns the -b budget into (SD_BUDGET_KBPS)
+ * Both ways are cross-checked, the reference decodes every ntv_lz4 block
+ * and Lz4_Decompress() every reference block; corrupted blocks must give the
+ * same status and output in Lz4_Decompress() and Lz4_Decompress_Ref(). Host
+ * speeds rank the decoders; the share of the Cortex-M4 is the card rate over
+ * the on-target decode rate.
+ */
+
+#define _POSIX_C_SOURCE 199309L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <lz4.h>
+#include <lz4hc.h>
+
+#include "Lz4.h"
+#include "Ntv.h"
+#include "ntv_lz4.h"
+
+/* minimum measuring time per operation */
+#define BENCH_MIN_SECONDS 0.25
+
+/* payload of the largest chunk, less the unpacked size in front of the block */
+#define BLOCK_SIZE (NTV_BUFFER_SECTORS * NTV_SECTOR_SIZE - sizeof(Ntv_Chunk_t) - sizeof(uint32_t))
+
+/* see Tools/ntv/ntvenc.c */
+#define SD_BUDGET_KBPS 780
+
+#define CORRUPT_ROUNDS 2000
+
+typedef struct
+{
+    char name[64];
+    uint8_t *data;
+    size_t size;
+} input_t;
+
+typedef struct
+{
+    const char *name;
+    int level;     /* ntv_lz4 level, -1 reference default, -2 reference HC */
+} packer_t;
+
+static const packer_t packers[] = {
+    {"ntv_lz4 0", 0},
+    {"ntv_lz4 2", 2},
+    {"ntv_lz4 4", 4},
+    {"lz4 default", -1},
+    {"lz4 HC 9", -2},
+};
+
+#define PACKERS (sizeof(packers) / sizeof(packers[0]))
+
+typedef struct
+{
+    size_t count;
+    uint8_t **blocks;
+    size_t *sizes;   /* packed */
+    size_t *raw;     /* unpacked */
+} packed_t;
+
+static double now_seconds(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static uint32_t rng_state = 1;
+
+static uint32_t rng(void)
+{
+    rng_state = rng_state * 1664525U + 1013904223U;
+    return rng_state >> 8;
+}
+
+/* ---------------------------------------------------------------- corpus */
+
+static uint16_t rgb565(int r, int g, int b)
+{
+    return (uint16_t)(((r & 0xF8) << 8) | ((g & 0xFC) << 3) | (b >> 3));
+}
+
+static input_t make_cartoon(void)
+{
+    input_t in = {"cartoon RGB565", NULL, 240 * 240 * 2 * 4};
+    uint16_t *px = malloc(in.size);
+    static const uint16_t colors[] = {0xFFFF, 0x0000, 0xF800, 0x07E0, 0x001F, 0xFFE0, 0xFD20, 0x8410};
+    int f, x, y, i;
+
+    for (f = 0; f < 4; f++)
+    {
+        uint16_t *frame = px + f * 240 * 240;
+
+        for (y = 0; y < 240; y++)
+            for (x = 0; x < 240; x++)
+                frame[y * 240 + x] = (y < 160) ? 0x5D1F : 0x2444;
+        for (i = 0; i < 12; i++)
+        {
+            int cx = 20 + (int)(rng() % 200) + f * 3, cy = 20 + (int)(rng() % 200), r = 8 + (int)(rng() % 30);
+            uint16_t c = colors[rng() % 8];
+
+            for (y = cy - r - 2; y <= cy + r + 2; y++)
+                for (x = cx - r - 2; x <= cx + r + 2; x++)
+                {
+                    int d = (x - cx) * (x - cx) + (y - cy) * (y - cy);
+
+                    if (x < 0 || y < 0 || x >= 240 || y >= 240)
+                        continue;
+                    if (d <= r * r)
+                        frame[y * 240 + x] = c;
+                    else if (d <= (r + 2) * (r + 2))
+                        frame[y * 240 + x] = 0x0000; /* outline */
+                }
+        }
+    }
+    in.data = (uint8_t *)px;
+    return in;
+}
+
+static input_t make_photo(void)
+{
+    static const uint8_t bayer[4][4] = {{0, 8, 2, 10}, {12, 4, 14, 6}, {3, 11, 1, 9}, {15, 7, 13, 5}};
+    input_t in = {"photo RGB565 dithered", NULL, 240 * 240 * 2 * 2};
+    uint16_t *px = malloc(in.size);
+    int f, x, y;
+
+    for (f = 0; f < 2; f++)
+        for (y = 0; y < 240; y++)
+            for (x = 0; x < 240; x++)
+            {
+                int b = bayer[y & 3][x & 3], n = (int)(rng() % 9) - 4;
+                int r = x + n + (b >> 1), g = y + f * 7 + n + (b >> 2), bl = 128 + (x - y) / 4 + n + (b >> 1);
+
+                r = r < 0 ? 0 : (r > 255 ? 255 : r);
+                g = g < 0 ? 0 : (g > 255 ? 255 : g);
+                bl = bl < 0 ? 0 : (bl > 255 ? 255 : bl);
+                px[(f * 240 + y) * 240 + x] = rgb565(r, g, bl);
+            }
+    in.data = (uint8_t *)px;
+    return in;
+}
+
+static input_t make_pal8(void)
+{
+    input_t in = {"cartoon PAL8", NULL, 240 * 240 * 4};
+    input_t cartoon = make_cartoon();
+    const uint16_t *px = (const uint16_t *)cartoon.data;
+    size_t i;
+
+    in.data = malloc(in.size);
+    for (i = 0; i < in.size; i++)
+        in.data[i] = (uint8_t)((px[i] >> 8) ^ px[i]);
+    free(cartoon.data);
+    return in;
+}
+
+static input_t make_ui(void)
+{
+    input_t in = {"UI masks 4-bit", NULL, 64 * 1024};
+    int x, y, k = 0;
+
+    in.data = calloc(1, in.size);
+    /* 32x32 anti-aliased glyph-like masks, two pixels per byte */
+    while ((size_t)(k + 1) * 512 <= in.size)
+    {
+        int cx = 8 + (int)(rng() % 16), cy = 8 + (int)(rng() % 16), r = 4 + (int)(rng() % 10);
+
+        for (y = 0; y < 32; y++)
+            for (x = 0; x < 32; x++)
+            {
+                int d = (x - cx) * (x - cx) + (y - cy) * (y - cy) - r * r;
+                int v = d <= -2 * r ? 15 : (d >= 2 * r ? 0 : 15 * (2 * r - d) / (4 * r));
+
+                in.data[k * 512 + y * 16 + x / 2] |= (uint8_t)(v << ((x & 1) * 4));
+            }
+        k++;
+    }
+    return in;
+}
+
+static input_t make_text(void)
+{
+    static const char *titles[] = {"Big Buck Bunny", "Sintel", "Elephants Dream", "Tears of Steel", "Cosmos Laundromat"};
+    input_t in = {"config/playlist text", NULL, 0};
+    size_t cap = 64 * 1024;
+    int n = 0;
+
+    in.data = malloc(cap);
+    while (in.size + 200 < cap)
+    {
+        in.size += (size_t)snprintf((char *)in.data + in.size, cap - in.size,
+                                    "{\"title\": \"%s\", \"file\": \"/video/%03d.ntv\", \"volume\": %u, "
+                                    "\"position_ms\": %u, \"subtitles\": %s},\n",
+                                    titles[rng() % 5], n++, rng() % 100, rng() % 3600000, (rng() & 1) ? "true" : "false");
+    }
+    return in;
+}
+
+static int read_input(const char *path, input_t *in)
+{
+    FILE *file = fopen(path, "rb");
+    long size;
+
+    if (file == NULL || fseek(file, 0, SEEK_END) != 0 || (size = ftell(file)) <= 0)
+    {
+        fprintf(stderr, "cannot read %s\n", path);
+        if (file != NULL)
+            fclose(file);
+        return -1;
+    }
+    rewind(file);
+    snprintf(in->name, sizeof(in->name), "%s", path);
+    in->size = (size_t)size;
+    in->data = malloc(in->size);
+    if (in->data == NULL || fread(in->data, 1, in->size, file) != in->size)
+    {
+        fclose(file);
+        return -1;
+    }
+    fclose(file);
+    return 0;
+}
+
+/* ---------------------------------------------------------------- packing */
+
+static size_t pack_block(const packer_t *p, const uint8_t *src, size_t size, uint8_t *dst, size_t cap)
+{
+    if (p->level >= 0)
+        return ntv_lz4_compress(src, size, dst, cap, p->level);
+    if (p->level == -1)
+        return (size_t)LZ4_compress_default((const char *)src, (char *)dst, (int)size, (int)cap);
+    return (size_t)LZ4_compress_HC((const char *)src, (char *)dst, (int)size, (int)cap, 9);
+}
+
+/* every block of the input; the time per pass in *seconds */
+static int pack_input(const packer_t *p, const input_t *in, packed_t *out, double *seconds)
+{
+    size_t cap = ntv_lz4_bound(BLOCK_SIZE), i, passes = 0;
+    double start = now_seconds();
+
+    out->count = (in->size + BLOCK_SIZE - 1) / BLOCK_SIZE;
+    out->blocks = calloc(out->count, sizeof(*out->blocks));
+    out->sizes = calloc(out->count, sizeof(*out->sizes));
+    out->raw = calloc(out->count, sizeof(*out->raw));
+    for (i = 0; i < out->count; i++)
+        out->blocks[i] = malloc(cap);
+
+    do
+    {
+        for (i = 0; i < out->count; i++)
+        {
+            size_t offset = i * BLOCK_SIZE;
+
+            out->raw[i] = (in->size - offset < BLOCK_SIZE) ? in->size - offset : BLOCK_SIZE;
+            out->sizes[i] = pack_block(p, in->data + offset, out->raw[i], out->blocks[i], cap);
+            if (out->sizes[i] == 0)
+            {
+                fprintf(stderr, "%s: %s failed on block %zu\n", in->name, p->name, i);
+                return -1;
+            }
+        }
+        passes++;
+    } while (now_seconds() - start < BENCH_MIN_SECONDS);
+
+    *seconds = (now_seconds() - start) / passes;
+    return 0;
+}
+
+static void free_packed(packed_t *p)
+{
+    size_t i;
+
+    for (i = 0; i < p->count; i++)
+        free(p->blocks[i]);
+    free(p->blocks);
+    free(p->sizes);
+    free(p->raw);
+}
+
+/* ---------------------------------------------------------------- unpacking */
+
+typedef enum
+{
+    DECODER_FAST,
+    DECODER_REF,
+    DECODER_LZ4
+} decoder_t;
+
+static int unpack_block(decoder_t d, const uint8_t *src, size_t size, uint8_t *dst, size_t cap, size_t *written)
+{
+    uint32_t got = 0;
+    int n;
+
+    switch (d)
+    {
+    case DECODER_FAST:
+        if (Lz4_Decompress(src, (uint32_t)size, dst, (uint32_t)cap, &got) != LZ4_OK)
+            return -1;
+        *written = got;
+        return 0;
+    case DECODER_REF:
+        if (Lz4_Decompress_Ref(src, (uint32_t)size, dst, (uint32_t)cap, &got) != LZ4_OK)
+            return -1;
+        *written = got;
+        return 0;
+    default:
+        n = LZ4_decompress_safe((const char *)src, (char *)dst, (int)size, (int)cap);
+        if (n < 0)
+            return -1;
+        *written = (size_t)n;
+        return 0;
+    }
+}
+
+/* MB/s of output, -1 if a block does not come back as it went in */
+static double unpack_speed(decoder_t d, const input_t *in, const packed_t *p, uint8_t *out)
+{
+    double start = now_seconds(), seconds;
+    size_t passes = 0, bytes = 0, i, got = 0;
+
+    do
+    {
+        for (i = 0; i < p->count; i++)
+        {
+            if (unpack_block(d, p->blocks[i], p->sizes[i], out, p->raw[i], &got) != 0 || got != p->raw[i] ||
+                (passes == 0 && memcmp(out, in->data + i * BLOCK_SIZE, got) != 0))
+                return -1.0;
+            bytes += got;
+        }
+        passes++;
+    } while ((seconds = now_seconds() - start) < BENCH_MIN_SECONDS);
+
+    return bytes / seconds / 1e6;
+}
+
+/* flipped bytes and cut blocks: the fast decoder must agree with the reference decoder */
+static int corrupt_check(const packed_t *p)
+{
+    static uint8_t a[BLOCK_SIZE + 64], b[BLOCK_SIZE + 64];
+    uint8_t *block = malloc(ntv_lz4_bound(BLOCK_SIZE));
+    int round, failures = 0;
+
+    for (round = 0; round < CORRUPT_ROUNDS && p->count > 0; round++)
+    {
+        size_t i = rng() % p->count, size = p->sizes[i], cap = p->raw[i] - (rng() & 1 ? rng() % 64 : 0);
+        uint32_t got_a = 0, got_b = 0;
+        Lz4_Status_t ra, rb;
+        int flips = 1 + (int)(rng() % 4), k;
+
+        memcpy(block, p->blocks[i], size);
+        for (k = 0; k < flips; k++)
+            block[rng() % size] = (uint8_t)rng();
+        if (rng() & 1)
+            size -= rng() % size;
+        if (size == 0)
+            size = 1;
+
+        memset(a, 0, sizeof(a));
+        memset(b, 0, sizeof(b));
+        ra = Lz4_Decompress(block, (uint32_t)size, a, (uint32_t)cap, &got_a);
+        rb = Lz4_Decompress_Ref(block, (uint32_t)size, b, (uint32_t)cap, &got_b);
+        if (ra != rb || (ra == LZ4_OK && (got_a != got_b || memcmp(a, b, got_a) != 0)))
+            failures++;
+    }
+    free(block);
+    return failures;
+}
+
+/* ---------------------------------------------------------------- main */
+
+static int bench(const input_t *in, double budget)
+{
+    static uint8_t out[BLOCK_SIZE];
+    static const char *decoders[] = {"Lz4_Decompress", "Lz4_Decompress_Ref", "LZ4_decompress_safe"};
+    double fast_on_ref = 0.0;
+    size_t i, k;
+    int errors = 0;
+
+    printf("%s: %zu bytes, %zu blocks of up to %u\n", in->name, in->size, (in->size + BLOCK_SIZE - 1) / BLOCK_SIZE,
+           (unsigned)BLOCK_SIZE);
+    printf("  %-12s %7s %10s %10s   %s\n", "packer", "ratio", "pack MB/s", "card KB/s", "unpack MB/s: fast / ref / lz4");
+
+    for (k = 0; k < PACKERS; k++)
+    {
+        packed_t p;
+        double seconds = 0.0, speed[3];
+        size_t total = 0;
+        int d;
+
+        if (pack_input(&packers[k], in, &p, &seconds) != 0)
+            return 1;
+        for (i = 0; i < p.count; i++)
+            total += p.sizes[i] + sizeof(uint32_t);
+        for (d = 0; d < 3; d++)
+        {
+            speed[d] = unpack_speed((decoder_t)d, in, &p, out);
+            if (speed[d] < 0.0)
+            {
+                printf("  %s does not restore the %s blocks\n", decoders[d], packers[k].name);
+                errors++;
+            }
+        }
+        if (packers[k].level == -2)
+            fast_on_ref = speed[0] / speed[2];
+        printf("  %-12s %7.3f %10.1f %10.0f   %.0f / %.0f / %.0f\n", packers[k].name, (double)in->size / total,
+               in->size / seconds / 1e6, budget * in->size / total, speed[0], speed[1], speed[2]);
+
+        if (packers[k].level == 2 && corrupt_check(&p) != 0)
+        {
+            printf("  Lz4_Decompress and Lz4_Decompress_Ref disagree on corrupt blocks\n");
+            errors++;
+        }
+        free_packed(&p);
+    }
+    printf("  Lz4_Decompress at %.2fx LZ4_decompress_safe\n\n", fast_on_ref);
+    return errors;
+}
+
+static void usage(void)
+{
+    fprintf(stderr, "usage: lz4bench [-b KB/s] [file ...]\n");
+    exit(2);
+}
+
+int main(int argc, char **argv)
+{
+    input_t inputs[64];
+    size_t count = 0, i;
+    double budget = SD_BUDGET_KBPS;
+    int opt, errors = 0;
+
+    while ((opt = getopt(argc, argv, "b:")) != -1)
+    {
+        switch (opt)
+        {
+        case 'b':
+            budget = atof(optarg);
+            break;
+        default:
+            usage();
+        }
+    }
+
+    if (optind == argc)
+    {
+        inputs[count++] = make_cartoon();
+        inputs[count++] = make_photo();
+        inputs[count++] = make_pal8();
+        inputs[count++] = make_ui();
+        inputs[count++] = make_text();
+    }
+    for (; optind < argc && count < sizeof(inputs) / sizeof(inputs[0]); optind++)
+    {
+        if (read_input(argv[optind], &inputs[count]) != 0)
+            return 1;
+        count++;
+    }
+
+    for (i = 0; i < count; i++)
+    {
+        errors += bench(&inputs[i], budget);
+        free(inputs[i].data);
+    }
+    if (errors)
+        printf("%d FAILURES\n", errors);
+    return errors ? 1 : 0;
+}
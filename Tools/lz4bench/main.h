@@ -0,0 +1,30 @@
+/**
+ * @file main.h
+ * @brief Host stand-in for the CubeMX main.h, enough for Source/Lz4.c.
+ */
+
+#ifndef LZ4BENCH_MAIN_H
+#define LZ4BENCH_MAIN_H
+
+#include <stdint.h>
+#include <string.h>
+
+#define __ALIGNED(x) __attribute__((aligned(x)))
+
+static inline uint32_t lz4bench_read32(const void *p)
+{
+    uint32_t v;
+
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+#define __UNALIGNED_UINT32_READ(addr) lz4bench_read32(addr)
+#define __UNALIGNED_UINT32_WRITE(addr, val) \
+    do                                      \
+    {                                       \
+        uint32_t v_ = (val);                \
+        memcpy((addr), &v_, sizeof(v_));    \
+    } while (0)
+
+#endif
@@ -0,0 +1,33 @@
+/**
+ * @file main.h
+ * @brief Host stand-in for the CubeMX main.h, enough for Source/TileDelta.c, Render.c and Lz4.c.
+ */
+
+#ifndef NTV_MAIN_H
+#define NTV_MAIN_H
+
+#include <stdint.h>
+#include <string.h>
+
+#define __ALIGNED(x) __attribute__((aligned(x)))
+
+/* provided by the check that needs it */
+uint32_t HAL_GetTick(void);
+
+static inline uint32_t ntv_read32(const void *p)
+{
+    uint32_t v;
+
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+#define __UNALIGNED_UINT32_READ(addr) ntv_read32(addr)
+#define __UNALIGNED_UINT32_WRITE(addr, val) \
+    do                                      \
+    {                                       \
+        uint32_t v_ = (val);                \
+        memcpy((addr), &v_, sizeof(v_));    \
+    } while (0)
+
+#endif
@@ -0,0 +1,187 @@
+/**
+ * @file ntv_lz4.c
+ * @brief LZ4 block compressor, see ntv_lz4.h.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "ntv_lz4.h"
+
+/* format limits: a block ends in 5 literals, the last match starts 12 bytes before the end */
+#define MIN_MATCH 4
+#define LAST_LITERALS 5
+#define MATCH_LIMIT 12
+#define MAX_OFFSET 65535
+
+#define HASH_BITS 16
+
+static uint32_t hash4(const uint8_t *p)
+{
+    uint32_t v;
+
+    memcpy(&v, p, sizeof(v));
+    return (v * 2654435761U) >> (32 - HASH_BITS);
+}
+
+static uint8_t *put_length(uint8_t *op, const uint8_t *oend, size_t length)
+{
+    while (length >= 255)
+    {
+        if (op >= oend)
+            return NULL;
+        *op++ = 255;
+        length -= 255;
+    }
+    if (op >= oend)
+        return NULL;
+    *op++ = (uint8_t)length;
+    return op;
+}
+
+/* one sequence; match 0 for the closing literals-only one */
+static uint8_t *put_sequence(uint8_t *op, const uint8_t *oend, const uint8_t *literals, size_t count, size_t offset,
+                             size_t match)
+{
+    size_t m = match ? match - MIN_MATCH : 0;
+
+    if (op >= oend)
+        return NULL;
+    *op++ = (uint8_t)(((count < 15 ? count : 15) << 4) | (m < 15 ? m : 15));
+    if (count >= 15 && (op = put_length(op, oend, count - 15)) == NULL)
+        return NULL;
+    if ((size_t)(oend - op) < count)
+        return NULL;
+    memcpy(op, literals, count);
+    op += count;
+    if (match == 0)
+        return op;
+
+    if (oend - op < 2)
+        return NULL;
+    *op++ = (uint8_t)offset;
+    *op++ = (uint8_t)(offset >> 8);
+    if (m >= 15 && (op = put_length(op, oend, m - 15)) == NULL)
+        return NULL;
+    return op;
+}
+
+typedef struct
+{
+    const uint8_t *src;
+    size_t size;
+    int32_t *head;
+    int32_t *chain;
+    int depth;
+} matcher_t;
+
+static void insert(matcher_t *m, size_t pos)
+{
+    uint32_t h = hash4(m->src + pos);
+
+    m->chain[pos] = m->head[h];
+    m->head[h] = (int32_t)pos;
+}
+
+/* longest match for pos among earlier positions, its length (0 if none) */
+static size_t find(const matcher_t *m, size_t pos, size_t limit, size_t *offset)
+{
+    int32_t cand = m->head[hash4(m->src + pos)];
+    size_t best = 0;
+    int tries = m->depth;
+
+    while (cand >= 0 && tries-- > 0 && pos - (size_t)cand <= MAX_OFFSET)
+    {
+        const uint8_t *a = m->src + cand, *b = m->src + pos;
+        size_t len = 0;
+
+        while (pos + len < limit && a[len] == b[len])
+            len++;
+        if (len >= MIN_MATCH && len > best)
+        {
+            best = len;
+            *offset = pos - (size_t)cand;
+            if (pos + len >= limit)
+                break;
+        }
+        cand = m->chain[cand];
+    }
+    return best;
+}
+
+size_t ntv_lz4_bound(size_t size)
+{
+    return size + size / 255 + 16;
+}
+
+size_t ntv_lz4_compress(const uint8_t *src, size_t size, uint8_t *dst, size_t cap, int level)
+{
+    matcher_t m;
+    uint8_t *op = dst, *oend = dst + cap;
+    size_t anchor = 0, pos = 0, i;
+    size_t match_end = size > LAST_LITERALS ? size - LAST_LITERALS : 0;
+    size_t search_end = size > MATCH_LIMIT ? size - MATCH_LIMIT : 0;
+
+    if (level < 0)
+        level = 0;
+    if (level > NTV_LZ4_LEVEL_MAX)
+        level = NTV_LZ4_LEVEL_MAX;
+    m.src = src;
+    m.size = size;
+    m.depth = level ? 1 << (2 * level) : 1;
+    m.head = malloc(sizeof(int32_t) << HASH_BITS);
+    m.chain = malloc((size + 1) * sizeof(int32_t));
+    if (m.head == NULL || m.chain == NULL)
+    {
+        free(m.head);
+        free(m.chain);
+        return 0;
+    }
+    for (i = 0; i < (size_t)1 << HASH_BITS; i++)
+        m.head[i] = -1;
+
+    while (pos < search_end)
+    {
+        size_t offset = 0, length = find(&m, pos, match_end, &offset);
+
+        insert(&m, pos);
+        /* lazy: a longer match one byte on is worth a literal */
+        if (length > 0 && level > 0 && pos + 1 < search_end)
+        {
+            size_t next_offset = 0, next = find(&m, pos + 1, match_end, &next_offset);
+
+            if (next > length + 1)
+            {
+                pos++;
+                length = next;
+                offset = next_offset;
+                insert(&m, pos);
+            }
+        }
+        if (length == 0)
+        {
+            pos++;
+            continue;
+        }
+        /* grow the match backwards over literals that repeat too */
+        while (pos > anchor && pos > offset && src[pos - 1] == src[pos - 1 - offset])
+        {
+            pos--;
+            length++;
+        }
+
+        op = put_sequence(op, oend, src + anchor, pos - anchor, offset, length);
+        if (op == NULL)
+            break;
+        for (i = pos + 1; i < pos + length && i < search_end; i++)
+            insert(&m, i);
+        pos += length;
+        anchor = pos;
+    }
+
+    if (op != NULL)
+        op = put_sequence(op, oend, src + anchor, size - anchor, 0, 0);
+    free(m.head);
+    free(m.chain);
+    return op != NULL ? (size_t)(op - dst) : 0;
+}
@@ -0,0 +1,26 @@
+/**
+ * @file ntv_lz4.h
+ * @brief LZ4 block compressor for the host tools, the counterpart of Source/Lz4.c.
+ *
+ * Writes the plain LZ4 block format, so the reference lz4 library decodes it
+ * as well. Level 0 takes the first match a hash probe finds (like
+ * LZ4_compress_default); higher levels search a hash chain deeper and look
+ * one byte ahead for a longer match, for smaller blocks at the same decoding
+ * cost on the device.
+ */
+
+#ifndef NTV_LZ4_H
+#define NTV_LZ4_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define NTV_LZ4_LEVEL_MAX 6
+
+/* largest block size for size input bytes */
+size_t ntv_lz4_bound(size_t size);
+
+/* compress src into dst; the block size, 0 if it does not fit cap */
+size_t ntv_lz4_compress(const uint8_t *src, size_t size, uint8_t *dst, size_t cap, int level);
+
+#endif
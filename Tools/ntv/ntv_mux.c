@@ -0,0 +1,356 @@
+/**
+ * @file ntv_mux.c
+ * @brief Writer for the NanoTV container, see ntv_mux.h.
+ *
+ * The structures of Include/Ntv.h are written as they are: the host must be
+ * little-endian like the device.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ntv_lz4.h"
+#include "ntv_mux.h"
+
+#define DEFAULT_INDEX_PERIOD_MS 500
+
+typedef struct
+{
+    uint32_t pts;
+    uint32_t sector;
+    uint16_t sectors;
+} key_group_t;
+
+struct ntv_mux
+{
+    FILE *file;
+    Ntv_Header_t header;
+    uint16_t max_sectors;
+
+    uint8_t *pending;        /* chunk waiting for the size of the next one */
+    uint16_t pending_sectors;
+    uint32_t chunk_sector;   /* where the pending chunk goes */
+
+    int64_t frame;           /* current video frame, -1 before the first */
+    uint64_t audio_pos;      /* sample frames written */
+    int key;                 /* current frame is a key frame */
+    int group_open;          /* the next chunk starts a key frame group */
+    uint32_t group_pts;
+
+    key_group_t *groups;
+    size_t group_count;
+    size_t group_cap;
+
+    int lz4_level;           /* -1: no LZ4 */
+    uint8_t *packed;         /* LZ4 payload being built */
+
+    ntv_mux_stats_t stats;
+    int failed;
+};
+
+static int write_pending(ntv_mux_t *mux, uint16_t next_sectors)
+{
+    Ntv_Chunk_t *chunk = (Ntv_Chunk_t *)mux->pending;
+    size_t bytes = (size_t)mux->pending_sectors * NTV_SECTOR_SIZE;
+
+    if (mux->pending_sectors == 0)
+        return 0;
+    chunk->NextSectors = next_sectors;
+    if (fwrite(mux->pending, 1, bytes, mux->file) != bytes)
+    {
+        fprintf(stderr, "write failed\n");
+        mux->failed = 1;
+        return -1;
+    }
+    mux->chunk_sector += mux->pending_sectors;
+    mux->stats.file_bytes += bytes;
+    mux->pending_sectors = 0;
+    return 0;
+}
+
+static int add_group(ntv_mux_t *mux, uint32_t pts, uint32_t sector, uint16_t sectors)
+{
+    if (mux->group_count == mux->group_cap)
+    {
+        size_t cap = mux->group_cap ? mux->group_cap * 2 : 256;
+        key_group_t *grown = realloc(mux->groups, cap * sizeof(*grown));
+
+        if (grown == NULL)
+            return -1;
+        mux->groups = grown;
+        mux->group_cap = cap;
+    }
+    mux->groups[mux->group_count++] = (key_group_t){pts, sector, sectors};
+    return 0;
+}
+
+static int emit_chunk(ntv_mux_t *mux, const Ntv_Chunk_t *head, const void *payload)
+{
+    uint16_t sectors = (uint16_t)((sizeof(Ntv_Chunk_t) + head->Size + NTV_SECTOR_SIZE - 1) / NTV_SECTOR_SIZE);
+    uint32_t sector = 0;
+    Ntv_Chunk_t *chunk = (Ntv_Chunk_t *)mux->pending;
+
+    if (mux->failed)
+        return -1;
+    if (head->Size > ntv_mux_max_payload(mux))
+    {
+        fprintf(stderr, "chunk of %u bytes does not fit %u sectors\n", head->Size, mux->max_sectors);
+        return -1;
+    }
+
+    if (mux->pending_sectors > 0)
+    {
+        if (write_pending(mux, sectors) != 0)
+            return -1;
+    }
+    else if (mux->header.FirstSectors == 0)
+    {
+        mux->header.FirstSectors = sectors;
+    }
+    sector = mux->chunk_sector;
+
+    memset(mux->pending, 0, (size_t)sectors * NTV_SECTOR_SIZE);
+    *chunk = *head;
+    chunk->Sectors = sectors;
+    memcpy(mux->pending + sizeof(Ntv_Chunk_t), payload, head->Size);
+    mux->pending_sectors = sectors;
+
+    if (mux->group_open)
+    {
+        if (add_group(mux, mux->group_pts, sector, sectors) != 0)
+            return -1;
+        mux->group_open = 0;
+    }
+    if (sectors > mux->stats.sectors_max)
+        mux->stats.sectors_max = sectors;
+    return 0;
+}
+
+ntv_mux_t *ntv_mux_open(const char *path, const Ntv_Header_t *params)
+{
+    static const uint8_t blank[NTV_SECTOR_SIZE];
+    ntv_mux_t *mux = calloc(1, sizeof(*mux));
+
+    if (mux == NULL)
+        return NULL;
+    mux->header = *params;
+    mux->max_sectors = params->MaxSectors ? params->MaxSectors : NTV_BUFFER_SECTORS;
+    if (mux->header.IndexPeriodMs == 0)
+        mux->header.IndexPeriodMs = DEFAULT_INDEX_PERIOD_MS;
+    mux->header.FirstSectors = 0;
+    mux->frame = -1;
+    mux->chunk_sector = 1;
+    mux->lz4_level = -1;
+
+    if (params->FrameUs == 0 || (params->AudioRate > 0 && (params->AudioChannels == 0 || params->AudioBits == 0)))
+    {
+        fprintf(stderr, "missing frame period or audio format\n");
+        free(mux);
+        return NULL;
+    }
+
+    mux->pending = malloc((size_t)mux->max_sectors * NTV_SECTOR_SIZE);
+    mux->file = fopen(path, "wb");
+    if (mux->pending == NULL || mux->file == NULL)
+    {
+        fprintf(stderr, "cannot create %s\n", path);
+        if (mux->file != NULL)
+            fclose(mux->file);
+        free(mux->pending);
+        free(mux);
+        return NULL;
+    }
+
+    /* the header is written last, over this */
+    fwrite(blank, 1, sizeof(blank), mux->file);
+    mux->stats.file_bytes = sizeof(blank);
+    return mux;
+}
+
+int ntv_mux_frame(ntv_mux_t *mux, int key)
+{
+    mux->frame++;
+    mux->key = key;
+    if (key)
+    {
+        mux->group_open = 1;
+        mux->group_pts = (uint32_t)(mux->frame * mux->header.FrameUs / 1000);
+    }
+    return 0;
+}
+
+int ntv_mux_audio(ntv_mux_t *mux, const void *samples, uint32_t frames)
+{
+    uint32_t frame_bytes = (uint32_t)mux->header.AudioChannels * mux->header.AudioBits / 8;
+    uint32_t per_chunk = 0;
+    const uint8_t *at = samples;
+    Ntv_Chunk_t head;
+
+    if (mux->header.AudioRate == 0 || frame_bytes == 0)
+        return -1;
+    /* whole 32-bit words per chunk, the audio DMA moves words */
+    per_chunk = (ntv_mux_max_payload(mux) / frame_bytes) & ~1U;
+
+    while (frames > 0)
+    {
+        uint32_t count = (frames < per_chunk) ? frames : per_chunk;
+
+        memset(&head, 0, sizeof(head));
+        head.Type = NTV_CHUNK_AUDIO;
+        head.Size = count * frame_bytes;
+        head.Pts = (uint32_t)(mux->audio_pos * 1000 / mux->header.AudioRate);
+        head.Index = (uint32_t)mux->audio_pos;
+        if (emit_chunk(mux, &head, at) != 0)
+            return -1;
+
+        mux->stats.audio_chunks++;
+        mux->stats.audio_bytes += head.Size;
+        mux->audio_pos += count;
+        at += head.Size;
+        frames -= count;
+    }
+    return 0;
+}
+
+/* sectors a chunk with this payload takes */
+static uint32_t chunk_sectors(uint32_t size)
+{
+    return (uint32_t)((sizeof(Ntv_Chunk_t) + size + NTV_SECTOR_SIZE - 1) / NTV_SECTOR_SIZE);
+}
+
+int ntv_mux_video(ntv_mux_t *mux, uint16_t line, uint16_t lines, const void *data, uint32_t size, int frame_end)
+{
+    Ntv_Chunk_t head;
+    uint32_t raw = size;
+    uint8_t flags = 0;
+
+    if (mux->frame < 0)
+        return -1;
+
+    if (mux->lz4_level >= 0 && size > 0)
+    {
+        size_t packed = ntv_lz4_compress(data, size, mux->packed + sizeof(uint32_t),
+                                         ntv_mux_max_payload(mux) - sizeof(uint32_t), mux->lz4_level);
+
+        if (packed > 0 && chunk_sectors((uint32_t)(sizeof(uint32_t) + packed)) < chunk_sectors(size))
+        {
+            memcpy(mux->packed, &raw, sizeof(raw));
+            data = mux->packed;
+            size = (uint32_t)(sizeof(uint32_t) + packed);
+            flags = NTV_CHUNK_LZ4;
+            mux->stats.lz4_chunks++;
+        }
+    }
+
+    memset(&head, 0, sizeof(head));
+    head.Type = NTV_CHUNK_VIDEO;
+    head.Flags = (uint8_t)((mux->key ? NTV_CHUNK_KEY : 0) | (frame_end ? NTV_CHUNK_FRAME_END : 0) | flags);
+    head.Size = size;
+    head.Pts = (uint32_t)(mux->frame * mux->header.FrameUs / 1000);
+    head.Line = line;
+    head.Lines = lines;
+    head.Index = (uint32_t)mux->frame;
+    if (emit_chunk(mux, &head, data) != 0)
+        return -1;
+
+    mux->stats.video_chunks++;
+    mux->stats.video_bytes += size;
+    mux->stats.video_raw += raw;
+    return 0;
+}
+
+uint32_t ntv_mux_max_payload(const ntv_mux_t *mux)
+{
+    return (uint32_t)mux->max_sectors * NTV_SECTOR_SIZE - sizeof(Ntv_Chunk_t);
+}
+
+void ntv_mux_set_lz4(ntv_mux_t *mux, int level)
+{
+    if (level >= 0 && mux->packed == NULL)
+        mux->packed = malloc(ntv_mux_max_payload(mux));
+    mux->lz4_level = (mux->packed != NULL) ? level : -1;
+}
+
+void ntv_mux_get_stats(const ntv_mux_t *mux, ntv_mux_stats_t *stats)
+{
+    *stats = mux->stats;
+}
+
+static int write_index(ntv_mux_t *mux)
+{
+    Ntv_IndexEntry_t entry;
+    uint32_t entries = 0, i;
+    size_t group = 0;
+    uint64_t bytes = 0;
+    static const uint8_t blank[NTV_SECTOR_SIZE];
+
+    mux->header.IndexSector = mux->chunk_sector;
+    if (mux->group_count == 0)
+        return 0;
+
+    entries = mux->header.DurationMs / mux->header.IndexPeriodMs + 1;
+    for (i = 0; i < entries; i++)
+    {
+        uint64_t t = (uint64_t)i * mux->header.IndexPeriodMs;
+
+        /* last key frame at or before t */
+        while (group + 1 < mux->group_count && mux->groups[group + 1].pts <= t)
+            group++;
+        memset(&entry, 0, sizeof(entry));
+        entry.Sector = mux->groups[group].sector;
+        entry.Sectors = mux->groups[group].sectors;
+        if (fwrite(&entry, sizeof(entry), 1, mux->file) != 1)
+            return -1;
+    }
+
+    bytes = (uint64_t)entries * sizeof(entry);
+    if (bytes % NTV_SECTOR_SIZE)
+        fwrite(blank, 1, NTV_SECTOR_SIZE - bytes % NTV_SECTOR_SIZE, mux->file);
+    mux->header.IndexEntries = entries;
+    mux->stats.file_bytes += (bytes + NTV_SECTOR_SIZE - 1) / NTV_SECTOR_SIZE * NTV_SECTOR_SIZE;
+    return 0;
+}
+
+int ntv_mux_close(ntv_mux_t *mux, ntv_mux_stats_t *stats)
+{
+    uint8_t sector[NTV_SECTOR_SIZE] = {0};
+    Ntv_Header_t *header = &mux->header;
+    uint64_t video_ms = (uint64_t)(mux->frame + 1) * header->FrameUs / 1000;
+    uint64_t audio_ms = header->AudioRate ? mux->audio_pos * 1000 / header->AudioRate : 0;
+    int ret = mux->failed ? -1 : 0;
+
+    if (ret == 0)
+        ret = write_pending(mux, 0);
+
+    header->Magic = NTV_MAGIC;
+    header->Version = NTV_VERSION;
+    header->HeaderSize = sizeof(Ntv_Header_t);
+    header->Frames = (uint32_t)(mux->frame + 1);
+    header->AudioSamples = (uint32_t)mux->audio_pos;
+    header->DurationMs = (uint32_t)(video_ms > audio_ms ? video_ms : audio_ms);
+    header->DataSector = 1;
+    header->MaxSectors = (uint16_t)mux->stats.sectors_max;
+
+    if (ret == 0 && header->FirstSectors == 0)
+    {
+        fprintf(stderr, "no chunks\n");
+        ret = -1;
+    }
+    if (ret == 0 && write_index(mux) != 0)
+        ret = -1;
+
+    memcpy(sector, header, sizeof(*header));
+    if (ret == 0 && (fseek(mux->file, 0, SEEK_SET) != 0 || fwrite(sector, 1, sizeof(sector), mux->file) != sizeof(sector)))
+        ret = -1;
+    if (fclose(mux->file) != 0)
+        ret = -1;
+
+    if (stats != NULL)
+        *stats = mux->stats;
+    free(mux->pending);
+    free(mux->packed);
+    free(mux->groups);
+    free(mux);
+    return ret;
+}
@@ -0,0 +1,59 @@
+/**
+ * @file ntv_mux.h
+ * @brief Writer for the NanoTV container, see Include/Ntv.h for the layout.
+ *
+ * Usage: fill an Ntv_Header_t with the stream parameters (Width, Height,
+ * Codec, CodecFlags, FrameUs, AudioRate, AudioChannels, AudioBits,
+ * MaxSectors, IndexPeriodMs), open, then for every video frame call
+ * ntv_mux_frame(), hand over the audio that plays during the frame and the
+ * video slices. Chunks are written one behind, once the size of the next one
+ * is known; ntv_mux_close() appends the index and writes the header.
+ */
+
+#ifndef NTV_MUX_H
+#define NTV_MUX_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "Ntv.h"
+
+typedef struct ntv_mux ntv_mux_t;
+
+typedef struct
+{
+    uint32_t video_chunks;
+    uint32_t audio_chunks;
+    uint64_t video_bytes;   /* payload */
+    uint64_t video_raw;     /* payload before LZ4 */
+    uint32_t lz4_chunks;
+    uint64_t audio_bytes;
+    uint64_t file_bytes;
+    uint32_t sectors_max;
+} ntv_mux_stats_t;
+
+/* NULL on error, the reason is printed */
+ntv_mux_t *ntv_mux_open(const char *path, const Ntv_Header_t *params);
+
+/* start the next video frame; a key frame becomes a seek point */
+int ntv_mux_frame(ntv_mux_t *mux, int key);
+
+/* interleaved samples that play from the current audio position on; split to fit the chunks */
+int ntv_mux_audio(ntv_mux_t *mux, const void *samples, uint32_t frames);
+
+/* one slice of the current frame, size at most ntv_mux_max_payload() */
+int ntv_mux_video(ntv_mux_t *mux, uint16_t line, uint16_t lines, const void *data, uint32_t size, int frame_end);
+
+uint32_t ntv_mux_max_payload(const ntv_mux_t *mux);
+
+/* LZ4 video chunks from now on (NTV_CHUNK_LZ4), level as ntv_lz4_compress(), -1 for none;
+   a chunk is packed only when that saves a sector. The player needs NTV_LZ4_BUFFER. */
+void ntv_mux_set_lz4(ntv_mux_t *mux, int level);
+
+/* running totals, file_bytes lags one chunk behind */
+void ntv_mux_get_stats(const ntv_mux_t *mux, ntv_mux_stats_t *stats);
+
+/* finish the file; 0 on success, the mux is freed either way */
+int ntv_mux_close(ntv_mux_t *mux, ntv_mux_stats_t *stats);
+
+#endif
@@ -0,0 +1,1391 @@
+/**
+ * @file ntvenc.c
+ * @brief Transcodes video into NanoTV containers (.ntv) that play on the device as they are.
+ *
+ * Build on Linux from this directory:
+ *   gcc -O2 -I../../Include ntvenc.c ntv_mux.c ntv_lz4.c -lm -o ntvenc
+ *
+ * Any file ffmpeg reads (ffmpeg must be on the PATH):
+ *   ./ntvenc [options] movie.mp4 out.ntv
+ * Raw input, RGB24 frames and signed 16-bit little-endian PCM:
+ *   ./ntvenc [options] -V 320x240@30 [-A audio.pcm -R 44100 -C 2] video.rgb24 out.ntv
+ *
+ * Options:
+ *   -r fps        output frame rate (25)
+ *   -q codec      video codec: raw565, tile, pal8, pal4
+ *   -k seconds    key frame period of the tile and palette codecs (2)
+ *   -T level      tile codec tolerance, 8-bit levels per channel (8), 0 is lossless
+ *   -d dither     palette codecs: ordered, fs (Floyd-Steinberg) or none (ordered)
+ *   -z level      LZ4 video chunks that get a sector smaller, level 0..6; the player
+ *                 needs NTV_LZ4_BUFFER
+ *   -c 1|2        audio channels (2), -n for no audio
+ *   -t seconds    stop after this much
+ *   -m sectors    largest chunk, at most NTV_BUFFER_SECTORS of the firmware (64)
+ *   -i ms         seek index period (500)
+ *   -b KB/s       card budget the stream is checked against (SD_BUDGET_KBPS)
+ *
+ * The picture is scaled to the panel (LCD_WIDTH x LCD_HEIGHT) keeping its
+ * aspect ratio, black bars fill the rest. RGB565 is made with the 4x4 ordered
+ * dither of ColorConv, so a still picture looks the same as the UI draws it.
+ * Audio is resampled to the rate I2S2 really runs at: MX_I2S2_Init() asks for
+ * 68000 Hz, 16-bit Philips, and HAL_I2S_Init() gets the closest divider from
+ * the 16 MHz SYSCLK, 16 MHz / (32 * 7) = 71428.6 Hz.
+ *
+ * The tile codec (NTV_CODEC_TILE, decoded by TileDelta) sends only the 8x8
+ * tiles that differ from what the panel already shows by more than -T, as a
+ * colour, run lengths or raw pixels. A key frame sends every tile.
+ *
+ * The palette codecs (NTV_CODEC_PAL8/PAL4, decoded by Palette) send one byte
+ * or half a byte per pixel. The palette is made by median cut and a few
+ * k-means passes over a 15-bit histogram of the frame; it is kept for the
+ * scene, a new one is made when the current one fits the picture clearly
+ * worse than when it was made, or a key frame is due. Ordered dither ties the
+ * pattern to the screen position like ColorConv, so it does not crawl;
+ * Floyd-Steinberg is finer on stills but changes every frame.
+ *
+ * At the end the stream rate, average and worst one-second window, is set
+ * against the card budget; when it does not fit, lower the frame rate, use
+ * mono or a compressing codec.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "LCD.h"
+#include "TileDelta.h"
+#include "ntv_mux.h"
+
+/* I2S2 sample rate: SYSCLK / (32 * (2 * I2SDIV + ODD)), see the header comment */
+#define I2S_RATE (16000000.0 / (32.0 * 7.0))
+
+/* Highest stall-free stream rate sdbench measured with the fast card profile (KB/s) */
+#define SD_BUDGET_KBPS 780
+
+/* An unchanged tile between two changed ones is sent anyway when it costs at most this: one address window less */
+#define TILE_GAP_BYTES 34
+
+/* Largest coded tile: RAW, RLE is only used when smaller */
+#define TILE_SLOT (TILEDELTA_SIZE * TILEDELTA_SIZE * 2)
+
+#define DITHER_NONE 0
+#define DITHER_ORDERED 1
+#define DITHER_FS 2
+
+/* A new palette is made when the current one fits this much worse than when it was made (scene cut) */
+#define PALETTE_ERROR_GROWTH 1.5
+#define PALETTE_ERROR_SLACK 16.0
+
+typedef struct encoder encoder_t;
+
+typedef struct
+{
+    const char *name;
+    uint8_t codec;
+    int intra; /* every frame is a key frame */
+    /* whether a frame is a key frame, 'due' when the key period says so; NULL: when due */
+    int (*is_key)(encoder_t *enc, const uint8_t *rgb, int due);
+    /* mux the video chunks of one panel-sized RGB24 frame */
+    int (*encode)(encoder_t *enc, const uint8_t *rgb, int key);
+} codec_t;
+
+struct encoder
+{
+    ntv_mux_t *mux;
+    const codec_t *codec;
+    uint16_t width;
+    uint16_t height;
+    uint32_t frame;
+    uint16_t *pixels; /* quantized frame */
+
+    /* tile codec */
+    int tolerance;        /* 8-bit levels */
+    uint16_t *reference;  /* what the panel shows */
+    uint8_t *types;       /* per tile, TILEDELTA_xxx */
+    uint16_t *bytes;      /* coded size per tile */
+    uint8_t *tiles;       /* coded data, TILE_SLOT bytes per tile */
+    uint8_t *payload;
+
+    /* palette codecs */
+    int dither;           /* DITHER_xxx */
+    uint16_t palette[256];
+    int colors;
+    int palette_new;      /* goes out with the next frame */
+    double palette_error; /* mean squared error when it was made */
+    float palette_step;   /* mean distance to the nearest other colour */
+    int16_t *nearest;     /* 6-bit RGB -> palette index, -1 unknown */
+    float *diffusion;     /* Floyd-Steinberg error, two lines */
+    uint8_t *indices;
+};
+
+typedef struct
+{
+    FILE *file;
+    pid_t ffmpeg;         /* reading from ffmpeg, 0 for a plain file */
+    uint32_t width;
+    uint32_t height;
+    double fps;           /* raw input only */
+    uint8_t *frame;       /* last frame read */
+    int64_t index;        /* its number, -1 before the first */
+    int eof;
+} video_in_t;
+
+typedef struct
+{
+    FILE *file;
+    pid_t ffmpeg;         /* reading from ffmpeg, 0 for a plain file */
+    uint32_t rate;
+    uint32_t channels;
+    float *buf;           /* stereo pairs from source sample base on */
+    size_t count;
+    size_t cap;
+    uint64_t base;
+    int eof;
+} audio_in_t;
+
+/* ---------------------------------------------------------------- video */
+
+static int video_next(video_in_t *in)
+{
+    size_t bytes = (size_t)in->width * in->height * 3;
+
+    if (in->eof || fread(in->frame, 1, bytes, in->file) != bytes)
+    {
+        in->eof = 1;
+        return -1;
+    }
+    in->index++;
+    return 0;
+}
+
+/* the source frame shown at output frame k (raw input converts the frame rate by dropping/repeating) */
+static int video_frame_at(video_in_t *in, uint32_t k, double out_fps)
+{
+    int64_t want = (in->fps > 0.0) ? (int64_t)floor(k * in->fps / out_fps + 1e-6) : (int64_t)k;
+
+    while (in->index < want)
+    {
+        if (video_next(in) != 0)
+            return -1;
+    }
+    return 0;
+}
+
+/* separable resampling with a tent filter widened to the scale factor */
+typedef struct
+{
+    int first;
+    int taps;
+    float *weights;
+} filter_t;
+
+static filter_t *make_filter(int src, int dst)
+{
+    filter_t *filter = calloc((size_t)dst, sizeof(*filter));
+    double scale = (double)src / dst;
+    double radius = scale > 1.0 ? scale : 1.0;
+    int i, t;
+
+    for (i = 0; filter != NULL && i < dst; i++)
+    {
+        double center = (i + 0.5) * scale - 0.5;
+        int first = (int)ceil(center - radius);
+        int last = (int)floor(center + radius);
+        double sum = 0.0;
+
+        filter[i].first = first;
+        filter[i].taps = last - first + 1;
+        filter[i].weights = calloc((size_t)filter[i].taps, sizeof(float));
+        for (t = 0; t < filter[i].taps; t++)
+        {
+            double w = 1.0 - fabs(first + t - center) / radius;
+
+            filter[i].weights[t] = (float)(w > 0.0 ? w : 0.0);
+            sum += filter[i].weights[t];
+        }
+        for (t = 0; t < filter[i].taps; t++)
+            filter[i].weights[t] = (float)(filter[i].weights[t] / sum);
+    }
+    return filter;
+}
+
+static void free_filter(filter_t *filter, int count)
+{
+    int i;
+
+    for (i = 0; filter != NULL && i < count; i++)
+        free(filter[i].weights);
+    free(filter);
+}
+
+typedef struct
+{
+    int src_w, src_h;
+    int dst_w, dst_h;     /* picture inside the panel */
+    int off_x, off_y;     /* black bars */
+    filter_t *fx, *fy;
+    float *tmp;           /* horizontally scaled rows */
+} scaler_t;
+
+static int scaler_init(scaler_t *s, int src_w, int src_h, int panel_w, int panel_h)
+{
+    memset(s, 0, sizeof(*s));
+    s->src_w = src_w;
+    s->src_h = src_h;
+    if ((long)src_w * panel_h > (long)src_h * panel_w)
+    {
+        s->dst_w = panel_w;
+        s->dst_h = (int)((long)src_h * panel_w / src_w);
+    }
+    else
+    {
+        s->dst_h = panel_h;
+        s->dst_w = (int)((long)src_w * panel_h / src_h);
+    }
+    if (s->dst_w < 1)
+        s->dst_w = 1;
+    if (s->dst_h < 1)
+        s->dst_h = 1;
+    s->off_x = (panel_w - s->dst_w) / 2;
+    s->off_y = (panel_h - s->dst_h) / 2;
+    s->fx = make_filter(src_w, s->dst_w);
+    s->fy = make_filter(src_h, s->dst_h);
+    s->tmp = malloc((size_t)s->dst_w * src_h * 3 * sizeof(float));
+    return (s->fx && s->fy && s->tmp) ? 0 : -1;
+}
+
+static void scaler_free(scaler_t *s)
+{
+    free_filter(s->fx, s->dst_w);
+    free_filter(s->fy, s->dst_h);
+    free(s->tmp);
+}
+
+static void scale_frame(const scaler_t *s, const uint8_t *src, uint8_t *dst, int panel_w, int panel_h)
+{
+    int x, y, t, c;
+
+    memset(dst, 0, (size_t)panel_w * panel_h * 3);
+    for (y = 0; y < s->src_h; y++)
+    {
+        for (x = 0; x < s->dst_w; x++)
+        {
+            const filter_t *f = &s->fx[x];
+            float acc[3] = {0.0f, 0.0f, 0.0f};
+
+            for (t = 0; t < f->taps; t++)
+            {
+                int sx = f->first + t;
+                const uint8_t *p;
+
+                sx = sx < 0 ? 0 : (sx >= s->src_w ? s->src_w - 1 : sx);
+                p = &src[((size_t)y * s->src_w + sx) * 3];
+                for (c = 0; c < 3; c++)
+                    acc[c] += f->weights[t] * p[c];
+            }
+            for (c = 0; c < 3; c++)
+                s->tmp[((size_t)y * s->dst_w + x) * 3 + c] = acc[c];
+        }
+    }
+    for (y = 0; y < s->dst_h; y++)
+    {
+        const filter_t *f = &s->fy[y];
+
+        for (x = 0; x < s->dst_w; x++)
+        {
+            uint8_t *out = &dst[((size_t)(y + s->off_y) * panel_w + x + s->off_x) * 3];
+
+            for (c = 0; c < 3; c++)
+            {
+                float acc = 0.0f;
+
+                for (t = 0; t < f->taps; t++)
+                {
+                    int sy = f->first + t;
+
+                    sy = sy < 0 ? 0 : (sy >= s->src_h ? s->src_h - 1 : sy);
+                    acc += f->weights[t] * s->tmp[((size_t)sy * s->dst_w + x) * 3 + c];
+                }
+                out[c] = (uint8_t)(acc < 0.0f ? 0 : (acc > 255.0f ? 255 : acc + 0.5f));
+            }
+        }
+    }
+}
+
+/* ---------------------------------------------------------------- codecs */
+
+/* ColorConv: Bayer threshold added with saturation, then cut to 5/6/5 bits */
+static const uint8_t bayer[4][4] = {
+    {0, 8, 2, 10},
+    {12, 4, 14, 6},
+    {3, 11, 1, 9},
+    {15, 7, 13, 5},
+};
+
+static uint16_t dither565(const uint8_t *p, int x, int y)
+{
+    int b = bayer[y & 3][x & 3];
+    int r = p[0] + (b >> 1), g = p[1] + (b >> 2), bl = p[2] + (b >> 1);
+
+    r = r > 255 ? 255 : r;
+    g = g > 255 ? 255 : g;
+    bl = bl > 255 ? 255 : bl;
+    return (uint16_t)(((r & 0xF8) << 8) | ((g & 0xFC) << 3) | (bl >> 3));
+}
+
+static void quantize565(const encoder_t *enc, const uint8_t *rgb, uint16_t *out)
+{
+    int x, y;
+
+    for (y = 0; y < enc->height; y++)
+    {
+        for (x = 0; x < enc->width; x++)
+            out[(size_t)y * enc->width + x] = dither565(&rgb[((size_t)y * enc->width + x) * 3], x, y);
+    }
+}
+
+/* whole frames in equal slices of whole lines, as few as fit a chunk */
+static int encode_raw565(encoder_t *enc, const uint8_t *rgb, int key)
+{
+    size_t line_bytes = (size_t)enc->width * 2;
+    uint32_t slice = ntv_mux_max_payload(enc->mux) / line_bytes;
+    uint32_t slices, line, lines;
+
+    (void)key;
+    if (slice == 0)
+        return -1;
+    slices = (enc->height + slice - 1) / slice;
+    slice = (enc->height + slices - 1) / slices;
+
+    quantize565(enc, rgb, enc->pixels);
+    for (line = 0; line < enc->height; line += lines)
+    {
+        lines = (enc->height - line < slice) ? enc->height - line : slice;
+        if (ntv_mux_video(enc->mux, (uint16_t)line, (uint16_t)lines, enc->pixels + (size_t)line * enc->width,
+                          (uint32_t)(lines * line_bytes), line + lines == enc->height) != 0)
+            return -1;
+    }
+    return 0;
+}
+
+/* largest channel difference of two RGB565 colours, in 8-bit levels */
+static int diff565(uint16_t a, uint16_t b)
+{
+    int r = abs((a >> 11) - (b >> 11)) << 3;
+    int g = abs(((a >> 5) & 0x3F) - ((b >> 5) & 0x3F)) << 2;
+    int bl = abs((a & 0x1F) - (b & 0x1F)) << 3;
+
+    return r > g ? (r > bl ? r : bl) : (g > bl ? g : bl);
+}
+
+static void tile_get(const encoder_t *enc, const uint16_t *frame, uint32_t tile, uint16_t *out)
+{
+    uint32_t columns = enc->width / TILEDELTA_SIZE;
+    size_t x0 = (size_t)(tile % columns) * TILEDELTA_SIZE, y0 = (size_t)(tile / columns) * TILEDELTA_SIZE;
+    int y;
+
+    for (y = 0; y < TILEDELTA_SIZE; y++)
+        memcpy(&out[y * TILEDELTA_SIZE], &frame[(y0 + y) * enc->width + x0], TILEDELTA_SIZE * sizeof(uint16_t));
+}
+
+static void tile_put(const encoder_t *enc, uint16_t *frame, uint32_t tile, const uint16_t *in)
+{
+    uint32_t columns = enc->width / TILEDELTA_SIZE;
+    size_t x0 = (size_t)(tile % columns) * TILEDELTA_SIZE, y0 = (size_t)(tile / columns) * TILEDELTA_SIZE;
+    int y;
+
+    for (y = 0; y < TILEDELTA_SIZE; y++)
+        memcpy(&frame[(y0 + y) * enc->width + x0], &in[y * TILEDELTA_SIZE], TILEDELTA_SIZE * sizeof(uint16_t));
+}
+
+/* code one tile as the cheapest of SKIP (unless forced), SOLID, RLE and RAW; px becomes what the panel will show */
+static uint8_t tile_code(encoder_t *enc, uint32_t tile, int force, uint16_t *px)
+{
+    const int n = TILEDELTA_SIZE * TILEDELTA_SIZE;
+    uint8_t *out = &enc->tiles[(size_t)tile * TILE_SLOT];
+    uint16_t ref[TILEDELTA_SIZE * TILEDELTA_SIZE];
+    uint16_t solid;
+    long sum[3] = {0, 0, 0};
+    int worst = 0, runs = 1, i, j;
+
+    tile_get(enc, enc->reference, tile, ref);
+    for (i = 0; i < n; i++)
+    {
+        int d = diff565(px[i], ref[i]);
+
+        worst = d > worst ? d : worst;
+        sum[0] += px[i] >> 11;
+        sum[1] += (px[i] >> 5) & 0x3F;
+        sum[2] += px[i] & 0x1F;
+        if (i > 0 && px[i] != px[i - 1])
+            runs++;
+    }
+    if (!force && worst <= enc->tolerance)
+    {
+        enc->bytes[tile] = 0;
+        memcpy(px, ref, sizeof(ref));
+        return TILEDELTA_SKIP;
+    }
+
+    solid = (uint16_t)(((sum[0] + n / 2) / n) << 11 | ((sum[1] + n / 2) / n) << 5 | ((sum[2] + n / 2) / n));
+    for (i = 0, worst = 0; i < n; i++)
+    {
+        int d = diff565(px[i], solid);
+
+        worst = d > worst ? d : worst;
+    }
+    if (worst <= enc->tolerance)
+    {
+        memcpy(out, &solid, sizeof(solid));
+        enc->bytes[tile] = sizeof(solid);
+        for (i = 0; i < n; i++)
+            px[i] = solid;
+        return TILEDELTA_SOLID;
+    }
+
+    if (((runs + 2) & ~1) + runs * 2 < TILE_SLOT)
+    {
+        uint16_t *colors = (uint16_t *)&out[(runs + 2) & ~1];
+
+        out[0] = (uint8_t)runs;
+        for (i = 0, j = 0; i < n; j++)
+        {
+            int len = 1;
+
+            while (i + len < n && px[i + len] == px[i])
+                len++;
+            out[1 + j] = (uint8_t)(len - 1);
+            colors[j] = px[i];
+            i += len;
+        }
+        if ((runs & 1) == 0)
+            out[1 + runs] = 0; /* padding */
+        enc->bytes[tile] = (uint16_t)(((runs + 2) & ~1) + runs * 2);
+        return TILEDELTA_RLE;
+    }
+
+    memcpy(out, px, TILE_SLOT);
+    enc->bytes[tile] = TILE_SLOT;
+    return TILEDELTA_RAW;
+}
+
+static uint32_t tile_map_bytes(uint32_t tiles)
+{
+    return ((tiles + 3) / 4 + 1) & ~1U;
+}
+
+/* slice of tile rows [first, last) */
+static int tile_emit(encoder_t *enc, uint32_t first, uint32_t last, int frame_end)
+{
+    uint32_t columns = enc->width / TILEDELTA_SIZE;
+    uint32_t tiles = (last - first) * columns;
+    uint32_t size = tile_map_bytes(tiles), t;
+
+    memset(enc->payload, 0, size);
+    for (t = 0; t < tiles; t++)
+    {
+        uint32_t tile = first * columns + t;
+
+        enc->payload[t / 4] |= (uint8_t)(enc->types[tile] << ((t % 4) * 2));
+        memcpy(&enc->payload[size], &enc->tiles[(size_t)tile * TILE_SLOT], enc->bytes[tile]);
+        size += enc->bytes[tile];
+    }
+    return ntv_mux_video(enc->mux, (uint16_t)(first * TILEDELTA_SIZE), (uint16_t)((last - first) * TILEDELTA_SIZE),
+                         enc->payload, size, frame_end);
+}
+
+/* changed tiles against the panel, in slices of changed tile rows */
+static int encode_tile(encoder_t *enc, const uint8_t *rgb, int key)
+{
+    uint32_t columns = enc->width / TILEDELTA_SIZE, rows = enc->height / TILEDELTA_SIZE;
+    uint32_t tiles = columns * rows, max = ntv_mux_max_payload(enc->mux);
+    uint32_t slices[TILEDELTA_ROWS + 1][2];
+    uint32_t count = 0, row, col, t;
+    uint16_t px[TILEDELTA_SIZE * TILEDELTA_SIZE];
+
+    if (enc->width % TILEDELTA_SIZE != 0 || enc->height % TILEDELTA_SIZE != 0 || rows > TILEDELTA_ROWS)
+        return -1;
+    if (enc->reference == NULL)
+    {
+        enc->reference = calloc((size_t)enc->width * enc->height, sizeof(uint16_t));
+        enc->types = calloc(tiles, 1);
+        enc->bytes = calloc(tiles, sizeof(uint16_t));
+        enc->tiles = malloc((size_t)tiles * TILE_SLOT);
+        enc->payload = malloc(max);
+        if (enc->reference == NULL || enc->types == NULL || enc->bytes == NULL || enc->tiles == NULL ||
+            enc->payload == NULL)
+            return -1;
+    }
+
+    quantize565(enc, rgb, enc->pixels);
+    for (t = 0; t < tiles; t++)
+    {
+        tile_get(enc, enc->pixels, t, px);
+        enc->types[t] = tile_code(enc, t, key, px);
+        tile_put(enc, enc->pixels, t, px);
+    }
+
+    /* close single-tile gaps that are cheap, so the row goes out in one window */
+    for (t = 0; t < tiles; t++)
+    {
+        col = t % columns;
+        if (enc->types[t] != TILEDELTA_SKIP || col == 0 || col + 1 == columns ||
+            enc->types[t - 1] == TILEDELTA_SKIP || enc->types[t + 1] == TILEDELTA_SKIP)
+            continue;
+        tile_get(enc, enc->pixels, t, px);
+        enc->types[t] = tile_code(enc, t, 1, px);
+        if (enc->bytes[t] > TILE_GAP_BYTES)
+        {
+            enc->types[t] = TILEDELTA_SKIP;
+            enc->bytes[t] = 0;
+            continue;
+        }
+        tile_put(enc, enc->pixels, t, px);
+    }
+
+    /* runs of changed tile rows, cut where a chunk is full */
+    for (row = 0; row < rows;)
+    {
+        uint32_t first = row, data = 0;
+
+        for (; row < rows; row++)
+        {
+            uint32_t bytes = 0, changed = 0;
+
+            for (col = 0; col < columns; col++)
+            {
+                bytes += enc->bytes[row * columns + col];
+                changed |= enc->types[row * columns + col] != TILEDELTA_SKIP;
+            }
+            if (!changed)
+                break;
+            if (tile_map_bytes((row + 1 - first) * columns) + data + bytes > max)
+            {
+                if (row == first)
+                    return -1;
+                break;
+            }
+            data += bytes;
+        }
+        if (row > first)
+        {
+            slices[count][0] = first;
+            slices[count][1] = row;
+            count++;
+        }
+        else
+        {
+            row++;
+        }
+    }
+
+    for (t = 0; t < count; t++)
+    {
+        if (tile_emit(enc, slices[t][0], slices[t][1], t + 1 == count) != 0)
+            return -1;
+    }
+    if (count == 0 && ntv_mux_video(enc->mux, 0, 0, enc->payload, 0, 1) != 0)
+        return -1;
+
+    /* the panel now shows the coded frame */
+    memcpy(enc->reference, enc->pixels, (size_t)enc->width * enc->height * sizeof(uint16_t));
+    return 0;
+}
+
+static void expand565(uint16_t c, int *rgb)
+{
+    rgb[0] = ((c >> 11) << 3) | (c >> 13);
+    rgb[1] = (((c >> 5) & 0x3F) << 2) | ((c >> 9) & 0x03);
+    rgb[2] = ((c & 0x1F) << 3) | ((c >> 2) & 0x07);
+}
+
+static int palette_nearest(encoder_t *enc, int r, int g, int b)
+{
+    int key = ((r >> 2) << 12) | ((g >> 2) << 6) | (b >> 2);
+    int best = 0, i;
+    long best_d = -1;
+
+    if (enc->nearest[key] >= 0)
+        return enc->nearest[key];
+    /* the centre of the 6-bit cell stands for it */
+    r = (r & ~3) | 2;
+    g = (g & ~3) | 2;
+    b = (b & ~3) | 2;
+    for (i = 0; i < enc->colors; i++)
+    {
+        int p[3];
+        long d;
+
+        expand565(enc->palette[i], p);
+        d = (long)(r - p[0]) * (r - p[0]) + (long)(g - p[1]) * (g - p[1]) + (long)(b - p[2]) * (b - p[2]);
+        if (best_d < 0 || d < best_d)
+        {
+            best_d = d;
+            best = i;
+        }
+    }
+    enc->nearest[key] = (int16_t)best;
+    return best;
+}
+
+/* mean squared error of the frame against the palette, no dither, every 4th pixel both ways */
+static double palette_error(encoder_t *enc, const uint8_t *rgb)
+{
+    double sum = 0.0;
+    long count = 0;
+    int x, y, c;
+
+    for (y = 0; y < enc->height; y += 4)
+    {
+        for (x = 0; x < enc->width; x += 4)
+        {
+            const uint8_t *p = &rgb[((size_t)y * enc->width + x) * 3];
+            int q[3];
+
+            expand565(enc->palette[palette_nearest(enc, p[0], p[1], p[2])], q);
+            for (c = 0; c < 3; c++)
+                sum += (double)(p[c] - q[c]) * (p[c] - q[c]);
+            count++;
+        }
+    }
+    return sum / (count * 3);
+}
+
+typedef struct
+{
+    uint32_t count;
+    double sum[3];
+} bin_t;
+
+static bin_t *sort_bins;
+static int sort_channel;
+
+static int compare_bins(const void *a, const void *b)
+{
+    const bin_t *x = &sort_bins[*(const int *)a], *y = &sort_bins[*(const int *)b];
+    double mx = x->sum[sort_channel] / x->count, my = y->sum[sort_channel] / y->count;
+
+    return (mx > my) - (mx < my);
+}
+
+/* median cut over the 15-bit histogram, then k-means passes over the same bins */
+static void palette_make(encoder_t *enc, const uint8_t *rgb, int colors)
+{
+    static bin_t bins[32768];
+    static int order[32768];
+    int box_start[257], box_end[257], boxes = 1, used = 0, i, j, c, pass;
+    double means[256][3];
+    size_t n = (size_t)enc->width * enc->height, k;
+
+    memset(bins, 0, sizeof(bins));
+    for (k = 0; k < n; k++)
+    {
+        const uint8_t *p = &rgb[k * 3];
+        bin_t *bin = &bins[((p[0] >> 3) << 10) | ((p[1] >> 3) << 5) | (p[2] >> 3)];
+
+        bin->count++;
+        for (c = 0; c < 3; c++)
+            bin->sum[c] += p[c];
+    }
+    for (i = 0; i < 32768; i++)
+    {
+        if (bins[i].count > 0)
+            order[used++] = i;
+    }
+
+    box_start[0] = 0;
+    box_end[0] = used;
+    while (boxes < colors)
+    {
+        double best_score = 0.0, lo[3], hi[3];
+        int best = -1, channel = 0;
+        uint64_t total = 0, half = 0;
+
+        /* split the box with the most pixels times colour range */
+        for (i = 0; i < boxes; i++)
+        {
+            double score, range = 0.0;
+            uint64_t count = 0;
+            int ch = 0;
+
+            if (box_end[i] - box_start[i] < 2)
+                continue;
+            for (c = 0; c < 3; c++)
+            {
+                lo[c] = 255.0;
+                hi[c] = 0.0;
+            }
+            for (j = box_start[i]; j < box_end[i]; j++)
+            {
+                const bin_t *bin = &bins[order[j]];
+
+                for (c = 0; c < 3; c++)
+                {
+                    double m = bin->sum[c] / bin->count;
+
+                    lo[c] = m < lo[c] ? m : lo[c];
+                    hi[c] = m > hi[c] ? m : hi[c];
+                }
+                count += bin->count;
+            }
+            for (c = 0; c < 3; c++)
+            {
+                if (hi[c] - lo[c] > range)
+                {
+                    range = hi[c] - lo[c];
+                    ch = c;
+                }
+            }
+            score = range * (double)count;
+            if (score > best_score)
+            {
+                best_score = score;
+                best = i;
+                channel = ch;
+            }
+        }
+        if (best < 0)
+            break;
+
+        sort_bins = bins;
+        sort_channel = channel;
+        qsort(&order[box_start[best]], (size_t)(box_end[best] - box_start[best]), sizeof(int), compare_bins);
+        for (j = box_start[best]; j < box_end[best]; j++)
+            total += bins[order[j]].count;
+        for (j = box_start[best]; j < box_end[best] - 1; j++)
+        {
+            half += bins[order[j]].count;
+            if (half * 2 >= total)
+                break;
+        }
+        box_start[boxes] = j + 1;
+        box_end[boxes] = box_end[best];
+        box_end[best] = j + 1;
+        boxes++;
+    }
+
+    for (i = 0; i < boxes; i++)
+    {
+        double sum[3] = {0.0, 0.0, 0.0}, count = 0.0;
+
+        for (j = box_start[i]; j < box_end[i]; j++)
+        {
+            for (c = 0; c < 3; c++)
+                sum[c] += bins[order[j]].sum[c];
+            count += bins[order[j]].count;
+        }
+        for (c = 0; c < 3; c++)
+            means[i][c] = count > 0.0 ? sum[c] / count : 0.0;
+    }
+
+    for (pass = 0; pass < 4; pass++)
+    {
+        double sum[256][3], count[256];
+
+        memset(sum, 0, sizeof(sum));
+        memset(count, 0, sizeof(count));
+        for (j = 0; j < used; j++)
+        {
+            const bin_t *bin = &bins[order[j]];
+            double best_d = -1.0, m[3];
+            int best = 0;
+
+            for (c = 0; c < 3; c++)
+                m[c] = bin->sum[c] / bin->count;
+            for (i = 0; i < boxes; i++)
+            {
+                double d = 0.0;
+
+                for (c = 0; c < 3; c++)
+                    d += (m[c] - means[i][c]) * (m[c] - means[i][c]);
+                if (best_d < 0.0 || d < best_d)
+                {
+                    best_d = d;
+                    best = i;
+                }
+            }
+            for (c = 0; c < 3; c++)
+                sum[best][c] += bin->sum[c];
+            count[best] += bin->count;
+        }
+        for (i = 0; i < boxes; i++)
+        {
+            for (c = 0; c < 3; c++)
+                means[i][c] = count[i] > 0.0 ? sum[i][c] / count[i] : means[i][c];
+        }
+    }
+
+    for (i = 0; i < boxes; i++)
+    {
+        int r = (int)lrint(means[i][0] * 31.0 / 255.0), g = (int)lrint(means[i][1] * 63.0 / 255.0);
+        int b = (int)lrint(means[i][2] * 31.0 / 255.0);
+
+        enc->palette[i] = (uint16_t)((r << 11) | (g << 5) | b);
+    }
+    enc->colors = boxes;
+
+    /* the ordered dither spans the gaps between neighbouring colours */
+    enc->palette_step = 0.0f;
+    for (i = 0; i < boxes; i++)
+    {
+        double nearest = -1.0;
+        int p[3], q[3];
+
+        expand565(enc->palette[i], p);
+        for (j = 0; j < boxes; j++)
+        {
+            double d;
+
+            expand565(enc->palette[j], q);
+            d = sqrt((double)(p[0] - q[0]) * (p[0] - q[0]) + (double)(p[1] - q[1]) * (p[1] - q[1]) +
+                     (double)(p[2] - q[2]) * (p[2] - q[2]));
+            if (j != i && d > 0.0 && (nearest < 0.0 || d < nearest))
+                nearest = d;
+        }
+        enc->palette_step += (float)(nearest > 0.0 ? nearest : 0.0) / boxes;
+    }
+    memset(enc->nearest, 0xFF, (size_t)(1 << 18) * sizeof(int16_t));
+}
+
+static int palette_is_key(encoder_t *enc, const uint8_t *rgb, int due)
+{
+    int colors = (enc->codec->codec == NTV_CODEC_PAL4) ? 16 : 256;
+
+    if (enc->nearest == NULL)
+    {
+        enc->nearest = malloc((size_t)(1 << 18) * sizeof(int16_t));
+        enc->diffusion = calloc((size_t)(enc->width + 2) * 3 * 2, sizeof(float));
+        enc->indices = malloc((size_t)enc->width * enc->height);
+        enc->payload = malloc(ntv_mux_max_payload(enc->mux));
+        if (enc->nearest == NULL || enc->diffusion == NULL || enc->indices == NULL || enc->payload == NULL)
+            return -1;
+    }
+
+    if (!due && enc->colors > 0 &&
+        palette_error(enc, rgb) <= enc->palette_error * PALETTE_ERROR_GROWTH + PALETTE_ERROR_SLACK)
+        return 0;
+
+    palette_make(enc, rgb, colors);
+    enc->palette_error = palette_error(enc, rgb);
+    enc->palette_new = 1;
+    return 1;
+}
+
+/* indices of the frame, dithered */
+static void palette_map(encoder_t *enc, const uint8_t *rgb)
+{
+    float step = enc->palette_step;
+    int x, y, c;
+
+    memset(enc->diffusion, 0, (size_t)(enc->width + 2) * 3 * 2 * sizeof(float));
+    for (y = 0; y < enc->height; y++)
+    {
+        float *here = &enc->diffusion[(size_t)(y & 1) * (enc->width + 2) * 3 + 3];
+        float *below = &enc->diffusion[(size_t)((y + 1) & 1) * (enc->width + 2) * 3 + 3];
+        int reverse = (enc->dither == DITHER_FS) && (y & 1); /* serpentine */
+        int dx = reverse ? -1 : 1;
+
+        memset(below - 3, 0, (size_t)(enc->width + 2) * 3 * sizeof(float));
+        for (x = reverse ? enc->width - 1 : 0; x >= 0 && x < enc->width; x += dx)
+        {
+            const uint8_t *p = &rgb[((size_t)y * enc->width + x) * 3];
+            float v[3], offset = 0.0f;
+            int q[3], in[3], index;
+
+            if (enc->dither == DITHER_ORDERED)
+                offset = ((bayer[y & 3][x & 3] + 0.5f) / 16.0f - 0.5f) * step;
+            for (c = 0; c < 3; c++)
+            {
+                v[c] = p[c] + offset + here[x * 3 + c];
+                in[c] = (int)lrintf(v[c] < 0.0f ? 0.0f : (v[c] > 255.0f ? 255.0f : v[c]));
+            }
+            index = palette_nearest(enc, in[0], in[1], in[2]);
+            enc->indices[(size_t)y * enc->width + x] = (uint8_t)index;
+
+            if (enc->dither != DITHER_FS)
+                continue;
+            expand565(enc->palette[index], q);
+            for (c = 0; c < 3; c++)
+            {
+                float e = in[c] - q[c];
+
+                here[(x + dx) * 3 + c] += e * 7.0f / 16.0f;
+                below[(x - dx) * 3 + c] += e * 3.0f / 16.0f;
+                below[x * 3 + c] += e * 5.0f / 16.0f;
+                below[(x + dx) * 3 + c] += e * 1.0f / 16.0f;
+            }
+        }
+    }
+}
+
+/* equal slices of whole lines; a new palette goes in front of the first */
+static int encode_palette(encoder_t *enc, const uint8_t *rgb, int key)
+{
+    int bits = (enc->codec->codec == NTV_CODEC_PAL4) ? 4 : 8;
+    uint32_t line_bytes = (uint32_t)enc->width * bits / 8;
+    uint32_t palette_bytes = (uint32_t)(enc->palette_new ? enc->colors * 2 + 3 : 0) & ~3U;
+    uint32_t slice = (ntv_mux_max_payload(enc->mux) - 4 - 512) / line_bytes;
+    uint32_t slices, line, lines, i;
+
+    (void)key;
+    if (slice == 0)
+        return -1;
+    slices = (enc->height + slice - 1) / slice;
+    slice = (enc->height + slices - 1) / slices;
+
+    palette_map(enc, rgb);
+    for (line = 0; line < enc->height; line += lines)
+    {
+        uint8_t *out = enc->payload;
+        uint16_t colors = (uint16_t)(line == 0 && enc->palette_new ? enc->colors : 0);
+        uint32_t header = 4 + (colors ? palette_bytes : 0);
+
+        lines = (enc->height - line < slice) ? enc->height - line : slice;
+        memset(out, 0, header);
+        memcpy(out, &colors, sizeof(colors));
+        memcpy(out + 4, enc->palette, (size_t)colors * 2);
+        for (i = 0; i < lines * enc->width; i++)
+        {
+            uint8_t index = enc->indices[(size_t)line * enc->width + i];
+
+            if (bits == 8)
+                out[header + i] = index;
+            else if (i & 1)
+                out[header + i / 2] |= (uint8_t)(index << 4);
+            else
+                out[header + i / 2] = index;
+        }
+        if (ntv_mux_video(enc->mux, (uint16_t)line, (uint16_t)lines, out, header + lines * line_bytes,
+                          line + lines == enc->height) != 0)
+            return -1;
+    }
+    enc->palette_new = 0;
+    return 0;
+}
+
+static const codec_t codecs[] = {
+    {"raw565", NTV_CODEC_RAW565, 1, NULL, encode_raw565},
+    {"tile", NTV_CODEC_TILE, 0, NULL, encode_tile},
+    {"pal8", NTV_CODEC_PAL8, 0, palette_is_key, encode_palette},
+    {"pal4", NTV_CODEC_PAL4, 0, palette_is_key, encode_palette},
+};
+
+/* ---------------------------------------------------------------- audio */
+
+static int audio_fill(audio_in_t *in, size_t need)
+{
+    int16_t pcm[2 * 1024];
+
+    while (!in->eof && in->count < need)
+    {
+        size_t frames = fread(pcm, in->channels * sizeof(int16_t), 1024, in->file);
+        size_t i;
+
+        if (frames == 0)
+        {
+            in->eof = 1;
+            break;
+        }
+        if (in->count + frames > in->cap)
+        {
+            in->cap = (in->count + frames) * 2;
+            in->buf = realloc(in->buf, in->cap * 2 * sizeof(float));
+            if (in->buf == NULL)
+                return -1;
+        }
+        for (i = 0; i < frames; i++)
+        {
+            float l = pcm[i * in->channels];
+            float r = (in->channels > 1) ? pcm[i * in->channels + 1] : l;
+
+            in->buf[(in->count + i) * 2] = l;
+            in->buf[(in->count + i) * 2 + 1] = r;
+        }
+        in->count += frames;
+    }
+    return 0;
+}
+
+static float audio_sample(const audio_in_t *in, int64_t n, int c)
+{
+    int64_t i = n - (int64_t)in->base;
+
+    if (i < 0)
+        i = 0;
+    if (i >= (int64_t)in->count)
+        return (in->count > 0) ? in->buf[(in->count - 1) * 2 + c] : 0.0f;
+    return in->buf[i * 2 + c];
+}
+
+/* output samples [from, to) at I2S_RATE, cubic Hermite interpolation of the source */
+static uint32_t audio_resample(audio_in_t *in, uint64_t from, uint64_t to, int channels, int16_t *out)
+{
+    double step = in->rate / I2S_RATE;
+    uint64_t n;
+    uint32_t produced = 0;
+    int c;
+
+    if (audio_fill(in, (size_t)((int64_t)(to * step) - (int64_t)in->base + 4)) != 0)
+        return 0;
+
+    for (n = from; n < to; n++)
+    {
+        double t = n * step;
+        int64_t i = (int64_t)floor(t);
+        float f = (float)(t - i);
+        float v[2];
+
+        if (in->eof && i >= (int64_t)(in->base + in->count))
+            break;
+        for (c = 0; c < 2; c++)
+        {
+            float p0 = audio_sample(in, i - 1, c), p1 = audio_sample(in, i, c);
+            float p2 = audio_sample(in, i + 1, c), p3 = audio_sample(in, i + 2, c);
+            float a = -0.5f * p0 + 1.5f * p1 - 1.5f * p2 + 0.5f * p3;
+            float b = p0 - 2.5f * p1 + 2.0f * p2 - 0.5f * p3;
+            float d = -0.5f * p0 + 0.5f * p2;
+
+            v[c] = ((a * f + b) * f + d) * f + p1;
+            v[c] = v[c] > 32767.0f ? 32767.0f : (v[c] < -32768.0f ? -32768.0f : v[c]);
+        }
+        if (channels == 1)
+        {
+            out[produced] = (int16_t)lrintf((v[0] + v[1]) * 0.5f);
+        }
+        else
+        {
+            out[produced * 2] = (int16_t)lrintf(v[0]);
+            out[produced * 2 + 1] = (int16_t)lrintf(v[1]);
+        }
+        produced++;
+    }
+
+    /* keep what the next call can still reach */
+    {
+        int64_t keep_from = (int64_t)floor(to * step) - 2;
+        int64_t drop = keep_from - (int64_t)in->base;
+
+        if (drop > 0 && (size_t)drop <= in->count)
+        {
+            memmove(in->buf, in->buf + drop * 2, (in->count - (size_t)drop) * 2 * sizeof(float));
+            in->count -= (size_t)drop;
+            in->base += (uint64_t)drop;
+        }
+    }
+    return produced;
+}
+
+/* ---------------------------------------------------------------- main */
+
+/* ffmpeg writing to a pipe; exec'd with an argument list, no shell ever sees the file name */
+static FILE *run_ffmpeg(const char *input, const char *const *args, pid_t *pid)
+{
+    const char *argv[32] = {"ffmpeg", "-v", "error", "-nostdin", "-i", input};
+    size_t n = 6;
+    int fds[2];
+    FILE *file = NULL;
+
+    while (*args != NULL && n < sizeof(argv) / sizeof(argv[0]) - 2)
+        argv[n++] = *args++;
+    argv[n++] = "-";
+    argv[n] = NULL;
+
+    /* close-on-exec, or the second ffmpeg would hold the first one's pipe open */
+    if (pipe(fds) != 0)
+        return NULL;
+    fcntl(fds[0], F_SETFD, FD_CLOEXEC);
+    fcntl(fds[1], F_SETFD, FD_CLOEXEC);
+
+    *pid = fork();
+    if (*pid == 0)
+    {
+        dup2(fds[1], STDOUT_FILENO);
+        execvp("ffmpeg", (char *const *)argv);
+        fprintf(stderr, "cannot run ffmpeg\n");
+        _exit(127);
+    }
+    close(fds[1]);
+    if (*pid > 0)
+        file = fdopen(fds[0], "r");
+    if (file == NULL)
+    {
+        close(fds[0]);
+        if (*pid > 0)
+            waitpid(*pid, NULL, 0);
+        *pid = 0;
+    }
+    return file;
+}
+
+static void close_input(FILE *file, pid_t ffmpeg)
+{
+    fclose(file);
+    if (ffmpeg > 0)
+        waitpid(ffmpeg, NULL, 0);
+}
+
+static void usage(void)
+{
+    fprintf(stderr, "usage: ntvenc [-r fps] [-q codec] [-k s] [-T level] [-d dither] [-z level] [-c 1|2] [-n] [-t s] [-m sectors] [-i ms] [-b KB/s] input out.ntv\n"
+                    "       ntvenc [...] -V WxH@fps [-A audio.pcm -R Hz -C channels] video.rgb24 out.ntv\n");
+    exit(2);
+}
+
+int main(int argc, char **argv)
+{
+    video_in_t video = {0};
+    audio_in_t audio = {0};
+    encoder_t enc = {0};
+    scaler_t scaler;
+    Ntv_Header_t params;
+    ntv_mux_stats_t stats;
+    const char *codec_name = "raw565", *raw_audio = NULL, *input, *output;
+    double fps = 25.0, seconds = 0.0, budget = SD_BUDGET_KBPS, peak = 0.0, key_seconds = 2.0;
+    unsigned raw_w = 0, raw_h = 0;
+    double raw_fps = 0.0;
+    int channels = 2, no_audio = 0, lz4_level = -1, opt, key, ret = 0;
+    uint32_t raw_rate = 0, raw_channels = 2, max_frames = 0, per_second, key_every;
+    uint64_t *sizes = NULL, audio_done = 0, audio_due;
+    uint8_t *panel = NULL;
+    int16_t *pcm = NULL;
+    size_t i;
+
+    memset(&params, 0, sizeof(params));
+    enc.tolerance = 8;
+    enc.dither = DITHER_ORDERED;
+    while ((opt = getopt(argc, argv, "r:q:k:T:d:z:c:nt:m:i:b:V:A:R:C:")) != -1)
+    {
+        switch (opt)
+        {
+        case 'r': fps = atof(optarg); break;
+        case 'q': codec_name = optarg; break;
+        case 'k': key_seconds = atof(optarg); break;
+        case 'T': enc.tolerance = atoi(optarg); break;
+        case 'd':
+            enc.dither = !strcmp(optarg, "none") ? DITHER_NONE : !strcmp(optarg, "fs") ? DITHER_FS :
+                         !strcmp(optarg, "ordered") ? DITHER_ORDERED : -1;
+            break;
+        case 'z': lz4_level = atoi(optarg); break;
+        case 'c': channels = atoi(optarg); break;
+        case 'n': no_audio = 1; break;
+        case 't': seconds = atof(optarg); break;
+        case 'm': params.MaxSectors = (uint16_t)strtoul(optarg, NULL, 0); break;
+        case 'i': params.IndexPeriodMs = (uint32_t)strtoul(optarg, NULL, 0); break;
+        case 'b': budget = atof(optarg); break;
+        case 'V':
+            if (sscanf(optarg, "%ux%u@%lf", &raw_w, &raw_h, &raw_fps) != 3 || raw_w == 0 || raw_h == 0 || raw_fps <= 0.0)
+                usage();
+            break;
+        case 'A': raw_audio = optarg; break;
+        case 'R': raw_rate = (uint32_t)strtoul(optarg, NULL, 0); break;
+        case 'C': raw_channels = (uint32_t)strtoul(optarg, NULL, 0); break;
+        default: usage();
+        }
+    }
+    if (optind + 2 != argc || fps <= 0.0 || key_seconds <= 0.0 || enc.tolerance < 0 || enc.dither < 0 || (channels != 1 && channels != 2) || (raw_channels != 1 && raw_channels != 2))
+        usage();
+    input = argv[optind];
+    output = argv[optind + 1];
+
+    for (i = 0; i < sizeof(codecs) / sizeof(codecs[0]); i++)
+    {
+        if (strcmp(codecs[i].name, codec_name) == 0)
+            enc.codec = &codecs[i];
+    }
+    if (enc.codec == NULL)
+    {
+        fprintf(stderr, "unknown codec %s\n", codec_name);
+        return 2;
+    }
+
+    /* inputs: ffmpeg scales and converts the frame rate itself, raw input is done here */
+    if (raw_w > 0)
+    {
+        video.file = fopen(input, "rb");
+        video.width = raw_w;
+        video.height = raw_h;
+        video.fps = raw_fps;
+        if (raw_audio != NULL && !no_audio)
+        {
+            if (raw_rate == 0)
+                usage();
+            audio.file = fopen(raw_audio, "rb");
+            audio.rate = raw_rate;
+            audio.channels = raw_channels;
+            if (audio.file == NULL)
+            {
+                fprintf(stderr, "cannot read %s\n", raw_audio);
+                return 1;
+            }
+        }
+    }
+    else
+    {
+        char filter[160];
+        char rate[32];
+        char sample_rate[16];
+        const char *video_args[] = {"-an", "-vf", filter, "-r", rate, "-f", "rawvideo", "-pix_fmt", "rgb24", NULL};
+        const char *audio_args[] = {"-vn", "-ac", "2", "-ar", sample_rate, "-f", "s16le", NULL};
+
+        snprintf(filter, sizeof(filter),
+                 "scale=%d:%d:force_original_aspect_ratio=decrease:flags=area,pad=%d:%d:(ow-iw)/2:(oh-ih)/2",
+                 LCD_WIDTH, LCD_HEIGHT, LCD_WIDTH, LCD_HEIGHT);
+        snprintf(rate, sizeof(rate), "%g", fps);
+        video.file = run_ffmpeg(input, video_args, &video.ffmpeg);
+        video.width = LCD_WIDTH;
+        video.height = LCD_HEIGHT;
+        if (!no_audio)
+        {
+            /* ffmpeg resamples to the integer rate nearest I2S_RATE, the last step is done here */
+            audio.rate = (uint32_t)lrint(I2S_RATE);
+            audio.channels = 2;
+            snprintf(sample_rate, sizeof(sample_rate), "%u", audio.rate);
+            audio.file = run_ffmpeg(input, audio_args, &audio.ffmpeg);
+        }
+    }
+    if (video.file == NULL)
+    {
+        fprintf(stderr, "cannot read %s\n", input);
+        return 1;
+    }
+
+    video.frame = malloc((size_t)video.width * video.height * 3);
+    video.index = -1;
+    panel = malloc((size_t)LCD_WIDTH * LCD_HEIGHT * 3);
+    enc.width = LCD_WIDTH;
+    enc.height = LCD_HEIGHT;
+    enc.pixels = malloc((size_t)LCD_WIDTH * LCD_HEIGHT * sizeof(uint16_t));
+    if (video.frame == NULL || panel == NULL || enc.pixels == NULL ||
+        scaler_init(&scaler, (int)video.width, (int)video.height, LCD_WIDTH, LCD_HEIGHT) != 0)
+    {
+        fprintf(stderr, "out of memory\n");
+        return 1;
+    }
+
+    params.Width = LCD_WIDTH;
+    params.Height = LCD_HEIGHT;
+    params.Codec = enc.codec->codec;
+    params.FrameUs = (uint32_t)lrint(1e6 / fps);
+    if (audio.file != NULL)
+    {
+        params.AudioRate = (uint32_t)lrint(I2S_RATE);
+        params.AudioChannels = (uint8_t)channels;
+        params.AudioBits = 16;
+        pcm = malloc(((size_t)I2S_RATE + 2) * 2 * sizeof(int16_t));
+    }
+    enc.mux = ntv_mux_open(output, &params);
+    if (enc.mux == NULL)
+        return 1;
+    ntv_mux_set_lz4(enc.mux, lz4_level);
+
+    max_frames = (seconds > 0.0) ? (uint32_t)ceil(seconds * fps) : UINT32_MAX;
+    per_second = (uint32_t)lrint(fps);
+    if (per_second == 0)
+        per_second = 1;
+    key_every = (uint32_t)lrint(key_seconds * fps);
+    if (key_every == 0)
+        key_every = 1;
+
+    for (enc.frame = 0; enc.frame < max_frames; enc.frame++)
+    {
+        if (video_frame_at(&video, enc.frame, fps) != 0)
+            break;
+
+        scale_frame(&scaler, video.frame, panel, LCD_WIDTH, LCD_HEIGHT);
+        key = enc.codec->intra || enc.frame % key_every == 0;
+        if (enc.codec->is_key != NULL && (key = enc.codec->is_key(&enc, panel, key)) < 0)
+        {
+            fprintf(stderr, "out of memory\n");
+            ret = 1;
+            break;
+        }
+        ntv_mux_frame(enc.mux, key);
+
+        /* the audio that plays during this frame goes first */
+        if (audio.file != NULL && pcm != NULL)
+        {
+            audio_due = (uint64_t)floor((enc.frame + 1) * (params.FrameUs / 1e6) * I2S_RATE);
+            while (audio_done < audio_due)
+            {
+                uint64_t to = audio_due - audio_done > (uint64_t)I2S_RATE ? audio_done + (uint64_t)I2S_RATE : audio_due;
+                uint32_t got = audio_resample(&audio, audio_done, to, channels, pcm);
+
+                if (got == 0 || ntv_mux_audio(enc.mux, pcm, got) != 0)
+                    break;
+                audio_done += got;
+            }
+        }
+
+        if (enc.codec->encode(&enc, panel, key) != 0)
+        {
+            fprintf(stderr, "frame %u does not fit a chunk\n", enc.frame);
+            ret = 1;
+            break;
+        }
+
+        if ((enc.frame & 1023) == 0)
+            sizes = realloc(sizes, (enc.frame + 1024) * sizeof(*sizes));
+        ntv_mux_get_stats(enc.mux, &stats);
+        sizes[enc.frame] = stats.file_bytes;
+    }
+
+    if (ntv_mux_close(enc.mux, &stats) != 0)
+        ret = 1;
+    close_input(video.file, video.ffmpeg);
+    if (audio.file != NULL)
+        close_input(audio.file, audio.ffmpeg);
+
+    if (ret == 0 && enc.frame > 0)
+    {
+        double duration = enc.frame / fps;
+        double average = stats.file_bytes / 1024.0 / duration;
+
+        /* worst one-second window */
+        for (i = 0; i < enc.frame; i++)
+        {
+            uint64_t before = (i >= per_second) ? sizes[i - per_second] : 0;
+            double window = (sizes[i] - before) / 1024.0 * fps / per_second;
+
+            if (window > peak)
+                peak = window;
+        }
+
+        printf("%s: %u frames at %g fps (%.1f s), %ux%u %s, audio %s\n", output, enc.frame, fps, duration, LCD_WIDTH,
+               LCD_HEIGHT, enc.codec->name,
+               params.AudioRate ? (channels == 1 ? "mono 16 bit 71429 Hz" : "stereo 16 bit 71429 Hz") : "none");
+        printf("  video %.1f KB/s, audio %.1f KB/s, container %.1f KB/s average, %.1f KB/s worst second\n",
+               stats.video_bytes / 1024.0 / duration, stats.audio_bytes / 1024.0 / duration, average, peak);
+        if (stats.lz4_chunks > 0)
+            printf("  LZ4: %u of %u video chunks, video %.1f KB/s before (%.0f%% saved)\n", stats.lz4_chunks,
+                   stats.video_chunks, stats.video_raw / 1024.0 / duration,
+                   100.0 - stats.video_bytes * 100.0 / stats.video_raw);
+        printf("  card budget %.0f KB/s: %s (%.0f%%)\n", budget, peak <= budget ? "fits" : "TOO FAST",
+               peak * 100.0 / budget);
+        if (peak > budget)
+            printf("  lower -r, use -c 1 or a compressing -q to play at full frame rate\n");
+    }
+
+    scaler_free(&scaler);
+    free(sizes);
+    free(video.frame);
+    free(audio.buf);
+    free(panel);
+    free(enc.pixels);
+    free(enc.reference);
+    free(enc.types);
+    free(enc.bytes);
+    free(enc.tiles);
+    free(enc.payload);
+    free(enc.nearest);
+    free(enc.diffusion);
+    free(enc.indices);
+    free(pcm);
+    return ret;
+}
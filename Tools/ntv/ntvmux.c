@@ -0,0 +1,296 @@
+/**
+ * @file ntvmux.c
+ * @brief Muxes raw RGB565 video and PCM audio into a NanoTV container (.ntv), or checks one.
+ *
+ * Build on Linux from this directory:
+ *   gcc -O2 -I../../Include ntvmux.c ntv_mux.c ntv_lz4.c -o ntvmux
+ *
+ * Mux:
+ *   ./ntvmux -s 240x240 -f 25 [-a audio.pcm -r 71429 -c 2] [-m 64] [-i 500] [-z 2] video.rgb565 out.ntv
+ *     video.rgb565  frames of width x height RGB565 pixels, little-endian
+ *     -a            signed 16-bit little-endian PCM, -c channels interleaved, -r Hz
+ *     -m            largest chunk in sectors, at most the NTV_BUFFER_SECTORS of the firmware
+ *     -i            seek index period (ms)
+ *     -z            LZ4 level for video chunks (ntv_lz4.h), the player needs NTV_LZ4_BUFFER
+ *   Every frame is a key frame (NTV_CODEC_RAW565) and is cut into slices of
+ *   whole lines that fit -m; the audio of a frame goes right before it.
+ *
+ * Check:
+ *   ./ntvmux -t file.ntv
+ *   Walks the chunk chain the way the demuxer does (every chunk announces the
+ *   size of the next), checks sizes, timestamps and that every index entry
+ *   points at a chunk, and prints the stream layout.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "ntv_mux.h"
+
+static int mux_raw(const char *video_path, const char *audio_path, const char *out_path, const Ntv_Header_t *params,
+                   int lz4_level)
+{
+    FILE *video = fopen(video_path, "rb");
+    FILE *audio = NULL;
+    ntv_mux_t *mux = NULL;
+    size_t frame_bytes = (size_t)params->Width * params->Height * 2;
+    size_t line_bytes = (size_t)params->Width * 2;
+    uint8_t *frame = malloc(frame_bytes);
+    int16_t *pcm = NULL;
+    uint32_t frames = 0, slice_lines = 0, slices = 0, line = 0, lines = 0;
+    uint64_t audio_due = 0, audio_done = 0;
+    size_t got = 0;
+    ntv_mux_stats_t stats;
+    int ret = 0;
+
+    if (video == NULL || frame == NULL)
+    {
+        fprintf(stderr, "cannot read %s\n", video_path);
+        return 1;
+    }
+    if (audio_path != NULL && (audio = fopen(audio_path, "rb")) == NULL)
+    {
+        fprintf(stderr, "cannot read %s\n", audio_path);
+        return 1;
+    }
+
+    mux = ntv_mux_open(out_path, params);
+    if (mux == NULL)
+        return 1;
+    ntv_mux_set_lz4(mux, lz4_level);
+
+    /* equal slices of whole lines, as few as fit */
+    slice_lines = ntv_mux_max_payload(mux) / line_bytes;
+    if (slice_lines == 0)
+    {
+        fprintf(stderr, "a line does not fit a chunk\n");
+        ntv_mux_close(mux, NULL);
+        return 1;
+    }
+    slices = (params->Height + slice_lines - 1) / slice_lines;
+    slice_lines = (params->Height + slices - 1) / slices;
+    if (audio != NULL)
+        pcm = malloc((size_t)params->AudioRate * params->AudioChannels * sizeof(int16_t));
+
+    while (fread(frame, 1, frame_bytes, video) == frame_bytes)
+    {
+        ntv_mux_frame(mux, 1);
+
+        /* audio up to the end of this frame */
+        if (audio != NULL && pcm != NULL)
+        {
+            audio_due = (uint64_t)(frames + 1) * params->FrameUs * params->AudioRate / 1000000;
+            while (audio_done < audio_due)
+            {
+                uint64_t want = audio_due - audio_done;
+
+                if (want > params->AudioRate)
+                    want = params->AudioRate;
+                got = fread(pcm, (size_t)params->AudioChannels * sizeof(int16_t), (size_t)want, audio);
+                if (got == 0)
+                    break;
+                if (ntv_mux_audio(mux, pcm, (uint32_t)got) != 0)
+                    ret = 1;
+                audio_done += got;
+            }
+        }
+
+        for (line = 0; line < params->Height; line += lines)
+        {
+            lines = (params->Height - line < slice_lines) ? params->Height - line : slice_lines;
+            if (ntv_mux_video(mux, (uint16_t)line, (uint16_t)lines, frame + line * line_bytes,
+                              (uint32_t)(lines * line_bytes), line + lines == params->Height) != 0)
+                ret = 1;
+        }
+        frames++;
+    }
+
+    if (ntv_mux_close(mux, &stats) != 0)
+        ret = 1;
+    fclose(video);
+    if (audio != NULL)
+        fclose(audio);
+    free(frame);
+    free(pcm);
+
+    if (ret == 0)
+        printf("%u frames, %u video chunks (%u slices per frame, %u LZ4), %u audio chunks, largest %u sectors, %.1f KB/s\n",
+               frames, stats.video_chunks, slices, stats.lz4_chunks, stats.audio_chunks, stats.sectors_max,
+               frames ? stats.file_bytes / 1024.0 / (frames * (params->FrameUs / 1e6)) : 0.0);
+    return ret;
+}
+
+static int check(const char *path)
+{
+    FILE *file = fopen(path, "rb");
+    uint8_t sector[NTV_SECTOR_SIZE];
+    Ntv_Header_t header;
+    Ntv_Chunk_t chunk;
+    Ntv_IndexEntry_t entry;
+    uint8_t *starts = NULL;
+    uint32_t pos = 0, sectors = 0, last_pts = 0, video = 0, audio = 0, frames = 0, packed = 0, errors = 0, i;
+    uint64_t samples = 0;
+    long size = 0;
+
+    if (file == NULL || fread(sector, 1, sizeof(sector), file) != sizeof(sector))
+    {
+        fprintf(stderr, "cannot read %s\n", path);
+        return 1;
+    }
+    memcpy(&header, sector, sizeof(header));
+    if (header.Magic != NTV_MAGIC || header.Version != NTV_VERSION)
+    {
+        fprintf(stderr, "%s: not an .ntv file\n", path);
+        return 1;
+    }
+    fseek(file, 0, SEEK_END);
+    size = ftell(file);
+
+    printf("%ux%u codec %u, %u frames of %u us, audio %u Hz x%u %u bit (%u samples), %u ms\n", header.Width,
+           header.Height, header.Codec, header.Frames, header.FrameUs, header.AudioRate, header.AudioChannels,
+           header.AudioBits, header.AudioSamples, header.DurationMs);
+    printf("data at sector %u, first chunk %u sectors, largest %u; index at %u, %u entries every %u ms\n",
+           header.DataSector, header.FirstSectors, header.MaxSectors, header.IndexSector, header.IndexEntries,
+           header.IndexPeriodMs);
+
+    /* chunk starts, to check the index against */
+    starts = calloc((size_t)size / NTV_SECTOR_SIZE + 1, 1);
+    pos = header.DataSector;
+    sectors = header.FirstSectors;
+    while (sectors != 0 && starts != NULL)
+    {
+        if (fseek(file, (long)pos * NTV_SECTOR_SIZE, SEEK_SET) != 0 || fread(&chunk, sizeof(chunk), 1, file) != 1)
+        {
+            printf("chunk at sector %u: beyond the end\n", pos);
+            errors++;
+            break;
+        }
+        if (chunk.Sectors != sectors || chunk.Sectors > header.MaxSectors ||
+            sizeof(chunk) + chunk.Size > (uint32_t)chunk.Sectors * NTV_SECTOR_SIZE || chunk.Pts < last_pts)
+        {
+            printf("chunk at sector %u: type %u, %u sectors (announced %u), %u bytes, pts %u\n", pos, chunk.Type,
+                   chunk.Sectors, sectors, chunk.Size, chunk.Pts);
+            errors++;
+            break;
+        }
+        starts[pos] = 1;
+        last_pts = chunk.Pts;
+        if (chunk.Type == NTV_CHUNK_VIDEO)
+        {
+            video++;
+            if (chunk.Flags & NTV_CHUNK_LZ4)
+                packed++;
+            if (chunk.Flags & NTV_CHUNK_FRAME_END)
+                frames++;
+        }
+        else if (chunk.Type == NTV_CHUNK_AUDIO)
+        {
+            audio++;
+            samples += chunk.Size / ((uint32_t)header.AudioChannels * header.AudioBits / 8);
+        }
+        pos += chunk.Sectors;
+        sectors = chunk.NextSectors;
+    }
+
+    if (frames != header.Frames || samples != header.AudioSamples)
+    {
+        printf("found %u frames and %llu samples\n", frames, (unsigned long long)samples);
+        errors++;
+    }
+    if (pos != header.IndexSector)
+    {
+        printf("chunks end at sector %u, index at %u\n", pos, header.IndexSector);
+        errors++;
+    }
+
+    fseek(file, (long)header.IndexSector * NTV_SECTOR_SIZE, SEEK_SET);
+    for (i = 0; i < header.IndexEntries; i++)
+    {
+        if (fread(&entry, sizeof(entry), 1, file) != 1 || entry.Sector >= header.IndexSector || starts == NULL ||
+            !starts[entry.Sector])
+        {
+            printf("index entry %u: sector %u is no chunk\n", i, entry.Sector);
+            errors++;
+            break;
+        }
+    }
+
+    printf("%u video chunks (%u LZ4), %u audio chunks, %ld bytes: %s\n", video, packed, audio, size,
+           errors ? "BROKEN" : "ok");
+    free(starts);
+    fclose(file);
+    return errors ? 1 : 0;
+}
+
+static void usage(void)
+{
+    fprintf(stderr, "usage: ntvmux -s WxH -f fps [-a audio.pcm -r Hz -c channels] [-m sectors] [-i ms] "
+                    "[-z level] video.rgb565 out.ntv\n"
+                    "       ntvmux -t file.ntv\n");
+    exit(2);
+}
+
+int main(int argc, char **argv)
+{
+    Ntv_Header_t params;
+    const char *audio_path = NULL;
+    const char *check_path = NULL;
+    unsigned width = 0, height = 0;
+    double fps = 25.0;
+    int lz4_level = -1, opt;
+
+    memset(&params, 0, sizeof(params));
+    params.Codec = NTV_CODEC_RAW565;
+    params.AudioChannels = 2;
+    params.AudioBits = 16;
+    while ((opt = getopt(argc, argv, "s:f:a:r:c:m:i:t:z:")) != -1)
+    {
+        switch (opt)
+        {
+        case 's':
+            if (sscanf(optarg, "%ux%u", &width, &height) != 2)
+                usage();
+            break;
+        case 'f':
+            fps = atof(optarg);
+            break;
+        case 'a':
+            audio_path = optarg;
+            break;
+        case 'r':
+            params.AudioRate = (uint32_t)strtoul(optarg, NULL, 0);
+            break;
+        case 'c':
+            params.AudioChannels = (uint8_t)strtoul(optarg, NULL, 0);
+            break;
+        case 'm':
+            params.MaxSectors = (uint16_t)strtoul(optarg, NULL, 0);
+            break;
+        case 'i':
+            params.IndexPeriodMs = (uint32_t)strtoul(optarg, NULL, 0);
+            break;
+        case 't':
+            check_path = optarg;
+            break;
+        case 'z':
+            lz4_level = atoi(optarg);
+            break;
+        default:
+            usage();
+        }
+    }
+
+    if (check_path != NULL)
+        return check(check_path);
+
+    if (optind + 2 != argc || width == 0 || height == 0 || fps <= 0.0 || (audio_path != NULL) != (params.AudioRate > 0))
+        usage();
+    params.Width = (uint16_t)width;
+    params.Height = (uint16_t)height;
+    params.FrameUs = (uint32_t)(1000000.0 / fps + 0.5);
+    if (audio_path == NULL)
+        params.AudioChannels = params.AudioBits = 0;
+    return mux_raw(argv[optind], audio_path, argv[optind + 1], &params, lz4_level);
+}
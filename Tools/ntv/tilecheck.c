@@ -0,0 +1,479 @@
+/**
+ * @file tilecheck.c
+ * @brief Host round trip of the ntvenc tile codec through the TileDelta decoder of the firmware.
+ *
+ * Build and run on Linux from this directory:
+ *   gcc -O2 -I../../Include ntvenc.c ntv_mux.c ntv_lz4.c -lm -o ntvenc
+ *   gcc -O1 -g -fsanitize=address,undefined -I. -I../../Include -I../../Components/MicroOS/include \
+ *       tilecheck.c ../../Source/TileDelta.c ../../Source/Render.c ../../Source/Lz4.c -o tilecheck
+ *   ./tilecheck [path/to/ntvenc]
+ *
+ * A clip of panel-sized frames is written as raw RGB24 and encoded by ntvenc
+ * with -q tile, lossless (-T 0) and with the default tolerance, each without
+ * and with LZ4 chunks (-z 1), once with short key periods. The clip has random
+ * frames, frames with a few small rectangles changed (noise, flat colour,
+ * stripes), changes below and just above the tolerance, flat and striped
+ * frames that pack well, and repeated frames that send nothing. Every channel
+ * has zero low bits, so the ordered dither of ntvenc leaves the picture as it
+ * is and the RGB565 the panel should show is known here.
+ *
+ * The .ntv file is walked the way the demuxer does it, LZ4 chunks are
+ * unpacked with Lz4_Decompress() into a buffer of their exact size, and every
+ * slice goes through TileDelta_Draw() and the real Render into a stand-in LCD
+ * that keeps the panel memory. After each frame the panel must equal the frame
+ * at -T 0, and be within the tolerance of it (8-bit levels per channel, the
+ * measure ntvenc uses) otherwise. Exit status 0 when every frame matches.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "Lz4.h"
+#include "MicroOS.h"
+#include "Ntv.h"
+#include "TileDelta.h"
+
+#define FRAMES 60
+#define FPS "25"
+#define TOLERANCE 8
+
+typedef struct
+{
+    const char *name;
+    int tolerance;
+    const char *lz4;  /* -z level, NULL for none */
+    const char *keys; /* -k seconds */
+} run_t;
+
+static const run_t runs[] = {
+    {"lossless", 0, NULL, "2"},
+    {"tolerance 8", TOLERANCE, NULL, "2"},
+    {"lossless, LZ4", 0, "1", "2"},
+    {"tolerance 8, LZ4, key every 0.2 s", TOLERANCE, "1", "0.2"},
+};
+
+static unsigned long checks = 0;
+static unsigned long failures = 0;
+
+static uint16_t clip[FRAMES][LCD_HEIGHT][LCD_WIDTH];
+static uint16_t panel[LCD_HEIGHT][LCD_WIDTH];
+static uint32_t ticks = 0;
+
+/* ---------------------------------------------------------------- stand-ins */
+
+uint32_t HAL_GetTick(void)
+{
+    return ticks++ / 16;
+}
+
+MicroOS_Status_t MicroOS_TriggerEvent(uint8_t id)
+{
+    (void)id;
+    return MICROOS_OK;
+}
+
+/* the transfer finishes at once, straight into the panel memory */
+LCD_Status_t LCD_Flush(const LCD_Rect_t *rect, const uint16_t *buf)
+{
+    uint16_t row;
+
+    if (rect == NULL || buf == NULL || rect->x + rect->w > LCD_WIDTH || rect->y + rect->h > LCD_HEIGHT)
+        return LCD_INVALID_PARAM;
+    for (row = 0; row < rect->h; row++)
+        memcpy(&panel[rect->y + row][rect->x], &buf[(size_t)row * rect->w], (size_t)rect->w * 2);
+    return LCD_OK;
+}
+
+bool LCD_IsBusy(void)
+{
+    return false;
+}
+
+LCD_Status_t LCD_GetResult(void)
+{
+    return LCD_OK;
+}
+
+/* ---------------------------------------------------------------- clip */
+
+static uint16_t random565(void)
+{
+    return (uint16_t)(((unsigned)rand() << 8) ^ (unsigned)rand());
+}
+
+static void fill_rect(uint16_t frame[LCD_HEIGHT][LCD_WIDTH], int x, int y, int w, int h, int kind)
+{
+    uint16_t color = random565();
+    int i, j;
+
+    for (j = y; j < y + h && j < LCD_HEIGHT; j++)
+    {
+        for (i = x; i < x + w && i < LCD_WIDTH; i++)
+        {
+            switch (kind)
+            {
+            case 0: /* noise: RAW */
+                frame[j][i] = random565();
+                break;
+            case 1: /* flat: SOLID */
+                frame[j][i] = color;
+                break;
+            default: /* stripes: RLE */
+                frame[j][i] = (uint16_t)(color ^ (((i / 3) & 1) ? 0xFFFF : 0));
+                break;
+            }
+        }
+    }
+}
+
+/* one step of the lowest bit of each channel is 8 levels of red and blue, 4 of green */
+static void nudge(uint16_t frame[LCD_HEIGHT][LCD_WIDTH], int x, int y, int w, int h, int steps)
+{
+    int i, j;
+
+    for (j = y; j < y + h && j < LCD_HEIGHT; j++)
+    {
+        for (i = x; i < x + w && i < LCD_WIDTH; i++)
+        {
+            uint16_t p = frame[j][i];
+            int r = p >> 11, g = (p >> 5) & 0x3F, b = p & 0x1F;
+
+            r = (r + steps <= 31) ? r + steps : r - steps;
+            g = (g + steps <= 63) ? g + steps : g - steps;
+            b = (b >= steps) ? b - steps : b + steps;
+            frame[j][i] = (uint16_t)(r << 11 | g << 5 | b);
+        }
+    }
+}
+
+static void make_clip(void)
+{
+    int f, k, x, y, w, h;
+
+    srand(1);
+    for (f = 0; f < FRAMES; f++)
+    {
+        if (f > 0)
+            memcpy(clip[f], clip[f - 1], sizeof(clip[f]));
+
+        switch (f % 10)
+        {
+        case 0:
+            /* all new: noise with flat and striped rectangles on it */
+            fill_rect(clip[f], 0, 0, LCD_WIDTH, LCD_HEIGHT, 0);
+            for (k = 0; k < 6; k++)
+            {
+                x = rand() % LCD_WIDTH;
+                y = rand() % LCD_HEIGHT;
+                fill_rect(clip[f], x, y, 8 + rand() % 80, 8 + rand() % 80, 1 + k % 2);
+            }
+            break;
+        case 1:
+        case 2:
+        case 3:
+            /* a few small changes, anywhere, tile aligned or not */
+            for (k = 0; k < 1 + rand() % 8; k++)
+            {
+                x = rand() % LCD_WIDTH;
+                y = rand() % LCD_HEIGHT;
+                w = 1 + rand() % 20;
+                h = 1 + rand() % 20;
+                fill_rect(clip[f], x, y, w, h, rand() % 3);
+            }
+            break;
+        case 4:
+            /* below the tolerance, then above it */
+            nudge(clip[f], rand() % LCD_WIDTH, rand() % LCD_HEIGHT, 40, 40, 1);
+            nudge(clip[f], rand() % LCD_WIDTH, rand() % LCD_HEIGHT, 17, 9, 2);
+            break;
+        case 5:
+            /* nothing changed */
+            break;
+        case 6:
+            /* flat: one colour, a few rectangles; packs well */
+            fill_rect(clip[f], 0, 0, LCD_WIDTH, LCD_HEIGHT, 1);
+            for (k = 0; k < 4; k++)
+                fill_rect(clip[f], rand() % LCD_WIDTH, rand() % LCD_HEIGHT, 30, 30, 1);
+            break;
+        case 7:
+            /* stripes over the whole panel */
+            fill_rect(clip[f], 0, 0, LCD_WIDTH, LCD_HEIGHT, 2);
+            break;
+        case 8:
+            /* changes on every tile row, in the last column and the first */
+            for (k = 0; k < LCD_HEIGHT; k += TILEDELTA_SIZE)
+            {
+                fill_rect(clip[f], LCD_WIDTH - 1, k + rand() % TILEDELTA_SIZE, 1, 1, 0);
+                fill_rect(clip[f], 0, k, 2, 2, 1);
+            }
+            break;
+        default:
+            /* one pixel */
+            fill_rect(clip[f], rand() % LCD_WIDTH, rand() % LCD_HEIGHT, 1, 1, 0);
+            break;
+        }
+    }
+}
+
+/* RGB24 with zero low bits: the ordered dither adds at most 7 (red, blue) or 3 (green) and cuts them off again */
+static int write_clip(const char *path)
+{
+    static uint8_t rgb[LCD_HEIGHT * LCD_WIDTH * 3];
+    FILE *file = fopen(path, "wb");
+    int f, i;
+
+    if (file == NULL)
+        return -1;
+    for (f = 0; f < FRAMES; f++)
+    {
+        const uint16_t *p = &clip[f][0][0];
+
+        for (i = 0; i < LCD_HEIGHT * LCD_WIDTH; i++)
+        {
+            rgb[i * 3 + 0] = (uint8_t)((p[i] >> 11) << 3);
+            rgb[i * 3 + 1] = (uint8_t)(((p[i] >> 5) & 0x3F) << 2);
+            rgb[i * 3 + 2] = (uint8_t)((p[i] & 0x1F) << 3);
+        }
+        if (fwrite(rgb, 1, sizeof(rgb), file) != sizeof(rgb))
+        {
+            fclose(file);
+            return -1;
+        }
+    }
+    return fclose(file);
+}
+
+/* ---------------------------------------------------------------- round trip */
+
+static int run_ntvenc(const char *ntvenc, const run_t *run, const char *input, const char *output)
+{
+    char tolerance[16];
+    char size[32];
+    const char *argv[24];
+    size_t n = 0;
+    pid_t pid;
+    int status = 0;
+
+    snprintf(tolerance, sizeof(tolerance), "%d", run->tolerance);
+    snprintf(size, sizeof(size), "%dx%d@%s", LCD_WIDTH, LCD_HEIGHT, FPS);
+    argv[n++] = ntvenc;
+    argv[n++] = "-q";
+    argv[n++] = "tile";
+    argv[n++] = "-n";
+    argv[n++] = "-r";
+    argv[n++] = FPS;
+    argv[n++] = "-T";
+    argv[n++] = tolerance;
+    argv[n++] = "-k";
+    argv[n++] = run->keys;
+    if (run->lz4 != NULL)
+    {
+        argv[n++] = "-z";
+        argv[n++] = run->lz4;
+    }
+    argv[n++] = "-V";
+    argv[n++] = size;
+    argv[n++] = input;
+    argv[n++] = output;
+    argv[n] = NULL;
+
+    /* or the child flushes what is buffered here once more */
+    fflush(stdout);
+    pid = fork();
+    if (pid == 0)
+    {
+        /* the stream summary is not needed here */
+        if (freopen("/dev/null", "w", stdout) == NULL)
+            _exit(127);
+        execv(ntvenc, (char *const *)argv);
+        fprintf(stderr, "cannot run %s\n", ntvenc);
+        _exit(127);
+    }
+    if (pid < 0 || waitpid(pid, &status, 0) != pid)
+        return -1;
+    return (WIFEXITED(status) && WEXITSTATUS(status) == 0) ? 0 : -1;
+}
+
+/* 8-bit levels between two RGB565 colours, the largest channel, as ntvenc measures them */
+static int diff565(uint16_t a, uint16_t b)
+{
+    int r = abs((a >> 11) - (b >> 11)) << 3;
+    int g = abs(((a >> 5) & 0x3F) - ((b >> 5) & 0x3F)) << 2;
+    int bl = abs((a & 0x1F) - (b & 0x1F)) << 3;
+
+    return r > g ? (r > bl ? r : bl) : (g > bl ? g : bl);
+}
+
+static void check_frame(const run_t *run, uint32_t frame)
+{
+    int x, y;
+
+    checks++;
+    for (y = 0; y < LCD_HEIGHT; y++)
+    {
+        for (x = 0; x < LCD_WIDTH; x++)
+        {
+            if (diff565(panel[y][x], clip[frame][y][x]) > run->tolerance)
+            {
+                if (failures < 10)
+                    printf("  %s, frame %u: pixel %d,%d is 0x%04X, frame has 0x%04X\n", run->name, frame, x, y,
+                           panel[y][x], clip[frame][y][x]);
+                failures++;
+                return;
+            }
+        }
+    }
+}
+
+static void fail(const run_t *run, const char *what, uint32_t value)
+{
+    if (failures < 10)
+        printf("  %s: %s (%u)\n", run->name, what, value);
+    failures++;
+}
+
+/* walk the chunk chain like the demuxer, decode every slice and compare each finished frame */
+static void decode_file(const run_t *run, const char *path)
+{
+    FILE *file = fopen(path, "rb");
+    Ntv_Header_t header;
+    Ntv_Chunk_t chunk;
+    uint8_t *payload = NULL;
+    uint32_t pos = 0, sectors = 0, frame = 0, packed = 0;
+    Render_Status_t ret;
+
+    memset(panel, 0, sizeof(panel));
+    if (file == NULL || fread(&header, sizeof(header), 1, file) != 1 || header.Magic != NTV_MAGIC ||
+        header.Codec != NTV_CODEC_TILE || header.Frames != FRAMES)
+    {
+        fail(run, "not a tile-coded file of the clip", 0);
+        if (file != NULL)
+            fclose(file);
+        return;
+    }
+
+    pos = header.DataSector;
+    sectors = header.FirstSectors;
+    while (sectors != 0)
+    {
+        uint8_t *data = NULL;
+        uint32_t size = 0;
+
+        if (fseek(file, (long)pos * NTV_SECTOR_SIZE, SEEK_SET) != 0 || fread(&chunk, sizeof(chunk), 1, file) != 1 ||
+            chunk.Sectors != sectors || sizeof(chunk) + chunk.Size > (uint32_t)chunk.Sectors * NTV_SECTOR_SIZE)
+        {
+            fail(run, "broken chunk at sector", pos);
+            break;
+        }
+        pos += chunk.Sectors;
+        sectors = chunk.NextSectors;
+        if (chunk.Type != NTV_CHUNK_VIDEO)
+            continue;
+
+        /* exactly the payload, so a read past it trips the sanitizer */
+        payload = malloc(chunk.Size ? chunk.Size : 1);
+        if (payload == NULL || fread(payload, 1, chunk.Size, file) != chunk.Size)
+        {
+            fail(run, "short payload at sector", pos - chunk.Sectors);
+            free(payload);
+            break;
+        }
+        data = payload;
+        size = chunk.Size;
+        if (chunk.Flags & NTV_CHUNK_LZ4)
+        {
+            uint32_t got = 0;
+
+            memcpy(&size, payload, sizeof(size));
+            data = malloc(size ? size : 1);
+            if (data == NULL || chunk.Size <= sizeof(uint32_t) ||
+                Lz4_Decompress(payload + sizeof(uint32_t), chunk.Size - sizeof(uint32_t), data, size, &got) !=
+                    LZ4_OK ||
+                got != size)
+            {
+                fail(run, "LZ4 chunk does not unpack, frame", chunk.Index);
+                free(data);
+                free(payload);
+                break;
+            }
+            packed++;
+        }
+
+        if (chunk.Index != frame)
+            fail(run, "slice out of order, frame", chunk.Index);
+        ret = TileDelta_Draw(data, size, chunk.Line, chunk.Lines);
+        if (ret != RENDER_OK)
+            fail(run, "TileDelta_Draw() failed, frame", chunk.Index);
+        if (data != payload)
+            free(data);
+        free(payload);
+
+        if (chunk.Flags & NTV_CHUNK_FRAME_END)
+        {
+            if (frame < FRAMES)
+                check_frame(run, frame);
+            frame++;
+        }
+    }
+    fclose(file);
+
+    checks++;
+    if (frame != FRAMES)
+        fail(run, "frames decoded", frame);
+    checks++;
+    if ((run->lz4 != NULL) != (packed > 0))
+        fail(run, "LZ4 chunks", packed);
+}
+
+int main(int argc, char **argv)
+{
+    const char *ntvenc = (argc > 1) ? argv[1] : "./ntvenc";
+    char input[] = "/tmp/tilecheck-XXXXXX";
+    char output[] = "/tmp/tilecheck-XXXXXX";
+    TileDelta_Stats_t stats;
+    int fd_in = mkstemp(input);
+    int fd_out = mkstemp(output);
+    size_t r;
+
+    if (fd_in < 0 || fd_out < 0)
+    {
+        fprintf(stderr, "cannot make temporary files\n");
+        return 1;
+    }
+    close(fd_in);
+    close(fd_out);
+
+    make_clip();
+    if (write_clip(input) != 0)
+    {
+        fprintf(stderr, "cannot write %s\n", input);
+        unlink(input);
+        unlink(output);
+        return 1;
+    }
+
+    for (r = 0; r < sizeof(runs) / sizeof(runs[0]); r++)
+    {
+        if (run_ntvenc(ntvenc, &runs[r], input, output) != 0)
+        {
+            fail(&runs[r], "ntvenc failed", 0);
+            continue;
+        }
+        TileDelta_ResetStats();
+        decode_file(&runs[r], output);
+        TileDelta_GetStats(&stats);
+        printf("%s: %u slices, %u solid, %u raw, %u RLE tiles, %u rectangles\n", runs[r].name, stats.Slices,
+               stats.Tiles[TILEDELTA_SOLID], stats.Tiles[TILEDELTA_RAW], stats.Tiles[TILEDELTA_RLE], stats.Rects);
+    }
+    unlink(input);
+    unlink(output);
+
+    printf("%lu checks: %s\n", checks, (failures == 0) ? "ok" : "FAILED");
+    return (failures == 0) ? 0 : 1;
+}
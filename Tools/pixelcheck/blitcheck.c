@@ -0,0 +1,247 @@
+/**
+ * @file blitcheck.c
+ * @brief Host check that every Blit fast path matches its *_Ref bit for bit.
+ *
+ * Build and run on Linux from this directory, once with the DSP paths
+ * (intrinsics emulated in main.h) and once with the plain word paths:
+ *   gcc -O1 -g -fno-strict-aliasing -fsanitize=address,undefined -D__ARM_FEATURE_DSP=1 \
+ *       -I. -I../../Include blitcheck.c ../../Source/Blit.c -o blitcheck && ./blitcheck
+ *   gcc -O1 -g -fno-strict-aliasing -fsanitize=address,undefined \
+ *       -I. -I../../Include blitcheck.c ../../Source/Blit.c -o blitcheck && ./blitcheck
+ *
+ * Fill, Copy, CopyKey, Blend and BlendMask run on random buffers over every
+ * width up to 67 and both word phases of destination, source and mask, with
+ * row strides larger than the width. Blend runs every alpha, CopyKey every
+ * key (with the key itself and its near misses planted in the source),
+ * BlendMask masks with empty and solid runs next to every coverage value.
+ * The whole destination buffer is compared, so a write outside the
+ * rectangle counts as a mismatch; buffers end on the word holding the last
+ * pixel, so a read beyond that trips the sanitizer. Exit status 0 when
+ * nothing differs.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "Blit.h"
+
+#define MAX_W 67
+#define MAX_H 4
+#define SLACK 3 /* extra pixels per row, and the largest start offset */
+
+typedef enum
+{
+    OP_FILL = 0,
+    OP_COPY,
+    OP_COPYKEY,
+    OP_BLEND,
+    OP_BLENDMASK,
+    OP_COUNT
+} blit_op_t;
+
+static const char *const op_names[OP_COUNT] = { "Blit_Fill", "Blit_Copy", "Blit_CopyKey", "Blit_Blend",
+                                                "Blit_BlendMask" };
+
+static unsigned long cases = 0;
+static unsigned long failures = 0;
+
+static uint16_t random16(void)
+{
+    return (uint16_t)(((unsigned)rand() << 8) ^ (unsigned)rand());
+}
+
+/* mostly empty and solid bytes in runs, the rest any coverage */
+static uint8_t random_coverage(void)
+{
+    int r = rand() % 8;
+
+    return (r < 3) ? 0 : (r < 6) ? 255 : (uint8_t)rand();
+}
+
+typedef struct
+{
+    uint16_t w, h;
+    uint16_t dst_off, src_off, mask_off; /* start offsets: pixels, pixels, bytes */
+    uint16_t dst_stride, src_stride, mask_stride;
+    uint16_t color;                      /* fill color, key or mask color */
+    uint8_t alpha;
+} blit_case_t;
+
+static void run_case(blit_op_t op, const blit_case_t *c, const uint16_t *src_pattern, const uint8_t *mask_pattern)
+{
+    size_t dst_pixels = (size_t)c->dst_off + (size_t)c->dst_stride * c->h;
+    size_t src_pixels = (size_t)c->src_off + (size_t)c->src_stride * c->h;
+    size_t mask_bytes = (size_t)c->mask_off + (size_t)c->mask_stride * c->h;
+    /* the uint32_t backing keeps offset 0 on a word, so dst_off and src_off pick the phase */
+    uint32_t *fast_mem = (uint32_t *)malloc((dst_pixels + 1) / 2 * 4);
+    uint32_t *ref_mem = (uint32_t *)malloc((dst_pixels + 1) / 2 * 4);
+    uint32_t *src_mem = (uint32_t *)malloc((src_pixels + 1) / 2 * 4);
+    uint32_t *mask_mem = (uint32_t *)malloc((mask_bytes + 3) / 4 * 4);
+    uint16_t *fast = (uint16_t *)fast_mem;
+    uint16_t *ref = (uint16_t *)ref_mem;
+    uint16_t *src = (uint16_t *)src_mem;
+    uint8_t *mask = (uint8_t *)mask_mem;
+    size_t i;
+
+    if ((fast == NULL) || (ref == NULL) || (src == NULL) || (mask == NULL))
+    {
+        fprintf(stderr, "out of memory\n");
+        exit(1);
+    }
+
+    for (i = 0; i < dst_pixels; i++)
+    {
+        fast[i] = ref[i] = random16();
+    }
+    for (i = 0; i < src_pixels; i++)
+    {
+        src[i] = src_pattern[i % (MAX_W + SLACK)];
+    }
+    for (i = 0; i < mask_bytes; i++)
+    {
+        mask[i] = mask_pattern[i % (MAX_W + SLACK)];
+    }
+
+    switch (op)
+    {
+        case OP_FILL:
+            Blit_Fill(fast + c->dst_off, c->dst_stride, c->w, c->h, c->color);
+            Blit_Fill_Ref(ref + c->dst_off, c->dst_stride, c->w, c->h, c->color);
+            break;
+        case OP_COPY:
+            Blit_Copy(fast + c->dst_off, c->dst_stride, src + c->src_off, c->src_stride, c->w, c->h);
+            Blit_Copy_Ref(ref + c->dst_off, c->dst_stride, src + c->src_off, c->src_stride, c->w, c->h);
+            break;
+        case OP_COPYKEY:
+            Blit_CopyKey(fast + c->dst_off, c->dst_stride, src + c->src_off, c->src_stride, c->w, c->h, c->color);
+            Blit_CopyKey_Ref(ref + c->dst_off, c->dst_stride, src + c->src_off, c->src_stride, c->w, c->h, c->color);
+            break;
+        case OP_BLEND:
+            Blit_Blend(fast + c->dst_off, c->dst_stride, src + c->src_off, c->src_stride, c->w, c->h, c->alpha);
+            Blit_Blend_Ref(ref + c->dst_off, c->dst_stride, src + c->src_off, c->src_stride, c->w, c->h, c->alpha);
+            break;
+        default:
+            Blit_BlendMask(fast + c->dst_off, c->dst_stride, mask + c->mask_off, c->mask_stride, c->w, c->h, c->color);
+            Blit_BlendMask_Ref(ref + c->dst_off, c->dst_stride, mask + c->mask_off, c->mask_stride, c->w, c->h,
+                               c->color);
+            break;
+    }
+
+    cases++;
+    if (memcmp(fast, ref, dst_pixels * 2) != 0)
+    {
+        for (i = 0; (i < dst_pixels) && (fast[i] == ref[i]); i++)
+        {
+        }
+        if (failures < 10)
+        {
+            printf("  %s w %u h %u dst+%u src+%u mask+%u color 0x%04X alpha %u: pixel %zu is 0x%04X, ref 0x%04X\n",
+                   op_names[op], c->w, c->h, c->dst_off, c->src_off, c->mask_off, c->color, c->alpha, i, fast[i],
+                   ref[i]);
+        }
+        failures++;
+    }
+
+    free(fast_mem);
+    free(ref_mem);
+    free(src_mem);
+    free(mask_mem);
+}
+
+/* every shape and phase for one operation and parameter */
+static void run_shapes(blit_op_t op, uint16_t color, uint8_t alpha, const uint16_t *src_pattern,
+                       const uint8_t *mask_pattern)
+{
+    blit_case_t c;
+
+    c.color = color;
+    c.alpha = alpha;
+    for (c.w = 0; c.w <= MAX_W; c.w++)
+    {
+        for (c.dst_off = 0; c.dst_off < 2; c.dst_off++)
+        {
+            for (c.src_off = 0; c.src_off < 2; c.src_off++)
+            {
+                c.h = (uint16_t)(1 + rand() % MAX_H);
+                c.mask_off = (uint16_t)(rand() % 4);
+                c.dst_stride = (uint16_t)(c.w + rand() % (SLACK + 1));
+                c.src_stride = (uint16_t)(c.w + rand() % (SLACK + 1));
+                c.mask_stride = (uint16_t)(c.w + rand() % (SLACK + 1));
+                run_case(op, &c, src_pattern, mask_pattern);
+            }
+        }
+    }
+}
+
+int main(void)
+{
+    uint16_t src_pattern[MAX_W + SLACK];
+    uint8_t mask_pattern[MAX_W + SLACK];
+    unsigned value;
+    size_t i;
+
+    srand(1);
+    for (i = 0; i < MAX_W + SLACK; i++)
+    {
+        src_pattern[i] = random16();
+        mask_pattern[i] = random_coverage();
+    }
+
+    for (value = 0; value < 16; value++)
+    {
+        run_shapes(OP_FILL, random16(), 0, src_pattern, mask_pattern);
+        run_shapes(OP_COPY, 0, 0, src_pattern, mask_pattern);
+    }
+
+    /* every alpha */
+    for (value = 0; value < 256; value++)
+    {
+        for (i = 0; i < MAX_W + SLACK; i++)
+        {
+            src_pattern[i] = random16();
+        }
+        run_shapes(OP_BLEND, 0, (uint8_t)value, src_pattern, mask_pattern);
+    }
+
+    /* every key: a third of the source is the key, a third differs from it in one bit */
+    for (value = 0; value < 65536; value++)
+    {
+        blit_case_t c = { 0 };
+
+        for (i = 0; i < MAX_W + SLACK; i++)
+        {
+            int r = rand() % 3;
+            uint16_t near = (uint16_t)(value ^ (1u << (rand() % 16)));
+
+            src_pattern[i] = (r == 0) ? (uint16_t)value : (r == 1) ? near : random16();
+        }
+        if ((value & 0xFF) == 0)
+        {
+            run_shapes(OP_COPYKEY, (uint16_t)value, 0, src_pattern, mask_pattern);
+            continue;
+        }
+        c.w = (uint16_t)(1 + rand() % MAX_W);
+        c.h = 2;
+        c.dst_off = (uint16_t)(rand() % 2);
+        c.src_off = (uint16_t)(rand() % 2);
+        c.dst_stride = (uint16_t)(c.w + 1);
+        c.src_stride = (uint16_t)(c.w + 1);
+        c.mask_stride = c.w;
+        c.color = (uint16_t)value;
+        run_case(OP_COPYKEY, &c, src_pattern, mask_pattern);
+    }
+
+    /* masks: every coverage value next to empty and solid runs, at every byte phase */
+    for (value = 0; value < 256; value++)
+    {
+        for (i = 0; i < MAX_W + SLACK; i++)
+        {
+            mask_pattern[i] = (rand() % 4 == 0) ? (uint8_t)value : random_coverage();
+        }
+        run_shapes(OP_BLENDMASK, random16(), 0, src_pattern, mask_pattern);
+    }
+
+    printf("%lu cases: %s\n", cases, (failures == 0) ? "ok" : "FAILED");
+    return (failures == 0) ? 0 : 1;
+}
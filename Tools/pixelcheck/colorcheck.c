@@ -0,0 +1,211 @@
+/**
+ * @file colorcheck.c
+ * @brief Host check that ColorConv_Convert() matches ColorConv_Convert_Ref() bit for bit.
+ *
+ * Build and run on Linux from this directory, once with the __UQADD8 path
+ * (emulated in main.h) and once with the SWAR saturating add:
+ *   gcc -O1 -g -fno-strict-aliasing -fsanitize=address,undefined -D__ARM_FEATURE_DSP=1 \
+ *       -I. -I../../Include colorcheck.c ../../Source/ColorConv.c -lm -o colorcheck && ./colorcheck
+ *   gcc -O1 -g -fno-strict-aliasing -fsanitize=address,undefined \
+ *       -I. -I../../Include colorcheck.c ../../Source/ColorConv.c -lm -o colorcheck && ./colorcheck
+ *
+ * Random RGB888 strips, with every byte value and the saturating corners
+ * planted in them, are converted over every width up to 67, both word phases
+ * of the destination, every dither phase (x and y mod 4) and with the dither
+ * off. This runs for the identity tables and for several gamma/brightness
+ * tables: dark and bright gammas, reduced gain, different curves per channel
+ * and a table that clips most of the range to 255. The whole destination
+ * buffer is compared, so a write outside the strip counts as a mismatch.
+ * Exit status 0 when nothing differs.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ColorConv.h"
+
+#define MAX_W 67
+#define MAX_H 5
+#define SLACK 3 /* extra pixels per destination row */
+
+typedef struct
+{
+    const char *name;
+    float gamma[3];
+    uint8_t gain[3];
+} curve_set_t;
+
+static const curve_set_t curve_sets[] = {
+    { "identity", { 0, 0, 0 }, { 0, 0, 0 } },
+    { "gamma 2.2", { 2.2f, 2.2f, 2.2f }, { 255, 255, 255 } },
+    { "gamma 0.45", { 0.45f, 0.45f, 0.45f }, { 255, 255, 255 } },
+    { "gain 160", { 1.0f, 1.0f, 1.0f }, { 160, 160, 160 } },
+    { "per channel", { 1.8f, 1.0f, 0.6f }, { 240, 255, 200 } },
+    { "clipping", { 0.1f, 0.1f, 0.1f }, { 255, 255, 255 } },
+    { "gamma 10, gain 0", { 10.0f, 1.0f, 10.0f }, { 255, 0, 128 } },
+};
+
+static unsigned long cases = 0;
+static unsigned long failures = 0;
+
+static int apply_curves(const curve_set_t *set)
+{
+    int c;
+
+    ColorConv_Init();
+    if (set->gamma[0] == 0)
+    {
+        return 0;
+    }
+    for (c = 0; c < 3; c++)
+    {
+        if (ColorConv_SetCurve((ColorConv_Channel_t)c, set->gamma[c], set->gain[c]) != COLORCONV_OK)
+        {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+static void run_case(const char *set, uint16_t w, uint16_t h, uint16_t dst_off, uint16_t x, uint16_t y, int dither)
+{
+    uint16_t dst_stride = (uint16_t)(w + rand() % (SLACK + 1));
+    uint32_t src_stride = (uint32_t)w * 3 + (uint32_t)(rand() % 4);
+    size_t dst_pixels = (size_t)dst_off + (size_t)dst_stride * h;
+    size_t src_bytes = (size_t)src_stride * h;
+    /* the uint32_t backing keeps offset 0 on a word, so dst_off picks the phase */
+    uint32_t *fast_mem = (uint32_t *)malloc((dst_pixels + 1) / 2 * 4);
+    uint32_t *ref_mem = (uint32_t *)malloc((dst_pixels + 1) / 2 * 4);
+    uint8_t *src = (uint8_t *)malloc(src_bytes ? src_bytes : 1);
+    uint16_t *fast = (uint16_t *)fast_mem;
+    uint16_t *ref = (uint16_t *)ref_mem;
+    size_t i;
+
+    if ((fast == NULL) || (ref == NULL) || (src == NULL))
+    {
+        fprintf(stderr, "out of memory\n");
+        exit(1);
+    }
+
+    for (i = 0; i < dst_pixels; i++)
+    {
+        fast[i] = ref[i] = (uint16_t)rand();
+    }
+    for (i = 0; i < src_bytes; i++)
+    {
+        int r = rand() % 8;
+
+        /* the ends of the range are where the saturating add matters */
+        src[i] = (r == 0) ? 255 : (r == 1) ? (uint8_t)(248 + rand() % 8) : (r == 2) ? 0 : (uint8_t)rand();
+    }
+
+    ColorConv_SetDither(dither != 0);
+    ColorConv_Convert(fast + dst_off, dst_stride, src, src_stride, w, h, x, y);
+    ColorConv_Convert_Ref(ref + dst_off, dst_stride, src, src_stride, w, h, x, y);
+
+    cases++;
+    if (memcmp(fast, ref, dst_pixels * 2) != 0)
+    {
+        for (i = 0; (i < dst_pixels) && (fast[i] == ref[i]); i++)
+        {
+        }
+        if (failures < 10)
+        {
+            printf("  %s w %u h %u dst+%u at %u,%u dither %d: pixel %zu is 0x%04X, ref 0x%04X\n", set, w, h, dst_off, x,
+                   y, dither, i, fast[i], ref[i]);
+        }
+        failures++;
+    }
+
+    free(fast_mem);
+    free(ref_mem);
+    free(src);
+}
+
+/* every value of every channel through one pixel, at every dither phase */
+static void run_all_values(const char *set)
+{
+    uint16_t x, y;
+    unsigned v;
+
+    for (y = 0; y < 4; y++)
+    {
+        for (x = 0; x < 4; x++)
+        {
+            for (v = 0; v < 256; v++)
+            {
+                uint8_t src[3] = { (uint8_t)v, (uint8_t)(255 - v), (uint8_t)(v * 7) };
+                uint16_t fast = 0;
+                uint16_t ref = 0;
+
+                ColorConv_SetDither(true);
+                ColorConv_Convert(&fast, 1, src, 3, 1, 1, x, y);
+                ColorConv_Convert_Ref(&ref, 1, src, 3, 1, 1, x, y);
+                cases++;
+                if (fast != ref)
+                {
+                    if (failures < 10)
+                    {
+                        printf("  %s value %u at %u,%u: 0x%04X, ref 0x%04X\n", set, v, x, y, fast, ref);
+                    }
+                    failures++;
+                }
+            }
+        }
+    }
+}
+
+int main(void)
+{
+    size_t s;
+
+    srand(1);
+    for (s = 0; s < sizeof(curve_sets) / sizeof(curve_sets[0]); s++)
+    {
+        uint16_t w, dst_off, x, y;
+        int dither;
+
+        if (apply_curves(&curve_sets[s]) != 0)
+        {
+            printf("  %s: ColorConv_SetCurve failed\n", curve_sets[s].name);
+            failures++;
+            continue;
+        }
+        run_all_values(curve_sets[s].name);
+
+        for (w = 0; w <= MAX_W; w++)
+        {
+            for (dst_off = 0; dst_off < 2; dst_off++)
+            {
+                for (dither = 0; dither < 2; dither++)
+                {
+                    /* every phase, also at screen positions past the first 4x4 cell */
+                    for (y = 0; y < 4; y++)
+                    {
+                        for (x = 0; x < 4; x++)
+                        {
+                            run_case(curve_sets[s].name, w, (uint16_t)(1 + rand() % MAX_H), dst_off,
+                                     (uint16_t)(x + 4 * (rand() % 60)), (uint16_t)(y + 4 * (rand() % 60)), dither);
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    /* parameters SetCurve must refuse */
+    cases++;
+    if ((ColorConv_SetCurve(COLORCONV_ALL, 0.05f, 255) == COLORCONV_OK) ||
+        (ColorConv_SetCurve(COLORCONV_ALL, 10.5f, 255) == COLORCONV_OK) ||
+        (ColorConv_SetCurve(COLORCONV_ALL, nanf(""), 255) == COLORCONV_OK) ||
+        (ColorConv_SetCurve((ColorConv_Channel_t)(COLORCONV_ALL + 1), 1.0f, 255) == COLORCONV_OK))
+    {
+        printf("  ColorConv_SetCurve accepted an invalid parameter\n");
+        failures++;
+    }
+
+    printf("%lu cases: %s\n", cases, (failures == 0) ? "ok" : "FAILED");
+    return (failures == 0) ? 0 : 1;
+}
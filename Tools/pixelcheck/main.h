@@ -0,0 +1,68 @@
+/**
+ * @file main.h
+ * @brief Host stand-in for the CubeMX main.h, enough for the pixel modules.
+ *
+ * The Cortex-M4 DSP intrinsics they use are emulated here, GE flags
+ * included, so building with -D__ARM_FEATURE_DSP=1 runs the same fast
+ * paths as the target.
+ */
+
+#ifndef PIXELCHECK_MAIN_H
+#define PIXELCHECK_MAIN_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define __ALIGNED(x) __attribute__((aligned(x)))
+
+/* provided by the check that needs it */
+uint32_t HAL_GetTick(void);
+
+/* APSR.GE, one bit per byte lane */
+static uint32_t pixelcheck_ge = 0;
+
+static inline uint32_t __USUB16(uint32_t a, uint32_t b)
+{
+    uint32_t lo = a & 0xFFFF, hi = a >> 16;
+    uint32_t blo = b & 0xFFFF, bhi = b >> 16;
+
+    pixelcheck_ge = (lo >= blo ? 0x3 : 0) | (hi >= bhi ? 0xC : 0);
+    return ((lo - blo) & 0xFFFF) | ((hi - bhi) << 16);
+}
+
+static inline uint32_t __SEL(uint32_t a, uint32_t b)
+{
+    uint32_t out = 0;
+    int i;
+
+    for (i = 0; i < 4; i++)
+        out |= (((pixelcheck_ge >> i) & 1) ? a : b) & (0xFFUL << (8 * i));
+    return out;
+}
+
+static inline uint32_t __UQADD8(uint32_t a, uint32_t b)
+{
+    uint32_t out = 0;
+    int i;
+
+    for (i = 0; i < 4; i++)
+    {
+        uint32_t sum = ((a >> (8 * i)) & 0xFF) + ((b >> (8 * i)) & 0xFF);
+
+        out |= (sum > 0xFF ? 0xFF : sum) << (8 * i);
+    }
+    return out;
+}
+
+/* halfword packing: bottom half of a under (b << shift), or top half of a over (b >> shift) */
+static inline uint32_t __PKHBT(uint32_t a, uint32_t b, uint32_t shift)
+{
+    return (a & 0xFFFFUL) | ((b << shift) & 0xFFFF0000UL);
+}
+
+static inline uint32_t __PKHTB(uint32_t a, uint32_t b, uint32_t shift)
+{
+    return (a & 0xFFFF0000UL) | ((b >> shift) & 0xFFFFUL);
+}
+
+#endif
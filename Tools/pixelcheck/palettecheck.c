@@ -0,0 +1,305 @@
+/**
+ * @file palettecheck.c
+ * @brief Host check that Palette_Expand8()/Palette_Expand4() match their *_Ref bit for bit.
+ *
+ * Build and run on Linux from this directory:
+ *   gcc -O1 -g -fno-strict-aliasing -fsanitize=address,undefined -I. -I../../Include \
+ *       palettecheck.c ../../Source/Palette.c -o palettecheck && ./palettecheck
+ *
+ * Random palettes and indices are expanded over every pixel count up to two
+ * panel lines and a bit, so every tail after the eight-pixel loop comes up,
+ * odd counts included, with the source and destination on each word of a
+ * small window. The whole destination buffer is compared, so a write past the
+ * last pixel counts as a mismatch; the source buffer ends on the last index
+ * byte, so a read beyond it trips the sanitizer. Whole slices then go through
+ * Palette_Draw() on a stand-in Render that draws every strip into a frame:
+ * PAL8 and PAL4, odd line counts at odd lines, a new palette and a kept one,
+ * and slices Palette_Start() must reject. Exit status 0 when nothing differs.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "Palette.h"
+
+#define MAX_PIXELS (2 * LCD_WIDTH + 17)
+#define SLACK 4 /* destination pixels past the expanded ones */
+
+static unsigned long cases = 0;
+static unsigned long failures = 0;
+
+static uint16_t frame[LCD_HEIGHT][LCD_WIDTH];
+static uint16_t strip[RENDER_STRIP_PIXELS];
+static const LCD_Rect_t *render_area = NULL;
+static Render_DrawFunction_t render_draw = NULL;
+static void *render_userdata = NULL;
+
+/* stand-in Render: the whole area is drawn, strip by strip, on the next Render_Process() */
+Render_Status_t Render_Start(const LCD_Rect_t *area, Render_DrawFunction_t Draw, void *Userdata)
+{
+    if (render_draw != NULL)
+        return RENDER_BUSY;
+    render_area = area;
+    render_draw = Draw;
+    render_userdata = Userdata;
+    return RENDER_OK;
+}
+
+Render_Status_t Render_Process(void)
+{
+    uint16_t y;
+
+    if (render_draw == NULL)
+        return RENDER_OK;
+
+    for (y = 0; y < render_area->h; y += RENDER_STRIP_LINES)
+    {
+        uint16_t lines = (uint16_t)(render_area->h - y < RENDER_STRIP_LINES ? render_area->h - y : RENDER_STRIP_LINES);
+        uint16_t row;
+
+        if (!render_draw(strip, render_area, y, lines, render_userdata))
+        {
+            render_draw = NULL;
+            return RENDER_ERROR;
+        }
+        for (row = 0; row < lines; row++)
+            memcpy(frame[render_area->y + y + row], &strip[(size_t)row * render_area->w], render_area->w * 2);
+    }
+    render_draw = NULL;
+    return RENDER_OK;
+}
+
+void Render_Abort(void)
+{
+    render_draw = NULL;
+}
+
+uint32_t HAL_GetTick(void)
+{
+    return 0;
+}
+
+static uint16_t random16(void)
+{
+    return (uint16_t)(((unsigned)rand() << 8) ^ (unsigned)rand());
+}
+
+static void report(const char *what, uint32_t pixels, uint32_t src_off, uint32_t dst_off, const uint16_t *fast,
+                   const uint16_t *ref, size_t count)
+{
+    size_t i;
+
+    cases++;
+    if (memcmp(fast, ref, count * 2) == 0)
+        return;
+    for (i = 0; (i < count) && (fast[i] == ref[i]); i++)
+    {
+    }
+    if (failures < 10)
+    {
+        printf("  %s pixels %u src+%u dst+%u: pixel %zu is 0x%04X, ref 0x%04X\n", what, pixels, src_off, dst_off, i,
+               fast[i], ref[i]);
+    }
+    failures++;
+}
+
+/* one expansion of each kind at the given count and word offsets */
+static void run_case(uint32_t pixels, uint32_t src_off, uint32_t dst_off, const uint16_t *palette,
+                     const uint32_t *pairs)
+{
+    size_t dst_pixels = dst_off * 2 + pixels + SLACK;
+    size_t src8 = src_off * 4 + pixels;
+    size_t src4 = src_off * 4 + (pixels + 1) / 2;
+    /* the uint32_t backing keeps offset 0 on a word, the offsets move whole words */
+    uint32_t *fast_mem = (uint32_t *)malloc((dst_pixels + 1) / 2 * 4);
+    uint32_t *ref_mem = (uint32_t *)malloc((dst_pixels + 1) / 2 * 4);
+    uint8_t *src = (uint8_t *)malloc(src8 ? src8 : 1);
+    uint16_t *fast = (uint16_t *)fast_mem;
+    uint16_t *ref = (uint16_t *)ref_mem;
+    size_t i;
+
+    if ((fast == NULL) || (ref == NULL) || (src == NULL))
+    {
+        fprintf(stderr, "out of memory\n");
+        exit(1);
+    }
+
+    for (i = 0; i < src8; i++)
+    {
+        src[i] = (uint8_t)rand();
+    }
+
+    for (i = 0; i < dst_pixels; i++)
+    {
+        fast[i] = ref[i] = random16();
+    }
+    Palette_Expand8(fast + dst_off * 2, src + src_off * 4, palette, pixels);
+    Palette_Expand8_Ref(ref + dst_off * 2, src + src_off * 4, palette, pixels);
+    report("Palette_Expand8", pixels, src_off, dst_off, fast, ref, dst_pixels);
+    free(src);
+
+    /* PAL4 reads half a byte per pixel, its source ends there */
+    src = (uint8_t *)malloc(src4 ? src4 : 1);
+    if (src == NULL)
+    {
+        fprintf(stderr, "out of memory\n");
+        exit(1);
+    }
+    for (i = 0; i < src4; i++)
+    {
+        src[i] = (uint8_t)rand();
+    }
+    for (i = 0; i < dst_pixels; i++)
+    {
+        fast[i] = ref[i] = random16();
+    }
+    Palette_Expand4(fast + dst_off * 2, src + src_off * 4, pairs, pixels);
+    Palette_Expand4_Ref(ref + dst_off * 2, src + src_off * 4, palette, pixels);
+    report("Palette_Expand4", pixels, src_off, dst_off, fast, ref, dst_pixels);
+
+    free(fast_mem);
+    free(ref_mem);
+    free(src);
+}
+
+/* slice payload: Colors, Reserved, the palette padded to 4 bytes, then the indices */
+static size_t make_slice(uint32_t *buf, uint16_t colors, const uint16_t *palette, uint16_t lines, uint8_t bits)
+{
+    uint8_t *p = (uint8_t *)buf;
+    size_t header = 4 + (((size_t)colors * 2 + 3) & ~(size_t)3);
+    size_t indices = (size_t)lines * LCD_WIDTH * bits / 8;
+    size_t i;
+
+    memset(p, 0, header);
+    memcpy(p, &colors, 2);
+    memcpy(p + 4, palette, (size_t)colors * 2);
+    for (i = 0; i < indices; i++)
+    {
+        p[header + i] = (uint8_t)rand();
+    }
+    return header + indices;
+}
+
+static void check_slice(const char *what, const uint32_t *buf, size_t size, uint16_t line, uint16_t lines, uint8_t bits,
+                        const uint16_t *palette, Render_Status_t want)
+{
+    static uint16_t expect[LCD_HEIGHT][LCD_WIDTH];
+    const uint8_t *p = (const uint8_t *)buf;
+    uint16_t colors = 0;
+    size_t header = 0;
+    uint16_t row;
+    Render_Status_t ret;
+
+    memcpy(&colors, p, 2);
+    header = 4 + (((size_t)colors * 2 + 3) & ~(size_t)3);
+    for (row = 0; row < LCD_HEIGHT; row++)
+    {
+        uint16_t x;
+
+        for (x = 0; x < LCD_WIDTH; x++)
+        {
+            frame[row][x] = expect[row][x] = random16();
+        }
+    }
+    if (want == RENDER_OK)
+    {
+        for (row = 0; row < lines; row++)
+        {
+            if (bits == 8)
+                Palette_Expand8_Ref(expect[line + row], p + header + (size_t)row * LCD_WIDTH, palette, LCD_WIDTH);
+            else
+                Palette_Expand4_Ref(expect[line + row], p + header + (size_t)row * LCD_WIDTH / 2, palette, LCD_WIDTH);
+        }
+    }
+
+    ret = Palette_Draw((const uint8_t *)buf, (uint32_t)size, line, lines, bits);
+    cases++;
+    if ((ret != want) || (memcmp(frame, expect, sizeof(frame)) != 0))
+    {
+        if (failures < 10)
+            printf("  %s: Palette_Draw() returned %d, expected %d%s\n", what, ret, want,
+                   (memcmp(frame, expect, sizeof(frame)) != 0) ? ", frame differs" : "");
+        failures++;
+    }
+}
+
+static void check_slices(void)
+{
+    static uint32_t buf[(4 + PALETTE_COLORS_MAX * 2 + LCD_WIDTH * LCD_HEIGHT) / 4];
+    uint16_t palette[PALETTE_COLORS_MAX];
+    uint16_t kept[PALETTE_COLORS_MAX];
+    size_t size;
+    size_t i;
+
+    for (i = 0; i < PALETTE_COLORS_MAX; i++)
+    {
+        palette[i] = random16();
+    }
+
+    /* PAL8 with a full palette, then a slice keeping it */
+    size = make_slice(buf, 256, palette, 17, 8);
+    check_slice("PAL8 with palette", buf, size, 3, 17, 8, palette, RENDER_OK);
+    size = make_slice(buf, 0, palette, LCD_HEIGHT, 8);
+    check_slice("PAL8 keeping it", buf, size, 0, LCD_HEIGHT, 8, palette, RENDER_OK);
+
+    /* a short palette: the entries after it are black */
+    memcpy(kept, palette, 5 * 2);
+    memset(&kept[5], 0, (PALETTE_COLORS_MAX - 5) * 2);
+    size = make_slice(buf, 5, palette, 9, 8);
+    check_slice("PAL8 with 5 colors", buf, size, LCD_HEIGHT - 9, 9, 8, kept, RENDER_OK);
+
+    /* PAL4: 16 colors, then one slice keeping them, then one with 3 */
+    size = make_slice(buf, 16, palette, 33, 4);
+    check_slice("PAL4 with palette", buf, size, 101, 33, 4, palette, RENDER_OK);
+    size = make_slice(buf, 0, palette, 1, 4);
+    check_slice("PAL4 keeping it", buf, size, 239, 1, 4, palette, RENDER_OK);
+    memcpy(kept, palette, 3 * 2);
+    memset(&kept[3], 0, (PALETTE_COLORS_MAX - 3) * 2);
+    size = make_slice(buf, 3, palette, 16, 4);
+    check_slice("PAL4 with 3 colors", buf, size, 16, 16, 4, kept, RENDER_OK);
+
+    /* rejected: the palette is PAL4's, too many colors, indices cut short, past the panel */
+    size = make_slice(buf, 0, palette, 4, 8);
+    check_slice("PAL8 without its palette", buf, size, 0, 4, 8, palette, RENDER_ERROR);
+    size = make_slice(buf, 17, palette, 4, 4);
+    check_slice("PAL4 with 17 colors", buf, size, 0, 4, 4, palette, RENDER_ERROR);
+    size = make_slice(buf, 16, palette, 4, 4);
+    check_slice("PAL4 cut short", buf, size - 1, 0, 4, 4, palette, RENDER_ERROR);
+    check_slice("PAL4 past the panel", buf, size, LCD_HEIGHT - 3, 4, 4, palette, RENDER_INVALID_PARAM);
+}
+
+int main(void)
+{
+    uint16_t palette[PALETTE_COLORS_MAX];
+    uint32_t pairs[256];
+    uint32_t pixels, src_off, dst_off;
+    int round;
+    size_t i;
+
+    srand(1);
+    for (round = 0; round < 4; round++)
+    {
+        for (i = 0; i < PALETTE_COLORS_MAX; i++)
+        {
+            palette[i] = random16();
+        }
+        Palette_MakePairs(pairs, palette);
+
+        for (pixels = 0; pixels <= MAX_PIXELS; pixels++)
+        {
+            for (src_off = 0; src_off < 2; src_off++)
+            {
+                for (dst_off = 0; dst_off < 2; dst_off++)
+                {
+                    run_case(pixels, src_off, dst_off, palette, pairs);
+                }
+            }
+        }
+    }
+
+    check_slices();
+
+    printf("%lu cases: %s\n", cases, (failures == 0) ? "ok" : "FAILED");
+    return (failures == 0) ? 0 : 1;
+}
@@ -0,0 +1,331 @@
+/**
+ * @file scalecheck.c
+ * @brief Host check that the Scale 1x, 2x and 1.5x fast paths draw what Scale_Sample() describes.
+ *
+ * Build and run on Linux from this directory, once with the DSP paths
+ * (intrinsics emulated in main.h) and once with the plain paths:
+ *   gcc -O1 -g -fno-strict-aliasing -fsanitize=address,undefined -D__ARM_FEATURE_DSP=1 \
+ *       -I. -I../../Include scalecheck.c ../../Source/Scale.c ../../Source/Blit.c -o scalecheck && ./scalecheck
+ *   gcc -O1 -g -fno-strict-aliasing -fsanitize=address,undefined \
+ *       -I. -I../../Include scalecheck.c ../../Source/Scale.c ../../Source/Blit.c -o scalecheck && ./scalecheck
+ *
+ * Every source width that makes an exact 2x (1..120) or 1.5x (2..160 even,
+ * so odd picture widths too) fit in a box up to the panel width runs with both
+ * filters, odd and even source heights, word aligned and unaligned source
+ * rows, and strips of random height that cover the whole panel or only a
+ * column range of it. The panel-wide 120 and 160 pixel sources and a few 1x
+ * and generic ratios run as well. Scale_Draw() with the fast path, and with
+ * the same setup forced to SCALE_PATH_GENERIC, must both equal a reference
+ * picture built pixel by pixel from reference_sample() (the formula of the
+ * static Scale_Sample()) and the vertical Blit_Blend() step, border bars
+ * included and the panel outside the box untouched. Every source row is a
+ * buffer of its own, so a read beyond it trips the sanitizer. Exit status 0
+ * when nothing differs.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "Blit.h"
+#include "Scale.h"
+
+#define MAX_SRC_H 9
+#define MAX_LINES 16 /* tallest strip */
+
+typedef struct
+{
+    uint16_t w, h;
+    uint16_t phase;      /* 1 puts every source row one pixel past a word boundary */
+    const uint16_t *rows[LCD_HEIGHT];
+    uint16_t *mem[LCD_HEIGHT];
+} source_t;
+
+static unsigned long cases = 0;
+static unsigned long failures = 0;
+
+static uint16_t got[LCD_HEIGHT][LCD_WIDTH];
+static uint16_t want[LCD_HEIGHT][LCD_WIDTH];
+
+static const char *const path_names[] = { "generic", "1x", "2x", "1.5x" };
+
+uint32_t HAL_GetTick(void)
+{
+    return 0;
+}
+
+static uint16_t random16(void)
+{
+    return (uint16_t)(((unsigned)rand() << 8) ^ (unsigned)rand());
+}
+
+static uint16_t canary(int x, int y)
+{
+    return (uint16_t)(0xA5C3 ^ (x * 31) ^ (y * 977));
+}
+
+static void make_source(source_t *source, uint16_t w, uint16_t h, uint16_t phase)
+{
+    uint16_t x, y;
+
+    source->w = w;
+    source->h = h;
+    source->phase = phase;
+    for (y = 0; y < h; y++)
+    {
+        /* malloc gives a word aligned block, the pixels end where it ends */
+        source->mem[y] = (uint16_t *)malloc(((size_t)w + phase) * 2);
+        if (source->mem[y] == NULL)
+        {
+            fprintf(stderr, "out of memory\n");
+            exit(1);
+        }
+        for (x = 0; x < w; x++)
+        {
+            /* runs of one color next to noise, so the averages see equal and distant neighbours */
+            source->mem[y][phase + x] = (rand() % 4 == 0 && x > 0) ? source->mem[y][phase + x - 1] : random16();
+        }
+        source->rows[y] = source->mem[y] + phase;
+    }
+}
+
+static void free_source(source_t *source)
+{
+    uint16_t y;
+
+    for (y = 0; y < source->h; y++)
+    {
+        free(source->mem[y]);
+    }
+}
+
+static const uint16_t *get_row(uint16_t row, void *Userdata)
+{
+    const source_t *source = (const source_t *)Userdata;
+
+    return (row < source->h) ? source->rows[row] : NULL;
+}
+
+/* Scale_Sample() of Source/Scale.c, written out the same way */
+static uint16_t reference_sample(const Scale_t *scale, const uint16_t *src, uint32_t j)
+{
+    uint32_t pos = j * scale->StepX;
+    uint32_t x = pos >> 16;
+    uint32_t a5 = (pos >> 11) & 31;
+    uint32_t se, de, e;
+
+    if (scale->Filter == SCALE_NEAREST || a5 == 0 || x + 1 >= scale->SrcW)
+        return src[x];
+    se = (src[x + 1] | ((uint32_t)src[x + 1] << 16)) & 0x07E0F81FUL;
+    de = (src[x] | ((uint32_t)src[x] << 16)) & 0x07E0F81FUL;
+    e = ((((se - de) * a5) >> 5) + de) & 0x07E0F81FUL;
+    return (uint16_t)(e | (e >> 16));
+}
+
+/* the panel as Scale_Draw() should leave it, within the columns [x0, x1) */
+static void reference_draw(const Scale_t *scale, const source_t *source, int x0, int x1)
+{
+    int x, y;
+
+    for (y = 0; y < LCD_HEIGHT; y++)
+    {
+        for (x = 0; x < LCD_WIDTH; x++)
+        {
+            uint32_t pos, a5;
+            uint16_t row, upper, lower;
+
+            want[y][x] = canary(x, y);
+            if (x < x0 || x >= x1 || x < scale->Box.x || x >= scale->Box.x + scale->Box.w || y < scale->Box.y ||
+                y >= scale->Box.y + scale->Box.h)
+                continue;
+            if (x < scale->Dst.x || x >= scale->Dst.x + scale->Dst.w || y < scale->Dst.y ||
+                y >= scale->Dst.y + scale->Dst.h)
+            {
+                want[y][x] = scale->Border;
+                continue;
+            }
+
+            pos = (uint32_t)(y - scale->Dst.y) * scale->StepY;
+            row = (uint16_t)(pos >> 16);
+            a5 = (scale->Filter == SCALE_BILINEAR && row + 1 < scale->SrcH) ? (pos >> 11) & 31 : 0;
+            upper = reference_sample(scale, source->rows[row], (uint32_t)(x - scale->Dst.x));
+            if (a5 != 0)
+            {
+                lower = reference_sample(scale, source->rows[row + 1], (uint32_t)(x - scale->Dst.x));
+                Blit_Blend(&upper, 1, &lower, 1, 1, 1, (uint8_t)(a5 * 8));
+            }
+            want[y][x] = upper;
+        }
+    }
+}
+
+/* the panel in strips of random height, each strip a buffer of its own */
+static Scale_Status_t draw(const Scale_t *scale, source_t *source, const LCD_Rect_t *area)
+{
+    Scale_Status_t status = SCALE_OK;
+    uint16_t y = 0, lines, r;
+    uint16_t *strip;
+    int x;
+
+    for (y = 0; y < LCD_HEIGHT; y++)
+    {
+        for (x = 0; x < LCD_WIDTH; x++)
+        {
+            got[y][x] = canary(x, y);
+        }
+    }
+
+    for (y = 0; y < area->h && status == SCALE_OK; y += lines)
+    {
+        lines = (uint16_t)(1 + rand() % MAX_LINES);
+        if (lines > area->h - y)
+            lines = area->h - y;
+        strip = (uint16_t *)malloc((size_t)area->w * lines * 2);
+        if (strip == NULL)
+        {
+            fprintf(stderr, "out of memory\n");
+            exit(1);
+        }
+        for (r = 0; r < lines; r++)
+        {
+            memcpy(&strip[(size_t)r * area->w], &got[area->y + y + r][area->x], (size_t)area->w * 2);
+        }
+        status = Scale_Draw(scale, strip, area, y, lines, get_row, source);
+        for (r = 0; r < lines; r++)
+        {
+            memcpy(&got[area->y + y + r][area->x], &strip[(size_t)r * area->w], (size_t)area->w * 2);
+        }
+        free(strip);
+    }
+    return status;
+}
+
+static void compare(const Scale_t *scale, const source_t *source, const char *what, Scale_Status_t status)
+{
+    int x = 0, y = 0;
+
+    cases++;
+    if (status == SCALE_OK && memcmp(got, want, sizeof(got)) == 0)
+        return;
+
+    for (y = 0; y < LCD_HEIGHT - 1 && memcmp(got[y], want[y], sizeof(got[y])) == 0; y++)
+    {
+    }
+    for (x = 0; x < LCD_WIDTH - 1 && got[y][x] == want[y][x]; x++)
+    {
+    }
+    if (failures < 10)
+    {
+        printf("  %s, %ux%u+%u %s %s into %ux%u at %u,%u: status %d, pixel %d,%d is 0x%04X, ref 0x%04X\n", what,
+               source->w, source->h, source->phase, path_names[scale->Path],
+               (scale->Filter == SCALE_NEAREST) ? "nearest" : "bilinear", scale->Dst.w, scale->Dst.h, scale->Dst.x,
+               scale->Dst.y, (int)status, x, y, got[y][x], want[y][x]);
+    }
+    failures++;
+}
+
+/* one setup: the fast path it picks, then the same setup on the generic path */
+static void run_case(uint16_t src_w, uint16_t src_h, const LCD_Rect_t *box, Scale_Filter_t filter,
+                     Scale_Path_t path)
+{
+    static const LCD_Rect_t screen = { 0, 0, LCD_WIDTH, LCD_HEIGHT };
+    Scale_t scale, generic;
+    source_t source;
+    LCD_Rect_t area = screen;
+
+    cases++;
+    if (Scale_Init(&scale, src_w, src_h, box, filter, random16()) != SCALE_OK || scale.Path != path)
+    {
+        if (failures < 10)
+            printf("  %ux%u into %ux%u: no %s path\n", src_w, src_h, box ? box->w : LCD_WIDTH,
+                   box ? box->h : LCD_HEIGHT, path_names[path]);
+        failures++;
+        return;
+    }
+
+    /* half the time only some columns of the panel, so the picture starts and ends inside strips */
+    if (rand() % 2)
+    {
+        area.x = (uint16_t)(rand() % LCD_WIDTH);
+        area.w = (uint16_t)(1 + rand() % (LCD_WIDTH - area.x));
+    }
+
+    make_source(&source, src_w, src_h, (uint16_t)(rand() % 2));
+    reference_draw(&scale, &source, area.x, area.x + area.w);
+    compare(&scale, &source, "fast", draw(&scale, &source, &area));
+    generic = scale;
+    generic.Path = SCALE_PATH_GENERIC;
+    compare(&generic, &source, "generic", draw(&generic, &source, &area));
+    free_source(&source);
+}
+
+/* a box w wide that the src_w x src_h picture fills across, at a random place on the panel */
+static void run_width(uint16_t src_w, uint16_t w, Scale_Path_t path)
+{
+    LCD_Rect_t box;
+    uint16_t src_h;
+    int filter;
+
+    for (filter = SCALE_NEAREST; filter <= SCALE_BILINEAR; filter++)
+    {
+        for (src_h = 1; src_h <= MAX_SRC_H; src_h += 1 + rand() % 3)
+        {
+            box.w = w;
+            box.h = (uint16_t)((uint32_t)src_h * w / src_w + rand() % 4);
+            if (box.h > LCD_HEIGHT)
+                box.h = LCD_HEIGHT;
+            box.x = (uint16_t)(rand() % (LCD_WIDTH - w + 1));
+            box.y = (uint16_t)(rand() % (LCD_HEIGHT - box.h + 1));
+            run_case(src_w, src_h, &box, (Scale_Filter_t)filter, path);
+        }
+    }
+}
+
+int main(void)
+{
+    static const uint16_t panel_sources[][2] = { { 120, 90 }, { 120, 120 }, { 120, 67 },
+                                                 { 160, 120 }, { 160, 160 }, { 160, 91 } };
+    LCD_Rect_t box;
+    uint16_t w;
+    size_t i;
+    int filter;
+
+    srand(1);
+
+    /* every exact 2x and 1.5x width, up to the panel */
+    for (w = 1; 2 * w <= LCD_WIDTH; w++)
+    {
+        run_width(w, (uint16_t)(2 * w), SCALE_PATH_2X);
+    }
+    for (w = 2; 3 * w / 2 <= LCD_WIDTH; w += 2)
+    {
+        run_width(w, (uint16_t)(3 * w / 2), SCALE_PATH_1_5X);
+    }
+
+    /* the sources the paths are there for, on the whole screen */
+    for (i = 0; i < sizeof(panel_sources) / sizeof(panel_sources[0]); i++)
+    {
+        for (filter = SCALE_NEAREST; filter <= SCALE_BILINEAR; filter++)
+        {
+            run_case(panel_sources[i][0], panel_sources[i][1], NULL, (Scale_Filter_t)filter,
+                     (panel_sources[i][0] == 120) ? SCALE_PATH_2X : SCALE_PATH_1_5X);
+        }
+    }
+
+    /* 1x and a few ratios without a fast path, for the generic path and the vertical step */
+    run_width(37, 37, SCALE_PATH_1X);
+    for (filter = SCALE_NEAREST; filter <= SCALE_BILINEAR; filter++)
+    {
+        run_case(LCD_WIDTH, 135, NULL, (Scale_Filter_t)filter, SCALE_PATH_1X);
+        run_case(320, 240, NULL, (Scale_Filter_t)filter, SCALE_PATH_GENERIC);
+        run_case(176, 144, NULL, (Scale_Filter_t)filter, SCALE_PATH_GENERIC);
+        box.x = 3;
+        box.y = 5;
+        box.w = 101;
+        box.h = 77;
+        run_case(39, 29, &box, (Scale_Filter_t)filter, SCALE_PATH_GENERIC);
+    }
+
+    printf("%lu cases: %s\n", cases, (failures == 0) ? "ok" : "FAILED");
+    return (failures == 0) ? 0 : 1;
+}
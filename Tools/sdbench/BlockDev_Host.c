@@ -0,0 +1,361 @@
+/**
+ * @file BlockDev_Host.c
+ * @brief BlockDev on a disk image file for host builds, see BlockDev_Host.h.
+ */
+
+#define _DEFAULT_SOURCE
+
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "BlockDev.h"
+#include "BlockDev_Host.h"
+#include "MicroOS.h"
+#include "main.h"
+
+/* data token and CRC16 around every block */
+#define BLOCK_BUS_BYTES (BLOCKDEV_SECTOR_SIZE + 3)
+
+typedef enum
+{
+    OP_READ,
+    OP_WRITE,
+    OP_WRITE_LIST,
+} transfer_op_t;
+
+static const blockdev_model_t profiles[] = {
+    /* good class 10 card; SPI3 gets PCLK/2 = 8 MHz at the 16 MHz HSI clock */
+    {"fast", 8000000, 20, 250, 100, 20, 250, 1500, 0.0, 0, 0},
+    /* old class 4 card */
+    {"slow", 8000000, 40, 1500, 800, 150, 1200, 15000, 0.0, 0, 0},
+    /* fast card that stops for garbage collection now and then */
+    {"spiky", 8000000, 20, 250, 100, 20, 250, 1500, 0.01, 20000, 150000},
+};
+
+static uint8_t *image = NULL;
+static size_t image_size = 0;
+static blockdev_model_t model;
+static uint32_t rng_state = 1;
+static uint64_t clock_us = 0;
+
+static struct
+{
+    int busy;
+    transfer_op_t op;
+    uint32_t sector;
+    uint32_t count;
+    uint8_t *buf;
+    const uint8_t *src;
+    const uint8_t *const *list;
+    uint64_t issue_us;
+    uint64_t done_us;
+    BlockDev_Status_t result;
+    BlockDev_Request_t *req; /* started with BlockDev_ReadAsync() */
+} transfer;
+
+static BlockDev_Status_t fail_next = BLOCKDEV_OK;
+
+static blockdev_host_stats_t stats;
+static uint32_t *latencies = NULL;
+static size_t latency_count = 0;
+static size_t latency_cap = 0;
+
+static uint32_t rng_next(void)
+{
+    /* xorshift32 */
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    return rng_state;
+}
+
+static uint32_t rng_range(uint32_t lo, uint32_t hi)
+{
+    return (hi > lo) ? lo + rng_next() % (hi - lo + 1) : lo;
+}
+
+static uint64_t bus_us(uint32_t bytes)
+{
+    return ((uint64_t)bytes * 8 * 1000000 + model.spi_hz - 1) / model.spi_hz;
+}
+
+static uint64_t transfer_us(transfer_op_t op, uint32_t count)
+{
+    uint64_t us = model.cmd_us + count * bus_us(BLOCK_BUS_BYTES);
+
+    if (op == OP_READ)
+        us += model.access_us + rng_range(0, model.jitter_us) + (uint64_t)(count - 1) * model.block_gap_us;
+    else
+        us += (uint64_t)count * model.write_busy_us + (count > 1 ? model.commit_us : 0);
+
+    if (model.spike_rate > 0.0 && rng_next() < (uint32_t)(model.spike_rate * 4294967295.0))
+    {
+        us += rng_range(model.spike_min_us, model.spike_max_us);
+        stats.spikes++;
+    }
+    return us;
+}
+
+static void record_latency(uint32_t us)
+{
+    if (latency_count == latency_cap)
+    {
+        size_t cap = latency_cap ? latency_cap * 2 : 4096;
+        uint32_t *grown = realloc(latencies, cap * sizeof(*grown));
+
+        if (grown == NULL)
+            return;
+        latencies = grown;
+        latency_cap = cap;
+    }
+    latencies[latency_count++] = us;
+}
+
+static void complete(void)
+{
+    uint8_t *at = image + (size_t)transfer.sector * BLOCKDEV_SECTOR_SIZE;
+    uint32_t i;
+
+    stats.busy_us += transfer.done_us - transfer.issue_us;
+    record_latency((uint32_t)(transfer.done_us - transfer.issue_us));
+    transfer.busy = 0;
+    transfer.result = fail_next;
+    fail_next = BLOCKDEV_OK;
+    if (transfer.req != NULL)
+    {
+        transfer.req->Result = transfer.result;
+        transfer.req->EndTick = HAL_GetTick();
+        transfer.req->Done = true;
+        transfer.req = NULL;
+    }
+    if (transfer.result != BLOCKDEV_OK)
+    {
+        /* a failed read leaves garbage behind, a failed write nothing */
+        if (transfer.op == OP_READ)
+            memset(transfer.buf, 0xA5, (size_t)transfer.count * BLOCKDEV_SECTOR_SIZE);
+        stats.errors++;
+        MicroOS_TriggerEvent(BLOCKDEV_EVENT_DONE);
+        return;
+    }
+
+    switch (transfer.op)
+    {
+    case OP_READ:
+        memcpy(transfer.buf, at, (size_t)transfer.count * BLOCKDEV_SECTOR_SIZE);
+        stats.reads++;
+        stats.sectors_read += transfer.count;
+        break;
+    case OP_WRITE:
+        memcpy(at, transfer.src, (size_t)transfer.count * BLOCKDEV_SECTOR_SIZE);
+        stats.writes++;
+        stats.sectors_written += transfer.count;
+        break;
+    case OP_WRITE_LIST:
+        for (i = 0; i < transfer.count; i++)
+            memcpy(at + (size_t)i * BLOCKDEV_SECTOR_SIZE, transfer.list[i], BLOCKDEV_SECTOR_SIZE);
+        stats.writes++;
+        stats.sectors_written += transfer.count;
+        break;
+    }
+
+    MicroOS_TriggerEvent(BLOCKDEV_EVENT_DONE);
+}
+
+static BlockDev_Status_t start(transfer_op_t op, uint32_t sector, uint32_t count)
+{
+    if (image == NULL)
+        return BLOCKDEV_NO_MEDIA;
+    if (count == 0 || sector >= image_size / BLOCKDEV_SECTOR_SIZE ||
+        count > image_size / BLOCKDEV_SECTOR_SIZE - sector)
+        return BLOCKDEV_INVALID_PARAM;
+    if (transfer.busy)
+        return BLOCKDEV_BUSY;
+
+    transfer.busy = 1;
+    transfer.op = op;
+    transfer.sector = sector;
+    transfer.count = count;
+    transfer.issue_us = clock_us;
+    transfer.done_us = clock_us + transfer_us(op, count);
+    transfer.result = BLOCKDEV_BUSY;
+    transfer.req = NULL;
+    return BLOCKDEV_OK;
+}
+
+int blockdev_host_open(const char *path)
+{
+    struct stat st;
+    int fd = open(path, O_RDONLY);
+
+    if (fd < 0)
+        return -1;
+    if (fstat(fd, &st) != 0 || st.st_size < BLOCKDEV_SECTOR_SIZE)
+    {
+        close(fd);
+        return -1;
+    }
+
+    /* private mapping: writes stay in memory */
+    image = mmap(NULL, (size_t)st.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (image == MAP_FAILED)
+    {
+        image = NULL;
+        return -1;
+    }
+    image_size = (size_t)st.st_size;
+    if (model.spi_hz == 0)
+        model = profiles[0];
+    return 0;
+}
+
+void blockdev_host_close(void)
+{
+    if (image != NULL)
+        munmap(image, image_size);
+    image = NULL;
+    image_size = 0;
+    free(latencies);
+    latencies = NULL;
+    latency_count = latency_cap = 0;
+}
+
+const blockdev_model_t *blockdev_host_profile(const char *name)
+{
+    size_t i;
+
+    for (i = 0; i < sizeof(profiles) / sizeof(profiles[0]); i++)
+    {
+        if (strcmp(profiles[i].name, name) == 0)
+            return &profiles[i];
+    }
+    return NULL;
+}
+
+void blockdev_host_set_model(const blockdev_model_t *m, uint32_t seed)
+{
+    model = *m;
+    rng_state = seed ? seed : 1;
+}
+
+uint64_t blockdev_host_now_us(void)
+{
+    return clock_us;
+}
+
+void blockdev_host_advance_us(uint64_t us)
+{
+    clock_us += us;
+    if (transfer.busy && transfer.done_us <= clock_us)
+        complete();
+}
+
+void blockdev_host_fail_next(BlockDev_Status_t result)
+{
+    fail_next = result;
+}
+
+void blockdev_host_get_stats(blockdev_host_stats_t *out)
+{
+    *out = stats;
+}
+
+size_t blockdev_host_latencies(const uint32_t **latency_us)
+{
+    *latency_us = latencies;
+    return latency_count;
+}
+
+void blockdev_host_reset_stats(void)
+{
+    memset(&stats, 0, sizeof(stats));
+    latency_count = 0;
+}
+
+uint32_t HAL_GetTick(void)
+{
+    return (uint32_t)(clock_us / 1000);
+}
+
+BlockDev_Status_t BlockDev_Init(void)
+{
+    return (image != NULL) ? BLOCKDEV_OK : BLOCKDEV_NO_MEDIA;
+}
+
+uint32_t BlockDev_GetSectorCount(void)
+{
+    return (uint32_t)(image_size / BLOCKDEV_SECTOR_SIZE);
+}
+
+BlockDev_Status_t BlockDev_Read(uint32_t sector, uint8_t *buf, uint32_t count)
+{
+    BlockDev_Status_t ret = start(OP_READ, sector, count);
+
+    if (ret == BLOCKDEV_OK)
+        transfer.buf = buf;
+    return ret;
+}
+
+BlockDev_Status_t BlockDev_ReadAsync(uint32_t sector, uint8_t *buf, uint32_t count, BlockDev_Request_t *req)
+{
+    BlockDev_Status_t ret;
+
+    if (req == NULL)
+        return BLOCKDEV_INVALID_PARAM;
+    req->Done = false;
+    req->Result = BLOCKDEV_BUSY;
+    ret = BlockDev_Read(sector, buf, count);
+    if (ret == BLOCKDEV_OK)
+        transfer.req = req;
+    return ret;
+}
+
+BlockDev_Status_t BlockDev_Write(uint32_t sector, const uint8_t *buf, uint32_t count)
+{
+    BlockDev_Status_t ret = start(OP_WRITE, sector, count);
+
+    if (ret == BLOCKDEV_OK)
+        transfer.src = buf;
+    return ret;
+}
+
+BlockDev_Status_t BlockDev_WriteList(uint32_t sector, const uint8_t *const *list, uint32_t count)
+{
+    BlockDev_Status_t ret = start(OP_WRITE_LIST, sector, count);
+
+    if (ret == BLOCKDEV_OK)
+        transfer.list = list;
+    return ret;
+}
+
+bool BlockDev_IsBusy(void)
+{
+    return transfer.busy != 0;
+}
+
+BlockDev_Status_t BlockDev_GetResult(void)
+{
+    return transfer.busy ? BLOCKDEV_BUSY : transfer.result;
+}
+
+BlockDev_Status_t BlockDev_WaitIdle(uint32_t timeout_ms)
+{
+    uint64_t left;
+
+    if (!transfer.busy)
+        return transfer.result;
+
+    /* a blocking wait is where card time passes */
+    left = transfer.done_us - clock_us;
+    if (left > (uint64_t)timeout_ms * 1000)
+    {
+        clock_us += (uint64_t)timeout_ms * 1000;
+        return BLOCKDEV_TIMEOUT;
+    }
+    blockdev_host_advance_us(left);
+    return transfer.result;
+}
@@ -0,0 +1,67 @@
+/**
+ * @file BlockDev_Host.h
+ * @brief BlockDev backend on a disk image file, with an SD card timing model.
+ *
+ * The image is mapped copy-on-write: writes land in memory and never reach
+ * the file. Transfers complete on a virtual microsecond clock that only moves
+ * when the caller advances it or waits with BlockDev_WaitIdle(); the data is
+ * moved and BLOCKDEV_EVENT_DONE triggered at the modelled completion time.
+ */
+
+#ifndef BLOCKDEV_HOST_H
+#define BLOCKDEV_HOST_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "BlockDev.h"
+
+typedef struct
+{
+    const char *name;
+    uint32_t spi_hz;         /* SCK, a block costs 515 bytes on the bus */
+    uint32_t cmd_us;         /* command, response and stop per transfer */
+    uint32_t access_us;      /* first data token after a read command */
+    uint32_t jitter_us;      /* uniform extra on every read access */
+    uint32_t block_gap_us;   /* token wait between blocks of a multi-block read */
+    uint32_t write_busy_us;  /* busy after every written block */
+    uint32_t commit_us;      /* busy after the stop of a multi-block write */
+    double spike_rate;       /* chance of an internal stall per transfer */
+    uint32_t spike_min_us;
+    uint32_t spike_max_us;
+} blockdev_model_t;
+
+typedef struct
+{
+    uint32_t reads;
+    uint32_t writes;
+    uint64_t sectors_read;
+    uint64_t sectors_written;
+    uint32_t spikes;
+    uint32_t errors;         /* transfers failed by blockdev_host_fail_next() */
+    uint64_t busy_us;        /* time the card was transferring */
+} blockdev_host_stats_t;
+
+/* map the image, 0 on success */
+int blockdev_host_open(const char *path);
+void blockdev_host_close(void);
+
+/* built-in profiles: fast, slow, spiky; NULL for an unknown name */
+const blockdev_model_t *blockdev_host_profile(const char *name);
+void blockdev_host_set_model(const blockdev_model_t *model, uint32_t seed);
+
+uint64_t blockdev_host_now_us(void);
+
+/* move the clock, a transfer that becomes due completes */
+void blockdev_host_advance_us(uint64_t us);
+
+/* the next transfer to end fails with result (a read leaves garbage in the buffer) */
+void blockdev_host_fail_next(BlockDev_Status_t result);
+
+void blockdev_host_get_stats(blockdev_host_stats_t *stats);
+
+/* per-transfer latency (issue to completion) recorded since the last reset */
+size_t blockdev_host_latencies(const uint32_t **latency_us);
+void blockdev_host_reset_stats(void);
+
+#endif
@@ -0,0 +1,18 @@
+/**
+ * @file main.h
+ * @brief Host stand-in for the CubeMX main.h, enough for the storage modules.
+ *
+ * HAL_GetTick() runs on the virtual clock of BlockDev_Host.c, so card time
+ * and not host time is what the firmware modules see.
+ */
+
+#ifndef SDBENCH_MAIN_H
+#define SDBENCH_MAIN_H
+
+#include <stdint.h>
+
+#define __ALIGNED(x) __attribute__((aligned(x)))
+
+uint32_t HAL_GetTick(void);
+
+#endif
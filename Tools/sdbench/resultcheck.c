@@ -0,0 +1,497 @@
+/**
+ * @file resultcheck.c
+ * @brief Host check that background card reads keep their own result when other card users get in between.
+ *
+ * Build and run on Linux from this directory:
+ *   gcc -O1 -g -fsanitize=address,undefined -I. -I../../Include -I../../Components/MicroOS/include \
+ *       resultcheck.c BlockDev_Host.c ../../Source/Fat.c ../../Source/BlockCache.c \
+ *       ../../Source/Prefetch.c ../../Source/Ntv.c -o resultcheck
+ *   ./resultcheck
+ *
+ * Builds a small unpartitioned FAT32 image with a contiguous stream file and
+ * an .ntv file, mounts it through BlockDev_Host.c and streams the first
+ * through Prefetch.
+ * Now and then a prefetch read is in flight when the card model is
+ * told to fail it, and a blocking BlockCache read waits for the prefetch read
+ * and then runs its own (successful) transfer before Prefetch_Task() polls.
+ * The failed read must be counted as an error and retried, never handed to
+ * the reader: the streamed bytes must equal the file. Its latency must be
+ * that of the prefetch read alone. The same holds when a failed prefetch read
+ * has ended and the BlockCache task writes a dirty sector back before
+ * Prefetch_Task() polls. The .ntv file is read through Ntv with its chunk
+ * reads failed the same way: every chunk must come out intact and in order.
+ * Exit status 0 when every check passes.
+ */
+
+#define _DEFAULT_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "BlockCache.h"
+#include "BlockDev.h"
+#include "BlockDev_Host.h"
+#include "Fat.h"
+#include "MicroOS.h"
+#include "Ntv.h"
+#include "Prefetch.h"
+#include "main.h"
+
+#define SECTOR 512
+#define RESERVED 32
+#define FAT_SECTORS 4
+#define STREAM_SECTORS 400
+#define NTV_CHUNKS 24
+#define CHUNK_SECTORS 4
+#define MOVIE_SECTORS (1 + NTV_CHUNKS * CHUNK_SECTORS)
+#define SPARE_SECTORS 32 /* read by BlockCache in between */
+#define DATA_SECTORS (1 + STREAM_SECTORS + MOVIE_SECTORS + SPARE_SECTORS)
+#define FIRST_DATA (RESERVED + FAT_SECTORS)
+#define STREAM_CLUSTER 3 /* root directory in cluster 2, one sector per cluster */
+#define MOVIE_CLUSTER (STREAM_CLUSTER + STREAM_SECTORS)
+
+typedef struct
+{
+    MicroOS_EventFunction_t function;
+    void *data;
+    int pending;
+} check_event_t;
+
+static uint8_t image[(RESERVED + FAT_SECTORS + DATA_SECTORS) * SECTOR];
+static check_event_t events[256];
+static unsigned checks = 0;
+static unsigned failures = 0;
+
+/* MicroOS events: queued when triggered, run from the check loop like the scheduler does */
+MicroOS_Status_t MicroOS_RegisterEvent(uint8_t id, MicroOS_EventFunction_t function, void *data)
+{
+    events[id].function = function;
+    events[id].data = data;
+    return MICROOS_OK;
+}
+
+MicroOS_Status_t MicroOS_TriggerEvent(uint8_t id)
+{
+    events[id].pending = 1;
+    return MICROOS_OK;
+}
+
+bool Battery_IsLow(void)
+{
+    return false;
+}
+
+static void dispatch_events(void)
+{
+    size_t i;
+
+    for (i = 0; i < sizeof(events) / sizeof(events[0]); i++)
+    {
+        if (events[i].pending)
+        {
+            events[i].pending = 0;
+            if (events[i].function != NULL)
+                events[i].function(events[i].data);
+        }
+    }
+}
+
+static void check(int condition, const char *what)
+{
+    checks++;
+    if (!condition)
+    {
+        printf("  %s\n", what);
+        failures++;
+    }
+}
+
+static void put16(uint8_t *p, uint16_t v)
+{
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+}
+
+static void put32(uint8_t *p, uint32_t v)
+{
+    put16(p, (uint16_t)v);
+    put16(p + 2, (uint16_t)(v >> 16));
+}
+
+static uint8_t stream_byte(uint32_t pos)
+{
+    return (uint8_t)(pos * 131 + pos / SECTOR);
+}
+
+/* contiguous chain of count clusters from first, 8.3 entry number n of the root */
+static void add_file(unsigned n, const char *name83, uint32_t first, uint32_t count, uint32_t size)
+{
+    uint8_t *fat = &image[RESERVED * SECTOR];
+    uint8_t *entry = &image[FIRST_DATA * SECTOR + 32 * n];
+    uint32_t i;
+
+    for (i = 0; i < count; i++)
+        put32(&fat[4 * (first + i)], i + 1 < count ? first + i + 1 : 0x0FFFFFFF);
+    memcpy(entry, name83, 11);
+    entry[11] = 0x20;
+    put16(&entry[20], (uint16_t)(first >> 16));
+    put16(&entry[26], (uint16_t)first);
+    put32(&entry[28], size);
+}
+
+static uint8_t movie_byte(uint32_t chunk, uint32_t offset)
+{
+    return (uint8_t)(chunk * 37 + offset * 11 + offset / 256);
+}
+
+/* header and NTV_CHUNKS video chunks of CHUNK_SECTORS each */
+static void build_movie(uint8_t *movie)
+{
+    Ntv_Header_t header;
+    uint32_t c;
+    uint32_t i;
+
+    memset(&header, 0, sizeof(header));
+    header.Magic = NTV_MAGIC;
+    header.Version = NTV_VERSION;
+    header.HeaderSize = sizeof(Ntv_Header_t);
+    header.Width = 16;
+    header.Height = 16;
+    header.Codec = NTV_CODEC_RAW565;
+    header.FrameUs = 40000;
+    header.Frames = NTV_CHUNKS;
+    header.DataSector = 1;
+    header.FirstSectors = CHUNK_SECTORS;
+    header.MaxSectors = CHUNK_SECTORS;
+    memcpy(movie, &header, sizeof(header));
+
+    for (c = 0; c < NTV_CHUNKS; c++)
+    {
+        uint8_t *at = movie + (1 + (size_t)c * CHUNK_SECTORS) * SECTOR;
+        Ntv_Chunk_t chunk;
+
+        memset(&chunk, 0, sizeof(chunk));
+        chunk.Type = NTV_CHUNK_VIDEO;
+        chunk.Flags = NTV_CHUNK_KEY | NTV_CHUNK_FRAME_END;
+        chunk.Sectors = CHUNK_SECTORS;
+        chunk.NextSectors = (c + 1 < NTV_CHUNKS) ? CHUNK_SECTORS : 0;
+        chunk.Size = CHUNK_SECTORS * SECTOR - sizeof(Ntv_Chunk_t);
+        chunk.Pts = c * 40;
+        chunk.Lines = 16;
+        chunk.Index = c;
+        memcpy(at, &chunk, sizeof(chunk));
+        for (i = 0; i < chunk.Size; i++)
+            at[sizeof(chunk) + i] = movie_byte(c, i);
+    }
+}
+
+static void build_image(void)
+{
+    uint8_t *bs = image;
+    uint8_t *fat = &image[RESERVED * SECTOR];
+    uint32_t i;
+
+    bs[0] = 0xEB;
+    bs[1] = 0x58;
+    bs[2] = 0x90;
+    memcpy(&bs[3], "MSWIN4.1", 8);
+    put16(&bs[11], SECTOR);
+    bs[13] = 1;
+    put16(&bs[14], RESERVED);
+    bs[16] = 1;
+    put32(&bs[32], sizeof(image) / SECTOR);
+    put32(&bs[36], FAT_SECTORS);
+    put32(&bs[44], 2);
+    bs[510] = 0x55;
+    bs[511] = 0xAA;
+
+    put32(&fat[0], 0x0FFFFFF8);
+    put32(&fat[4], 0x0FFFFFFF);
+    put32(&fat[8], 0x0FFFFFFF);
+
+    add_file(0, "STREAM  BIN", STREAM_CLUSTER, STREAM_SECTORS, STREAM_SECTORS * SECTOR);
+    for (i = 0; i < STREAM_SECTORS * SECTOR; i++)
+        image[(FIRST_DATA + 1) * SECTOR + i] = stream_byte(i);
+    add_file(1, "MOVIE   NTV", MOVIE_CLUSTER, MOVIE_SECTORS, MOVIE_SECTORS * SECTOR);
+    build_movie(&image[(FIRST_DATA + 1 + STREAM_SECTORS) * SECTOR]);
+}
+
+/* sector n of the spare area, after the files */
+static uint32_t spare_sector(unsigned n)
+{
+    return FIRST_DATA + 1 + STREAM_SECTORS + MOVIE_SECTORS + n % SPARE_SECTORS;
+}
+
+/*
+ * Prefetch reads fail while BlockCache reads get in between: the failed data
+ * must never reach the reader.
+ */
+static void check_prefetch(void)
+{
+    static uint8_t got[STREAM_SECTORS * SECTOR];
+    Fat_File_t file;
+    Prefetch_Stats_t stats;
+    uint32_t pos = 0;
+    unsigned injected = 0;
+    unsigned n = 0;
+    unsigned step;
+
+    if (Fat_Open(&file, "/STREAM.BIN") != FAT_OK)
+    {
+        check(0, "cannot open /STREAM.BIN");
+        return;
+    }
+    Prefetch_ResetStats();
+    Prefetch_Start(&file, 0);
+
+    for (step = 0; step < 20000 && pos < sizeof(got); step++)
+    {
+        uint32_t read = 0;
+
+        /* now and then a read in flight fails while a blocking read waits for it */
+        if (step % 16 == 0 && BlockDev_IsBusy())
+        {
+            const uint8_t *data = NULL;
+
+            blockdev_host_fail_next(BLOCKDEV_ERROR);
+            injected++;
+            check(BlockCache_Read(spare_sector(n++), 0, &data) == BLOCKCACHE_OK,
+                  "BlockCache_Read failed after a failed prefetch read");
+        }
+
+        blockdev_host_advance_us(1000);
+        dispatch_events();
+        Prefetch_Task(NULL);
+
+        Prefetch_Read(&got[pos], (uint32_t)(sizeof(got) - pos) < 700 ? (uint32_t)(sizeof(got) - pos) : 700, &read);
+        pos += read;
+    }
+    Prefetch_GetStats(&stats);
+    Prefetch_Stop();
+
+    check(pos == sizeof(got), "Prefetch did not deliver the whole stream");
+    for (pos = 0; pos < sizeof(got) && got[pos] == stream_byte(pos); pos++)
+    {
+    }
+    if (pos < sizeof(got))
+        printf("    byte %u is 0x%02X, expected 0x%02X\n", pos, got[pos], stream_byte(pos));
+    check(pos == sizeof(got), "Prefetch handed out data of a failed read");
+    check(injected > 0 && stats.Errors == injected, "Prefetch did not count every failed read");
+}
+
+/*
+ * The latency of a prefetch read is its own, not that of the transfer some
+ * other card user started after waiting for it.
+ */
+static void check_prefetch_latency(void)
+{
+    static uint8_t buf[SPARE_SECTORS * SECTOR];
+    Fat_File_t file;
+    Prefetch_Stats_t stats;
+    const uint32_t *latency_us = NULL;
+
+    if (Fat_Open(&file, "/STREAM.BIN") != FAT_OK)
+    {
+        check(0, "cannot open /STREAM.BIN");
+        return;
+    }
+    while (BlockDev_IsBusy())
+        blockdev_host_advance_us(1000);
+    dispatch_events();
+
+    Prefetch_ResetStats();
+    blockdev_host_reset_stats();
+    Prefetch_Start(&file, 0);
+    check(BlockDev_IsBusy(), "Prefetch_Start() did not issue a read");
+
+    /* a long bypass read right behind it, then the prefetch task polls */
+    check(BlockCache_ReadBlocks(spare_sector(0), buf, SPARE_SECTORS) == BLOCKCACHE_OK, "BlockCache_ReadBlocks failed");
+    dispatch_events();
+    Prefetch_Task(NULL);
+    Prefetch_GetStats(&stats);
+    Prefetch_Stop();
+
+    /* the first transfer recorded is the prefetch read */
+    if (blockdev_host_latencies(&latency_us) < 2)
+    {
+        check(0, "fewer transfers than expected");
+        return;
+    }
+    if (stats.LatencyMs > latency_us[0] / 1000 + 1)
+        printf("    %u ms, the read took %u us\n", stats.LatencyMs, latency_us[0]);
+    check(stats.LatencyMs <= latency_us[0] / 1000 + 1, "Prefetch latency includes the transfer after it");
+}
+
+/*
+ * A prefetch read fails and ends, then the BlockCache task writes a dirty
+ * sector back before Prefetch_Task() polls: the failure stays Prefetch's.
+ */
+static void check_write_back(void)
+{
+    static uint8_t sector[SECTOR];
+    uint8_t got[SECTOR];
+    Fat_File_t file;
+    Prefetch_Stats_t stats;
+    BlockCache_Stats_t cache;
+    uint32_t read = 0;
+    uint32_t waited;
+    uint32_t i;
+
+    if (Fat_Open(&file, "/STREAM.BIN") != FAT_OK)
+    {
+        check(0, "cannot open /STREAM.BIN");
+        return;
+    }
+    while (BlockDev_IsBusy())
+        blockdev_host_advance_us(1000);
+    dispatch_events();
+
+    memset(sector, 0x5A, sizeof(sector));
+    BlockCache_ResetStats();
+    check(BlockCache_Write(spare_sector(1), sector, 0) == BLOCKCACHE_OK, "BlockCache_Write failed");
+    blockdev_host_advance_us((BLOCKCACHE_WRITE_DELAY + 1) * 1000);
+
+    Prefetch_ResetStats();
+    Prefetch_Start(&file, 0);
+    check(BlockDev_IsBusy(), "Prefetch_Start() did not issue a read");
+    blockdev_host_fail_next(BLOCKDEV_TIMEOUT);
+    for (waited = 0; BlockDev_IsBusy() && waited < 1000; waited++)
+        blockdev_host_advance_us(1000);
+
+    /* the write-back runs first, then the events and the prefetch task */
+    BlockCache_Task(NULL);
+    BlockCache_GetStats(&cache);
+    check(cache.WriteBacks == 1 && cache.Dirty == 0, "BlockCache_Task did not write the sector back");
+    dispatch_events();
+    Prefetch_Task(NULL);
+    Prefetch_GetStats(&stats);
+    check(stats.Errors == 1 && stats.Reads == 0 && stats.Ahead == 0,
+          "Prefetch took a failed read as good after a write-back");
+
+    /* the retry fills the ring with the file */
+    for (waited = 0; Prefetch_Available() < SECTOR && waited < 1000; waited++)
+    {
+        blockdev_host_advance_us(1000);
+        dispatch_events();
+        Prefetch_Task(NULL);
+    }
+    Prefetch_Read(got, sizeof(got), &read);
+    for (i = 0; i < read && got[i] == stream_byte(i); i++)
+    {
+    }
+    check(read == sizeof(got) && i == read, "Prefetch retry returned wrong data");
+    Prefetch_Stop();
+}
+
+/*
+ * Ntv chunk reads fail while a long BlockCache read gets in between: every
+ * chunk must come out intact, in order, and the latency must be the chunk
+ * read's own.
+ */
+static void check_ntv(void)
+{
+    static uint8_t buf[SPARE_SECTORS * SECTOR];
+    Fat_File_t file;
+    Ntv_Stats_t stats;
+    uint32_t next = 0;
+    unsigned injected = 0;
+    unsigned step;
+    uint32_t i;
+
+    if (Fat_Open(&file, "/MOVIE.NTV") != FAT_OK || Ntv_Open(&file) != NTV_OK)
+    {
+        check(0, "cannot open /MOVIE.NTV");
+        return;
+    }
+    Ntv_ResetStats();
+
+    for (step = 0; step < 20000; step++)
+    {
+        const Ntv_Chunk_t *chunk = NULL;
+        const uint8_t *payload = NULL;
+        Ntv_Status_t ret;
+
+        if (step % 8 == 0 && BlockDev_IsBusy())
+        {
+            blockdev_host_fail_next(BLOCKDEV_ERROR);
+            injected++;
+            check(BlockCache_ReadBlocks(spare_sector(0), buf, SPARE_SECTORS) == BLOCKCACHE_OK,
+                  "BlockCache_ReadBlocks failed after a failed chunk read");
+        }
+
+        blockdev_host_advance_us(1000);
+        dispatch_events();
+        Ntv_Task(NULL);
+
+        ret = Ntv_GetChunk(&chunk, &payload);
+        if (ret == NTV_UNDERRUN)
+            continue;
+        if (ret != NTV_OK)
+        {
+            check(ret == NTV_END, "Ntv_GetChunk failed");
+            break;
+        }
+        if (chunk->Index != next || chunk->Size != CHUNK_SECTORS * SECTOR - sizeof(Ntv_Chunk_t))
+        {
+            printf("    chunk %u: index %u, size %u\n", next, chunk->Index, chunk->Size);
+            check(0, "Ntv handed out a chunk of a failed read");
+            break;
+        }
+        for (i = 0; i < chunk->Size && payload[i] == movie_byte(next, i); i++)
+        {
+        }
+        check(i == chunk->Size, "Ntv handed out a payload of a failed read");
+        next++;
+        Ntv_Release();
+    }
+    Ntv_GetStats(&stats);
+    Ntv_Close();
+
+    check(next == NTV_CHUNKS, "Ntv did not deliver every chunk");
+    check(injected > 0 && stats.Errors == injected, "Ntv did not count every failed read");
+    /* a chunk read takes under 3 ms on the fast profile, the read after it over 16 */
+    if (stats.LatencyMaxMs > 4)
+        printf("    worst chunk read %u ms\n", stats.LatencyMaxMs);
+    check(stats.LatencyMaxMs <= 4, "Ntv latency includes the transfer after it");
+}
+
+int main(void)
+{
+    char path[] = "/tmp/resultcheckXXXXXX";
+    int fd;
+
+    build_image();
+    fd = mkstemp(path);
+    if (fd < 0 || write(fd, image, sizeof(image)) != (ssize_t)sizeof(image))
+    {
+        fprintf(stderr, "cannot write %s\n", path);
+        return 1;
+    }
+    close(fd);
+
+    if (blockdev_host_open(path) != 0)
+    {
+        fprintf(stderr, "cannot map %s\n", path);
+        return 1;
+    }
+    unlink(path);
+    blockdev_host_set_model(blockdev_host_profile("fast"), 1);
+    BlockCache_Init();
+    Prefetch_Init();
+    if (BlockDev_Init() != BLOCKDEV_OK || Fat_Mount() != FAT_OK)
+    {
+        fprintf(stderr, "cannot mount the image\n");
+        return 1;
+    }
+
+    check_prefetch();
+    check_prefetch_latency();
+    check_write_back();
+    check_ntv();
+
+    blockdev_host_close();
+    printf("%u checks: %s\n", checks, failures == 0 ? "ok" : "FAILED");
+    return failures == 0 ? 0 : 1;
+}
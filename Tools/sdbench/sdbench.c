@@ -0,0 +1,456 @@
+/**
+ * @file sdbench.c
+ * @brief Host I/O benchmark for the storage stack (Fat, BlockCache, Prefetch).
+ *
+ * Build and run on Linux from this directory:
+ *   gcc -O2 -I. -I../../Include -I../../Components/MicroOS/include sdbench.c \
+ *       BlockDev_Host.c ../../Source/Fat.c ../../Source/BlockCache.c \
+ *       ../../Source/Prefetch.c -o sdbench
+ *   ./sdbench [-p fast|slow|spiky] [-f /path/in/volume] [-r KB/s] [-t seconds]
+ *             [-s seed] disk.img
+ *
+ * The firmware modules run unchanged on top of BlockDev_Host.c, which serves
+ * the image (a raw card dump or a partitioned/unpartitioned FAT32 or exFAT
+ * image) with the latency of the chosen card profile on a virtual clock. All
+ * times below are card time, host speed does not enter. Add
+ * -DBLOCKCACHE_SLOTS=n, -DPREFETCH_SECTORS=n and friends to the build line to
+ * try other configurations.
+ *
+ * Reported:
+ *   - mount and recursive listing, cold and warm cache
+ *   - sequential Fat_Read() throughput and per-call latency percentiles
+ *   - streaming through Prefetch at -r KB/s (25 frames per second): late
+ *     frames, stall time, card latency and window depth
+ *   - the highest stream rate without a late frame for the profile
+ *   - write-back coalescing of BlockCache (image writes stay in memory)
+ * Without -f the largest file on the volume is used.
+ */
+
+#define _DEFAULT_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "BlockCache.h"
+#include "BlockDev.h"
+#include "BlockDev_Host.h"
+#include "Fat.h"
+#include "MicroOS.h"
+#include "Prefetch.h"
+#include "main.h"
+
+#define FRAME_MS 40
+#define WRITE_SECTORS 256
+#define SEARCH_STEPS 12
+
+typedef struct
+{
+    MicroOS_EventFunction_t function;
+    void *data;
+    int pending;
+} bench_event_t;
+
+typedef struct
+{
+    uint32_t frames;
+    uint32_t late;
+    uint32_t stall_ms;
+    uint32_t worst_stall_ms;
+    Prefetch_Stats_t prefetch;
+} stream_result_t;
+
+static bench_event_t events[256];
+static char largest_path[512];
+static uint32_t largest_size = 0;
+static uint8_t read_buf[262144];
+
+/* MicroOS events: queued when triggered, run from the bench loop like the scheduler does */
+MicroOS_Status_t MicroOS_RegisterEvent(uint8_t id, MicroOS_EventFunction_t function, void *data)
+{
+    events[id].function = function;
+    events[id].data = data;
+    return MICROOS_OK;
+}
+
+MicroOS_Status_t MicroOS_TriggerEvent(uint8_t id)
+{
+    events[id].pending = 1;
+    return MICROOS_OK;
+}
+
+bool Battery_IsLow(void)
+{
+    return false;
+}
+
+static void dispatch_events(void)
+{
+    size_t i;
+
+    for (i = 0; i < sizeof(events) / sizeof(events[0]); i++)
+    {
+        if (events[i].pending)
+        {
+            events[i].pending = 0;
+            if (events[i].function != NULL)
+                events[i].function(events[i].data);
+        }
+    }
+}
+
+/* one scheduler millisecond: card time passes, events run, then the periodic tasks */
+static void tick(void)
+{
+    blockdev_host_advance_us(1000);
+    dispatch_events();
+    Prefetch_Task(NULL);
+    if (HAL_GetTick() % 100 == 0)
+        BlockCache_Task(NULL);
+}
+
+static int compare_u32(const void *a, const void *b)
+{
+    uint32_t x = *(const uint32_t *)a;
+    uint32_t y = *(const uint32_t *)b;
+
+    return (x > y) - (x < y);
+}
+
+static void print_percentiles(const char *what, const uint32_t *values, size_t count)
+{
+    uint32_t *sorted;
+
+    if (count == 0)
+        return;
+    sorted = malloc(count * sizeof(*sorted));
+    if (sorted == NULL)
+        return;
+    memcpy(sorted, values, count * sizeof(*sorted));
+    qsort(sorted, count, sizeof(*sorted), compare_u32);
+    printf("    %-10s n=%-7zu p50 %7.2f  p99 %7.2f  p99.9 %7.2f  max %7.2f ms\n", what, count,
+           sorted[count / 2] / 1000.0, sorted[count * 99 / 100] / 1000.0, sorted[count * 999 / 1000] / 1000.0,
+           sorted[count - 1] / 1000.0);
+    free(sorted);
+}
+
+static void print_card_latency(void)
+{
+    const uint32_t *latency;
+    size_t count = blockdev_host_latencies(&latency);
+
+    print_percentiles("card", latency, count);
+}
+
+static void list_dir(const char *path, uint32_t *files, uint32_t *dirs)
+{
+    Fat_File_t dir;
+    Fat_Info_t info;
+    char child[512];
+
+    if (Fat_Open(&dir, path) != FAT_OK)
+        return;
+    while (Fat_ReadDir(&dir, &info) == FAT_OK)
+    {
+        if (strcmp(info.Name, ".") == 0 || strcmp(info.Name, "..") == 0)
+            continue;
+        snprintf(child, sizeof(child), "%s/%s", strcmp(path, "/") == 0 ? "" : path, info.Name);
+        if (info.Attr & FAT_ATTR_DIRECTORY)
+        {
+            (*dirs)++;
+            list_dir(child, files, dirs);
+        }
+        else
+        {
+            (*files)++;
+            if (info.Size > largest_size)
+            {
+                largest_size = info.Size;
+                snprintf(largest_path, sizeof(largest_path), "%s", child);
+            }
+        }
+    }
+}
+
+static void bench_listing(const char *label)
+{
+    BlockCache_Stats_t cache;
+    blockdev_host_stats_t card;
+    uint32_t files = 0, dirs = 0;
+    uint64_t start = blockdev_host_now_us();
+
+    blockdev_host_reset_stats();
+    BlockCache_ResetStats();
+    list_dir("/", &files, &dirs);
+    BlockCache_GetStats(&cache);
+    blockdev_host_get_stats(&card);
+    printf("  listing %-5s %u files, %u dirs: %8.2f ms, %u card reads, cache %u hits %u misses\n", label, files,
+           dirs, (blockdev_host_now_us() - start) / 1000.0, card.reads, cache.Hits, cache.Misses);
+}
+
+static void bench_sequential(const char *path, uint32_t chunk)
+{
+    Fat_File_t file;
+    uint32_t *latency;
+    uint32_t calls = 0, read = 0;
+    uint64_t total = 0, start, before;
+    blockdev_host_stats_t card;
+
+    if (Fat_Open(&file, path) != FAT_OK)
+        return;
+    latency = malloc(((size_t)file.Size / chunk + 1) * sizeof(*latency));
+    if (latency == NULL)
+        return;
+
+    blockdev_host_reset_stats();
+    start = blockdev_host_now_us();
+    do
+    {
+        before = blockdev_host_now_us();
+        if (Fat_Read(&file, read_buf, chunk, &read) != FAT_OK)
+            break;
+        latency[calls++] = (uint32_t)(blockdev_host_now_us() - before);
+        total += read;
+    } while (read == chunk);
+
+    blockdev_host_get_stats(&card);
+    printf("  Fat_Read %5u B: %7.1f KB/s, %u card reads (%.1f sectors each)\n", chunk,
+           total / 1024.0 / ((blockdev_host_now_us() - start) / 1e6), card.reads,
+           card.reads ? (double)card.sectors_read / card.reads : 0.0);
+    print_percentiles("per call", latency, calls);
+    free(latency);
+}
+
+static int stream(Fat_File_t *file, uint32_t rate, uint32_t seconds, stream_result_t *result)
+{
+    uint32_t frame = rate * FRAME_MS / 1000;
+    uint32_t got = 0, read = 0, stall = 0, ms = 0;
+    uint32_t next_frame = FRAME_MS;
+    Prefetch_Status_t ret;
+
+    memset(result, 0, sizeof(*result));
+    if (frame == 0 || frame > sizeof(read_buf))
+        return -1;
+    if (Prefetch_Start(file, 0) != PREFETCH_OK)
+        return -1;
+    Prefetch_ResetStats();
+
+    /* half a second of preroll, as the player fills the ring before the first frame */
+    for (ms = 0; ms < 500; ms++)
+        tick();
+
+    for (ms = 0; ms < seconds * 1000; ms++)
+    {
+        tick();
+        if (ms + 1 < next_frame)
+            continue;
+
+        ret = Prefetch_Read(read_buf + got, frame - got, &read);
+        got += read;
+        if (ret == PREFETCH_END)
+        {
+            Prefetch_Seek(0);
+            ret = PREFETCH_OK;
+            got = frame;
+        }
+        if (ret == PREFETCH_ERROR)
+        {
+            Prefetch_Stop();
+            return -1;
+        }
+        if (got < frame)
+        {
+            /* frame is late, try again next millisecond */
+            if (stall++ == 0)
+                result->late++;
+            continue;
+        }
+
+        result->frames++;
+        result->stall_ms += stall;
+        if (stall > result->worst_stall_ms)
+            result->worst_stall_ms = stall;
+        stall = 0;
+        got = 0;
+        next_frame = ms + 1 + FRAME_MS;
+    }
+
+    Prefetch_GetStats(&result->prefetch);
+    Prefetch_Stop();
+    BlockDev_WaitIdle(1000);
+    dispatch_events();
+    return 0;
+}
+
+static void bench_stream(const char *path, uint32_t rate, uint32_t seconds)
+{
+    Fat_File_t file;
+    stream_result_t result;
+
+    if (Fat_Open(&file, path) != FAT_OK)
+        return;
+    blockdev_host_reset_stats();
+    if (stream(&file, rate, seconds, &result) != 0)
+    {
+        printf("  stream %u KB/s: failed\n", rate / 1024);
+        return;
+    }
+    printf("  stream %u KB/s for %u s: %u frames, %u late, stall %u ms (worst %u ms)\n", rate / 1024, seconds,
+           result.frames, result.late, result.stall_ms, result.worst_stall_ms);
+    printf("    prefetch: %u reads, %.1f sectors each, %u errors, latency max %u ms, depth %u, ahead %u\n",
+           result.prefetch.Reads, result.prefetch.Reads ? (double)result.prefetch.Sectors / result.prefetch.Reads : 0.0,
+           result.prefetch.Errors, result.prefetch.LatencyMaxMs, result.prefetch.Depth, result.prefetch.Ahead);
+    print_card_latency();
+}
+
+static void bench_max_rate(const char *path, uint32_t seconds, const blockdev_model_t *model, uint32_t seed)
+{
+    Fat_File_t file;
+    stream_result_t result;
+    uint32_t lo = 8 * 1024, hi = 4096 * 1024, mid;
+    int step;
+
+    for (step = 0; step < SEARCH_STEPS && hi - lo > 1024; step++)
+    {
+        mid = lo + (hi - lo) / 2;
+        /* the same card behaviour for every rate tried */
+        blockdev_host_set_model(model, seed);
+        if (Fat_Open(&file, path) != FAT_OK || stream(&file, mid, seconds, &result) != 0)
+            break;
+        if (result.late == 0)
+            lo = mid;
+        else
+            hi = mid;
+    }
+    printf("  highest rate without late frames: %u KB/s\n", lo / 1024);
+}
+
+static void bench_write_back(void)
+{
+    static uint8_t data[BLOCKDEV_SECTOR_SIZE];
+    uint32_t order[WRITE_SECTORS];
+    uint32_t base = BlockDev_GetSectorCount() - WRITE_SECTORS;
+    uint32_t i, j, swap;
+    uint64_t start;
+    BlockCache_Stats_t cache;
+    blockdev_host_stats_t card;
+
+    /* shuffled within windows of 8 sectors, like scattered FAT and directory updates */
+    for (i = 0; i < WRITE_SECTORS; i++)
+        order[i] = i;
+    for (i = 0; i < WRITE_SECTORS; i++)
+    {
+        j = (i & ~7U) + (uint32_t)rand() % 8;
+        swap = order[i];
+        order[i] = order[j];
+        order[j] = swap;
+    }
+
+    blockdev_host_reset_stats();
+    BlockCache_ResetStats();
+    start = blockdev_host_now_us();
+    for (i = 0; i < WRITE_SECTORS; i++)
+    {
+        memset(data, (int)i, sizeof(data));
+        if (BlockCache_Write(base + order[i], data, 0) != BLOCKCACHE_OK)
+            break;
+    }
+    BlockCache_Flush();
+    BlockCache_GetStats(&cache);
+    blockdev_host_get_stats(&card);
+    printf("  write-back %u sectors: %8.2f ms, %u card writes (%.1f sectors each)\n", WRITE_SECTORS,
+           (blockdev_host_now_us() - start) / 1000.0, card.writes,
+           card.writes ? (double)card.sectors_written / card.writes : 0.0);
+    print_card_latency();
+}
+
+static void usage(void)
+{
+    fprintf(stderr, "usage: sdbench [-p fast|slow|spiky] [-f /path/in/volume] [-r KB/s] [-t seconds] [-s seed] "
+                    "disk.img\n");
+    exit(2);
+}
+
+int main(int argc, char **argv)
+{
+    const blockdev_model_t *model = blockdev_host_profile("fast");
+    const char *path = NULL;
+    uint32_t rate = 64 * 1024, seconds = 20, seed = 1;
+    static const uint32_t chunks[] = {512, 4096, 32768};
+    uint64_t start;
+    size_t i;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "p:f:r:t:s:")) != -1)
+    {
+        switch (opt)
+        {
+        case 'p':
+            model = blockdev_host_profile(optarg);
+            if (model == NULL)
+                usage();
+            break;
+        case 'f':
+            path = optarg;
+            break;
+        case 'r':
+            rate = (uint32_t)strtoul(optarg, NULL, 0) * 1024;
+            break;
+        case 't':
+            seconds = (uint32_t)strtoul(optarg, NULL, 0);
+            break;
+        case 's':
+            seed = (uint32_t)strtoul(optarg, NULL, 0);
+            break;
+        default:
+            usage();
+        }
+    }
+    if (optind + 1 != argc || rate == 0 || seconds == 0)
+        usage();
+
+    if (blockdev_host_open(argv[optind]) != 0)
+    {
+        fprintf(stderr, "cannot map %s\n", argv[optind]);
+        return 1;
+    }
+    blockdev_host_set_model(model, seed);
+    srand(seed);
+    printf("profile %s, SCK %.1f MHz, %u sectors, BLOCKCACHE_SLOTS %d, PREFETCH_SECTORS %d\n", model->name,
+           model->spi_hz / 1e6, BlockDev_GetSectorCount(), BLOCKCACHE_SLOTS, PREFETCH_SECTORS);
+
+    BlockCache_Init();
+    Prefetch_Init();
+    start = blockdev_host_now_us();
+    if (BlockDev_Init() != BLOCKDEV_OK || Fat_Mount() != FAT_OK)
+    {
+        fprintf(stderr, "no FAT32/exFAT volume\n");
+        return 1;
+    }
+    printf("  mount (%s): %8.2f ms\n", Fat_IsExFat() ? "exFAT" : "FAT32", (blockdev_host_now_us() - start) / 1000.0);
+
+    bench_listing("cold");
+    bench_listing("warm");
+    if (path == NULL)
+        path = largest_path;
+    if (path[0] == '\0')
+    {
+        fprintf(stderr, "no file to read\n");
+        return 1;
+    }
+    printf("file %s\n", path);
+
+    for (i = 0; i < sizeof(chunks) / sizeof(chunks[0]); i++)
+    {
+        BlockCache_Invalidate();
+        bench_sequential(path, chunks[i]);
+    }
+
+    bench_stream(path, rate, seconds);
+    bench_max_rate(path, seconds, model, seed);
+    bench_write_back();
+
+    blockdev_host_close();
+    return 0;
+}